@@ -86,6 +86,7 @@
         INTEROP_TUPLE2(EmpiricalPhasing, CycleFeature), \
         INTEROP_TUPLE2(DynamicPhasing, CycleFeature), \
         INTEROP_TUPLE2(ExtendedTile, TileFeature), \
+        INTEROP_TUPLE2(QByTileRead, ReadFeature), \
         INTEROP_TUPLE1(MetricCount),\
         INTEROP_TUPLE1(UnknownMetricGroup)
 
@@ -11,6 +11,8 @@
 #include <iosfwd>
 #include "interop/util/cstdint.h"
 #include "interop/model/metric_base/metric_set.h"
+#include "interop/model/metric_base/tile_filter.h"
+#include "interop/io/read_status.h"
 
 namespace illumina { namespace interop { namespace io
 {
@@ -59,10 +61,26 @@ namespace illumina { namespace interop { namespace io
          * @param in input stream
          * @param metric_set destination set of metrics
          * @param file_size number of bytes in the file
+         * @param filter optional filter that selects the tiles to read (null reads all tiles)
          */
         virtual void read_metrics(std::istream& in,
                                   model::metric_base::metric_set<Metric>& metric_set,
-                                  const size_t file_size)=0;
+                                  const size_t file_size,
+                                  const model::metric_base::tile_filter* filter)=0;
+        /** Read every complete record into a metric set, without throwing on a partially written file
+         *
+         * Reading stops at the first incomplete record, and the metric set holds every record before it.
+         *
+         * @param in input stream
+         * @param metric_set destination set of metrics
+         * @param file_size number of bytes in the file
+         * @param filter optional filter that selects the tiles to read (null reads all tiles)
+         * @return status of the read, with the size of the valid prefix of the file
+         */
+        virtual read_status read_available_metrics(std::istream& in,
+                                                   model::metric_base::metric_set<Metric>& metric_set,
+                                                   const size_t file_size,
+                                                   const model::metric_base::tile_filter* filter)=0;
         /** Read only the header of a metric set
          *
          * @param in input stream
@@ -70,6 +88,39 @@ namespace illumina { namespace interop { namespace io
          * @return number of bytes read
          */
         virtual size_t read_header(std::istream& in, model::metric_base::metric_set<Metric>& metric_set)=0;
+        /** Decode the identifier of a single record from a raw byte buffer
+         *
+         * @param record pointer to the first byte of the record
+         * @return unique identifier of the metric or 0 if the record does not hold a valid identifier
+         */
+        virtual id_t decode_record_id(const char* record) const = 0;
+        /** Decode a single record from a raw byte buffer into a metric
+         *
+         * Vector members of the destination metric are reused, so decoding many records into the same
+         * metric does not allocate after the first record.
+         *
+         * @param record pointer to the first byte of the record
+         * @param metric destination metric
+         * @param header header of the metric set that holds the record
+         * @return number of bytes decoded
+         */
+        virtual size_t decode_record(const char* record,
+                                     metric_t& metric,
+                                     const model::metric_base::metric_set<Metric>& header) const = 0;
+        /** Read a single record from a raw byte buffer into a metric set
+         *
+         * The record is merged into the metric set as it would be by `read_metrics`, so records of multi-record
+         * formats update the metric they belong to.
+         *
+         * @param record pointer to the first byte of the record
+         * @param metric_set destination set of metrics
+         * @param metric scratch metric for records that are skipped
+         * @param filter optional filter that selects the tiles to read (null reads all tiles)
+         */
+        virtual void read_record(const char* record,
+                                 model::metric_base::metric_set<Metric>& metric_set,
+                                 metric_t& metric,
+                                 const model::metric_base::tile_filter* filter) = 0;
 
         /** Write a metric record to the given output stream
          *
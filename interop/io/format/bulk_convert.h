@@ -0,0 +1,141 @@
+/** Convert arrays of values between the binary and the model types in bulk
+ *
+ * InterOp records store arrays of values, such as the intensity of each channel or the count of each q-score bin,
+ * in a narrower type than the model. These kernels convert a whole block of values at once rather than
+ * one value at a time. Identical types are copied with memcpy and, on processors with SSE2, widening 16-bit
+ * integers to float and narrowing float to 16-bit integers are vectorized. Every other conversion falls back to a
+ * scalar loop.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <cstring>
+#include "interop/util/cstdint.h"
+#include "interop/util/type_traits.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define INTEROP_HAS_SSE2 1
+#endif
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Number of values converted in a single block
+     *
+     * Stream reads and writes go through a stack buffer of this many values.
+     */
+    static const size_t bulk_convert_block_size = 256;
+
+    /** Convert an array of values from one type to another
+     *
+     * The generic version assigns each value, which supports conversion to and from the layout structures.
+     */
+    template<typename Source, typename Destination, bool ExactBinary=is_exact_binary<Source, Destination>::value>
+    struct bulk_convert_helper
+    {
+        /** Convert an array of values
+         *
+         * @param src source array
+         * @param dst destination array
+         * @param n number of values
+         */
+        static void convert(const Source* src, Destination* dst, const size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                dst[i] = src[i];
+        }
+    };
+    /** Convert an array of values from one type to another
+     *
+     * Specialization for types with the same binary storage
+     */
+    template<typename Source, typename Destination>
+    struct bulk_convert_helper<Source, Destination, true>
+    {
+        /** Copy an array of values
+         *
+         * @param src source array
+         * @param dst destination array
+         * @param n number of values
+         */
+        static void convert(const Source* src, Destination* dst, const size_t n)
+        {
+            if(n > 0) std::memcpy(dst, src, n*sizeof(Source));
+        }
+    };
+#ifdef INTEROP_HAS_SSE2
+    /** Convert an array of values from one type to another
+     *
+     * Specialization widening unsigned 16-bit integers to float, 8 values at a time
+     */
+    template<>
+    struct bulk_convert_helper< ::uint16_t, float, false >
+    {
+        /** Convert an array of values
+         *
+         * @param src source array
+         * @param dst destination array
+         * @param n number of values
+         */
+        static void convert(const ::uint16_t* src, float* dst, const size_t n)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m128i vals = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(vals, zero)));
+                _mm_storeu_ps(dst + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(vals, zero)));
+            }
+            for (; i < n; ++i)
+                dst[i] = static_cast<float>(src[i]);
+        }
+    };
+    /** Convert an array of values from one type to another
+     *
+     * Specialization narrowing float to unsigned 16-bit integers, 8 values at a time
+     *
+     * Like the scalar cast, each value is truncated toward zero and only the low 16 bits are kept.
+     */
+    template<>
+    struct bulk_convert_helper< float, ::uint16_t, false >
+    {
+        /** Convert an array of values
+         *
+         * @param src source array
+         * @param dst destination array
+         * @param n number of values
+         */
+        static void convert(const float* src, ::uint16_t* dst, const size_t n)
+        {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                // Sign extend the low 16 bits, so the saturating pack keeps them unchanged
+                const __m128i lo = _mm_srai_epi32(_mm_slli_epi32(_mm_cvttps_epi32(_mm_loadu_ps(src + i)), 16), 16);
+                const __m128i hi = _mm_srai_epi32(_mm_slli_epi32(_mm_cvttps_epi32(_mm_loadu_ps(src + i + 4)), 16), 16);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+            }
+            for (; i < n; ++i)
+                dst[i] = static_cast< ::uint16_t >(src[i]);
+        }
+    };
+#endif
+
+    /** Convert an array of values from one type to another
+     *
+     * @param src source array
+     * @param dst destination array
+     * @param n number of values
+     */
+    template<typename Source, typename Destination>
+    void bulk_convert(const Source* src, Destination* dst, const size_t n)
+    {
+        bulk_convert_helper<Source, Destination>::convert(src, dst, n);
+    }
+
+}}}
+
@@ -68,6 +68,14 @@ namespace illumina { namespace interop { namespace io
         {
             return metric.id() == 0;
         }
+        /** Update the metric set header with a record decoded into the metric set
+         *
+         * This hook lets a layout derive metadata while the record is hot, rather than in a pass after loading.
+         */
+        template<class Metric, class Header>
+        static void track_decoded(const Metric&, Header&)
+        {
+        }
         /** Skip inserting this metric into the metric set
          *
          * This function was originally added to skip control records in tile metrics.
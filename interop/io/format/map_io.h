@@ -15,8 +15,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include "interop/io/format/stream_util.h"
+#include "interop/io/format/bulk_convert.h"
+#include "interop/util/assert.h"
 #include "interop/util/length_of.h"
+#include "interop/util/type_traits.h"
 
 namespace illumina { namespace interop { namespace io
 {
@@ -101,13 +105,13 @@ namespace illumina { namespace interop { namespace io
     }
 
     /** Helper to read an array
+     *
+     * The values are read in blocks into a stack buffer, and each block is converted with `bulk_convert`.
      */
-    template<typename ReadType, typename ValueType, bool SameSize=sizeof(ReadType)==sizeof(ValueType)>
+    template<typename ReadType, typename ValueType, bool ExactBinary=is_exact_binary<ReadType, ValueType>::value>
     struct read_array_helper
     {
         /** Read an array of values of type ReadType from the given input stream
-         *
-         * TODO: create more efficient buffered version
          *
          * @param in input stream
          * @param vals destination array of values
@@ -117,19 +121,25 @@ namespace illumina { namespace interop { namespace io
          */
         static std::streamsize read_array_from_stream(std::istream &in, ValueType* vals, const size_t n, const size_t offset=0)
         {
+            ReadType block[bulk_convert_block_size];
             std::streamsize tot = 0;
-            for (size_t i = 0; i < n; i++)
+            vals += offset;
+            for (size_t i = 0; i < n; i += bulk_convert_block_size)
             {
-                ReadType read_val;
-                read_binary(in, read_val);
-                vals[offset + i] = read_val;
-                tot += in.gcount();
+                const size_t count = std::min(bulk_convert_block_size, n - i);
+                read_binary(in, block, count);
+                const std::streamsize read_count = in.gcount();
+                tot += read_count;
+                if (read_count != static_cast<std::streamsize>(count*sizeof(ReadType)))
+                {
+                    bulk_convert(block, vals + i, static_cast<size_t>(read_count) / sizeof(ReadType));
+                    break;
+                }
+                bulk_convert(block, vals + i, count);
             }
             return tot;
         }
         /** Read an array of values of type ReadType from the given input stream
-         *
-         * TODO: create more efficient buffered version
          *
          * @param in input stream
          * @param vals destination array of values
@@ -139,25 +149,26 @@ namespace illumina { namespace interop { namespace io
          */
         static std::streamsize read_array_from_stream(char* &in, ValueType* vals, const size_t n, const size_t offset=0)
         {
-            for (size_t i = 0; i < n; i++)
+            ReadType block[bulk_convert_block_size];
+            vals += offset;
+            for (size_t i = 0; i < n; i += bulk_convert_block_size)
             {
-                ReadType read_val;
-                read_binary(in, read_val);
-                vals[offset + i] = read_val;
+                const size_t count = std::min(bulk_convert_block_size, n - i);
+                read_binary(in, block, count);
+                bulk_convert(block, vals + i, count);
             }
             return n*sizeof(ReadType);
         }
     };
     /** Helper to read an array
      *
-     * Specialization for when ReadType and ValueType are the same size
+     * Specialization for when ReadType and ValueType have the same binary storage, the values are read directly
+     * into the destination array.
      */
     template<typename ReadType, typename ValueType>
     struct read_array_helper<ReadType, ValueType, true>
     {
         /** Read an array of values of type ReadType from the given input stream
-         *
-         * TODO: create more efficient buffered version
          *
          * @param in input stream
          * @param vals destination array of values
@@ -171,8 +182,6 @@ namespace illumina { namespace interop { namespace io
             return in.gcount();
         }
         /** Read an array of values of type ReadType from the given input stream
-         *
-         * TODO: create more efficient buffered version
          *
          * @param in input stream
          * @param vals destination array of values
@@ -187,9 +196,33 @@ namespace illumina { namespace interop { namespace io
         }
     };
 
-    /** Read an array of values of type ReadType from the given input stream
+    /** Write an array of values as type WriteType to the given output stream
      *
-     * TODO: create more efficient buffered version
+     * The values are converted in blocks with `bulk_convert` into a stack buffer, and each block is written with a
+     * single call to the stream.
+     *
+     * @param out output stream
+     * @param vals source array of values
+     * @param n number of values to write
+     */
+    template<typename WriteType, typename ValueType>
+    void write_array_to_stream(std::ostream &out, const ValueType* vals, const size_t n)
+    {
+        if (is_exact_binary<WriteType, ValueType>::value)
+        {
+            if (n > 0) out.write(reinterpret_cast<const char*>(vals), n*sizeof(WriteType));
+            return;
+        }
+        WriteType block[bulk_convert_block_size];
+        for (size_t i = 0; i < n; i += bulk_convert_block_size)
+        {
+            const size_t count = std::min(bulk_convert_block_size, n - i);
+            bulk_convert(vals + i, block, count);
+            write_binary(out, block, count);
+        }
+    }
+
+    /** Read an array of values of type ReadType from the given input stream
      *
      * @param in input stream
      * @param vals destination array of values
@@ -206,8 +239,6 @@ namespace illumina { namespace interop { namespace io
 
 
     /** Read an array of values of type ReadType from the given input stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param in input stream
      * @param vals destination array of values
@@ -223,8 +254,6 @@ namespace illumina { namespace interop { namespace io
     }
 
     /** Read an array of values of type ReadType from the given input stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param in input stream
      * @param vals destination array of values
@@ -241,8 +270,6 @@ namespace illumina { namespace interop { namespace io
 
 
     /** Read an array of values of type ReadType from the given input stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param in input stream
      * @param vals destination array of values
@@ -260,8 +287,6 @@ namespace illumina { namespace interop { namespace io
 
 
     /** Read an array of values of type ReadType from the given input stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param in input stream
      * @param vals destination array of values
@@ -278,8 +303,6 @@ namespace illumina { namespace interop { namespace io
     }
 
     /** Read an array of values of type ReadType from the given input stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param in input stream
      * @param vals destination array of values
@@ -296,8 +319,6 @@ namespace illumina { namespace interop { namespace io
     }
 
     /** Read an array of values of type ReadType from the given input stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param in input stream
      * @param vals destination array of values
@@ -311,8 +332,6 @@ namespace illumina { namespace interop { namespace io
     }
 
     /** Read an array of values of type ReadType from the given input stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param in input stream
      * @param vals destination array of values
@@ -353,8 +372,6 @@ namespace illumina { namespace interop { namespace io
     }
 
     /** Write an array of values of type ReadType to the given output stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param out output stream
      * @param vals destination array of values
@@ -367,17 +384,11 @@ namespace illumina { namespace interop { namespace io
         INTEROP_ASSERT(util::length_of(vals) >= n);
         INTEROP_RANGE_CHECK_GT(n, util::length_of(vals), bad_format_exception,
                                "Write bug: expected values is greater than array size");
-        for (size_t i = 0; i < n; i++)
-        {
-            WriteType write_val = static_cast<WriteType>(vals[i]);
-            write_binary(out, write_val);
-        }
+        if (n > 0) write_array_to_stream<WriteType>(out, &vals[0], n);
         return out.tellp();
     }
 
     /** Write an array of values of type ReadType to the given output stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param out output stream
      * @param vals destination array of values
@@ -388,11 +399,7 @@ namespace illumina { namespace interop { namespace io
     template<typename WriteType, typename ValueType>
     std::streamsize padded_stream_map(std::ostream &out, const ValueType &vals, const size_t n, const WriteType pad)
     {
-        for (size_t i = 0; i < util::length_of(vals); i++)
-        {
-            WriteType write_val = static_cast<WriteType>(vals[i]);
-            write_binary(out, write_val);
-        }
+        if (util::length_of(vals) > 0) write_array_to_stream<WriteType>(out, &vals[0], util::length_of(vals));
         for (size_t i = util::length_of(vals); i < n; i++)
         {
             write_binary(out, pad);
@@ -401,8 +408,6 @@ namespace illumina { namespace interop { namespace io
     }
 
     /** Write an array of values of type ReadType to the given output stream
-     *
-     * TODO: create more efficient buffered version
      *
      * @param out output stream
      * @param vals destination array of values
@@ -416,11 +421,7 @@ namespace illumina { namespace interop { namespace io
         INTEROP_ASSERT(util::length_of(vals) >= (offset+n));
         INTEROP_RANGE_CHECK_GT(offset+n, util::length_of(vals), bad_format_exception,
                                "Write bug: expected values is greater than array size");
-        for (size_t i = 0; i < n; i++)
-        {
-            WriteType write_val = static_cast<WriteType>(vals[offset + i]);
-            write_binary(out, write_val);
-        }
+        if (n > 0) write_array_to_stream<WriteType>(out, &vals[offset], n);
         return out.tellp();
     }
 
@@ -12,10 +12,15 @@
 #endif
 
 
+#include <algorithm>
+#include <vector>
 #include "interop/util/exception.h"
 #include "interop/io/format/abstract_metric_format.h"
 #include "interop/io/format/generic_layout.h"
 #include "interop/io/format/stream_util.h"
+#include "interop/io/format/stream_membuf.h"
+#include "interop/util/hash.h"
+#include "interop/io/layout/base_metric.h"
 
 namespace illumina { namespace interop { namespace io
 {
@@ -80,52 +85,133 @@ namespace illumina { namespace interop { namespace io
         {
             const size_t version_byte_size = 1;
             const std::streampos beg = in.tellg();
+            metric_set.next_generation();
             read_header_impl(in, metric_set);
             return static_cast<size_t>(in.tellg()-beg)+version_byte_size;
         }
 
+        /** Decode the identifier of a single record from a raw byte buffer
+         *
+         * @param record pointer to the first byte of the record
+         * @return unique identifier of the metric or 0 if the record does not hold a valid identifier
+         */
+        id_t decode_record_id(const char* record) const
+        {
+            metric_id_t id;
+            char* in = const_cast<char*>(record);
+            read_binary_with_count(in, id);
+            if (!Layout::is_valid(id)) return 0;
+            return create_id(id);
+        }
+        /** Decode a single record from a raw byte buffer into a metric
+         *
+         * @param record pointer to the first byte of the record
+         * @param metric destination metric
+         * @param header header of the metric set that holds the record
+         * @return number of bytes decoded
+         */
+        size_t decode_record(const char* record, metric_t& metric, const metric_set_t& header) const
+        {
+            metric_id_t id;
+            // Reading from a raw buffer never writes to it
+            char* in = const_cast<char*>(record);
+            std::streamsize count = read_binary_with_count(in, id);
+            metric.set_base(id);
+            count += Layout::map_stream(in, metric, header, true);
+            return static_cast<size_t>(count);
+        }
+        /** Read a single record from a raw byte buffer into a metric set
+         *
+         * @param record pointer to the first byte of the record
+         * @param metric_set destination set of metrics
+         * @param metric scratch metric for records that are skipped
+         * @param filter optional filter that selects the tiles to read (null reads all tiles)
+         */
+        void read_record(const char* record,
+                         metric_set_t& metric_set,
+                         metric_t& metric,
+                         const model::metric_base::tile_filter* filter)
+        {
+            read_record(record, metric_set, metric, filter, int_constant_type<Layout::MULTI_RECORD>::null());
+        }
         /** Read all the metrics into a metric set
          *
          * @param in input stream
          * @param metric_set destination set of metrics
          * @param file_size size of the file
+         * @param filter optional filter that selects the tiles to read (null reads all tiles)
+         */
+        void read_metrics(std::istream& in,
+                          metric_set_t& metric_set,
+                          const size_t file_size,
+                          const model::metric_base::tile_filter* filter)
+        {
+            const read_status status = read_available_metrics(in, metric_set, file_size, filter);
+            if(status.is_incomplete())
+                INTEROP_THROW(incomplete_file_exception, incomplete_file_message<Metric>(status, Layout::VERSION));
+        }
+        /** Read every complete record into a metric set, without throwing on a partially written file
+         *
+         * Reading stops at the first incomplete record, and the metric set holds every record before it.
+         *
+         * @param in input stream
+         * @param metric_set destination set of metrics
+         * @param file_size size of the file
+         * @param filter optional filter that selects the tiles to read (null reads all tiles)
+         * @return status of the read, with the size of the valid prefix of the file
          */
-        void read_metrics(std::istream& in, metric_set_t& metric_set, const size_t file_size)
+        read_status read_available_metrics(std::istream& in,
+                                           metric_set_t& metric_set,
+                                           const size_t file_size,
+                                           const model::metric_base::tile_filter* filter)
         {
-            const std::streamsize record_size = read_header_impl(in, metric_set);
+            // Records read from this file are stamped with a new generation
+            metric_set.next_generation();
+            const std::streamsize record_size = read_header_status(in, metric_set);
+            if(record_size == 0) return read_status(read_status::IncompleteHeader);
             offset_map_t& metric_offset_map = metric_set.offset_map();
             metric_t metric(metric_set);
-            if(file_size > 0 && !Layout::MULTI_RECORD)
+            read_status status;
+            // Index metrics have variable length records, so they cannot be split into blocks of records
+            if(file_size > 0 && static_cast<constants::metric_group>(Metric::TYPE) != constants::Index)
             {
-                const size_t record_count = static_cast<size_t>((file_size-header_size(metric_set))/record_size);
-                metric_set.resize(metric_set.size()+record_count);
-                std::vector<char> buffer(static_cast<size_t>(record_size));
-                INTEROP_ASSERT(!buffer.empty());
-                while (in)
-                {
-                    char *in_ptr = &buffer.front();
-                    in.read(in_ptr, record_size);
-                    const std::streamsize count = in.gcount();
-                    try
-                    {
-                        if (!test_stream(in, metric_offset_map, count, record_size)) break;
-                        read_record(in_ptr, metric_set, metric_offset_map, metric, record_size);
-                    }
-                    catch(const incomplete_file_exception& ex)
-                    {
-                        metric_set.trim(metric_offset_map.size());
-                        throw ex;
-                    }
-                }
+                const size_t data_size = file_size > header_size(metric_set) ? file_size-header_size(metric_set) : 0;
+                const size_t record_count = data_size/static_cast<size_t>(record_size);
+                // Each record holds at most one metric, so the record count bounds the size of a multi-record
+                // format. Only the capacity is reserved, and the set is trimmed after reading.
+                if(Layout::MULTI_RECORD) metric_set.reserve(metric_set.size()+record_count);
+                else metric_set.resize(metric_set.size()+record_count);
+                metric_set.reserve_offset_map(metric_offset_map.size()+record_count);
+                status = read_record_blocks(in, metric_set, metric, record_size, data_size, filter);
+                if(Layout::MULTI_RECORD) metric_set.shrink_offset_map();
             }
             else
             {
+                const size_t header_byte_count = header_size(metric_set);
+                const std::streampos data_begin = in.tellg();
                 while (in)
                 {
-                    read_record(in, metric_set, metric_offset_map, metric, record_size);
+                    const std::streampos record_begin = in.tellg();
+                    std::streamsize count = 0;
+                    const stream_state state =
+                            read_record(in, metric_set, metric_offset_map, metric, record_size, filter, count);
+                    if(state == StreamGood) continue;
+                    const size_t byte_offset = header_byte_count + static_cast<size_t>(record_begin - data_begin);
+                    // Records may have a variable length, so the bytes decoded before the stream ended
+                    // may not be every byte of the incomplete record
+                    const size_t partial_byte_count = file_size > byte_offset ?
+                                                      file_size - byte_offset : static_cast<size_t>(count);
+                    if(state == StreamIncomplete)
+                        status = read_status(read_status::IncompleteRecord,
+                                             byte_offset,
+                                             partial_byte_count,
+                                             static_cast<size_t>(record_size));
+                    else status = read_status(read_status::Complete, byte_offset);
+                    break;
                 }
             }
             metric_set.trim(metric_offset_map.size());
+            return status;
         }
         /** Read a metric set from the given input stream
          *
@@ -135,11 +221,23 @@ namespace illumina { namespace interop { namespace io
          */
         std::streamsize read_header_impl(std::istream &in, header_t &header)
         {
-            // TODO: optimize header reading with block read
-            if (in.fail())
+            const std::streamsize layout_size = read_header_status(in, header);
+            if(layout_size == 0)
                 INTEROP_THROW(incomplete_file_exception, "Insufficient header data read from the file"
                         << " for "
                         << Metric::prefix() <<  " "  << Metric::suffix()  <<  " v"  << Layout::VERSION);
+            return layout_size;
+        }
+        /** Read a metric set from the given input stream, without throwing on a partially written header
+         *
+         * @param in input stream containing binary InterOp file data
+         * @param header metric set header
+         * @return number of bytes in the record, 0 if the header is incomplete
+         */
+        std::streamsize read_header_status(std::istream &in, header_t &header)
+        {
+            // TODO: optimize header reading with block read
+            if (in.fail()) return 0;
 
             //if we're not actually reading the record size from the stream
             // (the stream position is the same before and after),
@@ -147,12 +245,7 @@ namespace illumina { namespace interop { namespace io
             const ::int64_t stream_position_pre_record_check = in.tellg();
             const std::streamsize record_size = Layout::map_stream_record_size(in,
                                                                                static_cast<record_size_t>(0));
-            if(in.fail())
-            {
-                INTEROP_THROW(incomplete_file_exception, "Insufficient header data read from the file"
-                        << " for "
-                        << Metric::prefix() <<  " "  << Metric::suffix()  <<  " v"  << Layout::VERSION);
-            }
+            if(in.fail()) return 0;
             if(record_size==0)
             {
                 INTEROP_THROW(bad_format_exception, "Record size cannot be 0");
@@ -160,8 +253,7 @@ namespace illumina { namespace interop { namespace io
             const ::int64_t stream_position_post_record_check = in.tellg();
             Layout::map_stream_for_header(in, header);
 
-            if (in.fail())
-                INTEROP_THROW(incomplete_file_exception, "Insufficient extended header data read from the file");
+            if (in.fail()) return 0;
             const std::streamsize layout_size = Layout::compute_size(header);
             if (stream_position_pre_record_check != stream_position_post_record_check && record_size != layout_size)
                 INTEROP_THROW(bad_format_exception, "Record size does not match layout size, record size: " <<
@@ -227,6 +319,21 @@ namespace illumina { namespace interop { namespace io
         }
 
     private:
+        enum
+        {
+            /** Size of the blocks read from the file */
+            BLOCK_BYTE_COUNT = 1 << 20
+        };
+        /** State of the stream after reading a record */
+        enum stream_state
+        {
+            /** The record was read */
+            StreamGood,
+            /** The stream ended before the record, after at least one record */
+            StreamEnd,
+            /** The stream ended within the record, or before the first record */
+            StreamIncomplete
+        };
         typedef typename int_constant_type<0>::pointer_t is_single_record_t;
         typedef typename int_constant_type<1>::pointer_t is_multi_record_t;
         size_t buffer_size(const model::metric_base::metric_set<Metric>& metric_set, is_single_record_t)const
@@ -238,52 +345,247 @@ namespace illumina { namespace interop { namespace io
             return Layout::compute_buffer_size(metric_set);
         }
 
+        read_status read_record_blocks(std::istream& in,
+                                       metric_set_t& metric_set,
+                                       metric_t& metric,
+                                       const std::streamsize record_size,
+                                       const size_t data_size,
+                                       const model::metric_base::tile_filter* filter)
+        {
+            const size_t record_byte_count = static_cast<size_t>(record_size);
+            const size_t max_block_size = data_size < BLOCK_BYTE_COUNT ? data_size : BLOCK_BYTE_COUNT;
+            const size_t block_record_count = std::max<size_t>(1, max_block_size / record_byte_count);
+            std::vector<char> buffer(block_record_count*record_byte_count);
+            offset_map_t& metric_offset_map = metric_set.offset_map();
+            size_t byte_offset = header_size(metric_set);
+            while (in)
+            {
+                in.read(&buffer.front(), static_cast<std::streamsize>(buffer.size()));
+                const std::streamsize count = in.gcount();
+                const size_t complete_record_count = static_cast<size_t>(count / record_size);
+                const size_t read_record_count = read_block(&buffer.front(),
+                                                            complete_record_count,
+                                                            metric_set,
+                                                            metric,
+                                                            record_size,
+                                                            filter,
+                                                            int_constant_type<Layout::MULTI_RECORD>::null());
+                byte_offset += read_record_count*record_byte_count;
+                if(read_record_count < complete_record_count)
+                    return read_status(read_status::IncompleteRecord, byte_offset, 0, record_byte_count);
+                const stream_state state = check_stream(in, metric_offset_map, count % record_size);
+                if(state == StreamEnd) break;
+                if(state == StreamIncomplete)
+                    return read_status(read_status::IncompleteRecord,
+                                       byte_offset,
+                                       static_cast<size_t>(count % record_size),
+                                       record_byte_count);
+            }
+            return read_status(read_status::Complete, byte_offset);
+        }
+        size_t read_block(char* block,
+                          const size_t record_count,
+                          metric_set_t& metric_set,
+                          metric_t& metric,
+                          const std::streamsize record_size,
+                          const model::metric_base::tile_filter* filter,
+                          is_single_record_t)
+        {
+            std::streamsize count;
+            for(size_t i=0;i<record_count;++i)
+            {
+                char* in = block + i*static_cast<size_t>(record_size);
+                read_record(in, metric_set, metric_set.offset_map(), metric, record_size, filter, count);
+            }
+            return record_count;
+        }
+        size_t read_block(char* block,
+                          const size_t record_count,
+                          metric_set_t& metric_set,
+                          metric_t& metric,
+                          const std::streamsize record_size,
+                          const model::metric_base::tile_filter* filter,
+                          is_multi_record_t)
+        {
+            // Multi-record layouts only parse from a stream, so the whole block is wrapped in a single stream
+            detail::membuf sbuf(block, block + record_count*static_cast<size_t>(record_size));
+            std::istream in(&sbuf);
+            std::streamsize count;
+            for(size_t i=0;i<record_count;++i)
+            {
+                if(read_record(in, metric_set, metric_set.offset_map(), metric, record_size, filter, count)
+                   != StreamGood)
+                    return i;
+            }
+            return record_count;
+        }
+        void read_record(const char* record,
+                         metric_set_t& metric_set,
+                         metric_t& metric,
+                         const model::metric_base::tile_filter* filter,
+                         is_single_record_t)
+        {
+            // Record layouts only read from the buffer and it is never written
+            char* in = const_cast<char*>(record);
+            std::streamsize count;
+            read_record(in,
+                        metric_set,
+                        metric_set.offset_map(),
+                        metric,
+                        static_cast<std::streamsize>(record_size(metric_set)),
+                        filter,
+                        count);
+        }
+        void read_record(const char* record,
+                         metric_set_t& metric_set,
+                         metric_t& metric,
+                         const model::metric_base::tile_filter* filter,
+                         is_multi_record_t)
+        {
+            // Multi-record layouts only parse from a stream
+            const std::streamsize count = static_cast<std::streamsize>(record_size(metric_set));
+            char* begin = const_cast<char*>(record);
+            detail::membuf sbuf(begin, begin + count);
+            std::istream in(&sbuf);
+            std::streamsize read_count;
+            read_record(in, metric_set, metric_set.offset_map(), metric, count, filter, read_count);
+        }
+
     private:
-        static bool test_stream(std::istream& in,
-                         const offset_map_t& metric_offset_map,
-                         const std::streamsize count,
-                         const std::streamsize record_size)
+        template<class T>
+        static id_t create_id(const layout::base_metric<T>& id)
+        {
+            return Metric::create_id(id.lane, id.tile);
+        }
+        template<class T>
+        static id_t create_id(const layout::base_cycle_metric<T>& id)
+        {
+            return Metric::create_id(id.lane, id.tile, id.cycle);
+        }
+        template<class T>
+        static id_t create_id(const layout::base_read_metric<T>& id)
+        {
+            return Metric::create_id(id.lane, id.tile, id.read);
+        }
+
+    private:
+        static stream_state check_stream(std::istream& in,
+                                         const offset_map_t& metric_offset_map,
+                                         const std::streamsize count)
         {
             if (in.fail())
             {
-                if (count == 0 && !metric_offset_map.empty()) return false;
-                INTEROP_THROW(incomplete_file_exception, "Insufficient data read from the file, got: " << count
-                                                         << " != expected: " << record_size << " for "
-                                                         << Metric::prefix() <<  " "  << Metric::suffix()  <<  " v"
-                                                         << Layout::VERSION);
+                if (count == 0 && !metric_offset_map.empty()) return StreamEnd;
+                return StreamIncomplete;
+            }
+            return StreamGood;
+        }
+        static stream_state check_stream(const char*, const offset_map_t&, const std::streamsize)
+        {return StreamGood;}
+        static std::streamsize skip_record(char*& in, metric_t&, metric_set_t&, const std::streamsize remaining)
+        {
+            // The whole record is already in the buffer, so skipping is only a pointer increment
+            in += remaining;
+            return remaining;
+        }
+        static std::streamsize skip_record(std::istream& in,
+                                           metric_t& metric,
+                                           metric_set_t& metric_set,
+                                           const std::streamsize remaining)
+        {
+            // Index metrics have variable length records, so they are decoded into the scratch metric
+            if(static_cast<constants::metric_group>(Metric::TYPE) == constants::Index)
+                return Layout::map_stream(in, metric, metric_set, true);
+            in.ignore(remaining);
+            // A record cut short by the end of the file is reported as incomplete, like a decoded record
+            if(in.gcount() < remaining) in.setstate(std::ios::failbit);
+            return in.gcount();
+        }
+        /** Stamp a decoded record, unless the bytes it was decoded from did not change
+         *
+         * @param in input positioned after the record
+         * @param metric_set destination set of metrics
+         * @param offset offset of the record in the set
+         * @param count number of bytes decoded for the record
+         */
+        template<typename InputStream>
+        static void stamp_record(InputStream& in,
+                                 metric_set_t& metric_set,
+                                 const size_t offset,
+                                 const std::streamsize count)
+        {
+            if(!metric_set.track_changes()) return;
+            const ::uint64_t hash = record_hash(in, count);
+            if(hash == 0) metric_set.stamp(offset);
+            else metric_set.stamp(offset, hash);
+        }
+        static ::uint64_t record_hash(const char* in, const std::streamsize count)
+        {
+            return util::hash_bytes(util::hash_seed(), in-count, static_cast<size_t>(count));
+        }
+        static ::uint64_t record_hash(std::istream& in, const std::streamsize count)
+        {
+            // The stream does not keep the decoded bytes, so they are read again, 0 if the stream cannot seek
+            const std::streampos end = in.tellg();
+            if(end == std::streampos(std::streamoff(-1))) return 0;
+            in.seekg(end - std::streamoff(count));
+            if(in.fail())
+            {
+                in.clear();
+                return 0;
             }
-            return true;
+            ::uint64_t hash = util::hash_seed();
+            char buffer[256];
+            for(std::streamsize remaining = count;remaining > 0;)
+            {
+                const std::streamsize n = std::min(remaining, static_cast<std::streamsize>(sizeof(buffer)));
+                in.read(buffer, n);
+                hash = util::hash_bytes(hash, buffer, static_cast<size_t>(in.gcount()));
+                if(in.gcount() < n) return 0;
+                remaining -= n;
+            }
+            return hash;
         }
-        static bool test_stream(const char*, const offset_map_t&, const std::streamsize, const std::streamsize)
-        {return true;}
         template<typename InputStream>
-        static void read_record(InputStream& in,
-                                model::metric_base::metric_set<Metric>& metric_set,
-                                offset_map_t& metric_offset_map,
-                                metric_t& metric,
-                                const std::streamsize record_size)
+        static stream_state read_record(InputStream& in,
+                                        model::metric_base::metric_set<Metric>& metric_set,
+                                        offset_map_t& metric_offset_map,
+                                        metric_t& metric,
+                                        const std::streamsize record_size,
+                                        const model::metric_base::tile_filter* filter,
+                                        std::streamsize& count)
         {
             metric_id_t id;
-            const std::streamsize read_byte_count = read_binary_with_count (in, id);
-            if(!test_stream(in, metric_offset_map, read_byte_count, record_size)) return;
-            std::streamsize count=read_byte_count;
+            count = read_binary_with_count (in, id);
+            stream_state state = check_stream(in, metric_offset_map, count);
+            if(state != StreamGood) return state;
             if (Layout::is_valid(id))
                 // TODO: Refactor tile metrics to move record type into layout id, then we can remove skip_metric,
                 // simplifiy all this logic
             {
                 metric.set_base(id);// TODO replace with static call
-                if (metric_offset_map.find(metric.id()) == metric_offset_map.end())
+                if (filter != 0 && !filter->accept(metric.tile_hash()))
+                {
+                    count += skip_record(in, metric, metric_set, record_size-count);
+                }
+                else if (metric_offset_map.find(metric.id()) == metric_offset_map.end())
                 {
                     const size_t offset = metric_offset_map.size();
                     if(offset>= metric_set.size()) metric_set.resize(offset+1);
                     metric_set[offset].set_base(id);
                     count += Layout::map_stream(in, metric_set[offset], metric_set, true);
-                    if(!test_stream(in, metric_offset_map, count, record_size)) return;
+                    state = check_stream(in, metric_offset_map, count);
+                    if(state != StreamGood) return state;
                     if(Layout::skip_metric(metric_set[offset]))//Avoid adding control lanes in tile metrics
                     {
                         metric_set.resize(offset);
                     }
-                    else metric_offset_map[metric.id()] = offset;
+                    else
+                    {
+                        metric_offset_map[metric.id()] = offset;
+                        Layout::track_decoded(metric_set[offset], metric_set);
+                        stamp_record(in, metric_set, offset, count);
+                    }
                 }
                 else
                 {
@@ -291,6 +593,8 @@ namespace illumina { namespace interop { namespace io
                     INTEROP_ASSERTMSG(metric_set[offset].lane() != 0, offset);
                     count += Layout::map_stream(in, metric_set[offset], metric_set, false);
                     INTEROP_ASSERT(metric_set[offset].id()>0);
+                    Layout::track_decoded(metric_set[offset], metric_set);
+                    stamp_record(in, metric_set, offset, count);
                 }
             }
             else
@@ -298,7 +602,8 @@ namespace illumina { namespace interop { namespace io
                 count += Layout::map_stream(in, metric, metric_set, true);
                 //TODO: replace with skip function, simplify code, required for index metrics
             }
-            if(!test_stream(in, metric_offset_map, count, record_size)) return;
+            state = check_stream(in, metric_offset_map, count);
+            if(state != StreamGood) return state;
             if (count != record_size)
             {
                 INTEROP_THROW(bad_format_exception, "Record does not match expected size! for "
@@ -307,6 +612,7 @@ namespace illumina { namespace interop { namespace io
                                                      << " record_size: " << record_size
                                                      << " n= " << metric_offset_map.size());
             }
+            return StreamGood;
         }
     };
 }}}
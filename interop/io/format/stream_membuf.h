@@ -35,6 +35,35 @@ namespace illumina { namespace interop { namespace io
             {
                 this->setg(begin, begin, end);
             }
+
+        protected:
+            /** Move the read position, so tellg reports the number of bytes read
+             *
+             * @param off offset relative to the direction
+             * @param dir start, current position or end of the buffer
+             * @param which only the input sequence is supported
+             * @return new read position or -1 on failure
+             */
+            std::streampos seekoff(std::streamoff off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+            {
+                if((which & std::ios_base::in) == 0) return std::streampos(std::streamoff(-1));
+                char* base = this->eback();
+                if(dir == std::ios_base::cur) base = this->gptr();
+                else if(dir == std::ios_base::end) base = this->egptr();
+                if(base+off < this->eback() || base+off > this->egptr()) return std::streampos(std::streamoff(-1));
+                this->setg(this->eback(), base+off, this->egptr());
+                return std::streampos(std::streamoff(this->gptr()-this->eback()));
+            }
+            /** Move the read position to an absolute offset
+             *
+             * @param pos position from the start of the buffer
+             * @param which only the input sequence is supported
+             * @return new read position or -1 on failure
+             */
+            std::streampos seekpos(std::streampos pos, std::ios_base::openmode which)
+            {
+                return seekoff(std::streamoff(pos), std::ios_base::beg, which);
+            }
         };
     }
 }}}
@@ -0,0 +1,172 @@
+/** Kernel I/O hints for reading InterOp files
+ *
+ * A by cycle run folder holds hundreds of small files that are read one after another. The kernel read-ahead only
+ * sees one file at a time, so each file starts with a cold read. With hints enabled, the next few cycle files are
+ * read into the page cache on a helper thread while the current file is decoded, and files that will not be read
+ * again are dropped from the page cache when memory is constrained.
+ *
+ * The hints are disabled by default and must be enabled with io_hints::use_hints. They do nothing on platforms
+ * without posix_fadvise. POSIX_FADV_SEQUENTIAL is not issued: it only applies to the descriptor it is given, and the
+ * metric streams do not expose theirs.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Policy for dropping files from the page cache after they are decoded */
+    enum cache_drop_policy
+    {
+        /** Never drop decoded files from the page cache */
+        NeverDropCache,
+        /** Drop decoded files from the page cache when available memory is low */
+        DropCacheWhenConstrained,
+        /** Always drop decoded files from the page cache */
+        AlwaysDropCache
+    };
+
+    /** Process wide settings and helpers for kernel I/O hints
+     *
+     * @note The settings should be changed before any metrics are loaded, they are not synchronized with loading
+     * threads
+     */
+    class io_hints
+    {
+    public:
+        /** Enable or disable I/O hints
+         *
+         * The hints are disabled by default.
+         *
+         * @param enable true to give the kernel I/O hints
+         */
+        static void use_hints(const bool enable);
+        /** Test if I/O hints are enabled
+         *
+         * @return true if I/O hints are enabled
+         */
+        static bool use_hints();
+        /** Set the number of files to prefetch ahead of the file being decoded
+         *
+         * @param depth number of files
+         */
+        static void prefetch_depth(const size_t depth);
+        /** Get the number of files to prefetch ahead of the file being decoded
+         *
+         * @return number of files
+         */
+        static size_t prefetch_depth();
+        /** Set the policy for dropping decoded files from the page cache
+         *
+         * @param policy drop policy
+         */
+        static void drop_policy(const cache_drop_policy policy);
+        /** Get the policy for dropping decoded files from the page cache
+         *
+         * @return drop policy
+         */
+        static cache_drop_policy drop_policy();
+        /** Test if the platform supports I/O hints
+         *
+         * @return true if I/O hints are supported
+         */
+        static bool is_supported();
+
+    public:
+        /** Start reading a whole file into the page cache
+         *
+         * The call may block while the reads are queued, so it is best called from a helper thread.
+         *
+         * @param file_name path to the file
+         * @return true if the hint was given
+         */
+        static bool will_need(const std::string& file_name);
+        /** Drop the clean pages of a file from the page cache
+         *
+         * @param file_name path to the file
+         * @return true if the hint was given
+         */
+        static bool dont_need(const std::string& file_name);
+        /** Test if the memory available to the page cache is low
+         *
+         * Memory is constrained when less than an eighth of the physical memory is available.
+         *
+         * @return true if memory is constrained, false if not or unknown
+         */
+        static bool is_memory_constrained();
+
+    private:
+        static bool s_use_hints;
+        static size_t s_prefetch_depth;
+        static cache_drop_policy s_drop_policy;
+    };
+
+    /** Prefetch a sequence of files ahead of their decoding
+     *
+     * A helper thread reads the files into the page cache, staying at most prefetch_depth files ahead of the file
+     * being decoded. The helper thread is stopped and joined on destruction, so a prefetcher is safe to use when
+     * decoding throws.
+     *
+     * @code
+     * cycle_prefetcher prefetcher(file_names);
+     * for(size_t i=0;i<file_names.size();++i)
+     * {
+     *      prefetcher.advance(i);
+     *      // decode file_names[i]
+     *      prefetcher.done(i);
+     * }
+     * @endcode
+     */
+    class cycle_prefetcher
+    {
+    public:
+        /** Constructor
+         *
+         * Nothing is prefetched when I/O hints are disabled or for less than two files.
+         *
+         * @param file_names files in the order they are decoded, must outlive the prefetcher
+         */
+        explicit cycle_prefetcher(const std::vector<std::string>& file_names);
+        /** Destructor, stop and join the helper thread */
+        ~cycle_prefetcher();
+
+    public:
+        /** Signal that a file is about to be decoded
+         *
+         * @param index index of the file
+         */
+        void advance(const size_t index);
+        /** Signal that a file was decoded and will not be read again
+         *
+         * @param index index of the file
+         */
+        void done(const size_t index);
+        /** Test if a helper thread is prefetching files
+         *
+         * @return true if a helper thread is running
+         */
+        bool is_active()const;
+        /** Get the number of files read into the page cache by the helper thread
+         *
+         * @return number of files prefetched so far
+         */
+        size_t prefetch_count()const;
+
+    private:
+        cycle_prefetcher(const cycle_prefetcher&);
+        cycle_prefetcher& operator=(const cycle_prefetcher&);
+
+    private:
+        const std::vector<std::string>& m_file_names;
+        bool m_drop;
+        void* m_state;
+    };
+
+}}}
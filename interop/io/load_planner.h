@@ -0,0 +1,232 @@
+/** Plan how to load the InterOp files of a run folder
+ *
+ * The best way to load a metric group depends on its files and on the storage that holds them: tiny files are
+ * read through a plain stream, large files through a large stream buffer and by cycle folders one cycle file
+ * at a time. More threads help on local solid state storage, but only add seeks on spinning disks and
+ * contention on network file systems.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "interop/util/cstdint.h"
+#include "interop/constants/enums.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Class of storage that holds a run folder */
+    enum storage_type
+    {
+        /** Storage could not be determined */
+        UnknownStorage,
+        /** Local solid state storage */
+        LocalStorage,
+        /** Local spinning disk */
+        RotationalStorage,
+        /** Network file system, e.g. NFS or SMB */
+        NetworkStorage
+    };
+
+    /** Path used to decode a metric group */
+    enum load_path
+    {
+        /** No file was found for the group */
+        SkipLoad,
+        /** Small aggregate file read through the default stream buffer */
+        StreamLoad,
+        /** Large aggregate file read through a large stream buffer */
+        BufferedLoad,
+        /** One file per cycle read from the cycle folders */
+        ByCycleLoad
+    };
+
+    /** Tuned parameters of the load planner
+     *
+     * The defaults suit local storage. The parameters may be tuned for a mount point with load_planner::calibrate
+     * and persisted with write_load_tuning.
+     */
+    struct load_tuning
+    {
+        /** Constructor */
+        load_tuning() :
+                small_file_size(64*1024),
+                buffer_size(1024*1024),
+                local_thread_limit(0),
+                rotational_thread_limit(2),
+                network_thread_limit(4)
+        {}
+        /** Files smaller than this number of bytes are read through the default stream buffer */
+        size_t small_file_size;
+        /** Size of the stream buffer in bytes for larger files */
+        size_t buffer_size;
+        /** Maximum number of threads on local solid state storage, 0 for the number of cores */
+        size_t local_thread_limit;
+        /** Maximum number of threads on a spinning disk */
+        size_t rotational_thread_limit;
+        /** Maximum number of threads on a network file system */
+        size_t network_thread_limit;
+    };
+
+    /** Plan to load a single metric group */
+    struct group_load_plan
+    {
+        /** Constructor */
+        group_load_plan() :
+                group(constants::UnknownMetricGroup),
+                path(SkipLoad),
+                file_count(0),
+                byte_count(0),
+                record_count(0),
+                buffer_size(0)
+        {}
+        /** Metric group */
+        constants::metric_group group;
+        /** Path used to decode the group */
+        load_path path;
+        /** Number of files to read */
+        size_t file_count;
+        /** Total number of bytes to read */
+        ::uint64_t byte_count;
+        /** Estimated number of records */
+        size_t record_count;
+        /** Size of the stream buffer in bytes, 0 for the default */
+        size_t buffer_size;
+    };
+
+    /** Plan to load the InterOp files of a run folder */
+    struct load_plan
+    {
+        /** Constructor */
+        load_plan() : storage(UnknownStorage), core_count(1), thread_count(1){}
+        /** Mount point holding the run folder */
+        std::string mount_point;
+        /** Class of storage holding the run folder */
+        storage_type storage;
+        /** Number of cores */
+        size_t core_count;
+        /** Number of threads used to load the groups */
+        size_t thread_count;
+        /** Plan for each metric group with files */
+        std::vector<group_load_plan> groups;
+
+        /** Find the plan for a metric group
+         *
+         * @param group metric group
+         * @return plan for the group or null if the group has no files
+         */
+        const group_load_plan* find(const constants::metric_group group)const;
+        /** Write the plan as a table
+         *
+         * @param out output stream
+         */
+        void write(std::ostream& out)const;
+    };
+
+    /** Choose how to load each metric group of a run folder
+     *
+     * The planner only looks at the size of the files, never at their content, besides the record size in the
+     * header. Use run_metrics::plan_load to plan a run folder and run_metrics::read_metrics to execute the plan.
+     */
+    class load_planner
+    {
+    public:
+        /** Constructor
+         *
+         * @param tuning tuned parameters
+         */
+        explicit load_planner(const load_tuning& tuning=load_tuning());
+
+    public:
+        /** Begin a plan for a run folder
+         *
+         * @param run_folder run folder path
+         * @return plan with the storage and core count, and without any group
+         */
+        load_plan begin(const std::string& run_folder)const;
+        /** Plan a single metric group
+         *
+         * @param group metric group
+         * @param aggregate_size size of the aggregate file in bytes, negative if missing
+         * @param cycle_file_count number of cycle files
+         * @param cycle_byte_count total size of the cycle files in bytes
+         * @param record_size size of a record in bytes, 0 if unknown
+         * @return plan for the group
+         */
+        group_load_plan plan_group(const constants::metric_group group,
+                                   const ::int64_t aggregate_size,
+                                   const size_t cycle_file_count,
+                                   const ::uint64_t cycle_byte_count,
+                                   const size_t record_size)const;
+        /** Complete a plan by choosing the number of threads
+         *
+         * @param plan plan with every group
+         */
+        void finish(load_plan& plan)const;
+        /** Time short reads of a file with several buffer sizes and thread counts and tune both
+         *
+         * Each probe reads at most 16 MiB from its own region of the file, and the file is dropped from the page
+         * cache before each probe where supported. The best thread count becomes the thread limit for the class of
+         * storage holding the file.
+         *
+         * @param probe_file path to a large file on the storage to calibrate
+         * @return tuned parameters
+         */
+        load_tuning calibrate(const std::string& probe_file)const;
+        /** Get the tuned parameters
+         *
+         * @return tuned parameters
+         */
+        const load_tuning& tuning()const;
+
+    public:
+        /** Determine the class of storage holding a path
+         *
+         * @param path file path
+         * @return class of storage
+         */
+        static storage_type storage_of(const std::string& path);
+        /** Determine the mount point holding a path
+         *
+         * @param path file path
+         * @return mount point or empty string if unknown
+         */
+        static std::string mount_point_of(const std::string& path);
+        /** Get the number of cores
+         *
+         * @return number of cores
+         */
+        static size_t core_count();
+
+    private:
+        load_tuning m_tuning;
+    };
+
+    /** Read the tuned parameters for a mount point
+     *
+     * Each line of the file holds the parameters of a single mount point, separated by tabs.
+     *
+     * @param config_file path to the tuning file
+     * @param mount_point mount point
+     * @param tuning destination parameters, unchanged if the mount point is not found
+     * @return true if the mount point was found
+     */
+    bool read_load_tuning(const std::string& config_file, const std::string& mount_point, load_tuning& tuning);
+    /** Write the tuned parameters for a mount point
+     *
+     * The parameters of other mount points in the file are kept.
+     *
+     * @param config_file path to the tuning file
+     * @param mount_point mount point
+     * @param tuning tuned parameters
+     * @return true if the file was written
+     */
+    bool write_load_tuning(const std::string& config_file, const std::string& mount_point, const load_tuning& tuning);
+
+}}}
@@ -0,0 +1,166 @@
+/** Shared scheduler for loading InterOp files across concurrent runs
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "interop/util/exception.h"
+#include "interop/util/cstdint.h"
+#include "interop/util/mutex.h"
+#include "interop/io/stream_exceptions.h"
+#include "interop/model/model_exceptions.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Unit of work scheduled by the load scheduler
+     *
+     * A task usually reads a single InterOp metric group for a single run.
+     */
+    class load_task
+    {
+    public:
+        /** Destructor
+         */
+        virtual ~load_task(){}
+        /** Execute the task
+         */
+        virtual void operator()()=0;
+    };
+
+    /** Schedules InterOp load tasks from all runs in a process
+     *
+     * Every run that loads through the scheduler submits its tasks along with a priority class. The threads of
+     * each load then pull tasks from the shared queue rather than only their own:
+     *  - Interactive tasks are always dispatched before queued background tasks, so a background load hands its
+     *    threads over to an interactive load while the interactive tasks remain queued
+     *  - Runs with the same priority are served round robin
+     *  - The number of tasks in flight, and thus the number of open InterOp files, is capped
+     *
+     * Threads of an interactive load never pick up background tasks, so an interactive load only waits on tasks
+     * that are already in flight.
+     *
+     * @note Without OpenMP, each load is executed on the calling thread and the scheduler is not thread safe.
+     */
+    class load_scheduler
+    {
+    public:
+        /** Priority class of a load */
+        enum priority_t
+        {
+            /** Load requested by a user waiting on the result */
+            Interactive=0,
+            /** Load that can be deferred, e.g. re-indexing finished runs */
+            Background=1
+        };
+
+    private:
+        struct load_entry;
+        typedef std::vector<load_entry*> load_vector_t;
+
+    public:
+        /** Constructor
+         *
+         * @param max_open_files maximum number of tasks (open files) in flight across all loads
+         */
+        explicit load_scheduler(const size_t max_open_files=16);
+        /** Destructor
+         */
+        ~load_scheduler();
+
+    public:
+        /** Get the process wide scheduler
+         *
+         * @return process wide scheduler
+         */
+        static load_scheduler& instance();
+
+    public:
+        /** Execute a set of tasks for a single load
+         *
+         * This function returns after all the given tasks have completed. The calling threads may execute tasks
+         * from other loads of equal or higher priority while waiting.
+         *
+         * @param tasks array of tasks
+         * @param task_count number of tasks
+         * @param priority priority class of the load
+         * @param thread_count number of threads this load contributes
+         * @throws file_not_found_exception, incomplete_file_exception, bad_format_exception, invalid_parameter
+         * rethrown with the type and message of the first task that failed; any other exception is rethrown as
+         * bad_format_exception
+         */
+        void run(load_task* const* tasks,
+                 const size_t task_count,
+                 const priority_t priority,
+                 const size_t thread_count=1) INTEROP_THROW_SPEC((io::file_not_found_exception,
+                                                                     io::incomplete_file_exception,
+                                                                     io::bad_format_exception,
+                                                                     model::invalid_parameter));
+        /** Execute a set of tasks for a single load
+         *
+         * @param tasks vector of tasks
+         * @param priority priority class of the load
+         * @param thread_count number of threads this load contributes
+         * @throws file_not_found_exception, incomplete_file_exception, bad_format_exception, invalid_parameter
+         * rethrown with the type and message of the first task that failed; any other exception is rethrown as
+         * bad_format_exception
+         */
+        void run(const std::vector<load_task*>& tasks,
+                 const priority_t priority,
+                 const size_t thread_count=1) INTEROP_THROW_SPEC((io::file_not_found_exception,
+                                                                     io::incomplete_file_exception,
+                                                                     io::bad_format_exception,
+                                                                     model::invalid_parameter))
+        {
+            if(tasks.empty()) return;
+            run(&tasks.front(), tasks.size(), priority, thread_count);
+        }
+
+    public:
+        /** Set the maximum number of tasks (open files) in flight across all loads
+         *
+         * @param count maximum number of open files, must be greater than 0
+         * @throws invalid_parameter when count is 0
+         */
+        void max_open_files(const size_t count) INTEROP_THROW_SPEC((model::invalid_parameter));
+        /** Get the maximum number of tasks (open files) in flight across all loads
+         *
+         * @return maximum number of open files
+         */
+        size_t max_open_files()const;
+        /** Get the number of tasks (open files) currently in flight
+         *
+         * @return number of open files
+         */
+        size_t open_files()const;
+        /** Get the number of queued tasks for the given priority class
+         *
+         * @param priority priority class
+         * @return number of queued tasks
+         */
+        size_t pending_count(const priority_t priority)const;
+
+    private:
+        void work(load_entry& entry);
+        load_task* acquire(const load_entry& entry, load_entry*& owner);
+
+    private:
+        load_scheduler(const load_scheduler&);
+        load_scheduler& operator=(const load_scheduler&);
+
+    private:
+        load_vector_t m_loads;
+        size_t m_max_open_files;
+        size_t m_open_files;
+        ::uint64_t m_tick;
+        mutable util::mutex m_mutex;
+        util::condition_variable m_changed;
+    };
+
+}}}
+
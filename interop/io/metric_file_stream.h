@@ -8,9 +8,12 @@
  *  @copyright GNU Public License.
  */
 #pragma once
+#include <cstdio>
+#include <vector>
 #include "interop/util/exception.h"
 #include "interop/util/filesystem.h"
 #include "interop/io/format/stream_membuf.h"
+#include "interop/io/io_hints.h"
 #include "interop/io/metric_stream.h"
 #include "interop/model/metric_base/metric_exceptions.h"
 
@@ -108,6 +111,32 @@ namespace illumina { namespace interop { namespace io
         std::istringstream in(buffer);
         return read_header(in, metrics);
     }
+    /** Open a binary InterOp file, falling back to the other name when the file is missing
+     *
+     * @param fin destination file stream, not good if neither file exists
+     * @param buffer stream buffer, the default buffer is used if empty
+     * @param run_directory file path to the run directory
+     * @param use_out use the copied version
+     * @return file path of the last file opened
+     */
+    template<class MetricSet>
+    std::string open_interop(std::ifstream& fin,
+                             std::vector<char>& buffer,
+                             const std::string& run_directory,
+                             const bool use_out)
+    {
+        std::string file_name = interop_filename<MetricSet>(run_directory, use_out);
+        // The buffer must be set before the file is opened
+        if(!buffer.empty()) fin.rdbuf()->pubsetbuf(&buffer.front(), static_cast<std::streamsize>(buffer.size()));
+        fin.open(file_name.c_str(), std::ios::binary);
+        if(!fin.good())
+        {
+            fin.clear();
+            file_name = interop_filename<MetricSet>(run_directory, !use_out);
+            fin.open(file_name.c_str(), std::ios::binary);
+        }
+        return file_name;
+    }
     /** Read the binary InterOp file into the given metric set
      *
      * @snippet src/examples/example1.cpp Reading a binary InterOp file
@@ -118,12 +147,18 @@ namespace illumina { namespace interop { namespace io
      * @param run_directory file path to the run directory
      * @param metrics metric set
      * @param use_out use the copied version
+     * @param filter optional filter that selects the tiles to read (null reads all tiles)
+     * @param buffer_size size of the stream buffer in bytes, 0 for the default buffer
      * @throw file_not_found_exception
      * @throw bad_format_exception
      * @throw incomplete_file_exception
      */
     template<class MetricSet>
-    void read_interop(const std::string& run_directory, MetricSet& metrics, const bool use_out=true)   INTEROP_THROW_SPEC(
+    void read_interop(const std::string& run_directory,
+                      MetricSet& metrics,
+                      const bool use_out=true,
+                      const model::metric_base::tile_filter* filter=0,
+                      const size_t buffer_size=0)   INTEROP_THROW_SPEC(
                                                                         (   io::file_not_found_exception,
                                                                             io::bad_format_exception,
                                                                             io::incomplete_file_exception,
@@ -139,17 +174,48 @@ namespace illumina { namespace interop { namespace io
             // ---------------------------------------------------------------------------------------------------------
 #       endif
 
-        std::string file_name = interop_filename<MetricSet>(run_directory, use_out);
-        std::ifstream fin(file_name.c_str(), std::ios::binary);
-        if(!fin.good())
-        {
-            file_name = interop_filename<MetricSet>(run_directory, !use_out);
-            fin.open(file_name.c_str(), std::ios::binary);
-        }
+        std::vector<char> buffer(buffer_size);
+        std::ifstream fin;
+        const std::string file_name = open_interop<MetricSet>(fin, buffer, run_directory, use_out);
         if(!fin.good()) INTEROP_THROW(file_not_found_exception, "File not found: " << file_name);
-        read_metrics(fin, metrics, static_cast<size_t>(file_size(file_name)));
+        read_metrics(fin, metrics, static_cast<size_t>(file_size(file_name)), true, filter);
+    }
+    /** Read every complete record of a binary InterOp file, without throwing on a missing or partially written file
+     *
+     * This is intended for monitors that poll a run folder during a live run. Reading stops at the last complete
+     * record, and the metric set holds every record before it. A bad format still throws an exception.
+     *
+     * @note The 'Out' suffix (parameter: use_out) is appended when we read the file. We excluded the Out in certain
+     * conditions when writing the file.
+     *
+     * @param run_directory file path to the run directory
+     * @param metrics metric set
+     * @param use_out use the copied version
+     * @param filter optional filter that selects the tiles to read (null reads all tiles)
+     * @param buffer_size size of the stream buffer in bytes, 0 for the default buffer
+     * @return status of the read, with the size of the valid prefix of the file
+     * @throw bad_format_exception
+     */
+    template<class MetricSet>
+    read_status read_available_interop(const std::string& run_directory,
+                                       MetricSet& metrics,
+                                       const bool use_out=true,
+                                       const model::metric_base::tile_filter* filter=0,
+                                       const size_t buffer_size=0)   INTEROP_THROW_SPEC(
+                                                                        (   io::bad_format_exception,
+                                                                            model::index_out_of_bounds_exception))
+    {
+        std::vector<char> buffer(buffer_size);
+        std::ifstream fin;
+        const std::string file_name = open_interop<MetricSet>(fin, buffer, run_directory, use_out);
+        if(!fin.good()) return read_status(read_status::FileNotFound);
+        return read_available_metrics(fin, metrics, static_cast<size_t>(file_size(file_name)), true, filter);
     }
     /** Write the metric set to a binary InterOp file
+     *
+     * The metric set is written to a temporary file in the same directory, which is flushed to disk and then
+     * renamed over the target file. A reader never sees a partially written file and, if the write fails, the
+     * previous file is left untouched.
      *
      * @note The 'Out' suffix (parameter: use_out) is appended when we read the file. We excluded the Out in certain
      * conditions when writing the file.
@@ -158,23 +224,42 @@ namespace illumina { namespace interop { namespace io
      * @param metrics metric set
      * @param use_out use the copied version
      * @param version version of format to write
+     * @param sync_parent flush the directory holding the file, set to false to flush once after writing many files
      * @return true if write is successful
      */
     template<class MetricSet>
     bool write_interop(const std::string& run_directory,
                        const MetricSet& metrics,
                        const bool use_out=true,
-                       const ::int16_t version=-1)
+                       const ::int16_t version=-1,
+                       const bool sync_parent=true)
     INTEROP_THROW_SPEC((io::file_not_found_exception,
     io::bad_format_exception,
     io::incomplete_file_exception))
     {
         if(metrics.empty() || metrics.version() == 0 )return true;
         const std::string file_name = interop_filename<MetricSet>(run_directory, use_out);
-        std::ofstream fout(file_name.c_str(), std::ios::binary);
+        const std::string temp_name = file_name + ".tmp";
+        std::ofstream fout(temp_name.c_str(), std::ios::binary);
         if(!fout.good())INTEROP_THROW(file_not_found_exception, "File not found: " << file_name);
-        write_metrics(fout, metrics, version);
-        return fout.good();
+        try
+        {
+            write_metrics(fout, metrics, version);
+        }
+        catch(...)
+        {
+            fout.close();
+            std::remove(temp_name.c_str());
+            throw;
+        }
+        fout.close();
+        if(fout.fail() || !sync_file(temp_name) || !rename_file(temp_name, file_name))
+        {
+            std::remove(temp_name.c_str());
+            return false;
+        }
+        if(sync_parent) sync_directory(dirname(file_name));
+        return true;
     }
     /** Write only the header to a binary InterOp file
      *
@@ -251,9 +336,23 @@ namespace illumina { namespace interop { namespace io
             files.push_back(interop_filename<MetricSet>(run_directory, cycle, use_out));
         }
     }
-    /** Read the binary InterOp file into the given metric set
+    /** Read the size of a record from the header of a binary InterOp file
      *
-     * @snippet src/examples/example1.cpp Reading a binary InterOp file
+     * The record size is the second byte of the file, following the version.
+     *
+     * @param file_name file path to the binary InterOp file
+     * @return size of a record in bytes or 0 if the header cannot be read
+     */
+    inline size_t peek_record_size(const std::string& file_name)
+    {
+        std::ifstream fin(file_name.c_str(), std::ios::binary);
+        char header[2];
+        if(!fin.read(header, sizeof(header))) return 0;
+        return static_cast<size_t>(static_cast<unsigned char>(header[1]));
+    }
+    /** Read every complete record of the by cycle InterOp files, without throwing on a partially written file
+     *
+     * Each file is read up to its last complete record. A bad format still throws an exception.
      *
      * @note The 'Out' suffix (parameter: use_out) is appended when we read the file. We excluded the Out in certain
      * conditions when writing the file.
@@ -262,42 +361,89 @@ namespace illumina { namespace interop { namespace io
      * @param metrics metric set
      * @param last_cycle last cycle to check
      * @param use_out use the copied version
-     * @throw file_not_found_exception
+     * @param filter optional filter that selects the tiles to read (null reads all tiles)
+     * @return status of the last partially written file, or a complete status if every file was read
      * @throw bad_format_exception
-     * @throw incomplete_file_exception
      */
     template<class MetricSet>
-    void read_interop_by_cycle(const std::string& run_directory,
-                               MetricSet& metrics,
-                               const size_t last_cycle,
-                               const bool use_out=true)
-    INTEROP_THROW_SPEC((interop::io::file_not_found_exception,
-    interop::io::bad_format_exception,
-    interop::io::incomplete_file_exception,
+    read_status read_available_interop_by_cycle(const std::string& run_directory,
+                                                MetricSet& metrics,
+                                                const size_t last_cycle,
+                                                const bool use_out=true,
+                                                const model::metric_base::tile_filter* filter=0)
+    INTEROP_THROW_SPEC((interop::io::bad_format_exception,
     model::index_out_of_bounds_exception))
     {
-        std::string incomplete_file_message;
+        read_status status;
+        std::vector<std::string> file_names;
+        std::vector<size_t> file_sizes;
+        size_t total_file_size = 0;
         for(size_t cycle=1;cycle <= last_cycle;++cycle)
         {
             const std::string file_name = interop_filename<MetricSet>(run_directory, cycle, use_out);
             const int64_t file_size_in_bytes = file_size(file_name);
             if(file_size_in_bytes < 0) continue;
+            file_names.push_back(file_name);
+            file_sizes.push_back(static_cast<size_t>(file_size_in_bytes));
+            total_file_size += file_sizes.back();
+        }
+        // Reserve space for the records of every cycle at once, rather than growing the set for each file
+        const size_t record_byte_count = file_names.empty() ? 0 : peek_record_size(file_names.front());
+        if(record_byte_count > 0)
+        {
+            const size_t expected_count = metrics.size() + total_file_size / record_byte_count;
+            metrics.reserve(expected_count);
+            metrics.reserve_offset_map(expected_count);
+        }
+        // Read the next cycle files into the page cache while the current file is decoded
+        cycle_prefetcher prefetcher(file_names);
+        for(size_t i=0;i<file_names.size();++i)
+        {
+            const std::string& file_name = file_names[i];
+            const size_t file_size_in_bytes = file_sizes[i];
+            prefetcher.advance(i);
             std::ifstream fin(file_name.c_str(), std::ios::binary);
             if(fin.good())
             {
-                try
-                {
-                    read_metrics(fin, metrics, static_cast<size_t>(file_size_in_bytes), false);
-                }
-                catch(const incomplete_file_exception& ex)
-                {
-                    incomplete_file_message = ex.what();
-                }
+                const read_status file_status = read_available_metrics(fin, metrics, file_size_in_bytes, false, filter);
+                if(file_status.is_incomplete()) status = file_status;
             }
+            prefetcher.done(i);
         }
         metrics.rebuild_index();
-        if(incomplete_file_message != "")
-            throw incomplete_file_exception(incomplete_file_message);
+        return status;
+    }
+    /** Read the binary InterOp file into the given metric set
+     *
+     * @snippet src/examples/example1.cpp Reading a binary InterOp file
+     *
+     * @note The 'Out' suffix (parameter: use_out) is appended when we read the file. We excluded the Out in certain
+     * conditions when writing the file.
+     *
+     * @param run_directory file path to the run directory
+     * @param metrics metric set
+     * @param last_cycle last cycle to check
+     * @param use_out use the copied version
+     * @param filter optional filter that selects the tiles to read (null reads all tiles)
+     * @throw file_not_found_exception
+     * @throw bad_format_exception
+     * @throw incomplete_file_exception
+     */
+    template<class MetricSet>
+    void read_interop_by_cycle(const std::string& run_directory,
+                               MetricSet& metrics,
+                               const size_t last_cycle,
+                               const bool use_out=true,
+                               const model::metric_base::tile_filter* filter=0)
+    INTEROP_THROW_SPEC((interop::io::file_not_found_exception,
+    interop::io::bad_format_exception,
+    interop::io::incomplete_file_exception,
+    model::index_out_of_bounds_exception))
+    {
+        typedef typename MetricSet::metric_type metric_t;
+        const read_status status = read_available_interop_by_cycle(run_directory, metrics, last_cycle, use_out, filter);
+        if(status.is_incomplete())
+            INTEROP_THROW(incomplete_file_exception, incomplete_file_message<metric_t>(status, metrics.version()));
     }
     /** Check for the existence of the binary InterOp file into the given metric set
      *
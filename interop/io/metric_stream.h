@@ -12,6 +12,7 @@
 #include "interop/io/format/metric_format_factory.h"
 #include "interop/io/format/text_format_factory.h"
 #include "interop/io/paths.h"
+#include "interop/io/read_status.h"
 #include "interop/util/filesystem.h"
 #include "interop/util/assert.h"
 
@@ -94,9 +95,14 @@ namespace illumina { namespace interop { namespace io
      * @param metrics metric set
      * @param file_size number of bytes in the file
      * @param rebuild flag indicating whether to rebuild the lookup table
+     * @param filter optional filter that selects the tiles to read (null reads all tiles)
      */
     template<class MetricSet>
-    void read_metrics(std::istream &in, MetricSet &metrics, const size_t file_size, const bool rebuild=true)
+    void read_metrics(std::istream &in,
+                      MetricSet &metrics,
+                      const size_t file_size,
+                      const bool rebuild=true,
+                      const model::metric_base::tile_filter* filter=0)
     {
         typedef typename MetricSet::metric_type metric_t;
         typedef metric_format_factory<metric_t> factory_t;
@@ -114,7 +120,7 @@ namespace illumina { namespace interop { namespace io
         metrics.set_version(static_cast< ::int16_t>(version));
         try
         {
-            format_map[version]->read_metrics(in, metrics, file_size);
+            format_map[version]->read_metrics(in, metrics, file_size, filter);
         }
         catch(const incomplete_file_exception& ex)
         {
@@ -124,6 +130,44 @@ namespace illumina { namespace interop { namespace io
         if(rebuild)metrics.rebuild_index();
     }
 
+    /** Read every complete record of a binary InterOp file, without throwing on a partially written file
+     *
+     * This is intended for files that are still written during a live run. Reading stops at the last complete
+     * record, and the metric set holds every record before it. A bad format still throws an exception.
+     *
+     * @param in input stream
+     * @param metrics metric set
+     * @param file_size number of bytes in the file
+     * @param rebuild flag indicating whether to rebuild the lookup table
+     * @param filter optional filter that selects the tiles to read (null reads all tiles)
+     * @return status of the read, with the size of the valid prefix of the file
+     */
+    template<class MetricSet>
+    read_status read_available_metrics(std::istream &in,
+                                       MetricSet &metrics,
+                                       const size_t file_size,
+                                       const bool rebuild=true,
+                                       const model::metric_base::tile_filter* filter=0)
+    {
+        typedef typename MetricSet::metric_type metric_t;
+        typedef metric_format_factory<metric_t> factory_t;
+        typedef typename factory_t::metric_format_map metric_format_map;
+        metric_format_map &format_map = factory_t::metric_formats();
+        if (!in.good()) return read_status(read_status::EmptyFile);
+        const int version = in.get();
+        if (version == -1) return read_status(read_status::EmptyFile);
+        if (format_map.find(version) == format_map.end())
+            INTEROP_THROW(bad_format_exception, "No format found to parse " << paths::interop_basename<MetricSet>()
+                                                                            << " with version: " << version << " of "
+                                                                            << format_map.size() );
+        INTEROP_ASSERT(format_map[version]);
+        if(format_map[version]->is_deprecated()) return read_status(); // This version of the format is unsupported
+        metrics.set_version(static_cast< ::int16_t>(version));
+        const read_status status = format_map[version]->read_available_metrics(in, metrics, file_size, filter);
+        if(rebuild)metrics.rebuild_index();
+        return status;
+    }
+
     /** Get the size of a single metric record
      *
      * @param header header for metric
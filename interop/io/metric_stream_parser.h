@@ -0,0 +1,311 @@
+/** Incremental parser for binary InterOp data arriving in chunks
+ *
+ * The parser reads a binary InterOp file from a source that cannot seek or report its size, such as a pipe,
+ * standard input or a socket. Bytes are pushed into a bounded ring buffer, the header is parsed as soon as it is
+ * complete, and each record is then framed by the record size given in the header. Records may be split across
+ * chunks at any byte.
+ *
+ * Index metrics are not supported, as their records have a variable length.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <vector>
+#include <istream>
+#include <algorithm>
+#include <cstring>
+#include "interop/util/exception.h"
+#include "interop/util/assert.h"
+#include "interop/constants/enums.h"
+#include "interop/io/format/metric_format_factory.h"
+#include "interop/io/format/stream_membuf.h"
+#include "interop/io/metric_stream.h"
+#include "interop/io/stream_exceptions.h"
+#include "interop/model/metric_base/tile_filter.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Parse a binary InterOp file from a sequence of byte chunks in constant memory
+     *
+     * @code
+     * metric_stream_parser<error_metric> parser(metrics);
+     * while(read_chunk(socket, buffer, n)) parser.feed(buffer, n);
+     * parser.finish();
+     * @endcode
+     *
+     * @note The metric set is updated as records arrive, but the lookup table is only rebuilt by `finish`.
+     */
+    template<class Metric>
+    class metric_stream_parser
+    {
+    public:
+        /** Define the metric type */
+        typedef Metric metric_t;
+        /** Define the metric set type */
+        typedef model::metric_base::metric_set<Metric> metric_set_t;
+        /** Define the abstract format type */
+        typedef abstract_metric_format<Metric> format_t;
+        enum
+        {
+            /** Default size of the ring buffer in bytes */
+            DEFAULT_BUFFER_SIZE = 65536
+        };
+
+    public:
+        /** Constructor
+         *
+         * @param metrics destination metric set
+         * @param buffer_size size of the ring buffer, must hold the header and at least one record
+         * @param filter optional filter that selects the tiles to read (null reads all tiles)
+         */
+        metric_stream_parser(metric_set_t& metrics,
+                             const size_t buffer_size=DEFAULT_BUFFER_SIZE,
+                             const model::metric_base::tile_filter* filter=0) :
+                m_metrics(metrics),
+                m_filter(filter),
+                m_ring(std::max(buffer_size, static_cast<size_t>(1))),
+                m_head(0),
+                m_size(0),
+                m_format(0),
+                m_record_size(0),
+                m_record_count(0),
+                m_header_complete(false),
+                m_skip(false)
+        {
+        }
+
+    public:
+        /** Push the next chunk of bytes into the parser
+         *
+         * Every record completed by the chunk is read into the metric set. The bytes of an incomplete header or
+         * record are kept until the chunk that completes them arrives.
+         *
+         * @param data pointer to the first byte of the chunk
+         * @param n number of bytes in the chunk
+         * @return number of records completed by this chunk
+         * @throws bad_format_exception if the format is unknown, or the header or a record does not fit the buffer
+         */
+        size_t feed(const char* data, size_t n) INTEROP_THROW_SPEC((bad_format_exception))
+        {
+            const size_t previous_count = m_record_count;
+            while(n > 0)
+            {
+                const size_t count = std::min(n, m_ring.size() - m_size);
+                push(data, count);
+                data += count;
+                n -= count;
+                if(!m_header_complete && !parse_header())
+                {
+                    if(m_size == m_ring.size())
+                        INTEROP_THROW(bad_format_exception, "Header of " << paths::interop_basename<metric_set_t>()
+                                << " does not fit in the stream buffer of " << m_ring.size() << " bytes");
+                    continue;
+                }
+                parse_records();
+            }
+            return m_record_count - previous_count;
+        }
+        /** Signal the end of the stream
+         *
+         * This trims unused records and rebuilds the lookup table of the metric set.
+         *
+         * @throws incomplete_file_exception if the stream ended inside the header or a record
+         */
+        void finish() INTEROP_THROW_SPEC((incomplete_file_exception))
+        {
+            if(!m_header_complete)
+            {
+                if(m_size == 0) INTEROP_THROW(incomplete_file_exception, "Empty file found");
+                INTEROP_THROW(incomplete_file_exception, "Insufficient header data read from the stream for "
+                        << paths::interop_basename<metric_set_t>());
+            }
+            if(m_skip) return;
+            m_metrics.trim(m_metrics.offset_map().size());
+            m_metrics.rebuild_index();
+            if(m_size > 0)
+                INTEROP_THROW(incomplete_file_exception, "Insufficient data read from the stream, got: " << m_size
+                        << " != expected: " << m_record_size << " for " << paths::interop_basename<metric_set_t>());
+        }
+        /** Test if the header has been parsed
+         *
+         * @return true if the header has been parsed
+         */
+        bool header_complete()const
+        {
+            return m_header_complete;
+        }
+        /** Get the number of records read so far
+         *
+         * @return number of records
+         */
+        size_t record_count()const
+        {
+            return m_record_count;
+        }
+        /** Get the size of a record given by the header
+         *
+         * @return record size or 0 if the header has not been parsed
+         */
+        size_t record_size()const
+        {
+            return m_record_size;
+        }
+        /** Get the number of bytes waiting for the rest of the header or record
+         *
+         * @return number of buffered bytes
+         */
+        size_t buffered()const
+        {
+            return m_size;
+        }
+        /** Get the size of the ring buffer
+         *
+         * @return capacity in bytes
+         */
+        size_t capacity()const
+        {
+            return m_ring.size();
+        }
+
+    private:
+        void push(const char* data, const size_t n)
+        {
+            INTEROP_ASSERT(m_size + n <= m_ring.size());
+            const size_t tail = (m_head + m_size) % m_ring.size();
+            const size_t first = std::min(n, m_ring.size() - tail);
+            std::memcpy(&m_ring[tail], data, first);
+            if(first < n) std::memcpy(&m_ring[0], data+first, n-first);
+            m_size += n;
+        }
+        void pop(const size_t n)
+        {
+            INTEROP_ASSERT(n <= m_size);
+            m_head = (m_head + n) % m_ring.size();
+            m_size -= n;
+        }
+        bool parse_header()
+        {
+            typedef typename metric_format_factory<Metric>::metric_format_map metric_format_map;
+            // Nothing is consumed before the header is complete, so the header bytes are never wrapped
+            INTEROP_ASSERT(m_head == 0);
+            metric_format_map &format_map = metric_format_factory<Metric>::metric_formats();
+            const int version = static_cast< ::uint8_t >(m_ring[0]);
+            if (format_map.find(version) == format_map.end())
+                INTEROP_THROW(bad_format_exception, "No format found to parse "
+                        << paths::interop_basename<metric_set_t>() << " with version: " << version << " of "
+                        << format_map.size());
+            m_format = format_map[version].get();
+            INTEROP_ASSERT(m_format != 0);
+            if(static_cast<constants::metric_group>(Metric::TYPE) == constants::Index)
+                INTEROP_THROW(bad_format_exception, "Index metrics have variable length records and cannot be"
+                        << " framed by the record size");
+            if(m_format->is_deprecated())
+            {
+                // Match read_metrics, which silently skips unsupported versions
+                m_skip = true;
+                m_header_complete = true;
+                return true;
+            }
+            detail::membuf sbuf(&m_ring[0], &m_ring[0] + m_size);
+            std::istream in(&sbuf);
+            try
+            {
+                read_header(in, m_metrics);
+            }
+            catch(const incomplete_file_exception&)
+            {
+                return false;
+            }
+            const size_t header_size = m_format->header_size(m_metrics);
+            if(header_size > m_size) return false;
+            m_record_size = m_format->record_size(m_metrics);
+            if(m_record_size == 0) INTEROP_THROW(bad_format_exception, "Record size cannot be 0");
+            if(m_record_size > m_ring.size())
+                INTEROP_THROW(bad_format_exception, "Record of " << m_record_size << " bytes does not fit in the"
+                        << " stream buffer of " << m_ring.size() << " bytes for "
+                        << paths::interop_basename<metric_set_t>());
+            m_record.resize(m_record_size);
+            m_metric = metric_t(m_metrics);
+            m_header_complete = true;
+            pop(header_size);
+            return true;
+        }
+        void parse_records()
+        {
+            if(m_skip)
+            {
+                pop(m_size);
+                return;
+            }
+            while(m_size >= m_record_size)
+            {
+                const char* record = &m_ring[m_head];
+                if(m_head + m_record_size > m_ring.size())
+                {
+                    // Records that wrap around the end of the ring are copied to be contiguous
+                    const size_t first = m_ring.size() - m_head;
+                    std::memcpy(&m_record[0], &m_ring[m_head], first);
+                    std::memcpy(&m_record[first], &m_ring[0], m_record_size - first);
+                    record = &m_record[0];
+                }
+                m_format->read_record(record, m_metrics, m_metric, m_filter);
+                pop(m_record_size);
+                ++m_record_count;
+            }
+        }
+
+    private:
+        metric_stream_parser(const metric_stream_parser&);
+        metric_stream_parser& operator=(const metric_stream_parser&);
+
+    private:
+        metric_set_t& m_metrics;
+        const model::metric_base::tile_filter* m_filter;
+        std::vector<char> m_ring;
+        std::vector<char> m_record;
+        size_t m_head;
+        size_t m_size;
+        format_t* m_format;
+        metric_t m_metric;
+        size_t m_record_size;
+        size_t m_record_count;
+        bool m_header_complete;
+        bool m_skip;
+    };
+
+    /** Read a binary InterOp file from a stream that cannot seek or report its size
+     *
+     * The stream is read in chunks of the ring buffer size, so memory use does not depend on the file size.
+     *
+     * @param in input stream, e.g. standard input or a pipe
+     * @param metrics destination metric set
+     * @param buffer_size size of the ring buffer
+     * @param filter optional filter that selects the tiles to read (null reads all tiles)
+     * @return number of records read
+     */
+    template<class MetricSet>
+    size_t read_metrics_streaming(std::istream& in,
+                                  MetricSet& metrics,
+                                  const size_t buffer_size=metric_stream_parser<typename MetricSet::metric_type>::DEFAULT_BUFFER_SIZE,
+                                  const model::metric_base::tile_filter* filter=0)
+    INTEROP_THROW_SPEC((bad_format_exception, incomplete_file_exception))
+    {
+        typedef typename MetricSet::metric_type metric_t;
+        metric_stream_parser<metric_t> parser(metrics, buffer_size, filter);
+        std::vector<char> chunk(parser.capacity());
+        while(in)
+        {
+            in.read(&chunk[0], static_cast<std::streamsize>(chunk.size()));
+            const std::streamsize count = in.gcount();
+            if(count <= 0) break;
+            parser.feed(&chunk[0], static_cast<size_t>(count));
+        }
+        parser.finish();
+        return parser.record_count();
+    }
+
+}}}
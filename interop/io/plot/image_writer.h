@@ -0,0 +1,144 @@
+/** Render plot data directly to PNG or SVG images
+ *
+ * This is a built-in alternative to the GNUPlot scripts written by gnuplot_writer. Each plot is first laid out
+ * as a list of rectangles, lines and labels, which is then either written as SVG or rasterized into an RGB image
+ * and encoded as PNG. The raster is split into horizontal bands that are drawn in parallel when built with OpenMP.
+ *
+ * @note PNG images carry no text, so titles, tick labels and legends are only written to SVG images.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include "interop/model/plot/flowcell_data.h"
+#include "interop/model/plot/heatmap_data.h"
+#include "interop/model/plot/bar_point.h"
+#include "interop/model/plot/candle_stick_point.h"
+#include "interop/model/plot/plot_data.h"
+#include "interop/io/plot/png_encoder.h"
+
+namespace illumina { namespace interop { namespace io { namespace plot
+{
+
+    /** Write a plot as a PNG or SVG image
+     */
+    class image_writer
+    {
+    public:
+        /** Image file formats */
+        enum image_format
+        {
+            /** Portable network graphics */
+            PNG,
+            /** Scalable vector graphics */
+            SVG
+        };
+
+    public:
+        /** Constructor
+         *
+         * @param format image file format
+         * @param width width of the image in pixels
+         * @param height height of the image in pixels
+         * @param thread_count number of threads used to rasterize the image
+         */
+        image_writer(const image_format format=PNG,
+                     const size_t width=800,
+                     const size_t height=600,
+                     const size_t thread_count=1) :
+                m_format(format),
+                m_width(width),
+                m_height(height),
+                m_thread_count(thread_count)
+        { }
+
+    public:
+        /** Write the flowcell heat map of a specific metric to the output stream
+         *
+         * @param out output stream opened in binary mode
+         * @param data flowcell heatmap data
+         */
+        void write_flowcell(std::ostream &out, const model::plot::flowcell_data &data) const;
+        /** Write a heat map to the output stream
+         *
+         * @param out output stream opened in binary mode
+         * @param data heat map data
+         */
+        void write_heatmap(std::ostream &out, const model::plot::heatmap_data &data) const;
+        /** Write a candlestick or line chart to the output stream
+         *
+         * @param out output stream opened in binary mode
+         * @param data plot data for a line or candlestick plot
+         */
+        void write_chart(std::ostream &out,
+                         const model::plot::plot_data<model::plot::candle_stick_point> &data) const;
+        /** Write a bar chart to the output stream
+         *
+         * @param out output stream opened in binary mode
+         * @param data plot data for a bar plot
+         */
+        void write_chart(std::ostream &out, const model::plot::plot_data<model::plot::bar_point> &data) const;
+
+    public:
+        /** Rasterize the flowcell heat map of a specific metric
+         *
+         * @param data flowcell heatmap data
+         * @param image destination image, resized to the size of the writer
+         */
+        void render_flowcell(const model::plot::flowcell_data &data, raster_image& image) const;
+        /** Rasterize a heat map
+         *
+         * @param data heat map data
+         * @param image destination image, resized to the size of the writer
+         */
+        void render_heatmap(const model::plot::heatmap_data &data, raster_image& image) const;
+        /** Rasterize a candlestick or line chart
+         *
+         * @param data plot data for a line or candlestick plot
+         * @param image destination image, resized to the size of the writer
+         */
+        void render_chart(const model::plot::plot_data<model::plot::candle_stick_point> &data,
+                          raster_image& image) const;
+        /** Rasterize a bar chart
+         *
+         * @param data plot data for a bar plot
+         * @param image destination image, resized to the size of the writer
+         */
+        void render_chart(const model::plot::plot_data<model::plot::bar_point> &data, raster_image& image) const;
+
+    public:
+        /** Get the file extension of the image format
+         *
+         * @return file extension, including the leading dot
+         */
+        const char* extension() const
+        {
+            return m_format == SVG ? ".svg" : ".png";
+        }
+        /** Parse the name of an image format
+         *
+         * @param name format name, `png` or `svg`
+         * @param format destination format
+         * @return true if the name is a known format
+         */
+        static bool parse_format(const std::string& name, image_format& format)
+        {
+            if (name == "png" || name == "PNG") format = PNG;
+            else if (name == "svg" || name == "SVG") format = SVG;
+            else return false;
+            return true;
+        }
+
+    private:
+        image_format m_format;
+        size_t m_width;
+        size_t m_height;
+        size_t m_thread_count;
+    };
+
+}}}}
@@ -0,0 +1,150 @@
+/** Minimal PNG encoder for rendered plots
+ *
+ * The encoder writes 8-bit RGB images as a single IDAT chunk, compressed with a small deflate encoder that uses
+ * the fixed Huffman codes and a hash-chain LZ77 matcher. Plots are made of large flat regions, so this compresses
+ * them well without an external zlib dependency.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <iosfwd>
+#include <vector>
+#include "interop/util/cstdint.h"
+
+namespace illumina { namespace interop { namespace io { namespace plot
+{
+    /** 24-bit RGB color
+     */
+    struct rgb_color
+    {
+        /** Constructor
+         *
+         * @param red red component
+         * @param green green component
+         * @param blue blue component
+         */
+        rgb_color(const ::uint8_t red=0, const ::uint8_t green=0, const ::uint8_t blue=0) :
+                r(red), g(green), b(blue)
+        { }
+        /** Red component */
+        ::uint8_t r;
+        /** Green component */
+        ::uint8_t g;
+        /** Blue component */
+        ::uint8_t b;
+    };
+
+    /** In-memory 24-bit RGB image
+     *
+     * Pixels are stored row by row, from the top left corner, three bytes per pixel.
+     */
+    class raster_image
+    {
+    public:
+        /** Constructor
+         *
+         * @param width width in pixels
+         * @param height height in pixels
+         * @param background initial color of every pixel
+         */
+        raster_image(const size_t width=0, const size_t height=0, const rgb_color& background=rgb_color(255, 255, 255))
+        {
+            resize(width, height, background);
+        }
+
+    public:
+        /** Resize the image and fill every pixel with the background
+         *
+         * @param width width in pixels
+         * @param height height in pixels
+         * @param background color of every pixel
+         */
+        void resize(const size_t width, const size_t height, const rgb_color& background=rgb_color(255, 255, 255))
+        {
+            m_width = width;
+            m_height = height;
+            m_pixels.resize(width * height * 3);
+            for (size_t i = 0; i < m_pixels.size(); i += 3)
+            {
+                m_pixels[i] = background.r;
+                m_pixels[i + 1] = background.g;
+                m_pixels[i + 2] = background.b;
+            }
+        }
+        /** Set the color of a single pixel
+         *
+         * @note Pixels outside the image are ignored
+         * @param x column
+         * @param y row
+         * @param color pixel color
+         */
+        void set(const size_t x, const size_t y, const rgb_color& color)
+        {
+            if (x >= m_width || y >= m_height) return;
+            ::uint8_t* pixel = &m_pixels[(y * m_width + x) * 3];
+            pixel[0] = color.r;
+            pixel[1] = color.g;
+            pixel[2] = color.b;
+        }
+        /** Get the color of a single pixel
+         *
+         * @param x column
+         * @param y row
+         * @return pixel color
+         */
+        rgb_color at(const size_t x, const size_t y) const
+        {
+            const ::uint8_t* pixel = &m_pixels[(y * m_width + x) * 3];
+            return rgb_color(pixel[0], pixel[1], pixel[2]);
+        }
+        /** Get a pointer to the first pixel of a row
+         *
+         * @param y row
+         * @return pointer to the RGB bytes of the row
+         */
+        const ::uint8_t* row(const size_t y) const
+        {
+            return &m_pixels[y * m_width * 3];
+        }
+        /** Get the width of the image
+         *
+         * @return width in pixels
+         */
+        size_t width() const
+        {
+            return m_width;
+        }
+        /** Get the height of the image
+         *
+         * @return height in pixels
+         */
+        size_t height() const
+        {
+            return m_height;
+        }
+
+    private:
+        size_t m_width;
+        size_t m_height;
+        std::vector< ::uint8_t > m_pixels;
+    };
+
+    /** Compress a buffer into a zlib stream
+     *
+     * @param data bytes to compress
+     * @param size number of bytes to compress
+     * @param compressed destination zlib stream (header, deflate data and Adler-32 checksum)
+     */
+    void zlib_compress(const ::uint8_t* data, const size_t size, std::vector< ::uint8_t >& compressed);
+    /** Write an image as a PNG file to the output stream
+     *
+     * @param out output stream opened in binary mode
+     * @param image source image
+     */
+    void write_png(std::ostream& out, const raster_image& image);
+
+}}}}
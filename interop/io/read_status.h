@@ -0,0 +1,141 @@
+/** Status of reading a binary InterOp file that may still be written
+ *
+ * During a live run, many InterOp files are read while the instrument is still appending records. The status
+ * returning read functions stop at the last complete record and report how far they got, rather than throwing an
+ * incomplete_file_exception.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Outcome of reading a binary InterOp file
+     *
+     * The byte offset is the size of the valid prefix of the file: the header and every complete record that was
+     * read. A reader polling a file that is still written can compare the offset to the file size to decide whether
+     * to read the file again.
+     */
+    class read_status
+    {
+    public:
+        /** Result of the read */
+        enum status_code
+        {
+            /** The whole file was read */
+            Complete,
+            /** The file does not exist */
+            FileNotFound,
+            /** The file holds no data */
+            EmptyFile,
+            /** The file ends within the header, no records were read */
+            IncompleteHeader,
+            /** The file ends within a record, every complete record before it was read */
+            IncompleteRecord
+        };
+
+    public:
+        /** Constructor
+         *
+         * @param code result of the read
+         * @param byte_offset number of bytes in the valid prefix of the file
+         * @param partial_byte_count number of bytes of the incomplete record that follows the valid prefix
+         * @param record_size expected size of a record in bytes
+         */
+        read_status(const status_code code=Complete,
+                    const size_t byte_offset=0,
+                    const size_t partial_byte_count=0,
+                    const size_t record_size=0) :
+                m_code(code),
+                m_byte_offset(byte_offset),
+                m_partial_byte_count(partial_byte_count),
+                m_record_size(record_size)
+        { }
+
+    public:
+        /** Get the result of the read
+         *
+         * @return result of the read
+         */
+        status_code code()const
+        {
+            return m_code;
+        }
+        /** Test if the whole file was read
+         *
+         * @return true if the whole file was read
+         */
+        bool is_complete()const
+        {
+            return m_code == Complete;
+        }
+        /** Test if the file ends within the header or a record
+         *
+         * @return true if the file was only partially written
+         */
+        bool is_incomplete()const
+        {
+            return m_code == EmptyFile || m_code == IncompleteHeader || m_code == IncompleteRecord;
+        }
+        /** Get the number of bytes in the valid prefix of the file
+         *
+         * @return number of bytes in the header and every complete record
+         */
+        size_t byte_offset()const
+        {
+            return m_byte_offset;
+        }
+        /** Get the number of bytes of the incomplete record that follows the valid prefix
+         *
+         * @return number of bytes read from the incomplete record
+         */
+        size_t partial_byte_count()const
+        {
+            return m_partial_byte_count;
+        }
+        /** Get the expected size of a record
+         *
+         * @return size of a record in bytes
+         */
+        size_t record_size()const
+        {
+            return m_record_size;
+        }
+
+    private:
+        status_code m_code;
+        size_t m_byte_offset;
+        size_t m_partial_byte_count;
+        size_t m_record_size;
+    };
+
+    /** Describe a partially written file, as the message of an incomplete_file_exception
+     *
+     * @param status status of the read
+     * @param version version of the format
+     * @return message describing the incomplete file
+     */
+    template<class Metric>
+    std::string incomplete_file_message(const read_status& status, const int version)
+    {
+        std::ostringstream message;
+        if(status.code() == read_status::EmptyFile)
+            message << "Empty file found";
+        else if(status.code() == read_status::IncompleteHeader)
+            message << "Insufficient header data read from the file for "
+                    << Metric::prefix() <<  " "  << Metric::suffix()  <<  " v"  << version;
+        else
+            message << "Insufficient data read from the file, got: " << status.partial_byte_count()
+                    << " != expected: " << status.record_size() << " for "
+                    << Metric::prefix() <<  " "  << Metric::suffix()  <<  " v"  << version;
+        return message.str();
+    }
+}}}
+
@@ -0,0 +1,402 @@
+/** Lightweight views over the raw records of a binary InterOp file
+ *
+ * A record view points into the raw bytes of a single record and decodes fields only when they are
+ * requested. The state shared by all records in a file (format, header and record size) is held once by
+ * the record buffer, which also iterates over all the records in a file buffer.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstring>
+#include <iterator>
+#include <istream>
+#include "interop/util/exception.h"
+#include "interop/util/assert.h"
+#include "interop/io/format/metric_format_factory.h"
+#include "interop/io/format/stream_membuf.h"
+#include "interop/io/metric_stream.h"
+#include "interop/io/stream_exceptions.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    template<class Metric>
+    class record_buffer;
+
+    /** View of a single record in a binary InterOp buffer
+     *
+     * The view does not copy or decode the record. The identifier and individual fields are decoded from the
+     * raw bytes each time they are requested, while `decode` maps the whole record into a metric.
+     *
+     * @note The view is only valid as long as the underlying byte buffer and its record buffer are alive.
+     */
+    template<class Metric>
+    class record_view
+    {
+    public:
+        /** Define the metric type */
+        typedef Metric metric_t;
+        /** Define the metric set type */
+        typedef model::metric_base::metric_set<Metric> metric_set_t;
+        /** Define the ID type */
+        typedef typename Metric::id_t id_t;
+
+    public:
+        /** Constructor
+         *
+         * @param record pointer to the first byte of the record
+         * @param parent record buffer that holds the format and header
+         */
+        record_view(const char* record=0, const record_buffer<Metric>* parent=0) :
+                m_record(record), m_parent(parent)
+        {
+        }
+
+    public:
+        /** Get the unique identifier of the metric
+         *
+         * @return unique identifier or 0 if the record does not hold a valid identifier
+         */
+        id_t id()const
+        {
+            INTEROP_ASSERT(m_parent != 0);
+            return m_parent->format().decode_record_id(m_record);
+        }
+        /** Get the lane number
+         *
+         * @return lane number
+         */
+        id_t lane()const
+        {
+            return Metric::lane_from_id(id());
+        }
+        /** Get the tile number
+         *
+         * @return tile number
+         */
+        id_t tile()const
+        {
+            return Metric::tile_from_id(id());
+        }
+        /** Get the tile hash used to group records by lane and tile
+         *
+         * @return tile hash
+         */
+        id_t tile_hash()const
+        {
+            return Metric::tile_hash_from_id(id());
+        }
+        /** Decode a single raw field from the bytes of the record
+         *
+         * The view does not know the field layout of each metric and version, so the caller gives the byte offset
+         * and the stored type of the field as listed in the documentation of the file format. Like the rest of the
+         * library, the bytes are copied in file order, so the value is only correct on a little-endian host. Use
+         * `decode` to get typed values with the conversions the metric applies, e.g. scaling or padding.
+         *
+         * @param offset byte offset of the field from the start of the record
+         * @return value of the field
+         */
+        template<typename Stored>
+        Stored value(const size_t offset)const
+        {
+            INTEROP_ASSERT(m_parent != 0);
+            INTEROP_ASSERT(offset + sizeof(Stored) <= m_parent->record_size());
+            Stored val;
+            std::memcpy(&val, m_record+offset, sizeof(Stored));
+            return val;
+        }
+        /** Decode a single raw field from the bytes of the record and widen it to the given type
+         *
+         * @param offset byte offset of the field from the start of the record
+         * @return value of the field converted to T
+         */
+        template<typename Stored, typename T>
+        T value(const size_t offset)const
+        {
+            return static_cast<T>(value<Stored>(offset));
+        }
+        /** Decode the whole record into a metric
+         *
+         * Vector members of the destination metric are reused, so decoding every record of a file into the
+         * same metric does not allocate after the first record.
+         *
+         * @param metric destination metric
+         * @return number of bytes decoded
+         */
+        size_t decode(metric_t& metric)const
+        {
+            INTEROP_ASSERT(m_parent != 0);
+            return m_parent->format().decode_record(m_record, metric, m_parent->header());
+        }
+        /** Get a pointer to the raw bytes of the record
+         *
+         * @return pointer to the first byte of the record
+         */
+        const char* data()const
+        {
+            return m_record;
+        }
+
+    private:
+        const char* m_record;
+        const record_buffer<Metric>* m_parent;
+    };
+
+    /** Iterator over the records in a binary InterOp buffer
+     */
+    template<class Metric>
+    class record_iterator
+    {
+    public:
+        /** Define the iterator category */
+        typedef std::forward_iterator_tag iterator_category;
+        /** Define the value type */
+        typedef record_view<Metric> value_type;
+        /** Define the difference type */
+        typedef std::ptrdiff_t difference_type;
+        /** Define the pointer type */
+        typedef const value_type* pointer;
+        /** Define the reference type */
+        typedef const value_type& reference;
+
+    public:
+        /** Constructor
+         *
+         * @param record pointer to the first byte of the current record
+         * @param parent record buffer that holds the format and header
+         */
+        record_iterator(const char* record=0, const record_buffer<Metric>* parent=0) : m_view(record, parent),
+                                                                                      m_parent(parent)
+        {
+        }
+
+    public:
+        /** Get the view of the current record
+         *
+         * @return record view
+         */
+        reference operator*()const
+        {
+            return m_view;
+        }
+        /** Get the view of the current record
+         *
+         * @return pointer to record view
+         */
+        pointer operator->()const
+        {
+            return &m_view;
+        }
+        /** Advance to the next record
+         *
+         * @return this iterator
+         */
+        record_iterator& operator++()
+        {
+            INTEROP_ASSERT(m_parent != 0);
+            m_view = value_type(m_view.data()+m_parent->record_size(), m_parent);
+            return *this;
+        }
+        /** Advance to the next record
+         *
+         * @return copy of the iterator before it was advanced
+         */
+        record_iterator operator++(int)
+        {
+            record_iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+        /** Test if two iterators point to the same record
+         *
+         * @param rhs other iterator
+         * @return true if both point to the same record
+         */
+        bool operator==(const record_iterator& rhs)const
+        {
+            return m_view.data() == rhs.m_view.data();
+        }
+        /** Test if two iterators point to different records
+         *
+         * @param rhs other iterator
+         * @return true if the iterators point to different records
+         */
+        bool operator!=(const record_iterator& rhs)const
+        {
+            return !(*this == rhs);
+        }
+
+    private:
+        value_type m_view;
+        const record_buffer<Metric>* m_parent;
+    };
+
+    /** Collection of record views over a binary InterOp file held in memory
+     *
+     * The buffer parses the file header once and then exposes each record as a view. No record is decoded
+     * until a field is requested.
+     *
+     * Only formats with a fixed size record per metric are supported. Multi-record formats, such as tile
+     * metrics, spread a single metric over several records and must be read with `read_metrics`.
+     *
+     * @note The byte buffer is not copied and must outlive the record buffer and all of its views.
+     */
+    template<class Metric>
+    class record_buffer
+    {
+    public:
+        /** Define the metric type */
+        typedef Metric metric_t;
+        /** Define the metric set type */
+        typedef model::metric_base::metric_set<Metric> metric_set_t;
+        /** Define the abstract format type */
+        typedef abstract_metric_format<Metric> format_t;
+        /** Define the view type */
+        typedef record_view<Metric> view_t;
+        /** Define a constant iterator over the records */
+        typedef record_iterator<Metric> const_iterator;
+
+    public:
+        /** Constructor
+         *
+         * @param buffer pointer to the first byte of the binary InterOp file
+         * @param buffer_size number of bytes in the buffer
+         * @throws bad_format_exception if the format is unknown, deprecated or multi-record
+         * @throws incomplete_file_exception if the buffer is too small to hold the header
+         */
+        record_buffer(const char* buffer, const size_t buffer_size)
+        INTEROP_THROW_SPEC((bad_format_exception, incomplete_file_exception)) :
+                m_buffer(buffer),
+                m_format(0),
+                m_header_size(0),
+                m_record_size(0),
+                m_record_count(0)
+        {
+            typedef typename metric_format_factory<Metric>::metric_format_map metric_format_map;
+            if(buffer_size == 0) INTEROP_THROW(incomplete_file_exception, "Empty file found");
+            metric_format_map &format_map = metric_format_factory<Metric>::metric_formats();
+            const int version = static_cast< ::uint8_t >(buffer[0]);
+            if (format_map.find(version) == format_map.end())
+                INTEROP_THROW(bad_format_exception, "No format found to parse " << paths::interop_basename<Metric>()
+                                                    << " with version: " << version << " of " << format_map.size());
+            m_format = format_map[version].get();
+            INTEROP_ASSERT(m_format != 0);
+            if(m_format->is_deprecated() || m_format->is_multi_record())
+                INTEROP_THROW(bad_format_exception, "Record views do not support version: " << version << " of "
+                                                    << paths::interop_basename<Metric>());
+
+            char* begin = const_cast<char*>(buffer);
+            detail::membuf sbuf(begin, begin + buffer_size);
+            std::istream in(&sbuf);
+            read_header(in, m_header);
+            // The memory buffer does not support tellg, so the header size comes from the layout
+            m_header_size = m_format->header_size(m_header);
+            m_record_size = m_format->record_size(m_header);
+            INTEROP_ASSERT(m_record_size > 0);
+            if(m_header_size > buffer_size)
+                INTEROP_THROW(incomplete_file_exception, "Insufficient header data read from the file");
+            m_record_count = (buffer_size - m_header_size) / m_record_size;
+        }
+
+    public:
+        /** Get an iterator to the first record
+         *
+         * @return iterator to the first record
+         */
+        const_iterator begin()const
+        {
+            return const_iterator(m_buffer+m_header_size, this);
+        }
+        /** Get an iterator one past the last record
+         *
+         * @return iterator one past the last record
+         */
+        const_iterator end()const
+        {
+            return const_iterator(m_buffer+m_header_size+m_record_count*m_record_size, this);
+        }
+        /** Get a view of the record at the given index
+         *
+         * @param n index of the record
+         * @return record view
+         */
+        view_t operator[](const size_t n)const
+        {
+            INTEROP_ASSERT(n < m_record_count);
+            return view_t(m_buffer+m_header_size+n*m_record_size, this);
+        }
+        /** Get the number of complete records in the buffer
+         *
+         * @return number of records
+         */
+        size_t size()const
+        {
+            return m_record_count;
+        }
+        /** Test if the buffer holds no records
+         *
+         * @return true if there are no records
+         */
+        bool empty()const
+        {
+            return m_record_count == 0;
+        }
+        /** Get the size of a single record in bytes
+         *
+         * @return record size
+         */
+        size_t record_size()const
+        {
+            return m_record_size;
+        }
+        /** Get the size of the file header in bytes
+         *
+         * @return header size
+         */
+        size_t header_size()const
+        {
+            return m_header_size;
+        }
+        /** Get the version of the file format
+         *
+         * @return version number
+         */
+        ::int16_t version()const
+        {
+            return m_format->version();
+        }
+        /** Get the header parsed from the file
+         *
+         * @return empty metric set holding only the header
+         */
+        const metric_set_t& header()const
+        {
+            return m_header;
+        }
+        /** Get the format that decodes the records
+         *
+         * @return metric format
+         */
+        const format_t& format()const
+        {
+            return *m_format;
+        }
+
+    private:
+        record_buffer(const record_buffer&);
+        record_buffer& operator=(const record_buffer&);
+
+    private:
+        const char* m_buffer;
+        format_t* m_format;
+        metric_set_t m_header;
+        size_t m_header_size;
+        size_t m_record_size;
+        size_t m_record_count;
+    };
+
+}}}
+
@@ -0,0 +1,73 @@
+/** SQLite virtual tables over loaded run metrics
+ *
+ * Each loaded metric set is exposed as a SQLite virtual table that reads the records in place, so a run may be
+ * queried with SQL without exporting it to text first. Each row is a record, and each channel, base, read or Q-score
+ * bin of a record is a separate column. Equality constraints on the Lane, Tile and Cycle (or Read) columns are
+ * pushed into the table, so a fully specified record is found through the id index of the metric set, and a partially
+ * specified one is filtered before any column is read.
+ *
+ * This module is only built when SQLite 3 is found, and it is linked from the separate interop_sqlite library.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <string>
+#include "interop/util/base_exception.h"
+#include "interop/model/run_metrics.h"
+
+struct sqlite3;
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Exception raised if SQLite refuses to register a module or create a table
+     *
+     * @ingroup interop_exceptions
+     */
+    struct sqlite_exception : public util::base_exception
+    {
+        /** Constructor
+         *
+         *  @param mesg error message
+         */
+        sqlite_exception(const std::string &mesg) : util::base_exception(mesg)
+        { }
+    };
+
+    /** Attach the run metrics to a SQLite database connection
+     *
+     * A virtual table is created in the temp schema for each metric set that holds records, named after the prefix
+     * and the metric group, e.g. `run1_Error` or `run1_Q` with the prefix `run1_`. The tables only hold a reference to
+     * the metric sets, so the run metrics must neither be destroyed nor reloaded while the tables are attached.
+     *
+     * Index metrics are not attached, since their records have no fixed columns.
+     *
+     * @code
+     * sqlite3* db;
+     * sqlite3_open(":memory:", &db);
+     * io::attach_run_metrics(db, run, "run1_");
+     * // SELECT Tile, ErrorRate FROM run1_Error WHERE Lane=1 AND Cycle=25
+     * io::detach_run_metrics(db, run, "run1_");
+     * sqlite3_close(db);
+     * @endcode
+     *
+     * @param db open database connection
+     * @param metrics loaded run metrics
+     * @param prefix prefix of the table names, unique for each attached run
+     * @return number of tables created
+     */
+    size_t attach_run_metrics(sqlite3* db, const model::metrics::run_metrics& metrics, const std::string& prefix="")
+    INTEROP_THROW_SPEC((sqlite_exception));
+    /** Drop the virtual tables created by attach_run_metrics
+     *
+     * @param db open database connection
+     * @param metrics run metrics given to attach_run_metrics
+     * @param prefix prefix given to attach_run_metrics
+     */
+    void detach_run_metrics(sqlite3* db, const model::metrics::run_metrics& metrics, const std::string& prefix="")
+    INTEROP_THROW_SPEC((sqlite_exception));
+
+}}}
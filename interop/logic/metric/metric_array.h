@@ -0,0 +1,128 @@
+/** Logic to copy the values of a metric for a whole metric set into an array
+ *
+ * This generalizes `copy_focus` to every metric type, so a binding can fetch all the values of a metric in a
+ * single call rather than one call per record.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <string>
+#include "interop/util/cstdint.h"
+#include "interop/model/run_metrics.h"
+#include "interop/model/plot/filter_options.h"
+#include "interop/model/model_exceptions.h"
+#include "interop/constants/enums.h"
+
+
+namespace illumina { namespace interop { namespace logic { namespace metric
+{
+    /** Get the number of values copied for each record
+     *
+     * A channel metric has a value for each channel when all channels are selected, a base metric has a value for
+     * each base when all bases are selected and a read metric has a value for each read when all reads are
+     * selected. Otherwise, each record has a single value.
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     * @return number of values for each record
+     */
+    size_t metric_array_fanout(const model::metrics::run_metrics& metrics,
+                               const constants::metric_type type,
+                               const model::plot::filter_options& options);
+    /** Get the size of the array required to copy the values of a metric
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     * @return number of selected records times the number of values for each record
+     */
+    size_t metric_array_size(const model::metrics::run_metrics& metrics,
+                             const constants::metric_type type,
+                             const model::plot::filter_options& options)
+                            INTEROP_THROW_SPEC((model::invalid_metric_type,
+                            model::invalid_filter_option));
+    /** Copy the values of a metric for every selected record into an array
+     *
+     * The array holds one row for each record selected by the filter options, in the order of the metric set. Each
+     * row holds `metric_array_fanout` values, e.g. one value for each channel.
+     *
+     * @code
+     * std::vector<float> values(metric_array_size(metrics, constants::Intensity, options));
+     * copy_metric_values(metrics, constants::Intensity, options, &values[0], values.size());
+     * @endcode
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     * @param buffer destination array
+     * @param buffer_size size of the destination array
+     * @return number of records copied
+     */
+    size_t copy_metric_values(const model::metrics::run_metrics& metrics,
+                              const constants::metric_type type,
+                              const model::plot::filter_options& options,
+                              float* buffer,
+                              size_t buffer_size)
+                            INTEROP_THROW_SPEC((model::invalid_metric_type,
+                            model::invalid_filter_option,
+                            model::invalid_parameter));
+    /** Copy the values of a metric for every selected record into an array
+     *
+     * @param metrics run metrics
+     * @param metric_name name of the metric type
+     * @param options options to filter the data
+     * @param buffer destination array
+     * @param buffer_size size of the destination array
+     * @return number of records copied
+     */
+    size_t copy_metric_values(const model::metrics::run_metrics& metrics,
+                              const std::string& metric_name,
+                              const model::plot::filter_options& options,
+                              float* buffer,
+                              size_t buffer_size)
+                            INTEROP_THROW_SPEC((model::invalid_metric_type,
+                            model::invalid_filter_option,
+                            model::invalid_parameter));
+    /** Copy the lane, tile and cycle of every record selected by `copy_metric_values`
+     *
+     * Each row holds three ids: the lane, the tile number and the cycle. The cycle is 0 for metrics that are not
+     * recorded by cycle.
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     * @param id_buffer destination array, must hold 3 ids for each selected record
+     * @param id_buffer_size size of the destination array
+     * @return number of records copied
+     */
+    size_t copy_metric_ids(const model::metrics::run_metrics& metrics,
+                           const constants::metric_type type,
+                           const model::plot::filter_options& options,
+                           ::uint32_t* id_buffer,
+                           size_t id_buffer_size)
+                            INTEROP_THROW_SPEC((model::invalid_metric_type,
+                            model::invalid_filter_option,
+                            model::invalid_parameter));
+    /** Copy the q-score histogram of every selected q-metric record into an array
+     *
+     * Each row holds the count of every q-score bin for one record. The read filter is applied by mapping the cycle
+     * of each record to its read. Every selected record must have the same number of bins.
+     *
+     * @param metrics run metrics
+     * @param options options to filter the data
+     * @param buffer destination array, must hold a value for each bin of each selected record
+     * @param buffer_size size of the destination array
+     * @return number of records copied
+     */
+    size_t copy_qscore_histograms(const model::metrics::run_metrics& metrics,
+                                  const model::plot::filter_options& options,
+                                  float* buffer,
+                                  size_t buffer_size)
+                                INTEROP_THROW_SPEC((model::invalid_parameter));
+
+}}}}
+
@@ -10,6 +10,8 @@
 #include "interop/model/metrics/q_metric.h"
 #include "interop/model/metrics/q_collapsed_metric.h"
 #include "interop/model/metrics/q_by_lane_metric.h"
+#include "interop/model/metrics/q_by_tile_read_metric.h"
+#include "interop/logic/summary/map_cycle_to_read.h"
 #include "interop/model/model_exceptions.h"
 #include "interop/model/metric_base/metric_set.h"
 
@@ -78,7 +80,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
     /** Count number of unique counts to determine number
      * of unique bins for legacy binning
      *
-     * @note, if the number of bins is greater than 7, than this function stops counting!
+     * @note, if the number of bins is greater than 7, than this function stops counting and returns 8!
      *
      * @param q_metric_set q-metric set
      * @return number of unique bins
@@ -91,6 +93,9 @@ namespace illumina { namespace interop { namespace logic { namespace metric
         if (!q_metric_set.get_bins().empty()) return 0;   // If the metrics already have a header they do not require binning
 
         const size_t max_bin_count = 7;
+        // The decoder tracks the non-zero columns as it reads each record, so a loaded set needs no scan
+        if (q_metric_set.is_tracked(q_metric_set.size()))
+            return std::min(q_metric_set.nonzero_column_count(), max_bin_count+1);
         typename model::metric_base::metric_set<QMetric>::const_iterator beg = q_metric_set.begin(),
                 end = q_metric_set.end();
         if (beg == end) return 0;
@@ -101,7 +106,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
                 if (beg->qscore_hist()[i] > 0) bins_found.insert(i);
             if (bins_found.size() > max_bin_count) break; // Number of bins greater than 7 indicates this is unbinned
         }
-        return bins_found.size();
+        return std::min(bins_found.size(), max_bin_count+1);
     }
     /** Test if legacy binning should be performed
      *
@@ -296,5 +301,17 @@ namespace illumina { namespace interop { namespace logic { namespace metric
                                   model::metric_base::metric_set<model::metrics::q_by_lane_metric>& bylane,
                                   const constants::instrument_type instrument)
                                         INTEROP_THROW_SPEC((model::index_out_of_bounds_exception));
+    /** Generate the q-score histogram for each tile and read from Q-metrics
+     *
+     * The histograms of all cycles in a read are summed for each tile. Cycles that do not map to a read
+     * are skipped.
+     *
+     * @param metric_set Q-metrics
+     * @param cycle_to_read map that takes a cycle and returns the read-number cycle-in-read pair
+     * @param by_tile_read destination q-score histograms by tile and read
+     */
+    void create_q_metrics_by_tile_read(const model::metric_base::metric_set<model::metrics::q_metric>& metric_set,
+                                       const logic::summary::read_cycle_vector_t& cycle_to_read,
+                                       model::metric_base::metric_set<model::metrics::q_by_tile_read_metric>& by_tile_read);
 }}}}
 
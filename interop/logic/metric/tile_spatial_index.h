@@ -0,0 +1,309 @@
+/** Spatial index over the physical location of tiles
+ *
+ * The index is built once for a run, and answers nearest neighbor, radius and rectangular window queries for the
+ * tiles of a lane without scanning every tile.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <vector>
+#include <set>
+#include "interop/util/cstdint.h"
+#include "interop/model/run/flowcell_layout.h"
+#include "interop/model/metric_base/metric_set.h"
+#include "interop/model/metrics/extended_tile_metric.h"
+#include "interop/logic/metric/tile_metric.h"
+
+
+namespace illumina { namespace interop { namespace logic { namespace metric
+{
+    /** Physical location of a single tile
+     */
+    class tile_location
+    {
+    public:
+        /** Constructor
+         *
+         * @param lane lane number
+         * @param tile tile id
+         * @param x horizontal coordinate of the tile
+         * @param y vertical coordinate of the tile
+         */
+        tile_location(const ::uint32_t lane=0, const ::uint32_t tile=0, const float x=0, const float y=0) :
+                m_lane(lane), m_tile(tile), m_x(x), m_y(y){}
+
+    public:
+        /** Get the lane number
+         *
+         * @return lane number
+         */
+        ::uint32_t lane()const
+        {
+            return m_lane;
+        }
+        /** Get the tile id
+         *
+         * @return tile id
+         */
+        ::uint32_t tile()const
+        {
+            return m_tile;
+        }
+        /** Get the horizontal coordinate of the tile
+         *
+         * @return horizontal coordinate
+         */
+        float x()const
+        {
+            return m_x;
+        }
+        /** Get the vertical coordinate of the tile
+         *
+         * @return vertical coordinate
+         */
+        float y()const
+        {
+            return m_y;
+        }
+
+    private:
+        ::uint32_t m_lane;
+        ::uint32_t m_tile;
+        float m_x;
+        float m_y;
+    };
+
+    /** Uniform grid over the locations of the tiles in each lane
+     *
+     * Each lane is divided into square cells holding about one tile each. A query only visits the cells that
+     * overlap the query region, so its cost depends on the number of tiles found rather than on the number of tiles
+     * in the lane.
+     *
+     * Tiles can be located either by their column and row in the flowcell map, see `list_tile_locations` for a
+     * flowcell layout, or by the fiducial coordinates recorded in the extended tile metrics.
+     */
+    class tile_spatial_index
+    {
+    public:
+        /** Collection of tile locations */
+        typedef std::vector<tile_location> location_vector_t;
+        /** Collection of tile ids */
+        typedef std::vector< ::uint32_t > id_vector_t;
+
+    private:
+        /** Grid of cells over the tiles of a single lane
+         *
+         * The tiles in each cell are stored contiguously, and `cell_start` holds the offset of the first tile in each
+         * cell, with one extra entry marking the end.
+         */
+        struct lane_grid
+        {
+            /** Constructor */
+            lane_grid() : xmin(0), ymin(0), cell_size(1), column_count(0), row_count(0){}
+            /** Get the column of the cell holding a horizontal coordinate
+             *
+             * @param x horizontal coordinate
+             * @return column of the cell, clamped to the grid
+             */
+            size_t column(const float x)const
+            {
+                return clamp((x - xmin) / cell_size, column_count);
+            }
+            /** Get the row of the cell holding a vertical coordinate
+             *
+             * @param y vertical coordinate
+             * @return row of the cell, clamped to the grid
+             */
+            size_t row(const float y)const
+            {
+                return clamp((y - ymin) / cell_size, row_count);
+            }
+            /** Clamp a cell coordinate to the grid
+             *
+             * @param value cell coordinate
+             * @param count number of cells
+             * @return clamped cell coordinate
+             */
+            static size_t clamp(const float value, const size_t count)
+            {
+                if(!(value > 0)) return 0;
+                if(value >= static_cast<float>(count)) return count-1;
+                return static_cast<size_t>(value);
+            }
+            /** Minimum horizontal coordinate */
+            float xmin;
+            /** Minimum vertical coordinate */
+            float ymin;
+            /** Width and height of a cell */
+            float cell_size;
+            /** Number of cell columns */
+            size_t column_count;
+            /** Number of cell rows */
+            size_t row_count;
+            /** Offset of the first tile in each cell */
+            std::vector<size_t> cell_start;
+            /** Index of the tile location for each tile, grouped by cell */
+            std::vector<size_t> entries;
+        };
+        typedef std::vector<lane_grid> grid_vector_t;
+        typedef std::pair< ::uint64_t, size_t> key_index_t;
+        typedef std::vector<key_index_t> key_index_vector_t;
+
+    public:
+        /** Constructor
+         */
+        tile_spatial_index();
+        /** Constructor
+         *
+         * @param locations collection of tile locations
+         */
+        tile_spatial_index(const location_vector_t& locations);
+
+    public:
+        /** Build the index over a collection of tile locations
+         *
+         * Tiles with a NaN coordinate are not indexed.
+         *
+         * @param locations collection of tile locations
+         */
+        void build(const location_vector_t& locations);
+        /** Remove all tiles from the index
+         */
+        void clear();
+
+    public:
+        /** Find the tile nearest to a point in a lane
+         *
+         * @param lane lane number
+         * @param x horizontal coordinate of the point
+         * @param y vertical coordinate of the point
+         * @param tile destination for the nearest tile id
+         * @return false if the lane has no tiles
+         */
+        bool nearest(const ::uint32_t lane, const float x, const float y, ::uint32_t& tile)const;
+        /** Find all tiles in a lane within a distance of a point
+         *
+         * @param lane lane number
+         * @param x horizontal coordinate of the point
+         * @param y vertical coordinate of the point
+         * @param radius maximum distance from the point
+         * @param tiles destination for the tile ids
+         */
+        void within_radius(const ::uint32_t lane,
+                           const float x,
+                           const float y,
+                           const float radius,
+                           id_vector_t& tiles)const;
+        /** Find all tiles in a lane within a rectangular window
+         *
+         * @param lane lane number
+         * @param xmin minimum horizontal coordinate of the window
+         * @param ymin minimum vertical coordinate of the window
+         * @param xmax maximum horizontal coordinate of the window
+         * @param ymax maximum vertical coordinate of the window
+         * @param tiles destination for the tile ids
+         */
+        void within_window(const ::uint32_t lane,
+                           const float xmin,
+                           const float ymin,
+                           const float xmax,
+                           const float ymax,
+                           id_vector_t& tiles)const;
+        /** Find the tiles in the same lane within a distance of a tile, not including the tile itself
+         *
+         * @param lane lane number
+         * @param tile tile id
+         * @param radius maximum distance from the tile
+         * @param tiles destination for the tile ids
+         * @return false if the tile is not indexed
+         */
+        bool neighbors(const ::uint32_t lane, const ::uint32_t tile, const float radius, id_vector_t& tiles)const;
+        /** Find the location of a tile
+         *
+         * @param lane lane number
+         * @param tile tile id
+         * @return location of the tile or null if the tile is not indexed
+         */
+        const tile_location* find(const ::uint32_t lane, const ::uint32_t tile)const;
+        /** Get the number of indexed tiles
+         *
+         * @return number of tiles
+         */
+        size_t size()const
+        {
+            return m_locations.size();
+        }
+        /** Test if the index is empty
+         *
+         * @return true if no tile is indexed
+         */
+        bool empty()const
+        {
+            return m_locations.empty();
+        }
+
+    private:
+        const lane_grid* grid(const ::uint32_t lane)const;
+        void collect(const lane_grid& grid,
+                     const float xmin,
+                     const float ymin,
+                     const float xmax,
+                     const float ymax,
+                     const float x,
+                     const float y,
+                     const float radius2,
+                     id_vector_t& tiles)const;
+
+    private:
+        location_vector_t m_locations;
+        grid_vector_t m_grids;
+        key_index_vector_t m_keys;
+    };
+
+    /** List the location of every tile in the layout by its column and row in the flowcell map
+     *
+     * The column includes the surface, so tiles on both surfaces have distinct locations.
+     *
+     * @param layout flowcell layout with a list of tile names
+     * @param locations destination collection of tile locations
+     */
+    void list_tile_locations(const model::run::flowcell_layout& layout,
+                             tile_spatial_index::location_vector_t& locations);
+    /** List the location of every tile in the extended tile metrics by its upper left fiducial
+     *
+     * @param metrics extended tile metric set
+     * @param locations destination collection of tile locations
+     */
+    void list_tile_locations(const model::metric_base::metric_set<model::metrics::extended_tile_metric>& metrics,
+                             tile_spatial_index::location_vector_t& locations);
+    /** List the location of every tile in a metric set by its column and row in the flowcell map
+     *
+     * @param metrics metric set
+     * @param layout flowcell layout
+     * @param locations destination collection of tile locations
+     */
+    template<class Metric>
+    void list_tile_locations(const model::metric_base::metric_set<Metric>& metrics,
+                             const model::run::flowcell_layout& layout,
+                             tile_spatial_index::location_vector_t& locations)
+    {
+        typedef typename model::metric_base::metric_set<Metric>::const_iterator const_iterator;
+        std::set< ::uint64_t > seen;
+        locations.clear();
+        for(const_iterator it = metrics.begin();it != metrics.end();++it)
+        {
+            const ::uint64_t key = model::metric_base::base_metric::create_id(it->lane(), it->tile());
+            if(!seen.insert(key).second) continue;
+            locations.push_back(tile_location(
+                    it->lane(),
+                    it->tile(),
+                    static_cast<float>(physical_location_column(it->tile(), layout, true)),
+                    static_cast<float>(physical_location_row(it->tile(), layout))));
+        }
+    }
+
+}}}}
+
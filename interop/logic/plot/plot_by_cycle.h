@@ -12,6 +12,7 @@
 #include "interop/model/plot/candle_stick_point.h"
 #include "interop/constants/enums.h"
 #include "interop/logic/utils/metrics_to_load.h"
+#include "interop/logic/utils/workspace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace plot
 {
@@ -24,7 +25,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param data output plot data
      * @param skip_empty set false for testing purposes
      */
-    void plot_by_cycle(model::metrics::run_metrics& metrics,
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
                        const constants::metric_type type,
                        const model::plot::filter_options& options,
                        model::plot::plot_data<model::plot::candle_stick_point>& data,
@@ -34,6 +35,27 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                     model::invalid_channel_exception,
                     model::invalid_filter_option,
                     model::invalid_read_exception));
+    /** Plot a specified metric value by cycle reusing the scratch buffers in a workspace
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data
+     * @param workspace scratch buffers reused across calls
+     * @param skip_empty set false for testing purposes
+     */
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
+                       const constants::metric_type type,
+                       const model::plot::filter_options& options,
+                       model::plot::plot_data<model::plot::candle_stick_point>& data,
+                       logic::utils::workspace& workspace,
+                       const bool skip_empty=true)
+                    INTEROP_THROW_SPEC((model::index_out_of_bounds_exception,
+                    model::invalid_metric_type,
+                    model::invalid_channel_exception,
+                    model::invalid_filter_option,
+                    model::invalid_read_exception));
 
     /** Plot a specified metric value by cycle using the candle stick model
      *
@@ -45,10 +67,30 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param data output plot data
      * @param skip_empty set false for testing purposes
      */
-    void plot_by_cycle(model::metrics::run_metrics& metrics,
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
+                       const std::string& metric_name,
+                       const model::plot::filter_options& options,
+                       model::plot::plot_data<model::plot::candle_stick_point>& data,
+                       const bool skip_empty=true)
+            INTEROP_THROW_SPEC((model::index_out_of_bounds_exception,
+            model::invalid_filter_option,
+            model::invalid_channel_exception,
+            model::invalid_metric_type));
+    /** Plot a specified metric value by cycle using the candle stick model reusing the scratch buffers in a workspace
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param metric_name name of metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data
+     * @param workspace scratch buffers reused across calls
+     * @param skip_empty set false for testing purposes
+     */
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
                        const std::string& metric_name,
                        const model::plot::filter_options& options,
                        model::plot::plot_data<model::plot::candle_stick_point>& data,
+                       logic::utils::workspace& workspace,
                        const bool skip_empty=true)
             INTEROP_THROW_SPEC((model::index_out_of_bounds_exception,
             model::invalid_filter_option,
@@ -12,6 +12,7 @@
 #include "interop/model/plot/filter_options.h"
 #include "interop/model/plot/flowcell_data.h"
 #include "interop/logic/utils/metrics_to_load.h"
+#include "interop/logic/utils/workspace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace plot
 {
@@ -28,7 +29,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param tile_buffer preallocated memory for tile ids
      * @param skip_empty set false for testing purposes
      */
-    void plot_flowcell_map(model::metrics::run_metrics& metrics,
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
                                   const constants::metric_type type,
                                   const model::plot::filter_options& options,
                                   model::plot::flowcell_data& data,
@@ -38,6 +39,29 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                                   INTEROP_THROW_SPEC((model::invalid_filter_option,
                                   model::invalid_metric_type,
                                   model::index_out_of_bounds_exception));
+    /** Plot a flowcell map reusing the scratch buffers in a workspace
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output flowcell map
+     * @param workspace scratch buffers reused across calls
+     * @param buffer preallocated memory for data
+     * @param tile_buffer preallocated memory for tile ids
+     * @param skip_empty set false for testing purposes
+     */
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
+                           const constants::metric_type type,
+                           const model::plot::filter_options& options,
+                           model::plot::flowcell_data& data,
+                           logic::utils::workspace& workspace,
+                           float* buffer=0,
+                           ::uint32_t* tile_buffer=0,
+                           const bool skip_empty=true)
+                           INTEROP_THROW_SPEC((model::invalid_filter_option,
+                           model::invalid_metric_type,
+                           model::index_out_of_bounds_exception));
     /** Plot a flowcell map
      *
      * @ingroup plot_logic
@@ -51,7 +75,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param id_buffer_size size of the buffer
      * @param skip_empty set false for testing purposes
      */
-    inline void plot_flowcell_map2(model::metrics::run_metrics& metrics,
+    inline void plot_flowcell_map2(const model::metrics::run_metrics& metrics,
                            const constants::metric_type type,
                            const model::plot::filter_options& options,
                            model::plot::flowcell_data& data,
@@ -80,7 +104,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param tile_buffer preallocated memory for tile ids
      * @param skip_empty set false for testing purposes
      */
-    void plot_flowcell_map(model::metrics::run_metrics& metrics,
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
                                   const std::string& metric_name,
                                   const model::plot::filter_options& options,
                                   model::plot::flowcell_data& data,
@@ -90,6 +114,29 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                                   INTEROP_THROW_SPEC((model::invalid_filter_option,
                                   model::invalid_metric_type,
                                   model::index_out_of_bounds_exception));
+    /** Plot a flowcell map reusing the scratch buffers in a workspace
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param metric_name specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output flowcell map
+     * @param workspace scratch buffers reused across calls
+     * @param buffer preallocated memory for data
+     * @param tile_buffer preallocated memory for tile ids
+     * @param skip_empty set false for testing purposes
+     */
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
+                           const std::string& metric_name,
+                           const model::plot::filter_options& options,
+                           model::plot::flowcell_data& data,
+                           logic::utils::workspace& workspace,
+                           float* buffer=0,
+                           ::uint32_t* tile_buffer=0,
+                           const bool skip_empty=true)
+                           INTEROP_THROW_SPEC((model::invalid_filter_option,
+                           model::invalid_metric_type,
+                           model::index_out_of_bounds_exception));
     /** Plot a flowcell map
      *
      * @ingroup plot_logic
@@ -103,7 +150,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param id_buffer_size size of the buffer
      * @param skip_empty set false for testing purposes
      */
-    inline void plot_flowcell_map2(model::metrics::run_metrics& metrics,
+    inline void plot_flowcell_map2(const model::metrics::run_metrics& metrics,
                            const std::string& metric_name,
                            const model::plot::filter_options& options,
                            model::plot::flowcell_data& data,
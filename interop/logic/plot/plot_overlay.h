@@ -0,0 +1,127 @@
+/** Plot a metric for many runs on the same chart
+ *
+ * Each run contributes its own series to a single plot, and the axes are shared by all runs. Runs are plotted in
+ * parallel, and runs given by folder are loaded on demand with only the metric groups the plot requires.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <vector>
+#include <string>
+#include "interop/model/run_metrics.h"
+#include "interop/model/plot/filter_options.h"
+#include "interop/model/plot/plot_data.h"
+#include "interop/model/plot/candle_stick_point.h"
+#include "interop/model/plot/bar_point.h"
+#include "interop/constants/enums.h"
+
+namespace illumina { namespace interop { namespace logic { namespace plot
+{
+    /** Plot a specified metric value by cycle for many loaded runs
+     *
+     * Each run is labeled with its run name. A run that plots more than one series, e.g. by channel or base, adds
+     * each series with the series name appended to its label. Runs without data for the metric are skipped.
+     *
+     * Runs are plotted in parallel when `thread_count` is greater than 1. A run listed more than once is plotted
+     * once, and the exception of the first run that fails is thrown with its original type.
+     *
+     * @ingroup plot_logic
+     * @param runs collection of loaded runs
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data with a series for each run
+     * @param thread_count number of runs to plot in parallel
+     */
+    void plot_by_cycle_overlay(const std::vector<model::metrics::run_metrics*>& runs,
+                               const constants::metric_type type,
+                               const model::plot::filter_options& options,
+                               model::plot::plot_data<model::plot::candle_stick_point>& data,
+                               const size_t thread_count=1)
+                                INTEROP_THROW_SPEC((model::index_out_of_bounds_exception,
+                                model::invalid_metric_type,
+                                model::invalid_channel_exception,
+                                model::invalid_filter_option,
+                                model::invalid_read_exception,
+                                model::invalid_parameter));
+    /** Plot a specified metric value by cycle for many runs loaded on demand
+     *
+     * Only the metric groups required by the metric are read from each run folder. At most `thread_count` runs
+     * are held in memory at any time.
+     *
+     * @ingroup plot_logic
+     * @param run_folders collection of run folder paths
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data with a series for each run
+     * @param thread_count number of runs to load and plot in parallel
+     */
+    void plot_by_cycle_overlay(const std::vector<std::string>& run_folders,
+                               const constants::metric_type type,
+                               const model::plot::filter_options& options,
+                               model::plot::plot_data<model::plot::candle_stick_point>& data,
+                               const size_t thread_count=1)
+                                INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+                                xml::bad_xml_format_exception,
+                                xml::empty_xml_format_exception,
+                                xml::missing_xml_element_exception,
+                                xml::xml_parse_exception,
+                                io::file_not_found_exception,
+                                io::bad_format_exception,
+                                io::incomplete_file_exception,
+                                model::index_out_of_bounds_exception,
+                                model::invalid_metric_type,
+                                model::invalid_channel_exception,
+                                model::invalid_filter_option,
+                                model::invalid_read_exception,
+                                model::invalid_parameter));
+    /** Plot the q-score histogram for many loaded runs
+     *
+     * Each run adds a single line series labeled with its run name. All runs share the unit of the y-axis, so runs
+     * reported in millions are rescaled when any run is reported in billions.
+     *
+     * @ingroup plot_logic
+     * @param runs collection of loaded runs
+     * @param options options to filter the data
+     * @param data output plot data with a series for each run
+     * @param thread_count number of runs to plot in parallel
+     */
+    void plot_qscore_histogram_overlay(const std::vector<model::metrics::run_metrics*>& runs,
+                                       const model::plot::filter_options& options,
+                                       model::plot::plot_data<model::plot::bar_point>& data,
+                                       const size_t thread_count=1)
+                                        INTEROP_THROW_SPEC((model::invalid_read_exception,
+                                        model::index_out_of_bounds_exception,
+                                        model::invalid_filter_option,
+                                        model::invalid_parameter));
+    /** Plot the q-score histogram for many runs loaded on demand
+     *
+     * Only the q-metric groups are read from each run folder. At most `thread_count` runs are held in memory at
+     * any time.
+     *
+     * @ingroup plot_logic
+     * @param run_folders collection of run folder paths
+     * @param options options to filter the data
+     * @param data output plot data with a series for each run
+     * @param thread_count number of runs to load and plot in parallel
+     */
+    void plot_qscore_histogram_overlay(const std::vector<std::string>& run_folders,
+                                       const model::plot::filter_options& options,
+                                       model::plot::plot_data<model::plot::bar_point>& data,
+                                       const size_t thread_count=1)
+                                        INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+                                        xml::bad_xml_format_exception,
+                                        xml::empty_xml_format_exception,
+                                        xml::missing_xml_element_exception,
+                                        xml::xml_parse_exception,
+                                        io::file_not_found_exception,
+                                        io::bad_format_exception,
+                                        io::incomplete_file_exception,
+                                        model::invalid_read_exception,
+                                        model::index_out_of_bounds_exception,
+                                        model::invalid_filter_option,
+                                        model::invalid_parameter));
+
+}}}}
@@ -23,7 +23,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param buffer optional buffer of preallocated memory (for SWIG)
      * @param buffer_size number of elements in buffer
      */
-    void plot_qscore_heatmap(model::metrics::run_metrics& metrics,
+    void plot_qscore_heatmap(const model::metrics::run_metrics& metrics,
                                     const model::plot::filter_options& options,
                                     model::plot::heatmap_data& data,
                                     float* buffer=0,
@@ -24,7 +24,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param lane lane number
      * @param data output plot data
      */
-    void plot_sample_qc(model::metrics::run_metrics &metrics,
+    void plot_sample_qc(const model::metrics::run_metrics& metrics,
                         const size_t lane,
                         model::plot::plot_data <model::plot::bar_point> &data)
     INTEROP_THROW_SPEC((model::index_out_of_bounds_exception));
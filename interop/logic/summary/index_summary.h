@@ -21,7 +21,7 @@ namespace illumina { namespace interop { namespace logic { namespace summary
      * @param lane lane number
      * @param summary destination index lane summary
      */
-    void summarize_index_metrics(model::metrics::run_metrics &metrics,
+    void summarize_index_metrics(const model::metrics::run_metrics& metrics,
                                         const size_t lane,
                                         model::summary::index_lane_summary &summary)
                                         INTEROP_THROW_SPEC((model::index_out_of_bounds_exception));
@@ -45,7 +45,7 @@ namespace illumina { namespace interop { namespace logic { namespace summary
      * @param metrics source collection of all metrics
      * @param summary destination index flowcell summary
      */
-    void summarize_index_metrics(model::metrics::run_metrics &metrics,
+    void summarize_index_metrics(const model::metrics::run_metrics& metrics,
                                         model::summary::index_flowcell_summary &summary)
                                             INTEROP_THROW_SPEC((model::index_out_of_bounds_exception));
 }}}}
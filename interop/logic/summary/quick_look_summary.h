@@ -0,0 +1,90 @@
+/** Approximate summary logic computed over a stratified sample of tiles
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include "interop/model/model_exceptions.h"
+#include "interop/model/metric_base/tile_filter.h"
+#include "interop/model/summary/run_summary.h"
+#include "interop/model/summary/sampling_summary.h"
+#include "interop/model/run_metrics.h"
+
+
+namespace illumina { namespace interop { namespace logic { namespace summary
+{
+    /** Select a deterministic, stratified sample of tiles from the flowcell layout
+     *
+     * Each lane and surface forms a stratum. The tiles in a stratum are ordered by swath, section and tile
+     * number and then sampled at an even stride, so the sample covers the whole length and width of each lane.
+     *
+     * If RunInfo.xml lists the tiles, then the list is sampled. Otherwise, the tiles are generated from
+     * the flowcell layout and tile naming method.
+     *
+     * @ingroup summary_logic
+     * @param run_info run info
+     * @param tiles_per_surface maximum number of tiles to select from each lane surface
+     * @param sample destination tile filter
+     * @param sampling destination sampling summary (number of tiles sampled per lane)
+     */
+    void select_tile_sample(const model::run::info& run_info,
+                            const size_t tiles_per_surface,
+                            model::metric_base::tile_filter& sample,
+                            model::summary::sampling_summary& sampling)
+    INTEROP_THROW_SPEC(( model::invalid_tile_naming_method ));
+
+    /** Scale a summary computed over a tile sample to the whole flowcell
+     *
+     * The number of reads and yields are scaled by the ratio of total to sampled tiles in each lane, and each
+     * surface by the ratio of total to sampled tiles on that surface. When every surface is sampled, the lane
+     * totals are the sum of the surface estimates. The read and run totals are then recomputed from the lanes. All other
+     * values are means over tiles, which are unbiased estimates and are left as is.
+     *
+     * @ingroup summary_logic
+     * @param sampling sampling summary, the sampled tile count is updated to the tiles actually summarized
+     * @param summary run summary computed over the tile sample
+     */
+    void extrapolate_sampled_summary(model::summary::sampling_summary& sampling,
+                                     model::summary::run_summary& summary)
+    INTEROP_THROW_SPEC(( model::index_out_of_bounds_exception ));
+
+    /** Read a stratified sample of tiles from a run folder and summarize it
+     *
+     * Only the records for the selected tiles are decoded. The returned summary is approximate: lane means
+     * are sample means, while read counts and yields are extrapolated to the whole flowcell. The standard error
+     * of any lane mean can be estimated with `lane_sampling_summary::standard_error`.
+     *
+     * @ingroup summary_logic
+     * @param run_folder run folder path
+     * @param tiles_per_surface maximum number of tiles to select from each lane surface
+     * @param metrics destination run metrics holding only the sampled tiles
+     * @param summary destination run summary
+     * @param sampling destination sampling summary
+     * @param thread_count number of threads to use for network loading
+     */
+    void summarize_quick_look(const std::string& run_folder,
+                              const size_t tiles_per_surface,
+                              model::metrics::run_metrics& metrics,
+                              model::summary::run_summary& summary,
+                              model::summary::sampling_summary& sampling,
+                              const size_t thread_count=1)
+    INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception,
+    xml::empty_xml_format_exception,
+    xml::missing_xml_element_exception,
+    xml::xml_parse_exception,
+    io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    model::invalid_channel_exception,
+    model::index_out_of_bounds_exception,
+    model::invalid_tile_naming_method,
+    model::invalid_tile_list_exception,
+    model::invalid_run_info_exception,
+    model::invalid_run_info_cycle_exception,
+    model::invalid_parameter));
+
+}}}}
+
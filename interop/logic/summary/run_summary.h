@@ -8,8 +8,10 @@
 #pragma once
 #include "interop/model/model_exceptions.h"
 #include "interop/model/summary/run_summary.h"
+#include "interop/model/summary/columnar_summary.h"
 #include "interop/model/run_metrics.h"
 #include "interop/logic/utils/metrics_to_load.h"
+#include "interop/logic/utils/workspace.h"
 
 
 namespace illumina { namespace interop { namespace logic { namespace summary
@@ -25,13 +27,42 @@ namespace illumina { namespace interop { namespace logic { namespace summary
      * @param skip_median skip the median calculation
      * @param trim flag indicating whether to trim the summary model (default: true)
      */
-    void summarize_run_metrics(model::metrics::run_metrics& metrics,
+    void summarize_run_metrics(const model::metrics::run_metrics& metrics,
                                model::summary::run_summary& summary,
                                const bool skip_median=false,
                                const bool trim=true)
     INTEROP_THROW_SPEC(( model::index_out_of_bounds_exception,
     model::invalid_channel_exception,
     model::invalid_run_info_exception ));
+    /** Summarize a collection run metrics reusing the scratch buffers in a workspace
+     *
+     * @ingroup summary_logic
+     * @param metrics source collection of all metrics
+     * @param summary destination run summary
+     * @param workspace scratch buffers reused across calls
+     * @param skip_median skip the median calculation
+     * @param trim flag indicating whether to trim the summary model (default: true)
+     */
+    void summarize_run_metrics(const model::metrics::run_metrics& metrics,
+                               model::summary::run_summary& summary,
+                               utils::workspace& workspace,
+                               const bool skip_median=false,
+                               const bool trim=true)
+    INTEROP_THROW_SPEC(( model::index_out_of_bounds_exception,
+    model::invalid_channel_exception,
+    model::invalid_run_info_exception ));
+    /** Copy the read, lane and surface statistics of a run summary to flat columns
+     *
+     * This is the only way to create the columns: summarize the run into a tree with summarize_run_metrics (without
+     * trimming), then copy the tree. The lane index of each row is the lane number minus one, so lanes removed when trimming the
+     * summary are left as NaN.
+     *
+     * @ingroup summary_logic
+     * @param summary source run summary
+     * @param columns destination columnar summary
+     */
+    void create_columnar_summary(const model::summary::run_summary& summary,
+                                 model::summary::columnar_summary& columns);
 
 
 }}}}
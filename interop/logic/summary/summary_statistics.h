@@ -149,8 +149,8 @@ namespace illumina { namespace interop { namespace logic { namespace summary
     void summarize(I beg, I end, S &stat, const bool skip_median)
     {
         if (beg == end) return;
-        stat.mean(util::mean<float>(beg, end));
-        stat.stddev(std::sqrt(util::variance_with_mean<float>(beg, end, stat.mean())));
+        stat.mean(util::deterministic_mean<float>(beg, end, util::op::operator_none()));
+        stat.stddev(std::sqrt(util::deterministic_variance_with_mean<float>(beg, end, stat.mean(), util::op::operator_none())));
         if(!skip_median) stat.median(util::median_interpolated<float>(beg, end));
     }
 
@@ -167,8 +167,8 @@ namespace illumina { namespace interop { namespace logic { namespace summary
     void summarize(I beg, I end, S &stat, BinaryOp op, Compare comp, const bool skip_median)
     {
         if (beg == end) return;
-        stat.mean(util::mean<float>(beg, end, op));
-        stat.stddev(std::sqrt(util::variance_with_mean<float>(beg, end, stat.mean(), op)));
+        stat.mean(util::deterministic_mean<float>(beg, end, op));
+        stat.stddev(std::sqrt(util::deterministic_variance_with_mean<float>(beg, end, stat.mean(), op)));
         if(!skip_median) stat.median(util::median_interpolated<float>(beg, end, comp, op));
     }
 
@@ -189,9 +189,9 @@ namespace illumina { namespace interop { namespace logic { namespace summary
         if (beg == end) return 0;
         end = util::remove_nan(beg, end, op);
         if (beg == end) return 0;
-        stat.mean(util::mean<float>(beg, end, op));
+        stat.mean(util::deterministic_mean<float>(beg, end, op));
         INTEROP_ASSERT(!std::isnan(stat.mean()));
-        stat.stddev(std::sqrt(util::variance_with_mean<float>(beg, end, stat.mean(), op)));
+        stat.stddev(std::sqrt(util::deterministic_variance_with_mean<float>(beg, end, stat.mean(), op)));
         if(!skip_median) stat.median(util::median_interpolated<float>(beg, end, comp, op));
         return size_t(std::distance(beg, end));
     }
@@ -11,6 +11,7 @@
 #include "interop/model/table/imaging_column.h"
 #include "interop/model/table/imaging_table.h"
 #include "interop/logic/table/table_util.h"
+#include "interop/logic/utils/workspace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace table
 {
@@ -48,7 +49,17 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param metrics source run metrics
      * @param table destination imaging table
      */
-    void create_imaging_table(model::metrics::run_metrics& metrics, model::table::imaging_table& table)
+    void create_imaging_table(const model::metrics::run_metrics& metrics, model::table::imaging_table& table)
+    INTEROP_THROW_SPEC((model::invalid_column_type, model::index_out_of_bounds_exception, model::invalid_parameter));
+    /** Create an imaging table from run metrics reusing the scratch buffers in a workspace
+     *
+     * @param metrics source run metrics
+     * @param table destination imaging table
+     * @param workspace scratch buffers reused across calls
+     */
+    void create_imaging_table(const model::metrics::run_metrics& metrics,
+                              model::table::imaging_table& table,
+                              logic::utils::workspace& workspace)
     INTEROP_THROW_SPEC((model::invalid_column_type, model::index_out_of_bounds_exception, model::invalid_parameter));
 
     /** List the required on demand metrics
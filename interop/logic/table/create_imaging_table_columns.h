@@ -48,7 +48,7 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param metrics source collection of InterOp metrics from the run
      * @param columns destination vector of column descriptors
      */
-    void create_imaging_table_columns(model::metrics::run_metrics& metrics,
+    void create_imaging_table_columns(const model::metrics::run_metrics& metrics,
                                       std::vector< model::table::imaging_column >& columns)
     INTEROP_THROW_SPEC((model::invalid_column_type,
     model::index_out_of_bounds_exception,
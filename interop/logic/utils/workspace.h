@@ -0,0 +1,288 @@
+/** Reusable scratch buffers for the summary, plot and table logic
+ *
+ * A workspace owns the temporary buffers used by `summarize_run_metrics`, `plot_by_cycle`, `plot_flowcell_map`
+ * and `create_imaging_table`. Passing the same workspace to repeated calls on runs of the same shape reuses the
+ * capacity of these buffers rather than reallocating them on every call.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <vector>
+#include <map>
+#include <cstddef>
+#include "interop/util/cstdint.h"
+#include "interop/logic/summary/map_cycle_to_read.h"
+
+namespace illumina { namespace interop { namespace logic { namespace utils
+{
+    /** Scratch buffers shared by repeated calls to the summary, plot and table logic
+     *
+     * Each call marks the start and end of its use of the workspace with a `call_scope`. The scope records the
+     * capacity of every buffer on entry, and on exit counts the buffers that had to grow. On a run of the same
+     * shape, this count should drop to zero after the first call; a non-zero count on later calls shows that
+     * some buffer is not being reused.
+     *
+     * The growth count is not a count of heap allocations. The per-metric maps of the summary, the tile map used
+     * to pick the imaging table columns and the labels of the flowcell map are still allocated on each call. The
+     * row ordering of the imaging table is kept in the workspace and only rebuilt when the rows change.
+     * The `workspace` format of `benchmark_load` counts the real allocations of repeated calls.
+     *
+     * @note A workspace is not thread safe, each thread requires its own workspace.
+     */
+    class workspace
+    {
+    public:
+        /** Vector of floating point values */
+        typedef std::vector<float> float_vector_t;
+        /** Vector of floating point vectors */
+        typedef std::vector<float_vector_t> float_vector2d_t;
+        /** Vector of tile numbers */
+        typedef std::vector< ::uint32_t > id_vector_t;
+        /** Vector of unique metric ids */
+        typedef std::vector< ::uint64_t > key_vector_t;
+        /** Vector of indices */
+        typedef std::vector<size_t> index_vector_t;
+        /** Vector of read_cycle objects */
+        typedef summary::read_cycle_vector_t read_cycle_vector_t;
+        /** Map from a unique metric id to a table row */
+        typedef std::map< ::uint64_t, ::uint64_t > row_offset_map_t;
+
+    private:
+        enum buffer_id
+        {
+            CycleToReadBuffer,
+            TileNumberBuffer,
+            ValueBuffer,
+            OutlierBuffer,
+            ValueByCycleBuffer,
+            ValueByCycleRowBuffer,
+            ColumnMapBuffer,
+            TableDataBuffer,
+            KeyBuffer,
+            IndexBuffer,
+            BufferCount
+        };
+
+    public:
+        /** Mark the start and end of a call that uses the workspace
+         *
+         * Nested scopes are ignored, so only the outermost entry point updates the allocation count.
+         */
+        class call_scope
+        {
+        public:
+            /** Constructor
+             *
+             * @param ws workspace used by the call
+             */
+            call_scope(workspace& ws) : m_workspace(ws)
+            {
+                m_workspace.begin_call();
+            }
+            /** Destructor
+             */
+            ~call_scope()
+            {
+                m_workspace.end_call();
+            }
+
+        private:
+            call_scope(const call_scope&);
+            call_scope& operator=(const call_scope&);
+
+        private:
+            workspace& m_workspace;
+        };
+
+    public:
+        /** Constructor
+         */
+        workspace() : m_depth(0), m_call_count(0), m_growth_count(0), m_total_growth_count(0)
+        {
+            for(size_t i=0;i<BufferCount;++i) m_capacity[i] = 0;
+        }
+
+    public:
+        /** Get the map from cycle to read
+         *
+         * @return cycle to read buffer
+         */
+        read_cycle_vector_t& cycle_to_read()
+        {
+            return m_cycle_to_read;
+        }
+        /** Get the buffer of tile numbers
+         *
+         * @return tile number buffer
+         */
+        id_vector_t& tile_numbers()
+        {
+            return m_tile_numbers;
+        }
+        /** Get the buffer of values, e.g. values sorted to scale the flowcell color bar
+         *
+         * @return value buffer
+         */
+        float_vector_t& values()
+        {
+            return m_values;
+        }
+        /** Get the buffer of outlier values
+         *
+         * @return outlier buffer
+         */
+        float_vector_t& outliers()
+        {
+            return m_outliers;
+        }
+        /** Get the buffer of values grouped by cycle
+         *
+         * @return values by cycle buffer
+         */
+        float_vector2d_t& values_by_cycle()
+        {
+            return m_values_by_cycle;
+        }
+        /** Get the map from column id to column offset
+         *
+         * @return column map buffer
+         */
+        index_vector_t& column_map()
+        {
+            return m_column_map;
+        }
+        /** Get the buffer of table cells
+         *
+         * @return table data buffer
+         */
+        float_vector_t& table_data()
+        {
+            return m_table_data;
+        }
+        /** Get the map from a unique metric id to a row of the imaging table
+         *
+         * @return row offset map
+         */
+        row_offset_map_t& row_offsets()
+        {
+            return m_row_offsets;
+        }
+        /** Get the buffer of unique metric ids for batch lookups
+         *
+         * @return key buffer
+         */
+        key_vector_t& keys()
+        {
+            return m_keys;
+        }
+        /** Get the buffer of metric indices for batch lookups
+         *
+         * @return index buffer
+         */
+        index_vector_t& indices()
+        {
+            return m_indices;
+        }
+
+    public:
+        /** Get the number of workspace buffers that grew during the last call
+         *
+         * @return number of buffers that grew in the last call
+         */
+        size_t buffer_growth_count()const
+        {
+            return m_growth_count;
+        }
+        /** Get the number of times a workspace buffer grew over all calls
+         *
+         * @return number of buffers that grew over all calls
+         */
+        size_t total_buffer_growth_count()const
+        {
+            return m_total_growth_count;
+        }
+        /** Get the number of calls that used this workspace
+         *
+         * @return number of calls
+         */
+        size_t call_count()const
+        {
+            return m_call_count;
+        }
+        /** Release the memory held by all buffers
+         */
+        void clear()
+        {
+            read_cycle_vector_t().swap(m_cycle_to_read);
+            id_vector_t().swap(m_tile_numbers);
+            float_vector_t().swap(m_values);
+            float_vector_t().swap(m_outliers);
+            float_vector2d_t().swap(m_values_by_cycle);
+            index_vector_t().swap(m_column_map);
+            float_vector_t().swap(m_table_data);
+            key_vector_t().swap(m_keys);
+            m_row_offsets.clear();
+            index_vector_t().swap(m_indices);
+            for(size_t i=0;i<BufferCount;++i) m_capacity[i] = 0;
+        }
+
+    private:
+        void begin_call()
+        {
+            if(m_depth++ > 0) return;
+            capacities(m_capacity);
+        }
+        void end_call()
+        {
+            if(--m_depth > 0) return;
+            size_t capacity[BufferCount];
+            capacities(capacity);
+            m_growth_count = 0;
+            for(size_t i=0;i<BufferCount;++i)
+                if(capacity[i] > m_capacity[i]) ++m_growth_count;
+            m_total_growth_count += m_growth_count;
+            ++m_call_count;
+        }
+        void capacities(size_t* capacity)const
+        {
+            capacity[CycleToReadBuffer] = m_cycle_to_read.capacity();
+            capacity[TileNumberBuffer] = m_tile_numbers.capacity();
+            capacity[ValueBuffer] = m_values.capacity();
+            capacity[OutlierBuffer] = m_outliers.capacity();
+            capacity[ValueByCycleBuffer] = m_values_by_cycle.capacity();
+            capacity[ValueByCycleRowBuffer] = 0;
+            for(size_t i=0;i<m_values_by_cycle.size();++i)
+                capacity[ValueByCycleRowBuffer] += m_values_by_cycle[i].capacity();
+            capacity[ColumnMapBuffer] = m_column_map.capacity();
+            capacity[TableDataBuffer] = m_table_data.capacity();
+            capacity[KeyBuffer] = m_keys.capacity();
+            capacity[IndexBuffer] = m_indices.capacity();
+        }
+
+    private:
+        workspace(const workspace&);
+        workspace& operator=(const workspace&);
+
+    private:
+        read_cycle_vector_t m_cycle_to_read;
+        id_vector_t m_tile_numbers;
+        float_vector_t m_values;
+        float_vector_t m_outliers;
+        float_vector2d_t m_values_by_cycle;
+        index_vector_t m_column_map;
+        float_vector_t m_table_data;
+        key_vector_t m_keys;
+        index_vector_t m_indices;
+        row_offset_map_t m_row_offsets;
+        size_t m_capacity[BufferCount];
+        size_t m_depth;
+        size_t m_call_count;
+        size_t m_growth_count;
+        size_t m_total_growth_count;
+    };
+
+}}}}
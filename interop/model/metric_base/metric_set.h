@@ -21,6 +21,9 @@
 #include "interop/model/metric_base/metric_exceptions.h"
 #include "interop/util/lexical_cast.h"
 #include "interop/util/assert.h"
+#include "interop/util/prefetch.h"
+#include "interop/util/hash.h"
+#include "interop/util/memory_policy.h"
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -73,12 +76,18 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         typedef typename metric_array_t::const_iterator const_iterator;
         /** Metric iterator */
         typedef typename metric_array_t::iterator iterator;
+        /** Generation number type */
+        typedef ::uint64_t generation_t;
         enum
         {
             /** Group type enum */
             TYPE=metric_attributes<T>::TYPE,
             /** Latest version of the format */
-            LATEST_VERSION=metric_attributes<T>::LATEST_VERSION
+            LATEST_VERSION=metric_attributes<T>::LATEST_VERSION,
+            /** Number of ids resolved together by a batch lookup */
+            LOOKUP_BLOCK_SIZE=16,
+            /** Number of stale change log entries allowed beyond the number of records before compaction */
+            MIN_CHANGE_LOG_SLACK=1024
         };
 
     public:
@@ -87,7 +96,13 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          * @param version version of the file format
          */
         metric_set(const ::int16_t version )
-                : header_type(header_type::default_header()), m_version(version), m_data_source_exists(false)
+                : header_type(header_type::default_header()),
+                  m_version(version),
+                  m_data_source_exists(false),
+                  m_track_changes(false),
+                  m_generation(1),
+                  m_unsorted_change_log(false),
+                  m_retain_capacity(false)
         { }
         /** Constructor
          *
@@ -95,7 +110,13 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          * @param version version of the file format
          */
         metric_set(const header_type &header = header_type::default_header(), const ::int16_t version = 0)
-                : header_type(header), m_version(version), m_data_source_exists(false)
+                : header_type(header),
+                  m_version(version),
+                  m_data_source_exists(false),
+                  m_track_changes(false),
+                  m_generation(1),
+                  m_unsorted_change_log(false),
+                  m_retain_capacity(false)
         { }
 
         /** Constructor
@@ -108,7 +129,11 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
                 header_type(header),
                 m_data(vec),
                 m_version(version),
-                m_data_source_exists(false)
+                m_data_source_exists(false),
+                m_track_changes(false),
+                m_generation(1),
+                m_unsorted_change_log(false),
+                m_retain_capacity(false)
         {
             rebuild_index(true);
         }
@@ -196,7 +221,29 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          */
         void sort()
         {
-            std::sort(m_data.begin(), m_data.end());
+            if(m_generations.empty())
+            {
+                std::sort(m_data.begin(), m_data.end());
+                return;
+            }
+            // Move the generation of each record with it
+            std::vector<size_t> order(m_data.size());
+            for(size_t i=0;i<order.size();++i) order[i] = i;
+            std::sort(order.begin(), order.end(), offset_less(m_data));
+            metric_array_t data;
+            data.reserve(m_data.size());
+            std::vector<generation_t> generations(m_generations.size(), 0);
+            std::vector<content_t> contents(m_contents.size());
+            for(size_t i=0;i<order.size();++i)
+            {
+                data.push_back(m_data[order[i]]);
+                if(order[i] < m_generations.size()) generations[i] = m_generations[order[i]];
+                if(order[i] < m_contents.size()) contents[i] = m_contents[order[i]];
+            }
+            m_data.swap(data);
+            m_generations.swap(generations);
+            m_contents.swap(contents);
+            compact_change_log();
         }
 
     public:
@@ -208,6 +255,8 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          */
         void rebuild_index(const bool update_ids=false)
         {
+            // Records that kept the stamp of a previous load are added to the change log once the load ends
+            if(m_unsorted_change_log) compact_change_log();
             size_t offset = 0;
             for (const_iterator b = begin(), e = end(); b != e; ++b)
             {
@@ -223,29 +272,75 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             if(group != constants::Tile &&                // imaging table
                     group != constants::ExtendedTile &&
                     group != constants::DynamicPhasing && // Not read in
+                    group != constants::QByTileRead &&    // Not read in
                     group != constants::CorrectedInt)     // `populate_called_intensities`
             {
                 clear_lookup();
             }
+            // Shrinking the storage would free the capacity kept for the next load
+            if(m_retain_capacity) return;
             metric_array_t tmp;
             tmp.assign(m_data.begin(), m_data.end());
             tmp.swap(m_data);
         }
         /** Resize the number of places in the metric vector
+         *
+         * New places reuse the records kept by clear when retain_capacity is enabled. The storage grows at least
+         * geometrically, so growing the set one record at a time stays linear overall.
          *
          * @param n expected number of elements
          */
         void resize(const size_t n)
         {
-            m_data.resize(n, metric_type(*this));
+            if (n > m_data.capacity()) reserve(std::max(n, 2*m_data.capacity()));
+            if (n < m_data.size()) release_records(n);
+            else if (n > m_data.size())
+            {
+                const metric_type blank(*this);
+                reuse_records(n, blank);
+                m_data.resize(n, blank);
+            }
+            if(m_generations.size() > n) m_generations.resize(n);
+            if(m_contents.size() > n) m_contents.resize(n);
         }
         /** Reserve the number of places in the metric vector
+         *
+         * @note With C++11, the storage is advised to use huge pages when enabled by util::memory_policy
          *
          * @param n maximum number of elements
          */
         void reserve(const size_t n)
         {
+            if (n <= m_data.capacity()) return;
             m_data.reserve(n);
+#if (defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1600)
+            util::memory_policy::advise(m_data.data(), m_data.capacity() * sizeof(metric_type));
+#endif
+        }
+        /** Reserve buckets in the id map, so it is not rehashed while loading the expected number of metrics
+         *
+         * @note This does nothing when the id map is an ordered map
+         *
+         * @param n expected number of metrics
+         */
+        void reserve_offset_map(const size_t n)
+        {
+#ifdef INTEROP_HAS_UNORDERED_MAP
+            m_id_map.reserve(n);
+#else
+            (void)n;
+#endif
+        }
+        /** Release the buckets of the id map that are not required for its current size
+         *
+         * @note This does nothing when the id map is an ordered map
+         */
+        void shrink_offset_map()
+        {
+#ifdef INTEROP_HAS_UNORDERED_MAP
+            if(m_retain_capacity) return;
+            m_id_map.rehash(0);
+#endif
         }
         /** Trim the set to the proper number of metrics
          *
@@ -253,7 +348,10 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          */
         void trim(const size_t n)
         {
-            m_data.resize(n);
+            if(n < m_data.size()) release_records(n);
+            else m_data.resize(n);
+            if(m_generations.size() > n) m_generations.resize(n);
+            if(m_contents.size() > n) m_contents.resize(n);
         }
 
         /** Add a metric to the metric set
@@ -277,7 +375,9 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             m_id_map[id] = size();
 
             T::header_type::update_max_cycle(metric);
-            m_data.push_back(metric);
+            if(m_recycled.empty()) m_data.push_back(metric);
+            else reuse_records(m_data.size()+1, metric);
+            stamp(m_data.size()-1);
         }
 
         /** Remove a metric from the metric set
@@ -287,8 +387,12 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         void remove(iterator &it)
         {
             INTEROP_ASSERT(size() > 0);
+            const size_t offset = static_cast<size_t>(std::distance(m_data.begin(), it));
             std::iter_swap(it, m_data.rbegin());
+            if(size() <= m_contents.size()) std::swap(m_contents[offset], m_contents[size()-1]);
             trim(size()-1);
+            // The last record moved into the removed slot, so its change log entry no longer points to it
+            if(offset < size()) restamp(offset);
         }
 
         /** Get a metric at the given index
@@ -441,6 +545,29 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
                          lane_surface_equals(lane, surface, naming_convention),
                          to_tile);
         }
+        /** Append the tile numbers of every metric in the specified lane and surface
+         *
+         * Unlike `populate_tile_numbers_for_lane_surface`, the tile numbers are not made unique. Sort the
+         * vector and remove duplicates to count the tiles.
+         *
+         * @note this does not clear the vector!
+         *
+         * @param tile_numbers destination vector of tile numbers
+         * @param lane lane number
+         * @param surface surface number
+         * @param naming_convention tile naming convetion enum
+         */
+        void append_tile_numbers_for_lane_surface(id_vector& tile_numbers,
+                                                  const uint_t lane,
+                                                  const uint_t surface,
+                                                  const constants::tile_naming_method naming_convention) const
+        {
+            transform_if(begin(),
+                         end(),
+                         std::back_inserter(tile_numbers),
+                         lane_surface_equals(lane, surface, naming_convention),
+                         to_tile);
+        }
 
         /** Get a list of all available tile numbers
          *
@@ -538,10 +665,18 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         void clear()
         {
             header_type::clear();
-            clear_lookup();
-            m_data.clear();
+            if(m_track_changes) keep_stamps();
+            if(m_retain_capacity) recycle_records();
+            else
+            {
+                clear_lookup();
+                m_data.clear();
+            }
             m_version=0;
             m_data_source_exists=false;
+            m_generations.clear();
+            m_contents.clear();
+            m_change_log.clear();
         }
 
         /** Get the metrics in a vector
@@ -654,6 +789,61 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             return it->second;
         }
 
+        /** Find the index of each metric for a batch of ids
+         *
+         * The ids are resolved in blocks. All ids in a block are looked up before any record is touched, so the
+         * lookups do not wait on each other, and the records found are prefetched for the caller.
+         *
+         * @param ids array of ids
+         * @param n number of ids
+         * @param indices destination array of indices, the number of metrics for ids that are not found
+         */
+        void find(const id_t* ids, const size_t n, size_t* indices) const
+        {
+            const size_t missing = size();
+            for (size_t beg = 0; beg < n; beg += LOOKUP_BLOCK_SIZE)
+            {
+                const size_t end = std::min(n, beg + static_cast<size_t>(LOOKUP_BLOCK_SIZE));
+                for (size_t i = beg; i < end; ++i)
+                {
+                    typename offset_map_t::const_iterator it = m_id_map.find(ids[i]);
+                    indices[i] = it == m_id_map.end() ? missing : it->second;
+                }
+                for (size_t i = beg; i < end; ++i)
+                {
+                    if (indices[i] != missing) INTEROP_PREFETCH(&m_data[indices[i]]);
+                }
+            }
+        }
+        /** Find the index of each metric for a batch of ids
+         *
+         * @param ids vector of ids
+         * @param indices destination vector of indices, the number of metrics for ids that are not found
+         */
+        void find(const key_vector& ids, std::vector<size_t>& indices) const
+        {
+            indices.resize(ids.size());
+            if (ids.empty()) return;
+            find(&ids[0], ids.size(), &indices[0]);
+        }
+        /** Get a pointer to each metric for a batch of ids
+         *
+         * @param ids array of ids
+         * @param n number of ids
+         * @param metrics destination array of pointers to metrics, null for ids that are not found
+         */
+        void get_metrics(const id_t* ids, const size_t n, const metric_type** metrics) const
+        {
+            size_t indices[LOOKUP_BLOCK_SIZE];
+            for (size_t beg = 0; beg < n; beg += LOOKUP_BLOCK_SIZE)
+            {
+                const size_t count = std::min(n - beg, static_cast<size_t>(LOOKUP_BLOCK_SIZE));
+                find(ids + beg, count, indices);
+                for (size_t i = 0; i < count; ++i)
+                    metrics[beg + i] = indices[i] < m_data.size() ? &m_data[indices[i]] : 0;
+            }
+        }
+
         /** Get metric for lane, tile and cycle
          *
          * @todo: remove this function
@@ -730,10 +920,357 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          */
         void clear_lookup()
         {
+            if(m_retain_capacity)
+            {
+                m_id_map.clear();
+                return;
+            }
             INTEROP_CLEAR_MAP(m_id_map);
         }
 
+    public:
+        /** Enable or disable retaining the allocated capacity when the set is cleared
+         *
+         * A monitor that reloads the same run every few seconds clears the set before each load. With this enabled,
+         * clear keeps the storage of the records, the buckets of the id map, and the records themselves, with the
+         * arrays each record holds. The next load decodes into the kept records in place, so reloading a run of the
+         * same size does not allocate memory for the records.
+         *
+         * The kept records are only freed when a load uses fewer than half of them.
+         *
+         * @param enable true to keep the allocated capacity when the set is cleared
+         */
+        void retain_capacity(const bool enable)
+        {
+            m_retain_capacity = enable;
+            if(!enable) metric_array_t().swap(m_recycled);
+        }
+        /** Test if the set keeps the allocated capacity when it is cleared
+         *
+         * @return true if the allocated capacity is kept
+         */
+        bool retain_capacity()const
+        {
+            return m_retain_capacity;
+        }
+        /** Get the number of records kept for reuse by the next load
+         *
+         * @return number of kept records
+         */
+        size_t recycled_size()const
+        {
+            return m_recycled.size();
+        }
+
+    public:
+        /** @defgroup metric_set_changes Change tracking
+         *
+         * Each record inserted or updated while change tracking is enabled is stamped with the current generation
+         * of the set. The stamps are kept in a side array and a change log ordered by generation, so the records
+         * changed since a generation are found in time proportional to the number of changes.
+         *
+         * A reader starts a new generation each time it reads a file into the set. A consumer saves generation()
+         * as its cursor, and later asks for the ids changed since that cursor.
+         *
+         * The change log keeps one entry for each stamp. When it holds more than twice as many entries as
+         * there are records, plus MIN_CHANGE_LOG_SLACK, stale entries are dropped. Only the latest entry for
+         * each record is kept, so the log stays bounded.
+         *
+         * A reader also passes a hash of the bytes decoded for each record. A record that decodes to the same bytes
+         * as before keeps its stamp, so reading an unchanged file again reports nothing. Clearing the set keeps the
+         * stamp and hash of each record by id, so a reload that clears the set first reports only the records
+         * that are new or changed. The records that kept their stamp are added to the change log when the load
+         * ends, in rebuild_index.
+         *
+         * @note Removing records from the set is not reported, and clearing the set never resets the generation.
+         * @{
+         */
+        /** Enable or disable change tracking
+         *
+         * Disabling change tracking releases the side data.
+         *
+         * @param enable true to stamp inserted and updated records
+         */
+        void track_changes(const bool enable)
+        {
+            m_track_changes = enable;
+            if(enable) return;
+            std::vector<generation_t>().swap(m_generations);
+            std::vector<content_t>().swap(m_contents);
+            std::vector<kept_stamp_t>().swap(m_kept_stamps);
+            std::vector<change_t>().swap(m_change_log);
+            m_unsorted_change_log = false;
+        }
+        /** Test if change tracking is enabled
+         *
+         * @return true if inserted and updated records are stamped
+         */
+        bool track_changes()const
+        {
+            return m_track_changes;
+        }
+        /** Get the current generation
+         *
+         * @return generation stamped on records changed now
+         */
+        generation_t generation()const
+        {
+            return m_generation;
+        }
+        /** Start a new generation
+         *
+         * @return new generation
+         */
+        generation_t next_generation()
+        {
+            return ++m_generation;
+        }
+        /** Stamp the record at the given offset as changed in the current generation
+         *
+         * @param offset offset of the record
+         */
+        void stamp(const size_t offset)
+        {
+            if(!m_track_changes) return;
+            INTEROP_ASSERT(offset < m_data.size());
+            if(m_contents.size() <= offset) m_contents.resize(m_data.size());
+            // The content of the record is unknown, so it never matches the next decoded content
+            m_contents[offset] = content_t(m_generation);
+            if(m_generations.size() <= offset) m_generations.resize(m_data.size(), 0);
+            if(m_generations[offset] == m_generation) return;
+            restamp(offset);
+        }
+        /** Stamp the record at the given offset only if its content changed
+         *
+         * A record may be decoded from several parts in the same generation, and the hashes of the parts are
+         * combined. The record is stamped with the current generation while the combined hash differs from the
+         * hash it had before this generation, and keeps its previous stamp otherwise.
+         *
+         * @param offset offset of the record
+         * @param hash hash of the bytes decoded for the record, or of one part of it
+         */
+        void stamp(const size_t offset, const ::uint64_t hash)
+        {
+            if(!m_track_changes) return;
+            INTEROP_ASSERT(offset < m_data.size());
+            if(m_generations.size() <= offset) m_generations.resize(m_data.size(), 0);
+            if(m_contents.size() <= offset) m_contents.resize(m_data.size());
+            content_t& content = m_contents[offset];
+            if(content.generation != m_generation)
+            {
+                // First part decoded in this generation, save the content before it
+                if(content.generation > 0)
+                {
+                    content.previous_generation = m_generations[offset];
+                    content.previous_hash = content.hash;
+                }
+                else find_kept_stamp(m_data[offset].id(), content);
+                content.generation = m_generation;
+                content.hash = util::hash_seed();
+            }
+            content.hash = util::hash_combine(content.hash, hash);
+            if(content.previous_generation > 0 && content.hash == content.previous_hash)
+            {
+                if(m_generations[offset] == content.previous_generation) return;
+                m_generations[offset] = content.previous_generation;
+                m_unsorted_change_log = true;
+                return;
+            }
+            if(m_generations[offset] == m_generation) return;
+            restamp(offset);
+        }
+        /** Get the ids of the records changed since a generation
+         *
+         * If change tracking is disabled, every record is reported.
+         *
+         * @param since generation saved by the consumer
+         * @param ids destination ids of the records stamped after the given generation
+         */
+        void changed_since(const generation_t since, key_vector& ids)const
+        {
+            ids.clear();
+            if(!m_track_changes)
+            {
+                ids.reserve(m_data.size());
+                for(const_iterator it = begin();it != end();++it) ids.push_back(it->id());
+                return;
+            }
+            typename std::vector<change_t>::const_iterator it =
+                    std::upper_bound(m_change_log.begin(), m_change_log.end(), change_t(since, ~size_t(0)));
+            for(;it != m_change_log.end();++it)
+            {
+                // Skip entries replaced by a later stamp of the same record
+                if(it->second >= m_generations.size() || m_generations[it->second] != it->first) continue;
+                ids.push_back(m_data[it->second].id());
+            }
+        }
+        /** Get the number of entries in the change log
+         *
+         * @return number of entries, including stale entries not yet compacted
+         */
+        size_t change_log_size()const
+        {
+            return m_change_log.size();
+        }
+        /** Drop the stale entries of the change log
+         *
+         * The change log is rebuilt from the side array, with one entry per stamped record.
+         */
+        void compact_change_log()
+        {
+            m_unsorted_change_log = false;
+            m_change_log.clear();
+            for(size_t offset=0;offset<m_generations.size();++offset)
+            {
+                if(m_generations[offset] > 0) m_change_log.push_back(change_t(m_generations[offset], offset));
+            }
+            std::sort(m_change_log.begin(), m_change_log.end());
+        }
+        /** @} */
+
     private:
+        /** Generation and offset of a stamped record */
+        typedef std::pair<generation_t, size_t> change_t;
+        /** Hash of the content of a record, used to detect records decoded again without a change */
+        struct content_t
+        {
+            content_t(const generation_t gen=0) : generation(gen), hash(0), previous_generation(0), previous_hash(0){}
+            /** Generation the hash was computed in, 0 if the record was never decoded */
+            generation_t generation;
+            /** Hash of the parts decoded in that generation, 0 if the content is unknown */
+            ::uint64_t hash;
+            /** Stamp of the record before that generation, 0 if the record is new */
+            generation_t previous_generation;
+            /** Hash of the record before that generation */
+            ::uint64_t previous_hash;
+        };
+        /** Stamp and hash of a record kept by clear */
+        struct kept_stamp_t
+        {
+            kept_stamp_t(const id_t i=0, const generation_t gen=0, const ::uint64_t h=0) :
+                    id(i), generation(gen), hash(h){}
+            bool operator<(const kept_stamp_t& rhs)const
+            {
+                return id < rhs.id;
+            }
+            /** Id of the record */
+            id_t id;
+            /** Stamp of the record */
+            generation_t generation;
+            /** Hash of the content of the record */
+            ::uint64_t hash;
+        };
+        /** Keep the stamp and hash of each record with a known content, ordered by id
+         *
+         * The array keeps its capacity, so a steady state reload does not allocate.
+         */
+        void keep_stamps()
+        {
+            m_kept_stamps.clear();
+            const size_t n = std::min(m_data.size(), std::min(m_generations.size(), m_contents.size()));
+            for(size_t offset=0;offset<n;++offset)
+            {
+                if(m_generations[offset] == 0 || m_contents[offset].hash == 0) continue;
+                m_kept_stamps.push_back(kept_stamp_t(m_data[offset].id(),
+                                                     m_generations[offset],
+                                                     m_contents[offset].hash));
+            }
+            std::sort(m_kept_stamps.begin(), m_kept_stamps.end());
+        }
+        /** Set the previous content of a record to the stamp kept for its id by clear
+         *
+         * @param id id of the record
+         * @param content destination content
+         */
+        void find_kept_stamp(const id_t id, content_t& content)const
+        {
+            typename std::vector<kept_stamp_t>::const_iterator it =
+                    std::lower_bound(m_kept_stamps.begin(), m_kept_stamps.end(), kept_stamp_t(id));
+            const bool found = it != m_kept_stamps.end() && it->id == id;
+            content.previous_generation = found ? it->generation : 0;
+            content.previous_hash = found ? it->hash : 0;
+        }
+        /** Compare the records at two offsets */
+        struct offset_less
+        {
+            offset_less(const metric_array_t& data) : m_data(data){}
+            bool operator()(const size_t lhs, const size_t rhs)const
+            {
+                return m_data[lhs] < m_data[rhs];
+            }
+            const metric_array_t& m_data;
+        };
+        /** Move a record to the end of an array, without copying the arrays it holds
+         *
+         * @param from source record, left empty
+         * @param to destination array
+         */
+        static void move_record(metric_type& from, metric_array_t& to)
+        {
+#if (defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1600)
+            to.push_back(std::move(from));
+#else
+            to.push_back(from);
+#endif
+        }
+        /** Grow the set up to n records with the kept records, each reset to the given value in place
+         *
+         * @param n maximum number of records
+         * @param value value assigned to each reused record
+         */
+        void reuse_records(const size_t n, const metric_type& value)
+        {
+            while(m_data.size() < n && !m_recycled.empty())
+            {
+                move_record(m_recycled.back(), m_data);
+                m_recycled.pop_back();
+                // Assignment keeps the capacity of the arrays held by the record
+                m_data.back() = value;
+            }
+        }
+        /** Shrink the set to n records, keeping the removed records for reuse when retain_capacity is enabled
+         *
+         * @param n number of records to keep in the set
+         */
+        void release_records(const size_t n)
+        {
+            if(!m_retain_capacity)
+            {
+                m_data.resize(n);
+                return;
+            }
+            while(m_data.size() > n)
+            {
+                move_record(m_data.back(), m_recycled);
+                m_data.pop_back();
+            }
+        }
+        /** Empty the set, keeping every record for reuse by the next load
+         *
+         * If the last load used fewer than half the kept records, the unused records, the oversized storage and the
+         * buckets of the id map are freed first.
+         */
+        void recycle_records()
+        {
+            if(m_recycled.size() > m_data.size())
+            {
+                metric_array_t().swap(m_recycled);
+                release_records(0);
+                metric_array_t().swap(m_data);
+                INTEROP_CLEAR_MAP(m_id_map);
+                return;
+            }
+            m_id_map.clear();
+            release_records(0);
+        }
+        void restamp(const size_t offset)
+        {
+            if(!m_track_changes) return;
+            if(m_generations.size() <= offset) m_generations.resize(m_data.size(), 0);
+            m_generations[offset] = m_generation;
+            m_change_log.push_back(change_t(m_generation, offset));
+            if(m_change_log.size() > 2*m_data.size()+MIN_CHANGE_LOG_SLACK) compact_change_log();
+        }
         metric_array_t metrics_for_cycle(const uint_t cycle, const constants::base_cycle_t*) const
         {
             metric_array_t cycle_metrics;
@@ -876,6 +1413,24 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         // TODO: remove the following
         /** Map unique identifiers to the index of the metric */
         offset_map_t m_id_map;
+        /** Flag that indicates whether changed records are stamped */
+        bool m_track_changes;
+        /** Generation stamped on records changed now */
+        generation_t m_generation;
+        /** Generation of the last change to each record, 0 if never stamped */
+        std::vector<generation_t> m_generations;
+        /** Hash of the content of each record */
+        std::vector<content_t> m_contents;
+        /** Stamps of the records before the set was last cleared, ordered by id */
+        std::vector<kept_stamp_t> m_kept_stamps;
+        /** Flag that indicates whether some stamps are missing from the change log */
+        bool m_unsorted_change_log;
+        /** Stamps ordered by generation */
+        std::vector<change_t> m_change_log;
+        /** Flag that indicates whether clear keeps the allocated capacity */
+        bool m_retain_capacity;
+        /** Records kept by clear for reuse by the next load */
+        metric_array_t m_recycled;
     };
 
     /** Get metric set for a given metric set */
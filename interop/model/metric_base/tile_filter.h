@@ -0,0 +1,136 @@
+/** Filter that selects a subset of tiles when reading InterOp records
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "interop/model/metric_base/base_metric.h"
+
+namespace illumina { namespace interop { namespace model { namespace metric_base
+{
+    /** Sorted set of tile hashes used to skip records for tiles that are not of interest
+     *
+     * The reader checks each record id against this filter before decoding the record. Records
+     * for rejected tiles are skipped in place, so they are never added to the metric set.
+     *
+     * @see base_metric::tile_hash
+     */
+    class tile_filter
+    {
+    public:
+        /** Unique lane/tile id type */
+        typedef base_metric::id_t id_t;
+        /** Vector of tile hashes */
+        typedef std::vector<id_t> id_vector_t;
+        /** Constant iterator over tile hashes */
+        typedef id_vector_t::const_iterator const_iterator;
+
+    public:
+        /** Constructor
+         */
+        tile_filter(){}
+
+    public:
+        /** Add a tile to the filter
+         *
+         * @param lane lane number
+         * @param tile tile number
+         */
+        void insert(const id_t lane, const id_t tile)
+        {
+            insert(base_metric::create_id(lane, tile));
+        }
+        /** Add a tile to the filter
+         *
+         * @param tile_hash unique lane/tile id
+         */
+        void insert(const id_t tile_hash)
+        {
+            id_vector_t::iterator it = std::lower_bound(m_tile_hashes.begin(), m_tile_hashes.end(), tile_hash);
+            if(it != m_tile_hashes.end() && *it == tile_hash) return;
+            m_tile_hashes.insert(it, tile_hash);
+        }
+        /** Test if records for the given tile should be read
+         *
+         * @param tile_hash unique lane/tile id (the cycle and read are ignored)
+         * @return true if the tile is part of the filter
+         */
+        bool accept(const id_t tile_hash)const
+        {
+            return std::binary_search(m_tile_hashes.begin(),
+                                      m_tile_hashes.end(),
+                                      base_metric::tile_hash_from_id(tile_hash));
+        }
+        /** Test if records for the given tile should be read
+         *
+         * @param lane lane number
+         * @param tile tile number
+         * @return true if the tile is part of the filter
+         */
+        bool accept(const id_t lane, const id_t tile)const
+        {
+            return accept(base_metric::create_id(lane, tile));
+        }
+        /** Count the number of tiles selected in the given lane
+         *
+         * @param lane lane number
+         * @return number of tiles
+         */
+        size_t tile_count(const id_t lane)const
+        {
+            const_iterator beg = std::lower_bound(m_tile_hashes.begin(),
+                                                  m_tile_hashes.end(),
+                                                  base_metric::create_id(lane, 0));
+            const_iterator end = std::lower_bound(beg, m_tile_hashes.end(), base_metric::create_id(lane+1, 0));
+            return static_cast<size_t>(std::distance(beg, end));
+        }
+        /** Get the number of tiles in the filter
+         *
+         * @return number of tiles
+         */
+        size_t size()const
+        {
+            return m_tile_hashes.size();
+        }
+        /** Test if the filter has no tiles
+         *
+         * @return true if no tile is selected
+         */
+        bool empty()const
+        {
+            return m_tile_hashes.empty();
+        }
+        /** Get iterator to first tile hash
+         *
+         * @return iterator to first tile hash
+         */
+        const_iterator begin()const
+        {
+            return m_tile_hashes.begin();
+        }
+        /** Get iterator to end of tile hashes
+         *
+         * @return iterator to end of tile hashes
+         */
+        const_iterator end()const
+        {
+            return m_tile_hashes.end();
+        }
+        /** Remove all tiles from the filter
+         */
+        void clear()
+        {
+            m_tile_hashes.clear();
+        }
+
+    private:
+        id_vector_t m_tile_hashes;
+    };
+
+}}}}
+
@@ -0,0 +1,295 @@
+/** Q-score histogram by tile and read
+ *
+ * The q-score histogram by tile and read holds the cumulative distribution of q-scores over all cycles of a
+ * read for a single tile.
+ *
+ *  @note This is not actually an InterOp written to disk, but is calculated from QMetricsOut.bin
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "interop/model/metrics/q_metric.h"
+#include "interop/model/metric_base/base_read_metric.h"
+#include "interop/model/metric_base/metric_set.h"
+#include "interop/io/layout/base_metric.h"
+#include "interop/io/format/generic_layout.h"
+
+namespace illumina { namespace interop { namespace model { namespace metrics
+{
+    /** Header information for a q-score histogram by tile and read set
+     */
+    class q_by_tile_read_header : public metric_base::base_read_metric_header
+    {
+    public:
+        /** Vector of q-scores type */
+        typedef q_score_header::qscore_bin_vector_type qscore_bin_vector_type;
+        /** Q-score bin type */
+        typedef q_score_bin bin_t;
+    public:
+        /** Constructor
+         */
+        q_by_tile_read_header()
+        { }
+
+        /** Constructor
+         *
+         * @param bins q-score bin vector
+         */
+        q_by_tile_read_header(const qscore_bin_vector_type &bins) :
+                m_qscore_bins(bins)
+        { }
+
+    public:
+        /** Get the q-score bins
+         *
+         * @return vector of q-score bins
+         */
+        const qscore_bin_vector_type &get_bins() const
+        {
+            return m_qscore_bins;
+        }
+        /** Get the number of bins in header
+         *
+         * @return number of bins in header
+         */
+        size_t bin_count() const
+        { return m_qscore_bins.size(); }
+        /** Get the index for the given q-value
+         *
+         * @param qval q-value
+         * @return index of the first bin with a value greater than or equal to the q-value
+         */
+        size_t index_for_q_value(const size_t qval) const
+        {
+            if (m_qscore_bins.size() == 0) return qval > 0 ? qval - 1 : 0;
+            size_t index = 0;
+            while (index < m_qscore_bins.size() && m_qscore_bins[index].value() < qval) index++;
+            return index;
+        }
+        /** Get the q-value for the given index
+         *
+         * @param index index of a bin in the histogram
+         * @return q-value
+         */
+        size_t q_value_for_index(const size_t index) const
+        {
+            if (m_qscore_bins.size() == 0) return index + 1;
+            INTEROP_ASSERT(index < m_qscore_bins.size());
+            return m_qscore_bins[index].value();
+        }
+        /** Generate a default header
+         *
+         * @return default header
+         */
+        static q_by_tile_read_header default_header()
+        {
+            return q_by_tile_read_header();
+        }
+        /** Clear the data
+         */
+        void clear()
+        {
+            m_qscore_bins.clear();
+        }
+
+    private:
+        qscore_bin_vector_type m_qscore_bins;
+    };
+
+    /** Q-score histogram by tile and read
+     *
+     * The histogram is stored as a prefix sum over the q-score bins, so the number of clusters at or above any
+     * q-score, or the q-score at any quantile, is a single lookup (or a search over at most 50 bins) rather than
+     * a pass over every cycle of the read.
+     *
+     * @note This is not actually an InterOp written to disk, but is calculated from QMetricsOut.bin
+     * @note Supported versions: 1
+     */
+    class q_by_tile_read_metric : public metric_base::base_read_metric
+    {
+    public:
+        enum
+        {
+            /** Unique type code for metric */
+            TYPE = constants::QByTileRead,
+            /** Latest version of the InterOp format */
+            LATEST_VERSION = 1
+        };
+        /** Q-score histogram by tile and read header */
+        typedef q_by_tile_read_header header_type;
+        /** Vector of 64-bit counts */
+        typedef std::vector< ::uint64_t > uint64_vector;
+        /** Vector of q-score bins */
+        typedef header_type::qscore_bin_vector_type qscore_bin_vector_type;
+    public:
+        /** Constructor
+         */
+        q_by_tile_read_metric() :
+                metric_base::base_read_metric(0, 0, 0)
+        {
+        }
+        /** Constructor
+         */
+        q_by_tile_read_metric(const header_type&) :
+                metric_base::base_read_metric(0, 0, 0)
+        {
+        }
+
+        /** Constructor
+         *
+         * @param lane lane number
+         * @param tile tile number
+         * @param read read number
+         * @param qscore_hist q-score histogram summed over all cycles of the read
+         */
+        q_by_tile_read_metric(const uint_t lane,
+                              const uint_t tile,
+                              const uint_t read,
+                              const uint64_vector& qscore_hist) :
+                metric_base::base_read_metric(lane, tile, read),
+                m_qscore_hist_prefix(qscore_hist)
+        {
+            for (size_t i = 1; i < m_qscore_hist_prefix.size(); ++i)
+                m_qscore_hist_prefix[i] += m_qscore_hist_prefix[i-1];
+        }
+
+    public:
+        /** @defgroup q_by_tile_read_metric Q-score Histogram By Tile and Read
+         *
+         * Per tile per read q-score histogram
+         *
+         * @ref illumina::interop::model::metrics::q_by_tile_read_metric "See full class description"
+         *
+         * @ingroup run_metrics
+         * @note All metrics in this class are supported by all versions
+         * @{
+         */
+        /** Number of bins in the histogram
+         *
+         * @return number of bins
+         */
+        size_t size() const
+        {
+            return m_qscore_hist_prefix.size();
+        }
+        /** Total number of clusters over all bins
+         *
+         * @return total number of clusters
+         */
+        ::uint64_t sum_qscore() const
+        {
+            return m_qscore_hist_prefix.empty() ? 0 : m_qscore_hist_prefix.back();
+        }
+        /** Number of clusters in the given bin
+         *
+         * @param qscore_index index of the q-score bin
+         * @return number of clusters in the bin
+         */
+        ::uint64_t qscore_hist(const size_t qscore_index) const INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            INTEROP_BOUNDS_CHECK(qscore_index, m_qscore_hist_prefix.size(), "Index out of bounds");
+            return qscore_index == 0 ? m_qscore_hist_prefix[0] :
+                   m_qscore_hist_prefix[qscore_index] - m_qscore_hist_prefix[qscore_index-1];
+        }
+        /** Number of clusters at or above the given q-score
+         *
+         * This function takes an index corresponding to the q-value of interest. This index is provided by
+         * `index_for_q_value` in the metric header.
+         *
+         * @param qscore_index index of the q-score (for unbinned 29 is Q30)
+         * @return number of clusters at or above the given q-score
+         */
+        ::uint64_t total_over_qscore(const size_t qscore_index) const
+        {
+            if (qscore_index >= m_qscore_hist_prefix.size()) return 0;
+            if (qscore_index == 0) return sum_qscore();
+            return sum_qscore() - m_qscore_hist_prefix[qscore_index-1];
+        }
+        /** Percent of clusters at or above the given q-score
+         *
+         * This function takes an index corresponding to the q-value of interest. This index is provided by
+         * `index_for_q_value` in the metric header.
+         *
+         * @param qscore_index index of the q-score (for unbinned 29 is Q30)
+         * @return percent of clusters at or above the given q-score
+         */
+        float percent_over_qscore(const size_t qscore_index) const
+        {
+            const ::uint64_t total = sum_qscore();
+            if (total == 0) return std::numeric_limits<float>::quiet_NaN();
+            return 100.0f * static_cast<float>(total_over_qscore(qscore_index)) / static_cast<float>(total);
+        }
+        /** Index of the bin holding the given quantile
+         *
+         * @param fraction quantile as a fraction between 0 and 1 (0.5 is the median)
+         * @return index of the bin holding the quantile or the number of bins if the histogram is empty
+         */
+        size_t quantile_index(const double fraction) const
+        {
+            const ::uint64_t total = sum_qscore();
+            if (total == 0) return m_qscore_hist_prefix.size();
+            const double clamped = std::min(std::max(fraction, 0.0), 1.0);
+            ::uint64_t position = static_cast< ::uint64_t >(std::ceil(clamped * static_cast<double>(total)));
+            if (position == 0) position = 1;
+            return static_cast<size_t>(std::lower_bound(m_qscore_hist_prefix.begin(),
+                                                        m_qscore_hist_prefix.end(),
+                                                        position) - m_qscore_hist_prefix.begin());
+        }
+        /** Q-score at the given quantile
+         *
+         * If the quantile cannot be found, return the maximum integer.
+         *
+         * @param fraction quantile as a fraction between 0 and 1 (0.5 is the median)
+         * @param bins header bins (empty for unbinned histograms)
+         * @return q-score at the quantile
+         */
+        uint_t quantile(const double fraction, const qscore_bin_vector_type &bins = qscore_bin_vector_type()) const
+        {
+            const size_t index = quantile_index(fraction);
+            if (index >= m_qscore_hist_prefix.size()) return std::numeric_limits<uint_t>::max();
+            if (bins.empty()) return static_cast<uint_t>(index + 1);
+            if (index < bins.size()) return bins[index].value();
+            return std::numeric_limits<uint_t>::max();
+        }
+        /** Get the median q-score
+         *
+         * @param bins header bins (empty for unbinned histograms)
+         * @return median q-score
+         */
+        uint_t median(const qscore_bin_vector_type &bins = qscore_bin_vector_type()) const
+        {
+            return quantile(0.5, bins);
+        }
+        /** Prefix sum of the histogram over the q-score bins
+         *
+         * @return prefix sum of the histogram
+         */
+        const uint64_vector& qscore_hist_prefix() const
+        {
+            return m_qscore_hist_prefix;
+        }
+        /** @} */
+
+    public:
+        /** Get the prefix of the InterOp filename
+         *
+         * @return "QByTileRead"
+         */
+        static const char *prefix()
+        { return "QByTileRead"; }
+
+    private:
+        uint64_vector m_qscore_hist_prefix;
+        template<class MetricType, int Version>
+        friend
+        struct io::generic_layout;
+    };
+}}}}
+
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 #include <numeric>
 #include "interop/util/exception.h"
@@ -117,7 +118,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     public:
         /** Constructor
          */
-        q_score_header()
+        q_score_header() : m_nonzero_columns(0), m_tracked_record_count(0)
         { }
 
         /** Constructor
@@ -125,7 +126,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * @param bins q-score bin vector
          */
         q_score_header(const qscore_bin_vector_type &bins) :
-                m_qscore_bins(bins)
+                m_qscore_bins(bins), m_nonzero_columns(0), m_tracked_record_count(0)
         { }
 
         /** @defgroup q_score_header Quality Metric Header
@@ -191,6 +192,49 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             return index;
         }
         /** @} */
+        /** Test if the decoder tracked every record in the metric set
+         *
+         * The non-zero columns are only known for records decoded from an InterOp file. If records were inserted
+         * directly, or a record was decoded more than once, this returns false and the histograms must be scanned.
+         *
+         * @param record_count number of records in the metric set
+         * @return true if the non-zero column summary covers every record
+         */
+        bool is_tracked(const size_t record_count) const
+        {
+            return record_count > 0 && m_tracked_record_count == record_count;
+        }
+        /** Get the number of histogram columns with a non-zero count in any decoded record
+         *
+         * @return number of non-zero columns
+         */
+        size_t nonzero_column_count() const
+        {
+            size_t count = 0;
+            for (::uint64_t columns = m_nonzero_columns; columns != 0; columns &= columns - 1) ++count;
+            return count;
+        }
+        /** Record the non-zero columns of a decoded histogram
+         *
+         * @note This is called by the record decoder for every record inserted into the metric set
+         * @param histogram decoded q-score histogram
+         */
+        void track_histogram(const std::vector< ::uint32_t >& histogram)
+        {
+            const size_t column_count = std::min(histogram.size(), static_cast<size_t>(MAX_Q_BINS));
+            for (size_t i = 0; i < column_count; ++i)
+                if (histogram[i] > 0) m_nonzero_columns |= (::uint64_t(1) << i);
+            ++m_tracked_record_count;
+        }
+        /** Forget the non-zero columns recorded by the decoder
+         *
+         * @note This is called when the histograms are compressed, since the tracked columns no longer match them
+         */
+        void clear_tracking()
+        {
+            m_nonzero_columns = 0;
+            m_tracked_record_count = 0;
+        }
         /** Get the number of bins in header
          *
          * @deprecated Will be removed in 1.1.x (use bin_count instead)
@@ -223,12 +267,18 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         void clear()
         {
             m_qscore_bins.clear();
+            m_nonzero_columns = 0;
+            m_tracked_record_count = 0;
             metric_base::base_cycle_metric::header_type::clear();
         }
 
     protected:
         /** Q-score bins */
         qscore_bin_vector_type m_qscore_bins;
+        /** Bit mask of histogram columns with a non-zero count in any decoded record */
+        ::uint64_t m_nonzero_columns;
+        /** Number of records passed to track_histogram */
+        size_t m_tracked_record_count;
     private:
         template<class MetricType, int Version>
         friend
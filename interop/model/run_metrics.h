@@ -10,9 +10,12 @@
 #include "interop/util/exception.h"
 #include "interop/util/object_list.h"
 #include "interop/model/metric_base/metric_set.h"
+#include "interop/model/metric_base/tile_filter.h"
 #include "interop/model/model_exceptions.h"
 #include "interop/io/stream_exceptions.h"
 #include "interop/io/metric_file_stream.h"
+#include "interop/io/load_scheduler.h"
+#include "interop/io/load_planner.h"
 #include "interop/model/run/info.h"
 #include "interop/model/run/parameters.h"
 
@@ -27,6 +30,7 @@
 #include "interop/model/metrics/phasing_metric.h"
 #include "interop/model/metrics/q_metric.h"
 #include "interop/model/metrics/q_by_lane_metric.h"
+#include "interop/model/metrics/q_by_tile_read_metric.h"
 #include "interop/model/metrics/q_collapsed_metric.h"
 #include "interop/model/metrics/tile_metric.h"
 
@@ -47,6 +51,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      * @see q_metrics
      * @see tile_metrics
      * @see q_by_lane_metric
+     * @see q_by_tile_read_metric
      * @see q_collapsed_metric
      */
     class run_metrics
@@ -64,6 +69,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
                 phasing_metric,
                 q_metric,
                 q_by_lane_metric,
+                q_by_tile_read_metric,
                 q_collapsed_metric,
                 tile_metric
         >::result_t metric_type_list_t;
@@ -92,7 +98,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     public:
         /** Constructor
          */
-        run_metrics()
+        run_metrics() : m_has_derived_metrics(false)
         {
         }
 
@@ -103,7 +109,8 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          */
         run_metrics(const run::info &run_info, const run::parameters &run_param = run::parameters()) :
                 m_run_info(run_info),
-                m_run_parameters(run_param)
+                m_run_parameters(run_param),
+                m_has_derived_metrics(false)
         {
         }
 
@@ -165,6 +172,64 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         model::invalid_run_info_exception,
         model::invalid_run_info_cycle_exception,
         model::invalid_parameter));
+        /** Read binary metrics and XML files from the run folder using a shared load scheduler
+         *
+         * Each metric group is queued as a separate task, so concurrent loads from other runs in the same process
+         * share threads and file handles according to their priority.
+         *
+         * @note invalid_run_info_cycle_exception and invalid_tile_list_exception can be safely caught and ignored
+         *
+         * @param run_folder run folder path
+         * @param scheduler shared load scheduler
+         * @param priority priority class of this load
+         * @param thread_count number of threads this load contributes to the scheduler
+         */
+        void read(const std::string &run_folder,
+                  io::load_scheduler& scheduler,
+                  const io::load_scheduler::priority_t priority,
+                  const size_t thread_count=1)
+        INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+        xml::bad_xml_format_exception,
+        xml::empty_xml_format_exception,
+        xml::missing_xml_element_exception,
+        xml::xml_parse_exception,
+        io::file_not_found_exception,
+        io::bad_format_exception,
+        io::incomplete_file_exception,
+        model::invalid_channel_exception,
+        model::index_out_of_bounds_exception,
+        model::invalid_tile_naming_method,
+        model::invalid_tile_list_exception,
+        model::invalid_run_info_exception,
+        model::invalid_run_info_cycle_exception,
+        model::invalid_parameter));
+        /** Read binary metrics and XML files from the run folder following a load plan
+         *
+         * The planner chooses the number of threads and the decode path of each group from the size of the
+         * files, the storage holding the run folder and the number of cores.
+         *
+         * @note invalid_run_info_cycle_exception and invalid_tile_list_exception can be safely caught and ignored
+         *
+         * @param run_folder run folder path
+         * @param planner load planner
+         * @return plan that was executed
+         */
+        io::load_plan read(const std::string &run_folder, const io::load_planner& planner)
+        INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+        xml::bad_xml_format_exception,
+        xml::empty_xml_format_exception,
+        xml::missing_xml_element_exception,
+        xml::xml_parse_exception,
+        io::file_not_found_exception,
+        io::bad_format_exception,
+        io::incomplete_file_exception,
+        model::invalid_channel_exception,
+        model::index_out_of_bounds_exception,
+        model::invalid_tile_naming_method,
+        model::invalid_tile_list_exception,
+        model::invalid_run_info_exception,
+        model::invalid_run_info_cycle_exception,
+        model::invalid_parameter));
 
         /** Read XML files: RunInfo.xml and possibly RunParameters.xml
          *
@@ -212,6 +277,15 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         model::invalid_run_info_exception,
         model::invalid_run_info_cycle_exception,
         model::invalid_parameter));
+        /** Create the metric sets derived from the loaded metrics that are still missing
+         *
+         * The plot, summary and table logic take a constant run and call this function before reading any metric
+         * set, so one loaded run can be queried from many threads at once. Missing derived sets are created at most
+         * once, under a lock, and the run records that they were created, even when a set, such as dynamic phasing
+         * for a short run, is left empty. After `finalize_after_load`, this function only checks that record. Loading
+         * metrics or taking a mutable reference to a metric set clears it.
+         */
+        void ensure_derived_metrics()const;
 
         /** Test if all metrics are empty
          *
@@ -317,16 +391,20 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         void set(const T& metrics)
         {
             //static_assert( )
+            m_has_derived_metrics = false;
             m_metrics.get< T >() = metrics;
         }
         /** Get a metric set
          *
+         * @note The metric set may be changed through the reference, so missing derived sets are checked again by the
+         * next call to ensure_derived_metrics
          * @return metric set
          */
         template<class T>
         typename metric_base::metric_set_helper<T>::metric_set_t &get()
         {
             typedef typename metric_base::metric_set_helper<T>::metric_set_t metric_set_t;
+            m_has_derived_metrics = false;
             return m_metrics.get< metric_set_t >();
         }
 
@@ -349,6 +427,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         template<class T>
         metric_base::metric_set<T> &get_metric_set()
         {
+            m_has_derived_metrics = false;
             return m_metrics.get<metric_base::metric_set<T> >();
         }
 
@@ -400,22 +479,83 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * @param valid_to_load boolean vector indicating which files to load
          * @param thread_count number of threads to use for network loading
          * @param skip_loaded skip metrics that are already loaded
+         * @param filter optional filter that selects the tiles to read (null reads all tiles)
          */
         void read_metrics(const std::string &run_folder,
                           const size_t last_cycle,
                           const std::vector<unsigned char>& valid_to_load,
                           const size_t thread_count,
+                          const bool skip_loaded=false,
+                          const metric_base::tile_filter* filter=0) INTEROP_THROW_SPEC((
+        io::file_not_found_exception,
+        io::bad_format_exception,
+        io::incomplete_file_exception,
+        model::invalid_parameter));
+        /** Read binary metrics from the run folder using a shared load scheduler
+         *
+         * This function ignores:
+         *  - Missing InterOp files
+         *  - Incomplete InterOp files
+         *  - Missing RunParameters.xml for non-legacy run folders
+         *
+         * @param run_folder run folder path
+         * @param last_cycle last cycle of run
+         * @param valid_to_load boolean vector indicating which files to load
+         * @param scheduler shared load scheduler
+         * @param priority priority class of this load
+         * @param thread_count number of threads this load contributes to the scheduler
+         * @param skip_loaded skip metrics that are already loaded
+         */
+        void read_metrics(const std::string &run_folder,
+                          const size_t last_cycle,
+                          const std::vector<unsigned char>& valid_to_load,
+                          io::load_scheduler& scheduler,
+                          const io::load_scheduler::priority_t priority,
+                          const size_t thread_count=1,
                           const bool skip_loaded=false) INTEROP_THROW_SPEC((
         io::file_not_found_exception,
         io::bad_format_exception,
         io::incomplete_file_exception,
         model::invalid_parameter));
+        /** Plan how to load the binary metrics of a run folder
+         *
+         * Only the file sizes and the record size in each header are read.
+         *
+         * @param run_folder run folder path
+         * @param last_cycle last cycle to search for by cycle interops
+         * @param planner load planner
+         * @return plan for each metric group
+         */
+        io::load_plan plan_load(const std::string &run_folder,
+                                const size_t last_cycle,
+                                const io::load_planner& planner=io::load_planner())const;
+        /** Read binary metrics from the run folder following a load plan
+         *
+         * This function ignores:
+         *  - Missing InterOp files
+         *  - Incomplete InterOp files
+         *
+         * @param run_folder run folder path
+         * @param last_cycle last cycle to search for by cycle interops
+         * @param plan load plan from plan_load
+         */
+        void read_metrics(const std::string &run_folder,
+                          const size_t last_cycle,
+                          const io::load_plan& plan) INTEROP_THROW_SPEC((
+        io::file_not_found_exception,
+        io::bad_format_exception,
+        io::incomplete_file_exception));
         /** Write binary metrics to the run folder
+         *
+         * Each InterOp file is replaced atomically, so a crash never leaves a partially written file.
          *
          * @param run_folder run folder path
          * @param use_out use the copied version
+         * @param thread_count number of threads to use for writing
          */
-        void write_metrics(const std::string &run_folder, const bool use_out=true)const INTEROP_THROW_SPEC((
+        void write_metrics(const std::string &run_folder,
+                           const bool use_out=true,
+                           const size_t thread_count=1)const INTEROP_THROW_SPEC((
         io::file_not_found_exception,
         io::bad_format_exception));
 
@@ -479,6 +619,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         template<class Func>
         void metrics_callback(Func &func)
         {
+            m_has_derived_metrics = false;
             m_metrics.apply(func);
         }
         /** Read binary metrics from the run folder
@@ -488,7 +629,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         template<class Func>
         void metrics_callback(Func &func)const
         {
-            m_metrics.apply(func);
+            static_cast<const metric_list_t&>(m_metrics).apply(func);
         }
         /** Check if the metric group is empty
          *
@@ -502,6 +643,41 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * @return true if metric is empty
          */
         bool is_group_empty(const constants::metric_group group_id) const;
+        /** Enable or disable change tracking in every metric set
+         *
+         * @see metric_set::track_changes
+         * @param enable true to stamp inserted and updated records
+         */
+        void track_changes(const bool enable);
+        /** Enable or disable retaining the allocated capacity of every metric set when the run is cleared
+         *
+         * Every read clears the metric sets first, so a monitor that reloads the same run reuses the records of
+         * the previous load.
+         *
+         * @see metric_set::retain_capacity
+         * @param enable true to keep the allocated capacity when the run is cleared
+         */
+        void retain_capacity(const bool enable);
+        /** Get the current generation of a metric group
+         *
+         * Save the generation as a cursor before polling, then pass it to changed_since to get the ids of the
+         * records read since.
+         *
+         * @param group_id id of interop group metric
+         * @return current generation of the group, 0 if the group is not found
+         */
+        ::uint64_t generation(const constants::metric_group group_id) const;
+        /** Get the ids of the records of a metric group changed since a generation
+         *
+         * If change tracking is disabled, every id of the group is reported.
+         *
+         * @param group_id id of interop group metric
+         * @param generation generation saved by the consumer
+         * @param ids destination ids of the records stamped after the given generation
+         */
+        void changed_since(const constants::metric_group group_id,
+                           const ::uint64_t generation,
+                           std::vector< ::uint64_t >& ids) const;
 
         /** Populate a map of valid tiles
          *
@@ -523,9 +699,19 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          void clear();
 
     private:
-        metric_list_t m_metrics;
+        /** Create the derived metric sets that are missing
+         *
+         * @see ensure_derived_metrics
+         */
+        void create_missing_derived_metrics()const;
+
+    private:
+        // Mutable only so ensure_derived_metrics can fill the derived sets, a cache of the loaded metrics
+        mutable metric_list_t m_metrics;
         run::info m_run_info;
         run::parameters m_run_parameters;
+        // Set once the derived sets were created for the loaded metrics, even if some of them are empty
+        mutable bool m_has_derived_metrics;
 
     };
 
@@ -0,0 +1,293 @@
+/** Summary statistics over entire run stored as flat columns
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "interop/util/exception.h"
+#include "interop/model/model_exceptions.h"
+#include "interop/model/summary/metric_stat.h"
+
+namespace illumina { namespace interop { namespace model { namespace summary
+{
+    /** Summary statistics over entire run stored as flat columns
+     *
+     * This holds the same statistics as the read/lane/surface levels of run_summary, but as one contiguous block of
+     * floats. Each column holds one statistic, for example the median of the cluster density, and has one row for
+     * each (read, lane, surface) in the summary. Surface 0 holds the statistics for the whole lane and surfaces
+     * 1 to surface_count() hold the statistics for each surface. Rows without a value are NaN.
+     *
+     * The columns are stored one after the other, so the whole summary is copied to a NumPy or C# array in a single
+     * call with copy_values, rather than walking the summary tree node by node.
+     */
+    class columnar_summary
+    {
+    public:
+        /** Statistics stored as mean, standard deviation and median */
+        enum stat_column
+        {
+            Density,
+            DensityPf,
+            ClusterCount,
+            ClusterCountPf,
+            PercentPf,
+            Phasing,
+            Prephasing,
+            PercentAligned,
+            ErrorRate,
+            ErrorRate35,
+            ErrorRate50,
+            ErrorRate75,
+            ErrorRate100,
+            FirstCycleIntensity,
+            PhasingSlope,
+            PhasingOffset,
+            PrephasingSlope,
+            PrephasingOffset,
+            StatColumnCount
+        };
+        /** Statistics stored as a single value */
+        enum value_column
+        {
+            PercentGtQ30,
+            YieldG,
+            ProjectedYieldG,
+            Reads,
+            ReadsPf,
+            TileCount,
+            ValueColumnCount
+        };
+        /** Statistic of a stat_column */
+        enum statistic
+        {
+            Mean,
+            StdDev,
+            Median,
+            StatisticCount
+        };
+
+    public:
+        /** Constructor
+         */
+        columnar_summary() : m_read_count(0), m_lane_count(0), m_surface_count(0)
+        {
+        }
+
+    public:
+        /** Resize the columns, setting every value to NaN
+         *
+         * @param read_count number of reads
+         * @param lane_count number of lanes
+         * @param surface_count number of surfaces
+         */
+        void resize(const size_t read_count, const size_t lane_count, const size_t surface_count)
+        {
+            m_read_count = read_count;
+            m_lane_count = lane_count;
+            m_surface_count = surface_count;
+            m_values.assign(row_count() * column_count(), std::numeric_limits<float>::quiet_NaN());
+        }
+        /** Clear the columns
+         */
+        void clear()
+        {
+            m_read_count = 0;
+            m_lane_count = 0;
+            m_surface_count = 0;
+            m_values.clear();
+        }
+
+    public:
+        /** @defgroup columnar_summary Columnar summary
+         *
+         * Summary statistics for each read/lane/surface stored as flat columns
+         *
+         * @ingroup run_summary
+         * @ref illumina::interop::model::summary::columnar_summary "See full class description"
+         * @{
+         */
+        /** Get number of reads
+         *
+         * @return number of reads
+         */
+        size_t read_count() const
+        {
+            return m_read_count;
+        }
+        /** Get number of lanes
+         *
+         * @return number of lanes
+         */
+        size_t lane_count() const
+        {
+            return m_lane_count;
+        }
+        /** Get number of surfaces
+         *
+         * @return number of surfaces
+         */
+        size_t surface_count() const
+        {
+            return m_surface_count;
+        }
+        /** Get number of rows in each column
+         *
+         * @return number of rows
+         */
+        size_t row_count() const
+        {
+            return m_read_count * m_lane_count * (m_surface_count + 1);
+        }
+        /** Get number of columns
+         *
+         * @return number of columns
+         */
+        static size_t column_count()
+        {
+            return StatColumnCount * StatisticCount + ValueColumnCount;
+        }
+        /** Get total number of values in all columns
+         *
+         * @return number of values
+         */
+        size_t size() const
+        {
+            return m_values.size();
+        }
+        /** Get the row of a read, lane and surface
+         *
+         * @param read index of the read
+         * @param lane index of the lane
+         * @param surface surface number, or 0 for the whole lane
+         * @return row index
+         */
+        size_t row(const size_t read, const size_t lane, const size_t surface=0) const
+        INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            INTEROP_BOUNDS_CHECK(read, m_read_count, "Read index exceeds read count");
+            INTEROP_BOUNDS_CHECK(lane, m_lane_count, "Lane index exceeds lane count");
+            INTEROP_BOUNDS_CHECK(surface, m_surface_count+1, "Surface exceeds surface count");
+            return (read * m_lane_count + lane) * (m_surface_count + 1) + surface;
+        }
+        /** Get the column holding a statistic of a stat column
+         *
+         * @param col stat column
+         * @param stat statistic
+         * @return column index
+         */
+        static size_t column(const stat_column col, const statistic stat)
+        {
+            return static_cast<size_t>(col) * StatisticCount + static_cast<size_t>(stat);
+        }
+        /** Get the column holding a value column
+         *
+         * @param col value column
+         * @return column index
+         */
+        static size_t column(const value_column col)
+        {
+            return StatColumnCount * StatisticCount + static_cast<size_t>(col);
+        }
+        /** Get the value at a column and row
+         *
+         * @param col column index
+         * @param row_index row index
+         * @return value
+         */
+        float at(const size_t col, const size_t row_index) const
+        INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            INTEROP_BOUNDS_CHECK(col, column_count(), "Column index exceeds column count");
+            INTEROP_BOUNDS_CHECK(row_index, row_count(), "Row index exceeds row count");
+            return m_values[col * row_count() + row_index];
+        }
+        /** Get a stat column at a row as a metric_stat
+         *
+         * @param col stat column
+         * @param row_index row index
+         * @return mean, standard deviation and median
+         */
+        metric_stat stat(const stat_column col, const size_t row_index) const
+        INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            return metric_stat(at(column(col, Mean), row_index),
+                               at(column(col, StdDev), row_index),
+                               at(column(col, Median), row_index));
+        }
+        /** Get pointer to the first row of a column
+         *
+         * @param col column index
+         * @return pointer to row_count() contiguous values
+         */
+        const float* column_data(const size_t col) const
+        INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            INTEROP_BOUNDS_CHECK(col, column_count(), "Column index exceeds column count");
+            return m_values.empty() ? 0 : &m_values[col * row_count()];
+        }
+        /** Get all values, column by column
+         *
+         * @return values
+         */
+        const std::vector<float>& values() const
+        {
+            return m_values;
+        }
+        /** Copy all values, column by column, to an array
+         *
+         * @param buffer destination array
+         * @param buffer_size size of the destination array
+         */
+        void copy_values(float* buffer, size_t buffer_size) const
+        INTEROP_THROW_SPEC((model::invalid_parameter))
+        {
+            if(buffer_size < m_values.size())
+                INTEROP_THROW(model::invalid_parameter, "Buffer size too small for summary: "
+                        << buffer_size << " < " << m_values.size());
+            std::copy(m_values.begin(), m_values.end(), buffer);
+        }
+        /** @} */
+
+    public:
+        /** Set the value at a column and row
+         *
+         * @param col column index
+         * @param row_index row index
+         * @param value value
+         */
+        void set(const size_t col, const size_t row_index, const float value)
+        INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            INTEROP_BOUNDS_CHECK(col, column_count(), "Column index exceeds column count");
+            INTEROP_BOUNDS_CHECK(row_index, row_count(), "Row index exceeds row count");
+            m_values[col * row_count() + row_index] = value;
+        }
+        /** Set a stat column at a row from a metric_stat
+         *
+         * @param col stat column
+         * @param row_index row index
+         * @param stat mean, standard deviation and median
+         */
+        void set(const stat_column col, const size_t row_index, const metric_stat& stat)
+        INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            set(column(col, Mean), row_index, stat.mean());
+            set(column(col, StdDev), row_index, stat.stddev());
+            set(column(col, Median), row_index, stat.median());
+        }
+
+    private:
+        size_t m_read_count;
+        size_t m_lane_count;
+        size_t m_surface_count;
+        std::vector<float> m_values;
+    };
+
+}}}}
+
@@ -0,0 +1,309 @@
+/** Sampling statistics for a summary computed over a subset of tiles
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include "interop/util/assert.h"
+#include "interop/model/model_exceptions.h"
+#include "interop/model/summary/metric_stat.h"
+
+namespace illumina { namespace interop { namespace model { namespace summary
+{
+    /** Describes the tile sample drawn from a single lane
+     *
+     * The standard deviations reported in the lane summary are between tiles. When only a subset of tiles is
+     * summarized, the standard error of each lane mean is the between tile standard deviation scaled by the
+     * finite population correction.
+     */
+    class lane_sampling_summary
+    {
+    public:
+        /** Constructor
+         *
+         * @param lane lane number
+         * @param total_tile_count number of tiles in the lane
+         * @param sampled_tile_count number of tiles sampled from the lane
+         */
+        lane_sampling_summary(const size_t lane=0, const size_t total_tile_count=0, const size_t sampled_tile_count=0) :
+                m_lane(lane),
+                m_total_tile_count(total_tile_count),
+                m_sampled_tile_count(sampled_tile_count)
+        {
+        }
+
+    public:
+        /** @defgroup lane_sampling_summary Lane sampling summary
+         *
+         * Tile sample statistics for a lane
+         *
+         * @ingroup summary
+         * @ref illumina::interop::model::summary::lane_sampling_summary "See full class description"
+         * @{
+         */
+        /** Get the lane number
+         *
+         * @return lane number
+         */
+        size_t lane()const
+        {
+            return m_lane;
+        }
+        /** Get the number of tiles in the lane
+         *
+         * @return number of tiles in the lane
+         */
+        size_t total_tile_count()const
+        {
+            return m_total_tile_count;
+        }
+        /** Get the number of tiles sampled from the lane
+         *
+         * @return number of tiles sampled
+         */
+        size_t sampled_tile_count()const
+        {
+            return m_sampled_tile_count;
+        }
+        /** Get the number of tiles on a surface of the lane
+         *
+         * @param surface surface number
+         * @return number of tiles on the surface, 0 if unknown
+         */
+        size_t surface_total_tile_count(const size_t surface)const
+        {
+            if(surface == 0 || surface > m_surface_total_tile_counts.size()) return 0;
+            return m_surface_total_tile_counts[surface-1];
+        }
+        /** Get the factor that scales a total sampled from a surface to the whole surface
+         *
+         * If the number of tiles on the surface is unknown, the lane factor is used.
+         *
+         * @param surface surface number
+         * @param sampled_tile_count number of tiles summarized on the surface
+         * @return total surface tile count / sampled surface tile count
+         */
+        float surface_scale(const size_t surface, const size_t sampled_tile_count)const
+        {
+            const size_t total = surface_total_tile_count(surface);
+            if(total == 0) return scale();
+            if(sampled_tile_count == 0) return std::numeric_limits<float>::quiet_NaN();
+            return static_cast<float>(total) / sampled_tile_count;
+        }
+        /** Get the factor that scales a sampled total to the whole lane
+         *
+         * @return total tile count / sampled tile count
+         */
+        float scale()const
+        {
+            if(m_sampled_tile_count == 0) return std::numeric_limits<float>::quiet_NaN();
+            return static_cast<float>(m_total_tile_count) / m_sampled_tile_count;
+        }
+        /** Get the finite population correction for sampling without replacement
+         *
+         * @return sqrt((N-n)/(N-1))
+         */
+        float finite_population_correction()const
+        {
+            if(m_sampled_tile_count >= m_total_tile_count) return 0;
+            return std::sqrt(static_cast<float>(m_total_tile_count-m_sampled_tile_count) /
+                             static_cast<float>(m_total_tile_count-1));
+        }
+        /** Estimate the standard error of a sampled lane mean
+         *
+         * @param stat statistic over the sampled tiles
+         * @return standard error of the mean, NaN if it cannot be estimated
+         */
+        float standard_error(const metric_stat& stat)const
+        {
+            if(m_sampled_tile_count >= m_total_tile_count) return 0;
+            if(m_sampled_tile_count < 2) return std::numeric_limits<float>::quiet_NaN();
+            return stat.stddev() / std::sqrt(static_cast<float>(m_sampled_tile_count)) *
+                   finite_population_correction();
+        }
+        /** @} */
+        /** Set the lane number
+         *
+         * @param val lane number
+         */
+        void lane(const size_t val)
+        {
+            m_lane = val;
+        }
+        /** Set the number of tiles in the lane
+         *
+         * @param val number of tiles in the lane
+         */
+        void total_tile_count(const size_t val)
+        {
+            m_total_tile_count = val;
+        }
+        /** Set the number of tiles sampled from the lane
+         *
+         * @param val number of tiles sampled
+         */
+        void sampled_tile_count(const size_t val)
+        {
+            m_sampled_tile_count = val;
+        }
+        /** Set the number of tiles on a surface of the lane
+         *
+         * @param surface surface number
+         * @param val number of tiles on the surface
+         */
+        void surface_total_tile_count(const size_t surface, const size_t val)
+        {
+            INTEROP_ASSERT(surface > 0);
+            if(surface > m_surface_total_tile_counts.size()) m_surface_total_tile_counts.resize(surface, 0);
+            m_surface_total_tile_counts[surface-1] = val;
+        }
+
+    private:
+        size_t m_lane;
+        size_t m_total_tile_count;
+        size_t m_sampled_tile_count;
+        std::vector<size_t> m_surface_total_tile_counts;
+    };
+
+    /** Sampling statistics for each lane of a run summary computed over a subset of tiles
+     */
+    class sampling_summary
+    {
+        /** Lane vector type */
+        typedef std::vector<lane_sampling_summary> lane_sampling_vector_t;
+    public:
+        /** Constant random access iterator to vector of lane_sampling_summary */
+        typedef lane_sampling_vector_t::const_iterator const_iterator;
+        /** Random access iterator to vector of lane_sampling_summary */
+        typedef lane_sampling_vector_t::iterator iterator;
+
+    public:
+        /** Constructor
+         *
+         * @param lane_count number of lanes
+         */
+        sampling_summary(const size_t lane_count=0) : m_lanes(lane_count)
+        {
+            for(size_t lane=0;lane<lane_count;++lane) m_lanes[lane].lane(lane+1);
+        }
+
+    public:
+        /** Get reference to lane_sampling_summary at given index
+         *
+         * @param n index
+         * @return reference to lane_sampling_summary
+         */
+        lane_sampling_summary& operator[](const size_t n) INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            INTEROP_BOUNDS_CHECK(n, m_lanes.size(), "Lane index exceeds lane count");
+            return m_lanes[n];
+        }
+        /** Get constant reference to lane_sampling_summary at given index
+         *
+         * @param n index
+         * @return constant reference to lane_sampling_summary
+         */
+        const lane_sampling_summary& operator[](const size_t n)const INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            INTEROP_BOUNDS_CHECK(n, m_lanes.size(), "Lane index exceeds lane count");
+            return m_lanes[n];
+        }
+        /** Get the sampling summary for the given lane number
+         *
+         * @param lane lane number
+         * @return constant reference to lane_sampling_summary
+         */
+        const lane_sampling_summary& for_lane(const size_t lane)const INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
+        {
+            for(const_iterator it = m_lanes.begin();it != m_lanes.end();++it)
+                if(it->lane() == lane) return *it;
+            INTEROP_THROW(model::index_out_of_bounds_exception, "Lane not found in sampling summary: " << lane);
+        }
+        /** Get number of lanes
+         *
+         * @return number of lanes
+         */
+        size_t size()const
+        {
+            return m_lanes.size();
+        }
+        /** Get number of tiles on the flowcell
+         *
+         * @return number of tiles
+         */
+        size_t total_tile_count()const
+        {
+            size_t total = 0;
+            for(const_iterator it = m_lanes.begin();it != m_lanes.end();++it) total += it->total_tile_count();
+            return total;
+        }
+        /** Get number of tiles sampled from the flowcell
+         *
+         * @return number of tiles sampled
+         */
+        size_t sampled_tile_count()const
+        {
+            size_t total = 0;
+            for(const_iterator it = m_lanes.begin();it != m_lanes.end();++it) total += it->sampled_tile_count();
+            return total;
+        }
+        /** Resize the number of lanes, lane numbers are assigned by index
+         *
+         * @param lane_count number of lanes
+         */
+        void resize(const size_t lane_count)
+        {
+            m_lanes.resize(lane_count);
+            for(size_t lane=0;lane<lane_count;++lane) m_lanes[lane].lane(lane+1);
+        }
+        /** Clear the sampling summary
+         */
+        void clear()
+        {
+            m_lanes.clear();
+        }
+        /** Get iterator to first lane
+         *
+         * @return iterator to first lane
+         */
+        iterator begin()
+        {
+            return m_lanes.begin();
+        }
+        /** Get iterator to end of lanes
+         *
+         * @return iterator to end of lanes
+         */
+        iterator end()
+        {
+            return m_lanes.end();
+        }
+        /** Get constant iterator to first lane
+         *
+         * @return constant iterator to first lane
+         */
+        const_iterator begin()const
+        {
+            return m_lanes.begin();
+        }
+        /** Get constant iterator to end of lanes
+         *
+         * @return constant iterator to end of lanes
+         */
+        const_iterator end()const
+        {
+            return m_lanes.end();
+        }
+
+    private:
+        lane_sampling_vector_t m_lanes;
+    };
+
+}}}}
+
@@ -69,6 +69,30 @@ namespace illumina { namespace interop { namespace io
      * @return size of the file or -1 if the operation failed
      */
     ::int64_t file_size(const std::string& path);
+    /** Flush the contents of a file to the storage device
+     *
+     * @param path path to the target file
+     * @return true if the file was flushed
+     */
+    bool sync_file(const std::string& path);
+    /** Flush the entries of a directory to the storage device
+     *
+     * This makes a file created or renamed in the directory durable. It does nothing on Windows, where a
+     * directory cannot be flushed.
+     *
+     * @param path path to the target directory, an empty path is the current directory
+     * @return true if the directory was flushed
+     */
+    bool sync_directory(const std::string& path);
+    /** Rename a file, replacing the destination if it exists
+     *
+     * On the same file system, the destination either refers to the old file or the new file, never a partial file.
+     *
+     * @param from path to the source file
+     * @param to path to the destination file
+     * @return true if the file was renamed
+     */
+    bool rename_file(const std::string& from, const std::string& to);
 }}}
 
 
@@ -0,0 +1,52 @@
+/** Hash a sequence of bytes
+ *
+ * The hash is 64-bit FNV-1a. It is fast and well distributed, but it is not a cryptographic hash.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include "interop/util/cstdint.h"
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Get the initial value of a hash
+     *
+     * @return hash of an empty sequence
+     */
+    inline ::uint64_t hash_seed()
+    {
+        return UINT64_C(14695981039346656037);
+    }
+    /** Add a sequence of bytes to a hash
+     *
+     * @param hash hash of the bytes before the sequence
+     * @param bytes pointer to the first byte
+     * @param count number of bytes
+     * @return hash of the bytes before and in the sequence
+     */
+    inline ::uint64_t hash_bytes(::uint64_t hash, const char* bytes, const size_t count)
+    {
+        for(size_t i=0;i<count;++i)
+        {
+            hash ^= static_cast< ::uint8_t>(bytes[i]);
+            hash *= UINT64_C(1099511628211);
+        }
+        return hash;
+    }
+    /** Add a value to a hash
+     *
+     * @param hash hash of the values before
+     * @param value value to add
+     * @return hash of the values before and the given value
+     */
+    inline ::uint64_t hash_combine(const ::uint64_t hash, const ::uint64_t value)
+    {
+        return hash_bytes(hash, reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+}}}
+
@@ -0,0 +1,69 @@
+/** Placement policy for large metric buffers
+ *
+ * A metric set with millions of records spans thousands of 4 KiB pages, so a scan over the set spends much of
+ * its time on TLB misses. When the policy is enabled, large buffers are advised to be backed by transparent huge
+ * pages. The policy is off by default and does nothing on platforms without transparent huge pages.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Process wide placement policy for large metric buffers
+     *
+     * Pages are placed on the NUMA node of the thread that first touches them. A metric set is reserved and filled
+     * by the thread that reads it, so when run metrics are read with several threads, each set lives on the node of
+     * the thread that read it. On a single node machine, this placement has no effect.
+     *
+     * @note The policy should be set before any metrics are loaded, it is not synchronized with loading threads
+     */
+    class memory_policy
+    {
+    public:
+        /** Enable or disable huge page advice for large buffers
+         *
+         * @param enable true to advise huge pages for large buffers
+         */
+        static void use_huge_pages(const bool enable);
+        /** Test if huge page advice is enabled
+         *
+         * @return true if huge page advice is enabled
+         */
+        static bool use_huge_pages();
+        /** Test if the platform supports huge page advice
+         *
+         * @return true if huge page advice is supported
+         */
+        static bool is_huge_page_supported();
+        /** Get the size of a huge page
+         *
+         * @return size of a huge page in bytes
+         */
+        static size_t huge_page_size();
+        /** Get the number of NUMA nodes on this machine
+         *
+         * @return number of NUMA nodes, 1 if unknown
+         */
+        static size_t numa_node_count();
+        /** Advise the kernel to back a large buffer with huge pages
+         *
+         * Only the huge page aligned interior of the buffer is advised. Buffers smaller than a huge page are left
+         * alone, as is every buffer when the policy is disabled.
+         *
+         * @param ptr pointer to the buffer
+         * @param byte_count size of the buffer in bytes
+         * @return true if the advice was given
+         */
+        static bool advise(const void* ptr, const size_t byte_count);
+
+    private:
+        static bool s_use_huge_pages;
+    };
+
+}}}
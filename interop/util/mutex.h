@@ -0,0 +1,107 @@
+/** Portable mutex and condition variable
+ *
+ * The library is built as C++98, so it cannot rely on std::mutex. These classes wrap the POSIX threads API on
+ * Unix-like platforms and the native API on Windows. On other platforms they do nothing, and the library is not
+ * thread safe.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+namespace illumina { namespace interop { namespace util
+{
+    class condition_variable;
+
+    /** Non-recursive mutual exclusion lock
+     */
+    class mutex
+    {
+        friend class condition_variable;
+    public:
+        /** Constructor
+         */
+        mutex();
+        /** Destructor
+         */
+        ~mutex();
+
+    public:
+        /** Acquire the lock, waiting until it is available
+         */
+        void lock();
+        /** Release the lock
+         */
+        void unlock();
+
+    private:
+        mutex(const mutex&);
+        mutex& operator=(const mutex&);
+
+    private:
+        void* m_handle;
+    };
+
+    /** Hold a mutex for the lifetime of the object
+     */
+    class scoped_lock
+    {
+    public:
+        /** Acquire the lock
+         *
+         * @param lock mutex to hold
+         */
+        explicit scoped_lock(mutex& lock) : m_lock(lock)
+        {
+            m_lock.lock();
+        }
+        /** Release the lock
+         */
+        ~scoped_lock()
+        {
+            m_lock.unlock();
+        }
+
+    private:
+        scoped_lock(const scoped_lock&);
+        scoped_lock& operator=(const scoped_lock&);
+
+    private:
+        mutex& m_lock;
+    };
+
+    /** Condition variable used with a util::mutex
+     */
+    class condition_variable
+    {
+    public:
+        /** Constructor
+         */
+        condition_variable();
+        /** Destructor
+         */
+        ~condition_variable();
+
+    public:
+        /** Release the lock and wait until notified, then acquire the lock again
+         *
+         * The wait may end without a notification, so the caller must check its condition in a loop.
+         *
+         * @param lock mutex held by the calling thread
+         */
+        void wait(mutex& lock);
+        /** Wake every thread waiting on the condition
+         */
+        void notify_all();
+
+    private:
+        condition_variable(const condition_variable&);
+        condition_variable& operator=(const condition_variable&);
+
+    private:
+        void* m_handle;
+    };
+}}}
+
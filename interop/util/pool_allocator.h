@@ -0,0 +1,208 @@
+/** Allocator that reuses the nodes freed by a container
+ *
+ * A node based container, such as a map, allocates one node for each element. When the container is cleared and
+ * filled again with about as many elements, each node is freed and allocated again. This allocator keeps the freed
+ * nodes in a pool shared by the copies of the allocator, and hands them back before asking the heap for memory.
+ *
+ * The pool only grows: it is freed with the last container using it. Copying a container gives the copy its own
+ * pool, so two containers never share a pool unless one is moved or swapped into the other.
+ *
+ * @note This allocator requires C++11
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <type_traits>
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Free nodes kept for reuse, grouped by size
+     */
+    class node_pool
+    {
+        typedef std::vector<void*> node_list_t;
+        typedef std::pair<size_t, node_list_t> free_list_t;
+    public:
+        /** Constructor */
+        node_pool(){}
+        /** Free every kept node */
+        ~node_pool()
+        {
+            for(size_t i=0;i<m_free_lists.size();++i)
+            {
+                const node_list_t& nodes = m_free_lists[i].second;
+                for(size_t j=0;j<nodes.size();++j) ::operator delete(nodes[j]);
+            }
+        }
+
+    public:
+        /** Get a node of the given size, reusing a kept node if there is one
+         *
+         * @param size number of bytes in the node
+         * @return pointer to the node
+         */
+        void* allocate(const size_t size)
+        {
+            node_list_t& nodes = free_list(size);
+            if(nodes.empty()) return ::operator new(size);
+            void* node = nodes.back();
+            nodes.pop_back();
+            return node;
+        }
+        /** Keep a node for reuse
+         *
+         * @param node pointer to the node
+         * @param size number of bytes in the node
+         */
+        void deallocate(void* node, const size_t size)
+        {
+            try
+            {
+                free_list(size).push_back(node);
+            }
+            catch(const std::bad_alloc&)
+            {
+                // Keeping the node failed, so it is returned to the heap
+                ::operator delete(node);
+            }
+        }
+        /** Get the number of kept nodes
+         *
+         * @return number of nodes kept for reuse
+         */
+        size_t size()const
+        {
+            size_t count = 0;
+            for(size_t i=0;i<m_free_lists.size();++i) count += m_free_lists[i].second.size();
+            return count;
+        }
+
+    private:
+        node_pool(const node_pool&);
+        node_pool& operator=(const node_pool&);
+        node_list_t& free_list(const size_t size)
+        {
+            // A container allocates nodes of one or two sizes, so a linear search is enough
+            for(size_t i=0;i<m_free_lists.size();++i)
+                if(m_free_lists[i].first == size) return m_free_lists[i].second;
+            m_free_lists.push_back(free_list_t(size, node_list_t()));
+            return m_free_lists.back().second;
+        }
+
+    private:
+        std::vector<free_list_t> m_free_lists;
+    };
+
+    /** Allocator that takes single nodes from a shared node_pool
+     *
+     * Arrays, such as the buckets of a hash map, are allocated from the heap.
+     */
+    template<typename T>
+    class pool_allocator
+    {
+        template<typename U> friend class pool_allocator;
+    public:
+        /** Type of the allocated values */
+        typedef T value_type;
+        /** Pointer to an allocated value */
+        typedef T* pointer;
+        /** Pointer to a constant allocated value */
+        typedef const T* const_pointer;
+        /** Size type */
+        typedef size_t size_type;
+        /** Difference type */
+        typedef std::ptrdiff_t difference_type;
+        /** A moved container keeps using the pool that holds its nodes */
+        typedef std::true_type propagate_on_container_move_assignment;
+        /** A swapped container keeps using the pool that holds its nodes */
+        typedef std::true_type propagate_on_container_swap;
+        /** Allocator of another type, sharing the same pool */
+        template<typename U>
+        struct rebind
+        {
+            /** Allocator type */
+            typedef pool_allocator<U> other;
+        };
+
+    public:
+        /** Constructor, creating a new pool */
+        pool_allocator() : m_pool(std::make_shared<node_pool>()){}
+        /** Constructor, sharing the pool of another allocator
+         *
+         * @param other source allocator
+         */
+        template<typename U>
+        pool_allocator(const pool_allocator<U>& other) : m_pool(other.m_pool){}
+
+    public:
+        /** Allocate n values
+         *
+         * @param n number of values
+         * @return pointer to the first value
+         */
+        T* allocate(const size_t n)
+        {
+            if(n == 1) return static_cast<T*>(m_pool->allocate(sizeof(T)));
+            return static_cast<T*>(::operator new(n*sizeof(T)));
+        }
+        /** Free n values
+         *
+         * @param ptr pointer to the first value
+         * @param n number of values
+         */
+        void deallocate(T* ptr, const size_t n)
+        {
+            if(n == 1) m_pool->deallocate(ptr, sizeof(T));
+            else ::operator delete(ptr);
+        }
+        /** Get the allocator of a copied container, with a new pool
+         *
+         * @return allocator with a new pool
+         */
+        pool_allocator select_on_container_copy_construction()const
+        {
+            return pool_allocator();
+        }
+        /** Get the number of nodes kept for reuse
+         *
+         * @return number of nodes in the pool
+         */
+        size_t pool_size()const
+        {
+            return m_pool->size();
+        }
+        /** Test if two allocators share a pool
+         *
+         * @param other other allocator
+         * @return true if memory allocated by one can be freed by the other
+         */
+        template<typename U>
+        bool operator==(const pool_allocator<U>& other)const
+        {
+            return m_pool == other.m_pool;
+        }
+        /** Test if two allocators use different pools
+         *
+         * @param other other allocator
+         * @return true if memory allocated by one cannot be freed by the other
+         */
+        template<typename U>
+        bool operator!=(const pool_allocator<U>& other)const
+        {
+            return m_pool != other.m_pool;
+        }
+
+    private:
+        std::shared_ptr<node_pool> m_pool;
+    };
+}}}
+
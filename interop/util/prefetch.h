@@ -0,0 +1,20 @@
+/** Define a portable software prefetch hint
+ *
+ * The hint asks the processor to start loading the cache line holding an address before it is read. On
+ * compilers without a prefetch intrinsic, the hint does nothing.
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define INTEROP_PREFETCH(addr) __builtin_prefetch(static_cast<const void*>(addr))
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#   include <xmmintrin.h>
+#   define INTEROP_PREFETCH(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#else
+#   define INTEROP_PREFETCH(addr) ((void)(addr))
+#endif
@@ -15,7 +15,9 @@
 #include <cstddef>
 #include <limits>
 #include <numeric>
+#include <iterator>
 #include <algorithm>
+#include <vector>
 #include "interop/util/assert.h"
 #include "interop/util/math.h"
 
@@ -754,6 +756,376 @@ namespace illumina { namespace interop { namespace util
         return variance_with_mean<R>(beg, end, mean, op::operator_none());
     }
 
-}}}
+    /** Number of values reduced sequentially by a single block of a deterministic reduction
+     *
+     * The partition of the collection into blocks depends only on the number of values, never on the number of
+     * threads, so the deterministic reductions below return bit-identical results for any thread count.
+     */
+    static const size_t deterministic_block_size = 1024;
+
+    /** Partial sums of a deterministic reduction
+     *
+     * Holds the number of values, the sum of the values and the sum of the squared values, each shifted by a center.
+     */
+    template<typename R>
+    struct reduction_sums
+    {
+        /** Constructor */
+        reduction_sums() : count(0), sum(0), sum_squares(0){}
+        /** Add the partial sums of another block
+         *
+         * @param rhs partial sums of another block
+         */
+        void combine(const reduction_sums<R>& rhs)
+        {
+            count += rhs.count;
+            sum += rhs.sum;
+            sum_squares += rhs.sum_squares;
+        }
+        /** Number of values */
+        size_t count;
+        /** Sum of the values, less the center */
+        R sum;
+        /** Sum of the squared values, less the center */
+        R sum_squares;
+    };
+
+    /** Partial sums of a deterministic least squares fit of a line
+     */
+    template<typename R>
+    struct linear_fit_sums
+    {
+        /** Constructor */
+        linear_fit_sums() : count(0), sum_x(0), sum_y(0), sum_xy(0), sum_xx(0){}
+        /** Add the partial sums of another block
+         *
+         * @param rhs partial sums of another block
+         */
+        void combine(const linear_fit_sums<R>& rhs)
+        {
+            count += rhs.count;
+            sum_x += rhs.sum_x;
+            sum_y += rhs.sum_y;
+            sum_xy += rhs.sum_xy;
+            sum_xx += rhs.sum_xx;
+        }
+        /** Slope of the fitted line
+         *
+         * @return slope of the line, NaN if the x-coordinates do not vary
+         */
+        R slope()const
+        {
+            const R den = denominator();
+            if (den <= std::numeric_limits<R>::epsilon())
+                return std::numeric_limits<R>::quiet_NaN();
+            return (count * sum_xy - sum_x * sum_y) / den;
+        }
+        /** Offset of the fitted line
+         *
+         * @return offset of the line, NaN if the x-coordinates do not vary
+         */
+        R offset()const
+        {
+            const R den = denominator();
+            if (den <= std::numeric_limits<R>::epsilon())
+                return std::numeric_limits<R>::quiet_NaN();
+            return (sum_y * sum_xx - sum_x * sum_xy) / den;
+        }
+        /** Number of points */
+        size_t count;
+        /** Sum of the x-coordinates */
+        R sum_x;
+        /** Sum of the y-coordinates */
+        R sum_y;
+        /** Sum of the products of the coordinates */
+        R sum_xy;
+        /** Sum of the squared x-coordinates */
+        R sum_xx;
+
+    private:
+        R denominator()const
+        {
+            return count * sum_xx - sum_x * sum_x;
+        }
+    };
+
+    namespace detail
+    {
+        /** Reduce a block of values to the count, sum and sum of squares
+         */
+        template<typename R, typename UnaryOp>
+        class moment_block_reducer
+        {
+        public:
+            /** Sums produced for each block */
+            typedef reduction_sums<R> sums_t;
+            /** Constructor
+             *
+             * @param op unary operator that returns the value of an element
+             * @param center value subtracted from each value
+             * @param skip_nan skip NaN values
+             */
+            moment_block_reducer(UnaryOp op, const R center, const bool skip_nan) :
+                    m_op(op), m_center(center), m_skip_nan(skip_nan){}
+            /** Reduce a single block of values
+             *
+             * @param beg iterator to start of the block
+             * @param end iterator to end of the block
+             * @return partial sums over the block
+             */
+            template<typename I>
+            sums_t operator()(I beg, I end)const
+            {
+                sums_t partial;
+                for (; beg != end; ++beg)
+                {
+                    const R val = static_cast<R>(m_op(*beg)) - m_center;
+                    if (m_skip_nan && std::isnan(val)) continue;
+                    partial.sum += val;
+                    partial.sum_squares += val * val;
+                    ++partial.count;
+                }
+                return partial;
+            }
+
+        private:
+            mutable UnaryOp m_op;
+            R m_center;
+            bool m_skip_nan;
+        };
+
+        /** Reduce a block of points to the sums of a least squares line fit
+         */
+        template<typename R, typename XOp, typename YOp>
+        class linear_fit_block_reducer
+        {
+        public:
+            /** Sums produced for each block */
+            typedef linear_fit_sums<R> sums_t;
+            /** Constructor
+             *
+             * @param xop unary operator that returns the x-coordinate of an element
+             * @param yop unary operator that returns the y-coordinate of an element
+             */
+            linear_fit_block_reducer(XOp xop, YOp yop) : m_xop(xop), m_yop(yop){}
+            /** Reduce a single block of points
+             *
+             * @param beg iterator to start of the block
+             * @param end iterator to end of the block
+             * @return partial sums over the block
+             */
+            template<typename I>
+            sums_t operator()(I beg, I end)const
+            {
+                sums_t partial;
+                for (; beg != end; ++beg)
+                {
+                    const R x = static_cast<R>(m_xop(*beg));
+                    const R y = static_cast<R>(m_yop(*beg));
+                    partial.sum_x += x;
+                    partial.sum_y += y;
+                    partial.sum_xy += x * y;
+                    partial.sum_xx += x * x;
+                    ++partial.count;
+                }
+                return partial;
+            }
+
+        private:
+            mutable XOp m_xop;
+            mutable YOp m_yop;
+        };
+
+        /** Combine partial sums in a fixed pairwise tree
+         *
+         * @param partials array of partial sums
+         * @param n number of partial sums
+         * @return combined sums
+         */
+        template<typename Sums>
+        Sums combine_pairwise(const Sums* partials, const size_t n)
+        {
+            if (n == 0) return Sums();
+            if (n == 1) return partials[0];
+            const size_t half = n / 2;
+            Sums total = combine_pairwise(partials, half);
+            total.combine(combine_pairwise(partials + half, n - half));
+            return total;
+        }
+
+        /** Reduce a collection block by block
+         *
+         * Specialization for random access iterators, where the blocks may be reduced in parallel
+         *
+         * @param beg iterator to start of collection
+         * @param end iterator to end of collection
+         * @param reducer functor that reduces a single block to its partial sums
+         * @param thread_count number of threads
+         * @return sums over the collection
+         */
+        template<typename I, typename BlockReducer>
+        typename BlockReducer::sums_t reduce_blocks(I beg,
+                                                    I end,
+                                                    const BlockReducer& reducer,
+                                                    const size_t thread_count,
+                                                    std::random_access_iterator_tag)
+        {
+            typedef typename BlockReducer::sums_t sums_t;
+            const size_t n = static_cast<size_t>(std::distance(beg, end));
+            const size_t block_count = (n + deterministic_block_size - 1) / deterministic_block_size;
+            if (block_count <= 1) return reducer(beg, end);
+            std::vector< sums_t > partials(block_count);
+#ifdef _OPENMP
+#           pragma omp parallel for default(shared) num_threads(static_cast<int>(thread_count)) schedule(static) if(thread_count > 1)
+#else
+            (void)thread_count;
+#endif
+            for (int b = 0; b < static_cast<int>(block_count); ++b)
+            {
+                const size_t first = static_cast<size_t>(b) * deterministic_block_size;
+                const size_t last = std::min(first + deterministic_block_size, n);
+                partials[b] = reducer(beg + first, beg + last);
+            }
+            return combine_pairwise(&partials.front(), partials.size());
+        }
+
+        /** Reduce a collection block by block
+         *
+         * Generic version for iterators that cannot jump to a block, where the blocks are reduced in sequence
+         *
+         * @param beg iterator to start of collection
+         * @param end iterator to end of collection
+         * @param reducer functor that reduces a single block to its partial sums
+         * @return sums over the collection
+         */
+        template<typename I, typename BlockReducer, typename Tag>
+        typename BlockReducer::sums_t reduce_blocks(I beg, I end, const BlockReducer& reducer, const size_t, Tag)
+        {
+            typedef typename BlockReducer::sums_t sums_t;
+            std::vector< sums_t > partials;
+            while (beg != end)
+            {
+                I last = beg;
+                for (size_t i = 0; i < deterministic_block_size && last != end; ++i) ++last;
+                partials.push_back(reducer(beg, last));
+                beg = last;
+            }
+            if (partials.empty()) return sums_t();
+            return combine_pairwise(&partials.front(), partials.size());
+        }
+    }
 
+    /** Reduce a collection to the number of values, the sum and the sum of squares
+     *
+     * The collection is split into fixed blocks of deterministic_block_size values. Each block is summed in order
+     * and the block sums are combined in a fixed pairwise tree. Neither the partition nor the order of the additions
+     * depends on the number of threads, so the result is bit-identical for any thread count. A collection that fits
+     * in a single block is summed exactly as a sequential loop would. For larger collections, the pairwise tree
+     * also bounds the growth of the rounding error to the log of the number of blocks.
+     *
+     * @note Blocks are only reduced in parallel for random access iterators and when built with OpenMP
+     *
+     * @param beg iterator to start of collection
+     * @param end iterator to end of collection
+     * @param op unary operator that returns the value of an element
+     * @param center value subtracted from each value, e.g. the mean when computing the variance
+     * @param skip_nan skip NaN values
+     * @param thread_count number of threads
+     * @return sums over the collection
+     */
+    template<typename R, typename I, typename UnaryOp>
+    reduction_sums<R> deterministic_sums(I beg,
+                                         I end,
+                                         UnaryOp op,
+                                         const R center=0,
+                                         const bool skip_nan=false,
+                                         const size_t thread_count=1)
+    {
+        typedef typename std::iterator_traits<I>::iterator_category category_t;
+        return detail::reduce_blocks(beg,
+                                     end,
+                                     detail::moment_block_reducer<R, UnaryOp>(op, center, skip_nan),
+                                     thread_count,
+                                     category_t());
+    }
 
+    /** Reduce a collection of points to the sums of a least squares line fit
+     *
+     * The points are reduced with the same fixed blocks and pairwise tree as deterministic_sums, so the fit is
+     * bit-identical for any thread count. Fewer than deterministic_block_size points are summed exactly as a
+     * sequential loop would.
+     *
+     * Usage:
+     *  linear_fit_sums<float> fit = deterministic_linear_fit_sums<float>(points.begin(), points.end(), x_of, y_of);
+     *  float slope = fit.slope();
+     *
+     * @param beg iterator to start of collection
+     * @param end iterator to end of collection
+     * @param xop unary operator that returns the x-coordinate of an element
+     * @param yop unary operator that returns the y-coordinate of an element
+     * @param thread_count number of threads
+     * @return sums over the collection
+     */
+    template<typename R, typename I, typename XOp, typename YOp>
+    linear_fit_sums<R> deterministic_linear_fit_sums(I beg, I end, XOp xop, YOp yop, const size_t thread_count=1)
+    {
+        typedef typename std::iterator_traits<I>::iterator_category category_t;
+        return detail::reduce_blocks(beg,
+                                     end,
+                                     detail::linear_fit_block_reducer<R, XOp, YOp>(xop, yop),
+                                     thread_count,
+                                     category_t());
+    }
+
+    /** Estimate the mean of values in a given collection with a deterministic reduction
+     *
+     * Usage:
+     *  std::vector<float> values = {0,1,2,3};
+     *  double mean_val = deterministic_mean<double>(values.begin(), values.end(), op::operator_none());
+     *
+     * @see deterministic_sums
+     * @param beg iterator to start of collection
+     * @param end iterator to end of collection
+     * @param op unary operator that returns the value of an element
+     * @param skip_nan skip NaN values
+     * @param thread_count number of threads
+     * @return mean of the input collection, 0 (or NaN when skipping NaN values) if the collection is empty
+     */
+    template<typename R, typename I, typename UnaryOp>
+    R deterministic_mean(I beg, I end, UnaryOp op, const bool skip_nan=false, const size_t thread_count=1)
+    {
+        const reduction_sums<R> sums = deterministic_sums<R>(beg, end, op, R(0), skip_nan, thread_count);
+        if (sums.count == 0) return skip_nan ? std::numeric_limits<R>::quiet_NaN() : R(0);
+        return sums.sum / static_cast<R>(sums.count);
+    }
+
+    /** Estimate the variance of values in a given collection with a deterministic reduction
+     *
+     * Usage:
+     *  std::vector<float> values = {0,1,2,3};
+     *  double var_val = deterministic_variance_with_mean<double>(values.begin(), values.end(), 1.5, op::operator_none());
+     *
+     * @see deterministic_sums
+     * @param beg iterator to start of collection
+     * @param end iterator to end of collection
+     * @param mean_val pre-calculated mean
+     * @param op unary operator that returns the value of an element
+     * @param skip_nan skip NaN values
+     * @param thread_count number of threads
+     * @return variance of the input collection, 0 (or NaN when skipping NaN values) for fewer than two values
+     */
+    template<typename R, typename I, typename UnaryOp>
+    R deterministic_variance_with_mean(I beg,
+                                       I end,
+                                       const R mean_val,
+                                       UnaryOp op,
+                                       const bool skip_nan=false,
+                                       const size_t thread_count=1)
+    {
+        const reduction_sums<R> sums = deterministic_sums<R>(beg, end, op, mean_val, skip_nan, thread_count);
+        if (sums.count <= 1) return skip_nan ? std::numeric_limits<R>::quiet_NaN() : R(0);
+        const R n = static_cast<R>(sums.count);
+        return (sums.sum_squares - sums.sum * sums.sum / n) / (n - 1);
+    }
+
+}}}
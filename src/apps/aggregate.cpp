@@ -78,14 +78,15 @@ int main(int argc, const char** argv)
         return INVALID_ARGUMENTS;
     }
 
-    const size_t thread_count = 1;
+    size_t thread_count = 1;
 
     std::cout << "# Version: " << INTEROP_VERSION << std::endl;
 
     size_t max_tile_number=0;
     util::option_parser description;
     description
-            (max_tile_number, "max-tile", "Maximum tile number to include");
+            (max_tile_number, "max-tile", "Maximum tile number to include")
+            (thread_count, "thread-count", "Number of threads used to read and write InterOp files");
     if(description.is_help_requested(argc, argv))
     {
         std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [--option1=value1] [--option2=value2]" << std::endl;
@@ -128,7 +129,7 @@ int main(int argc, const char** argv)
         }
         std::cout << subset.get<model::metrics::extraction_metric>().size() << ", " << run.get<model::metrics::extraction_metric>().size() << std::endl;
         try{
-            subset.write_metrics(".");
+            subset.write_metrics(".", true, thread_count);
         }
         catch(const std::exception& ex)
         {
@@ -140,7 +141,7 @@ int main(int argc, const char** argv)
     else
     {
         try{
-            run.write_metrics(".");
+            run.write_metrics(".", true, thread_count);
         }
         catch(const std::exception& ex)
         {
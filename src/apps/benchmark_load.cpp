@@ -0,0 +1,897 @@
+/** @page benchmark_load Benchmark loading large InterOp files
+ *
+ * This developer application writes synthetic Q-metric (v6) and tile-metric (v2) InterOp files with a large number of
+ * records, then reports the time to load each file, the number of times the id map is rehashed while inserting the
+ * loaded ids and the peak resident memory of the process. It also reports the time and the data TLB misses of a scan
+ * over every loaded record, which is the access pattern of a summary.
+ *
+ * ### Running the Program
+ *
+ * The program runs as follows:
+ *
+ *      $ benchmark_load /tmp/bench --records=10000000 --format=q
+ *
+ * The synthetic files are written to the given folder. Run each format in a separate process to measure the peak
+ * resident memory of a single load. Compare runs with `--huge-pages=1` and `--huge-pages=0` to measure the effect
+ * of backing the metric storage with huge pages (see util::memory_policy).
+ *
+ *      # Version: v3.0.35-src
+ *      # Huge pages: 1
+ *      # NUMA nodes: 1
+ *      Format  Records   Metrics   Seconds  Rehash(reserved)  Rehash(unreserved)  PeakRSS(MB)  Scan(s)  dTLBMiss
+ *      Q       10000000  10000000  10.9     n/a               n/a                 2292.09      0.0213   n/a
+ *
+ * The `cycle` format writes the Q-metric records in one file per cycle and loads them as a by cycle run folder. Compare
+ * runs with `--io-hints=1` and `--io-hints=0` to measure the effect of prefetching the cycle files (see io::io_hints).
+ * With `--cold=1`, the files are dropped from the page cache before loading. The whole page cache is dropped when the
+ * process may write to /proc/sys/vm/drop_caches, otherwise each file is dropped with a hint, reported as
+ * `# Cold cache: fadvise`.
+ *
+ *      $ benchmark_load /tmp/bench --records=3000000 --format=cycle --cold=1 --io-hints=1
+ *
+ * The `live` format simulates a monitor polling a Q-metric file while the instrument appends to it. The writer
+ * appends the file in chunks that end within a record, and the file is read after each chunk, once with the status
+ * returning reader (see io::read_available_metrics) and once with the reader that throws an incomplete file exception.
+ *
+ *      $ benchmark_load /tmp/bench --records=1000000 --format=live --chunks=100
+ *
+ *      Reader     Polls  Incomplete  Seconds  Polls/s
+ *      status     100    96          38.5     2.6
+ *      exception  100    96          37.8     2.64
+ *
+ * The `reload` format simulates a monitor reloading a complete Q-metric file into the same metric set, and reports
+ * the number of memory allocations per poll after the first. The set is cleared before each poll, once freeing its
+ * memory and once retaining its capacity (see metric_set::retain_capacity). When the capacity is retained, the
+ * records and their histograms are reused, and the remaining allocations are one node of the id map for each record,
+ * plus a few for each file (the header and the read buffer).
+ *
+ *      $ benchmark_load /tmp/bench --records=1000000 --format=reload --polls=10
+ *
+ *      Clear     Polls  Seconds  Polls/s  Allocs/poll
+ *      free      10     7.34     1.36     3000005
+ *      retain    10     6.2      1.61     1000005
+ *
+ * The `workspace` format builds a synthetic run in memory and repeats the summary, imaging table and flowcell map
+ * with the same workspace (see logic::utils::workspace). It reports the memory allocations per call after the
+ * first, counted by the replacement operator new, next to the number of workspace buffers that grew. The buffer
+ * growth drops to zero after the first call, while the allocations made outside the workspace remain.
+ *
+ *      $ benchmark_load /tmp/bench --records=200000 --format=workspace --polls=5
+ *
+ *      Call      Calls  Seconds  Allocs/call  Growth/call
+ *      summary   5      0.0326   18729        0
+ *      table     5      0.0938   813          0
+ *      flowcell  5      0.00292  5            0
+ *
+ * The `lookup` format compares looking up every record of an error metric set by id, one at a time, to a single batch
+ * lookup (see metric_set::get_metrics). The ids are visited by cycle rather than by tile, as the imaging table joins
+ * do.
+ *
+ *      $ benchmark_load /tmp/bench --records=100000 --format=lookup
+ *
+ *      Lookup  Records   Seconds
+ *      single  100000    0.071
+ *      batch   100000    0.0696
+ *
+ * The rehash counts are only reported when the id map of a metric set is an unordered map. The TLB misses are only
+ * reported on Linux when performance counters are accessible.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <iterator>
+#include "interop/util/filesystem.h"
+#include "interop/util/option_parser.h"
+#include "interop/util/timer.h"
+#include "interop/util/memory_policy.h"
+#include "interop/io/io_hints.h"
+#include "interop/io/metric_file_stream.h"
+#include "interop/io/format/stream_membuf.h"
+#include "interop/model/run_metrics.h"
+#include "interop/logic/summary/run_summary.h"
+#include "interop/logic/table/create_imaging_table.h"
+#include "interop/logic/plot/plot_flowcell_map.h"
+#include "interop/version.h"
+#include "inc/application.h"
+
+#include <cstdlib>
+#include <new>
+#if defined(__unix__) || defined(__APPLE__)
+#   include <sys/resource.h>
+#endif
+#if defined(__linux__)
+#   include <cstring>
+#   include <unistd.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <linux/perf_event.h>
+#endif
+
+using namespace illumina::interop::model::metrics;
+using namespace illumina::interop;
+
+/** Number of memory allocations made by the process, counted by the replacement operator new */
+static size_t s_allocation_count = 0;
+
+// The replacement functions are not inlined, so the compiler does not pair a new expression with std::free
+#if defined(__GNUC__)
+#   define BENCHMARK_NOINLINE __attribute__((noinline))
+#else
+#   define BENCHMARK_NOINLINE
+#endif
+
+BENCHMARK_NOINLINE void* operator new(size_t size)
+{
+    ++s_allocation_count;
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if(ptr == 0) throw std::bad_alloc();
+    return ptr;
+}
+BENCHMARK_NOINLINE void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+BENCHMARK_NOINLINE void operator delete(void* ptr) throw()
+{
+    std::free(ptr);
+}
+BENCHMARK_NOINLINE void operator delete[](void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+/** Get the peak resident memory of the process
+ *
+ * @return peak resident memory in megabytes or 0 if not supported
+ */
+static double peak_resident_megabytes()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#   if defined(__APPLE__)
+    return static_cast<double>(usage.ru_maxrss) / (1024.0*1024.0);
+#   else
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#   endif
+#else
+    return 0;
+#endif
+}
+
+/** Counter of data TLB misses for the calling thread
+ *
+ * The counter is unavailable when the platform or the permissions do not support performance counters.
+ */
+class tlb_miss_counter
+{
+public:
+    /** Constructor */
+    tlb_miss_counter() : m_fd(-1)
+    {
+#if defined(__linux__)
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    /** Destructor */
+    ~tlb_miss_counter()
+    {
+#if defined(__linux__)
+        if(m_fd >= 0) close(m_fd);
+#endif
+    }
+    /** Test if the counter is available
+     *
+     * @return true if the counter is available
+     */
+    bool is_available()const
+    {
+        return m_fd >= 0;
+    }
+    /** Reset and start the counter */
+    void start()
+    {
+#if defined(__linux__)
+        if(m_fd < 0) return;
+        ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    /** Stop the counter
+     *
+     * @return number of misses since start
+     */
+    ::uint64_t stop()
+    {
+        ::uint64_t count = 0;
+#if defined(__linux__)
+        if(m_fd < 0) return 0;
+        ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if(read(m_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) return 0;
+#endif
+        return count;
+    }
+
+private:
+    tlb_miss_counter(const tlb_miss_counter&);
+    tlb_miss_counter& operator=(const tlb_miss_counter&);
+
+private:
+    int m_fd;
+};
+
+/** Scan every record of a metric set, like a summary does
+ *
+ * @param metrics metric set
+ * @return checksum over the scanned records, so the scan is not optimized away
+ */
+template<class MetricSet>
+::uint64_t scan_records(const MetricSet& metrics)
+{
+    ::uint64_t checksum = 0;
+    for(typename MetricSet::const_iterator it = metrics.begin();it != metrics.end();++it)
+        checksum += it->id();
+    return checksum;
+}
+
+/** Count the number of times an id map is rehashed while inserting ids
+ *
+ * @param metrics set of metrics holding the ids
+ * @param reserve number of buckets to reserve before inserting, as the loader does
+ * @return number of rehashes
+ */
+#ifdef INTEROP_HAS_UNORDERED_MAP
+template<class MetricSet>
+size_t count_rehash(const MetricSet& metrics, const size_t reserve)
+{
+    typename MetricSet::offset_map_t id_map;
+    if(reserve > 0) id_map.reserve(reserve);
+    size_t rehash_count = 0;
+    size_t bucket_count = id_map.bucket_count();
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        id_map[metrics[i].id()] = i;
+        if(id_map.bucket_count() != bucket_count)
+        {
+            bucket_count = id_map.bucket_count();
+            ++rehash_count;
+        }
+    }
+    return rehash_count;
+}
+#endif
+
+/** Create the header of the synthetic Q-metric files with 7 bins
+ *
+ * @return Q-metric header
+ */
+static q_metric::header_type synthetic_q_header()
+{
+    const ::uint16_t bin_count = 7;
+    const ::uint16_t lower[] = {1, 10, 20, 25, 30, 35, 40};
+    const ::uint16_t upper[] = {9, 19, 24, 29, 34, 39, 41};
+    const ::uint16_t value[] = {1, 14, 22, 27, 33, 37, 40};
+    q_metric::header_type::qscore_bin_vector_type bins;
+    for(::uint16_t i=0;i<bin_count;++i) bins.push_back(q_score_bin(lower[i], upper[i], value[i]));
+    return q_metric::header_type(bins);
+}
+
+/** Write a synthetic Q-metric file, one record at a time
+ *
+ * @param file_name destination file
+ * @param record_count number of records
+ */
+static void write_q_metrics(const std::string& file_name, const size_t record_count)
+{
+    const q_metric::header_type header = synthetic_q_header();
+    const size_t bin_count = header.bin_count();
+    const ::int16_t version = 6;
+    const size_t cycle_count = 500;
+    const size_t tile_count = 2500;
+    std::ofstream fout(file_name.c_str(), std::ios::binary);
+    io::write_metric_header<q_metric>(fout, version, header);
+    std::vector< ::uint32_t > hist(bin_count, 0);
+    for(size_t i=0;i<record_count;++i)
+    {
+        const ::uint32_t cycle = static_cast< ::uint32_t >(i % cycle_count + 1);
+        const ::uint32_t tile = static_cast< ::uint32_t >((i / cycle_count) % tile_count + 1);
+        const ::uint32_t lane = static_cast< ::uint32_t >(i / (cycle_count*tile_count) + 1);
+        hist[i % bin_count] = static_cast< ::uint32_t >(i);
+        io::write_metric(fout, q_metric(lane, tile, cycle, hist), header, version);
+        hist[i % bin_count] = 0;
+    }
+}
+
+/** Write synthetic Q-metric files, one file per cycle
+ *
+ * @param run_folder destination run folder
+ * @param record_count total number of records
+ * @param cycle_count number of cycles
+ */
+static void write_q_metrics_by_cycle(const std::string& run_folder,
+                                     const size_t record_count,
+                                     const size_t cycle_count)
+{
+    const q_metric::header_type header = synthetic_q_header();
+    const ::int16_t version = 6;
+    const size_t tile_count = 2500;
+    const size_t records_per_cycle = record_count / cycle_count;
+    io::mkdir(run_folder);
+    io::mkdir(io::combine(run_folder, "InterOp"));
+    std::vector< ::uint32_t > hist(header.bin_count(), 0);
+    for(size_t cycle=1;cycle<=cycle_count;++cycle)
+    {
+        const std::string file_name = io::interop_filename<q_metric>(run_folder, cycle);
+        io::mkdir(io::dirname(file_name));
+        std::ofstream fout(file_name.c_str(), std::ios::binary);
+        io::write_metric_header<q_metric>(fout, version, header);
+        for(size_t i=0;i<records_per_cycle;++i)
+        {
+            const ::uint32_t tile = static_cast< ::uint32_t >(i % tile_count + 1);
+            const ::uint32_t lane = static_cast< ::uint32_t >(i / tile_count + 1);
+            hist[i % hist.size()] = static_cast< ::uint32_t >(i);
+            io::write_metric(fout, q_metric(lane, tile, static_cast< ::uint32_t >(cycle), hist), header, version);
+            hist[i % hist.size()] = 0;
+        }
+    }
+}
+
+/** Write a synthetic tile-metric file, one tile at a time
+ *
+ * Each tile with two reads writes 10 records.
+ *
+ * @param file_name destination file
+ * @param record_count number of records
+ */
+static void write_tile_metrics(const std::string& file_name, const size_t record_count)
+{
+    const ::int16_t version = 2;
+    const size_t records_per_tile = 10;
+    const size_t tile_count = 60000;
+    const tile_metric::header_type header = tile_metric::header_type::default_header();
+    tile_metric::read_metric_vector reads;
+    reads.push_back(tile_metric::read_metric_type(1, 95.0f, 0.1f, 0.2f));
+    reads.push_back(tile_metric::read_metric_type(2, 94.0f, 0.15f, 0.25f));
+    std::ofstream fout(file_name.c_str(), std::ios::binary);
+    io::write_metric_header<tile_metric>(fout, version, header);
+    for(size_t i=0;i<record_count/records_per_tile;++i)
+    {
+        const ::uint32_t tile = static_cast< ::uint32_t >(i % tile_count + 1);
+        const ::uint32_t lane = static_cast< ::uint32_t >(i / tile_count + 1);
+        const tile_metric metric(lane, tile, 1000.0f, 900.0f, static_cast<float>(i), static_cast<float>(i/2), reads);
+        io::write_metric(fout, metric, header, version);
+    }
+}
+
+/** Report the benchmark of a load
+ *
+ * @param out output stream
+ * @param name name of the format
+ * @param record_count number of records in the files
+ * @param seconds time to load the files
+ * @param metrics loaded metric set
+ */
+template<class MetricSet>
+void report_load(std::ostream& out,
+                 const std::string& name,
+                 const size_t record_count,
+                 const double seconds,
+                 const MetricSet& metrics)
+{
+    out << std::left << std::setw(8) << name
+        << std::setw(10) << record_count
+        << std::setw(10) << metrics.size()
+        << std::setw(9) << std::setprecision(3) << seconds;
+#ifdef INTEROP_HAS_UNORDERED_MAP
+    out << std::setw(18) << count_rehash(metrics, record_count)
+        << std::setw(20) << count_rehash(metrics, 0);
+#else
+    out << std::setw(18) << "n/a"
+        << std::setw(20) << "n/a";
+#endif
+    out << std::setw(13) << std::setprecision(6) << peak_resident_megabytes();
+
+    tlb_miss_counter tlb_misses;
+    double scan_seconds = 0;
+    ::uint64_t miss_count = 0;
+    ::uint64_t checksum = 0;
+    {
+        util::scoped_timer timer(scan_seconds);
+        tlb_misses.start();
+        checksum = scan_records(metrics);
+        miss_count = tlb_misses.stop();
+    }
+    out << std::setw(9) << std::setprecision(3) << scan_seconds;
+    if(tlb_misses.is_available()) out << miss_count;
+    else out << "n/a";
+    out << std::endl;
+    if(checksum == 0 && !metrics.empty()) out << "# Empty checksum" << std::endl;
+}
+
+/** Drop files from the page cache, so the next load reads them from storage
+ *
+ * The whole page cache is dropped when the process may write to /proc/sys/vm/drop_caches, otherwise the clean pages
+ * of each file are dropped with an I/O hint.
+ *
+ * @param file_names files to drop
+ * @return name of the method used to drop the files
+ */
+static std::string drop_page_cache(const std::vector<std::string>& file_names)
+{
+#if defined(__linux__)
+    sync();
+    std::ofstream fout("/proc/sys/vm/drop_caches");
+    if(fout.good())
+    {
+        fout << "3" << std::endl;
+        if(fout.good()) return "drop_caches";
+    }
+#endif
+    for(size_t i=0;i<file_names.size();++i)
+    {
+        if(!io::io_hints::dont_need(file_names[i])) return "none";
+    }
+    return "fadvise";
+}
+
+/** Load a synthetic InterOp file and report the benchmark
+ *
+ * @param out output stream
+ * @param name name of the format
+ * @param file_name source file
+ * @param record_size size of a record in bytes
+ * @param cold drop the file from the page cache before loading
+ * @param metrics destination metric set
+ */
+template<class MetricSet>
+void benchmark_load(std::ostream& out,
+                    const std::string& name,
+                    const std::string& file_name,
+                    const size_t record_size,
+                    const bool cold,
+                    MetricSet& metrics)
+{
+    const size_t file_size = static_cast<size_t>(io::file_size(file_name));
+    if(cold) out << "# Cold cache: " << drop_page_cache(std::vector<std::string>(1, file_name)) << std::endl;
+    double seconds = 0;
+    {
+        util::scoped_timer timer(seconds);
+        std::ifstream fin(file_name.c_str(), std::ios::binary);
+        io::read_metrics(fin, metrics, file_size);
+    }
+    report_load(out, name, file_size / record_size, seconds, metrics);
+}
+
+/** Load synthetic by cycle InterOp files and report the benchmark
+ *
+ * @param out output stream
+ * @param name name of the format
+ * @param run_folder run folder holding the files
+ * @param cycle_count number of cycle files
+ * @param record_size size of a record in bytes
+ * @param cold drop the files from the page cache before loading
+ * @param metrics destination metric set
+ */
+template<class MetricSet>
+void benchmark_load_by_cycle(std::ostream& out,
+                             const std::string& name,
+                             const std::string& run_folder,
+                             const size_t cycle_count,
+                             const size_t record_size,
+                             const bool cold,
+                             MetricSet& metrics)
+{
+    std::vector<std::string> file_names;
+    size_t byte_count = 0;
+    for(size_t cycle=1;cycle<=cycle_count;++cycle)
+    {
+        file_names.push_back(io::interop_filename<MetricSet>(run_folder, cycle));
+        byte_count += static_cast<size_t>(io::file_size(file_names.back()));
+    }
+    if(cold) out << "# Cold cache: " << drop_page_cache(file_names) << std::endl;
+    double seconds = 0;
+    {
+        util::scoped_timer timer(seconds);
+        io::read_interop_by_cycle(run_folder, metrics, cycle_count);
+    }
+    report_load(out, name, byte_count / record_size, seconds, metrics);
+}
+
+/** Poll a Q-metric file while a simulated writer appends to it, and report the throughput of each reader
+ *
+ * @param out output stream
+ * @param file_name file written by the simulated writer
+ * @param record_count number of records in the complete file
+ * @param chunk_count number of chunks appended by the writer, the file is read after each chunk
+ */
+static void benchmark_live_polling(std::ostream& out,
+                                   const std::string& file_name,
+                                   const size_t record_count,
+                                   const size_t chunk_count)
+{
+    typedef model::metric_base::metric_set<q_metric> q_metric_set_t;
+    write_q_metrics(file_name, record_count);
+    std::string data;
+    {
+        std::ifstream fin(file_name.c_str(), std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    }
+    // An odd chunk size ends most chunks within a record, as a file caught mid-write
+    const size_t chunk_size = data.size() / chunk_count | 1;
+    const char* readers[] = {"status", "exception"};
+    out << "Reader     Polls  Incomplete  Seconds  Polls/s" << std::endl;
+    for(size_t reader=0;reader<2;++reader)
+    {
+        std::ofstream writer(file_name.c_str(), std::ios::binary | std::ios::trunc);
+        size_t poll_count = 0;
+        size_t incomplete_count = 0;
+        double seconds = 0;
+        for(size_t offset=0;offset < data.size();offset+=chunk_size)
+        {
+            writer.write(data.c_str()+offset, static_cast<std::streamsize>(std::min(chunk_size, data.size()-offset)));
+            writer.flush();
+            double poll_seconds = 0;
+            {
+                util::scoped_timer timer(poll_seconds);
+                q_metric_set_t metrics;
+                std::ifstream fin(file_name.c_str(), std::ios::binary);
+                const size_t file_size = static_cast<size_t>(io::file_size(file_name));
+                if(reader == 0)
+                {
+                    if(io::read_available_metrics(fin, metrics, file_size).is_incomplete()) ++incomplete_count;
+                }
+                else
+                {
+                    try
+                    {
+                        io::read_metrics(fin, metrics, file_size);
+                    }
+                    catch(const io::incomplete_file_exception&)
+                    {
+                        ++incomplete_count;
+                    }
+                }
+            }
+            seconds += poll_seconds;
+            ++poll_count;
+        }
+        out << std::left << std::setw(11) << readers[reader]
+            << std::setw(7) << poll_count
+            << std::setw(12) << incomplete_count
+            << std::setw(9) << std::setprecision(3) << seconds
+            << std::setprecision(3) << (seconds > 0 ? static_cast<double>(poll_count)/seconds : 0) << std::endl;
+    }
+}
+
+/** Reload a complete Q-metric file into the same metric set, and report the allocations made by each poll
+ *
+ * @param out output stream
+ * @param file_name file holding the synthetic records
+ * @param record_count number of records in the file
+ * @param poll_count number of times the file is reloaded
+ */
+static void benchmark_reload_polling(std::ostream& out,
+                                     const std::string& file_name,
+                                     const size_t record_count,
+                                     const size_t poll_count)
+{
+    typedef model::metric_base::metric_set<q_metric> q_metric_set_t;
+    write_q_metrics(file_name, record_count);
+    std::vector<char> data;
+    {
+        std::ifstream fin(file_name.c_str(), std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    }
+    if(data.empty()) return;
+    // The file is read from memory, so the allocations of the file stream are not counted
+    io::detail::membuf sbuf(&data.front(), &data.front()+data.size());
+    std::istream in(&sbuf);
+    const char* modes[] = {"free", "retain"};
+    out << "Clear     Polls  Seconds  Polls/s  Allocs/poll" << std::endl;
+    for(size_t mode=0;mode<2;++mode)
+    {
+        q_metric_set_t metrics;
+        metrics.retain_capacity(mode == 1);
+        size_t allocation_count = 0;
+        double seconds = 0;
+        for(size_t poll=0;poll<poll_count;++poll)
+        {
+            const size_t allocation_start = s_allocation_count;
+            double poll_seconds = 0;
+            {
+                util::scoped_timer timer(poll_seconds);
+                metrics.clear();
+                in.clear();
+                in.seekg(0);
+                io::read_metrics(in, metrics, data.size());
+            }
+            seconds += poll_seconds;
+            // The first poll fills an empty set in both modes
+            if(poll > 0) allocation_count += s_allocation_count - allocation_start;
+        }
+        out << std::left << std::setw(10) << modes[mode]
+            << std::setw(7) << poll_count
+            << std::setw(9) << std::setprecision(3) << seconds
+            << std::setw(9) << std::setprecision(3) << (seconds > 0 ? static_cast<double>(poll_count)/seconds : 0)
+            << (poll_count > 1 ? allocation_count / (poll_count-1) : 0) << std::endl;
+    }
+}
+
+/** Create a synthetic run with extraction and tile metrics
+ *
+ * The run has 2 lanes, 2 surfaces and 2 swaths. The number of tiles in each swath is chosen so the run holds about
+ * the given number of extraction records.
+ *
+ * @param metrics destination run metrics
+ * @param record_count number of extraction records
+ */
+static void create_synthetic_run(run_metrics& metrics, const size_t record_count)
+{
+    const ::uint32_t lane_count = 2;
+    const ::uint32_t surface_count = 2;
+    const ::uint32_t swath_count = 2;
+    const ::uint32_t cycle_count = 50;
+    const size_t tiles_per_swath = record_count / (cycle_count*lane_count*surface_count*swath_count);
+    const ::uint32_t tile_count = static_cast< ::uint32_t >(std::max(std::min(tiles_per_swath, size_t(99)), size_t(1)));
+    std::vector<model::run::read_info> reads(1, model::run::read_info(1, 1, cycle_count, false));
+    std::vector<std::string> channels;
+    channels.push_back("A");
+    channels.push_back("C");
+    channels.push_back("G");
+    channels.push_back("T");
+    const model::run::flowcell_layout layout(lane_count, surface_count, swath_count, tile_count, 1, 1,
+                                             std::vector<std::string>(), constants::FourDigit);
+    metrics.run_info(model::run::info(layout, reads, channels));
+    tile_metric::read_metric_vector tile_reads(1, tile_metric::read_metric_type(1, 95.0f, 0.1f, 0.2f));
+    for(::uint32_t lane=1;lane<=lane_count;++lane)
+    {
+        for(::uint32_t surface=1;surface<=surface_count;++surface)
+        {
+            for(::uint32_t swath=1;swath<=swath_count;++swath)
+            {
+                for(::uint32_t tile=1;tile<=tile_count;++tile)
+                {
+                    const ::uint32_t tile_number = surface*1000 + swath*100 + tile;
+                    metrics.get<tile_metric>().insert(tile_metric(lane, tile_number, 1000.0f, 900.0f,
+                                                                  static_cast<float>(tile_number),
+                                                                  static_cast<float>(tile_number/2), tile_reads));
+                    for(::uint32_t cycle=1;cycle<=cycle_count;++cycle)
+                    {
+                        const extraction_metric::ushort_array_t intensity(4, static_cast< ::uint16_t >(tile+cycle));
+                        const extraction_metric::float_array_t focus(4, 2.5f);
+                        metrics.get<extraction_metric>().insert(extraction_metric(lane, tile_number, cycle,
+                                                                                  intensity, focus));
+                    }
+                }
+            }
+        }
+    }
+    metrics.finalize_after_load();
+}
+
+/** Repeat the summary, imaging table and flowcell map with the same workspace, and report the allocations
+ * made by each call after the first
+ *
+ * @param out output stream
+ * @param record_count number of extraction records in the synthetic run
+ * @param call_count number of times each call is repeated
+ */
+static void benchmark_workspace_calls(std::ostream& out, const size_t record_count, const size_t call_count)
+{
+    run_metrics metrics;
+    create_synthetic_run(metrics, record_count);
+    const model::plot::filter_options::id_t ALL_IDS = model::plot::filter_options::ALL_IDS;
+    const model::plot::filter_options map_options(constants::FourDigit, ALL_IDS, 0, constants::A, ALL_IDS, 1, 1);
+    model::summary::run_summary summary;
+    model::table::imaging_table table;
+    model::plot::flowcell_data map;
+    const char* calls[] = {"summary", "table", "flowcell"};
+    out << "Call      Calls  Seconds  Allocs/call  Growth/call" << std::endl;
+    for(size_t call=0;call<3;++call)
+    {
+        logic::utils::workspace workspace;
+        size_t allocation_count = 0;
+        size_t growth_count = 0;
+        double seconds = 0;
+        for(size_t i=0;i<call_count;++i)
+        {
+            const size_t allocation_start = s_allocation_count;
+            double call_seconds = 0;
+            {
+                util::scoped_timer timer(call_seconds);
+                if(call == 0) logic::summary::summarize_run_metrics(metrics, summary, workspace);
+                else if(call == 1) logic::table::create_imaging_table(metrics, table, workspace);
+                else logic::plot::plot_flowcell_map(metrics, constants::Intensity, map_options, map, workspace);
+            }
+            seconds += call_seconds;
+            // The first call sizes the workspace buffers
+            if(i == 0) continue;
+            allocation_count += s_allocation_count - allocation_start;
+            growth_count += workspace.buffer_growth_count();
+        }
+        out << std::left << std::setw(10) << calls[call]
+            << std::setw(7) << call_count
+            << std::setw(9) << std::setprecision(3) << seconds
+            << std::setw(13) << (call_count > 1 ? allocation_count / (call_count-1) : 0)
+            << (call_count > 1 ? growth_count / (call_count-1) : 0) << std::endl;
+    }
+}
+
+/** Compare looking up every record by id, one at a time, to a single batch lookup
+ *
+ * @param out output stream
+ * @param record_count number of error metric records
+ */
+static void benchmark_batch_lookup(std::ostream& out, const size_t record_count)
+{
+    typedef model::metric_base::metric_set<error_metric> error_metric_set_t;
+    const ::uint32_t lane_count = 4;
+    const ::uint32_t cycle_count = 250;
+    const ::uint32_t tile_count = static_cast< ::uint32_t >(std::max(record_count / (lane_count*cycle_count),
+                                                                    size_t(1)));
+    error_metric_set_t metrics;
+    metrics.reserve(lane_count*tile_count*cycle_count);
+    for(::uint32_t lane=1;lane<=lane_count;++lane)
+        for(::uint32_t tile=1;tile<=tile_count;++tile)
+            for(::uint32_t cycle=1;cycle<=cycle_count;++cycle)
+                metrics.insert(error_metric(lane, tile, cycle, static_cast<float>(cycle)));
+    metrics.rebuild_index(true);
+
+    error_metric_set_t::key_vector ids;
+    ids.reserve(metrics.size());
+    for(error_metric_set_t::const_iterator it = metrics.begin();it != metrics.end();++it)
+        ids.push_back(it->id());
+    // Visit the records by cycle rather than by tile, as the imaging table joins do
+    for(size_t i=0;i<ids.size();++i) std::swap(ids[i], ids[(i*7919) % ids.size()]);
+
+    double single_seconds = 0;
+    float single_sum = 0;
+    {
+        util::scoped_timer timer(single_seconds);
+        for(size_t i=0;i<ids.size();++i)
+            single_sum += metrics.get_metric(ids[i]).error_rate();
+    }
+    std::vector<const error_metric*> found(ids.size());
+    double batch_seconds = 0;
+    float batch_sum = 0;
+    {
+        util::scoped_timer timer(batch_seconds);
+        if(!ids.empty()) metrics.get_metrics(&ids[0], ids.size(), &found[0]);
+        for(size_t i=0;i<found.size();++i)
+            batch_sum += found[i]->error_rate();
+    }
+    out << "Lookup  Records   Seconds" << std::endl;
+    out << std::left << std::setw(8) << "single" << std::setw(10) << ids.size()
+        << std::setprecision(3) << single_seconds << std::endl;
+    out << std::left << std::setw(8) << "batch" << std::setw(10) << ids.size()
+        << std::setprecision(3) << batch_seconds << std::endl;
+    if(single_sum != batch_sum) out << "# Lookups differ" << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    if(argc <= 1)
+    {
+        std::cerr << "No arguments specified!" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    size_t record_count = 10000000;
+    std::string format = "all";
+    bool use_huge_pages = false;
+    bool use_io_hints = false;
+    bool cold = false;
+    size_t cycle_count = 300;
+    size_t chunk_count = 200;
+    size_t poll_count = 20;
+    util::option_parser description;
+    description
+            (record_count, "records", "Number of records in each synthetic file")
+            (format, "format", "Format to benchmark: q, tile, all, cycle (Q-metrics in one file per cycle), live"
+                               " (Q-metrics polled while a simulated writer appends to the file), reload"
+                               " (Q-metrics reloaded into the same set), workspace (summary, table and flowcell"
+                               " map repeated with the same workspace) or lookup (error metrics looked up by id"
+                               " one at a time and in a batch)")
+            (use_huge_pages, "huge-pages", "Back the metric storage with huge pages")
+            (use_io_hints, "io-hints", "Give the kernel I/O hints and prefetch cycle files")
+            (cold, "cold", "Drop the files from the page cache before loading")
+            (cycle_count, "cycles", "Number of cycle files for the cycle format")
+            (chunk_count, "chunks", "Number of chunks appended by the simulated writer for the live format")
+            (poll_count, "polls", "Number of times the file is reloaded for the reload format, or each call is"
+                                  " repeated for the workspace format");
+    if(description.is_help_requested(argc, argv))
+    {
+        std::cout << "Usage: " << io::basename(argv[0]) << " output_folder [--option1=value1] [--option2=value2]" << std::endl;
+        description.display_help(std::cout);
+        return SUCCESS;
+    }
+    try{
+        description.parse(argc, argv);
+        description.check_for_unknown_options(argc, argv);
+    }
+    catch(const util::option_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    if(format != "all" && format != "q" && format != "tile" && format != "cycle" && format != "live" &&
+       format != "reload" && format != "workspace" && format != "lookup")
+    {
+        std::cerr << "Unknown format: " << format << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+
+    if(cycle_count == 0)
+    {
+        std::cerr << "Number of cycles must be greater than 0" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    if(chunk_count == 0)
+    {
+        std::cerr << "Number of chunks must be greater than 0" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+
+    util::memory_policy::use_huge_pages(use_huge_pages);
+    io::io_hints::use_hints(use_io_hints);
+    std::cout << "# Version: " << INTEROP_VERSION << std::endl;
+    std::cout << "# Huge pages: " << (use_huge_pages && util::memory_policy::is_huge_page_supported()) << std::endl;
+    std::cout << "# NUMA nodes: " << util::memory_policy::numa_node_count() << std::endl;
+    std::cout << "# I/O hints: " << (use_io_hints && io::io_hints::is_supported()) << std::endl;
+    if(format != "live" && format != "reload" && format != "workspace" && format != "lookup")
+        std::cout << "Format  Records   Metrics   Seconds  Rehash(reserved)  Rehash(unreserved)  PeakRSS(MB)  Scan(s)  dTLBMiss"
+                  << std::endl;
+    try
+    {
+        if(format == "all" || format == "q")
+        {
+            const std::string file_name = io::combine(argv[1], "QMetricsOut.bin");
+            write_q_metrics(file_name, record_count);
+            model::metric_base::metric_set<q_metric> metrics;
+            const size_t record_size = 6 + 7*sizeof(::uint32_t);
+            benchmark_load(std::cout, "Q", file_name, record_size, cold, metrics);
+        }
+        if(format == "all" || format == "tile")
+        {
+            const std::string file_name = io::combine(argv[1], "TileMetricsOut.bin");
+            write_tile_metrics(file_name, record_count);
+            model::metric_base::metric_set<tile_metric> metrics;
+            const size_t record_size = 10;
+            benchmark_load(std::cout, "Tile", file_name, record_size, cold, metrics);
+        }
+        if(format == "cycle")
+        {
+            const std::string run_folder = io::combine(argv[1], "ByCycle");
+            write_q_metrics_by_cycle(run_folder, record_count, cycle_count);
+            model::metric_base::metric_set<q_metric> metrics;
+            const size_t record_size = 6 + 7*sizeof(::uint32_t);
+            benchmark_load_by_cycle(std::cout, "QCycle", run_folder, cycle_count, record_size, cold, metrics);
+        }
+        if(format == "live")
+            benchmark_live_polling(std::cout, io::combine(argv[1], "QMetricsOut.bin"), record_count, chunk_count);
+        if(format == "reload")
+            benchmark_reload_polling(std::cout, io::combine(argv[1], "QMetricsOut.bin"), record_count, poll_count);
+        if(format == "workspace")
+            benchmark_workspace_calls(std::cout, record_count, poll_count);
+        if(format == "lookup")
+            benchmark_batch_lookup(std::cout, record_count);
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return UNEXPECTED_EXCEPTION;
+    }
+    return SUCCESS;
+}
+
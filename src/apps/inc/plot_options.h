@@ -8,7 +8,9 @@
  *  @copyright GNU Public License.
  */
 #pragma once
+#include <fstream>
 #include "interop/model/plot/filter_options.h"
+#include "interop/io/plot/image_writer.h"
 
 namespace illumina { namespace interop { namespace util
 {
@@ -81,22 +83,130 @@ void add_filter_options(illumina::interop::util::option_parser& description,
             (util::wrap_setter(options, &model::plot::filter_options::section), group+"section", "Only the data for the selected section will be displayed");
 }
 
+/** Add options to render the plot directly to an image
+ *
+ * This adds the following options to the parser:
+ *   - `--image-format=<png|svg>`: Render the plot to an image file rather than writing a GNUPlot script
+ *   - `--image-width=<pixels>`: Width of the rendered image
+ *   - `--image-height=<pixels>`: Height of the rendered image
+ *   - `--image-thread-count=<count>`: Number of threads used to rasterize the image
+ *
+ * @param description option parser
+ * @param image_format value to hold the image format, empty for a GNUPlot script
+ * @param width value to hold the image width
+ * @param height value to hold the image height
+ * @param thread_count value to hold the number of threads
+ */
+void add_image_options(illumina::interop::util::option_parser& description,
+                       std::string& image_format,
+                       size_t& width,
+                       size_t& height,
+                       size_t& thread_count)
+{
+    description
+            (image_format, "image-format", "Render the plot to an image file (png or svg) rather than writing a GNUPlot script")
+            (width, "image-width", "Width of the rendered image")
+            (height, "image-height", "Height of the rendered image")
+            (thread_count, "image-thread-count", "Number of threads used to rasterize the image");
+}
+
+/** Create the image writer from the image options
+ *
+ * @param image_format name of the image format, empty for a GNUPlot script
+ * @param width width of the rendered image
+ * @param height height of the rendered image
+ * @param thread_count number of threads used to rasterize the image
+ * @param writer destination image writer
+ * @return false if the image format is unknown
+ */
+bool create_image_writer(const std::string& image_format,
+                         const size_t width,
+                         const size_t height,
+                         const size_t thread_count,
+                         illumina::interop::io::plot::image_writer& writer)
+{
+    using namespace illumina::interop;
+    io::plot::image_writer::image_format format = io::plot::image_writer::PNG;
+    if(image_format != "" && !io::plot::image_writer::parse_format(image_format, format)) return false;
+    writer = io::plot::image_writer(format, width, height, thread_count);
+    return true;
+}
+
 /** Create a default image file name
  *
  * @param plot_name name of the plot
  * @param run_name name of the run folder
  * @param metric_name optional metric name
  * @param extra extra info
+ * @param extension file extension of the image
  * @return plot image filename
  */
 std::string plot_image_name(const std::string& plot_name,
                             const std::string& run_name,
                             const std::string& metric_name="",
-                            const std::string& extra="")
+                            const std::string& extra="",
+                            const std::string& extension=".png")
 {
     std::string name = run_name+"_"+plot_name;
     if(metric_name != "") name += "_"+metric_name;
     if(extra != "") name += "_"+extra;
-    return name+".png";
+    return name+extension;
+}
+
+/** Write a flowcell heat map with the image writer
+ *
+ * @param writer image writer
+ * @param out output stream
+ * @param data flowcell heat map
+ */
+inline void write_image(const illumina::interop::io::plot::image_writer& writer,
+                        std::ostream& out,
+                        const illumina::interop::model::plot::flowcell_data& data)
+{
+    writer.write_flowcell(out, data);
+}
+/** Write a heat map with the image writer
+ *
+ * @param writer image writer
+ * @param out output stream
+ * @param data heat map
+ */
+inline void write_image(const illumina::interop::io::plot::image_writer& writer,
+                        std::ostream& out,
+                        const illumina::interop::model::plot::heatmap_data& data)
+{
+    writer.write_heatmap(out, data);
+}
+/** Write a chart with the image writer
+ *
+ * @param writer image writer
+ * @param out output stream
+ * @param data line, candlestick or bar plot
+ */
+template<class Point>
+void write_image(const illumina::interop::io::plot::image_writer& writer,
+                 std::ostream& out,
+                 const illumina::interop::model::plot::plot_data<Point>& data)
+{
+    writer.write_chart(out, data);
+}
+
+/** Write a plot to an image file with the built-in renderer
+ *
+ * @param writer image writer
+ * @param data plot data, any type accepted by the image writer
+ * @param filename destination image file
+ * @return true if the image was written
+ */
+template<class PlotData>
+bool write_plot_image(const illumina::interop::io::plot::image_writer& writer,
+                      const PlotData& data,
+                      const std::string& filename)
+{
+    std::ofstream fout(filename.c_str(), std::ios::binary);
+    if(!fout.good()) return false;
+    write_image(writer, fout, data);
+    std::cout << "# Image: " << filename << std::endl;
+    return fout.good();
 }
 
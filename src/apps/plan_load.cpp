@@ -0,0 +1,133 @@
+/** @page plan_load Plan and time loading a run folder
+ *
+ * This developer application plans how to load the InterOp files of a run folder, loads the run following the plan
+ * and reports the plan along with the load time. The plan lists the storage holding the run folder, the number of
+ * threads and, for each metric group, the decode path, the number of files and bytes, and the stream buffer size.
+ *
+ * ### Running the Program
+ *
+ * The program runs as follows:
+ *
+ *      $ plan_load 140131_1287_0851_A01n401drr
+ *
+ *      # Version: v3.0.35-src
+ *      # Run Folder: 140131_1287_0851_A01n401drr
+ *      # Mount point: /
+ *      # Storage: local
+ *      # Cores: 8
+ *      # Threads: 3
+ *      Group             Path      Files   Bytes         Records     Buffer
+ *      Error             stream    1       6002          500         0
+ *      Extraction        buffered  1       2128402       55985       1048576
+ *      ...
+ *      # Load seconds: 0.0432
+ *
+ * The planner parameters may be calibrated for the storage holding the run folder. The calibration times reads of a
+ * large file with several buffer sizes and thread counts, and saves the fastest for the mount point in a tuning file:
+ *
+ *      $ plan_load 140131_1287_0851_A01n401drr --config=load_tuning.txt --calibrate=InterOp/QMetricsOut.bin
+ *
+ * Subsequent runs with the same tuning file use the parameters saved for the mount point.
+ */
+
+#include <iostream>
+#include "interop/util/filesystem.h"
+#include "interop/util/option_parser.h"
+#include "interop/util/timer.h"
+#include "interop/io/load_planner.h"
+#include "interop/model/run_metrics.h"
+#include "interop/version.h"
+#include "inc/application.h"
+
+using namespace illumina::interop::model::metrics;
+using namespace illumina::interop;
+
+int main(int argc, const char** argv)
+{
+    if(argc <= 1)
+    {
+        std::cerr << "No arguments specified!" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    std::string config_file;
+    std::string probe_file;
+    util::option_parser description;
+    description
+            (config_file, "config", "Tuning file holding the planner parameters of each mount point")
+            (probe_file, "calibrate", "Large file used to calibrate the planner parameters, saved to the tuning file");
+    if(description.is_help_requested(argc, argv))
+    {
+        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [--option1=value1] [--option2=value2]" << std::endl;
+        description.display_help(std::cout);
+        return SUCCESS;
+    }
+    try{
+        description.parse(argc, argv);
+        description.check_for_unknown_options(argc, argv);
+    }
+    catch(const util::option_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+
+    const std::string run_folder = argv[1];
+    std::cout << "# Version: " << INTEROP_VERSION << std::endl;
+    std::cout << "# Run Folder: " << io::basename(run_folder) << std::endl;
+
+    const std::string mount_point = io::load_planner::mount_point_of(run_folder);
+    io::load_tuning tuning;
+    if(!config_file.empty()) io::read_load_tuning(config_file, mount_point, tuning);
+    if(!probe_file.empty())
+    {
+        tuning = io::load_planner(tuning).calibrate(probe_file);
+        std::cout << "# Calibrated buffer size: " << tuning.buffer_size << std::endl;
+        if(!config_file.empty() && !io::write_load_tuning(config_file, mount_point, tuning))
+        {
+            std::cerr << "Unable to write tuning file: " << config_file << std::endl;
+            return UNEXPECTED_EXCEPTION;
+        }
+    }
+
+    const io::load_planner planner(tuning);
+    run_metrics run;
+    double seconds = 0;
+    try
+    {
+        run.read_xml(run_folder);
+        run.plan_load(run_folder, run.run_info().total_cycles(), planner).write(std::cout);
+        util::scoped_timer timer(seconds);
+        run.read(run_folder, planner);
+    }
+    catch(const model::invalid_run_info_cycle_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    catch(const xml::xml_file_not_found_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return MISSING_RUNINFO_XML;
+    }
+    catch(const xml::xml_parse_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return MALFORMED_XML;
+    }
+    catch(const io::bad_format_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return BAD_FORMAT;
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return UNEXPECTED_EXCEPTION;
+    }
+    std::cout << "# Load seconds: " << seconds << std::endl;
+    if(run.empty())
+    {
+        std::cerr << "No InterOp files found" << std::endl;
+        return EMPTY_INTEROP;
+    }
+    return SUCCESS;
+}
@@ -48,6 +48,13 @@
  *   - `--filter-by-swath=<swath number>`: Only the data for the selected swath will be displayed
  *   - `--filter-by-section=<section number>`: Only the data for the selected section will be displayed
  *
+ * #### Image Options
+ *
+ *   - `--image-format=<png|svg>`: Render the plot to an image file rather than writing a GNUPlot script
+ *   - `--image-width=<pixels>`: Width of the rendered image (default 800)
+ *   - `--image-height=<pixels>`: Height of the rendered image (default 600)
+ *   - `--image-thread-count=<count>`: Number of threads used to rasterize the image
+ *
  */
 
 #include <iostream>
@@ -79,9 +86,14 @@ int main(int argc, const char** argv)
 
     model::plot::filter_options options(constants::UnknownTileNamingMethod);
     std::string metric_name="Intensity";
+    std::string image_format;
+    size_t image_width = 800;
+    size_t image_height = 600;
+    size_t image_thread_count = 1;
     util::option_parser description;
     add_metric_option(description, metric_name);
     add_filter_options(description, options);
+    add_image_options(description, image_format, image_width, image_height, image_thread_count);
     if(description.is_help_requested(argc, argv))
     {
         std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [--option1=value1] [--option2=value2]" << std::endl;
@@ -97,6 +109,12 @@ int main(int argc, const char** argv)
         std::cerr << ex.what() << std::endl;
         return INVALID_ARGUMENTS;
     }
+    io::plot::image_writer image_writer;
+    if(!create_image_writer(image_format, image_width, image_height, image_thread_count, image_writer))
+    {
+        std::cerr << "Unknown image format: " << image_format << std::endl;
+        return INVALID_ARGUMENTS;
+    }
     std::vector<unsigned char> valid_to_load;
     try
     {
@@ -139,6 +157,15 @@ int main(int argc, const char** argv)
         if(data.size() == 0 ) continue;
 
 
+        if(image_format != "")
+        {
+            if(!write_plot_image(image_writer, data, plot_image_name(metric_name+"-by-cycle", run_name, metric_name, "", image_writer.extension())))
+            {
+                std::cerr << "Unable to write image for " << run_name << std::endl;
+                return UNEXPECTED_EXCEPTION;
+            }
+            continue;
+        }
         std::ostream& out = std::cout;
         io::plot::gnuplot_writer plot_writer;
         try
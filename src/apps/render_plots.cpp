@@ -0,0 +1,188 @@
+/** @page render_plots Render every plot of a run
+ *
+ * This application loads a run folder once and renders every plot supported by the run directly to PNG or SVG
+ * images, without GNUPlot. For each metric present in the run, it renders the flowcell heat map and either the
+ * by cycle plot (for cycle metrics) or the by lane plot (for tile metrics). If the run has q-metrics, it also
+ * renders the q-score histogram and the q-score heat map.
+ *
+ * ### Running the Program
+ *
+ * The program runs as follows:
+ *
+ *      $ render_plots 140131_1287_0851_A01n401drr --output-dir=plots --image-format=svg
+ *
+ *      # Version: v3.0.35-src
+ *      # Run Folder: 140131_1287_0851_A01n401drr
+ *      # Image: plots/140131_1287_0851_A01n401drr_flowcell-Intensity.svg
+ *      # Image: plots/140131_1287_0851_A01n401drr_Intensity-by-cycle_Intensity.svg
+ *      ...
+ *
+ * ### Available Options
+ *
+ *   - `--output-dir=<directory>`: Directory where the images are written (default: current directory)
+ *   - `--image-format=<png|svg>`: Format of the images (default: png)
+ *   - `--image-width=<pixels>`: Width of the rendered images (default 800)
+ *   - `--image-height=<pixels>`: Height of the rendered images (default 600)
+ *   - `--image-thread-count=<count>`: Number of threads used to rasterize each image
+ *   - `--thread-count=<count>`: Number of threads used to load the run folder
+ *
+ * The flowcell heat maps show cycle 1, base A and the first channel, the same defaults as plot_flowcell.
+ */
+
+#include <iostream>
+#include "interop/util/filesystem.h"
+#include "interop/logic/utils/enums.h"
+#include "interop/model/run_metrics.h"
+#include "interop/logic/plot/plot_by_cycle.h"
+#include "interop/logic/plot/plot_by_lane.h"
+#include "interop/logic/plot/plot_flowcell_map.h"
+#include "interop/logic/plot/plot_metric_list.h"
+#include "interop/logic/plot/plot_qscore_heatmap.h"
+#include "interop/logic/plot/plot_qscore_histogram.h"
+#include "interop/version.h"
+#include "inc/application.h"
+#include "inc/plot_options.h"
+
+using namespace illumina::interop::model::metrics;
+using namespace illumina::interop;
+
+/** Render every plot of a loaded run
+ *
+ * Plots that cannot be created for this run are reported and skipped.
+ *
+ * @param run loaded run metrics
+ * @param run_name name of the run folder
+ * @param output_dir directory where the images are written
+ * @param writer image writer
+ * @return number of plots that failed
+ */
+size_t render_plots(run_metrics& run,
+                    const std::string& run_name,
+                    const std::string& output_dir,
+                    const io::plot::image_writer& writer)
+{
+    const constants::tile_naming_method naming_method = run.run_info().flowcell().naming_method();
+    const model::plot::filter_options options(naming_method);
+    model::plot::filter_options flowcell_options(naming_method);
+    flowcell_options.cycle(1);
+    flowcell_options.dna_base(constants::A);
+    flowcell_options.channel(0);
+
+    std::vector<logic::utils::metric_type_description_t> types;
+    logic::plot::list_available_plot_metrics(run, types);
+    size_t failed = 0;
+    for(size_t i=0;i<types.size();++i)
+    {
+        const constants::metric_type type = types[i];
+        const std::string metric_name = constants::to_string(type);
+        try
+        {
+            model::plot::flowcell_data flowcell;
+            logic::plot::plot_flowcell_map(run, type, flowcell_options, flowcell);
+            if(flowcell.length() > 0 && !write_plot_image(writer, flowcell, io::combine(output_dir,
+                    plot_image_name("flowcell-"+metric_name, run_name, "", "", writer.extension()))))
+                ++failed;
+
+            model::plot::plot_data<model::plot::candle_stick_point> chart;
+            if(logic::utils::is_cycle_metric(type))
+            {
+                logic::plot::plot_by_cycle(run, type, options, chart);
+                if(chart.size() > 0 && !write_plot_image(writer, chart, io::combine(output_dir,
+                        plot_image_name(metric_name+"-by-cycle", run_name, metric_name, "", writer.extension()))))
+                    ++failed;
+            }
+            else
+            {
+                logic::plot::plot_by_lane(run, type, options, chart);
+                if(chart.size() > 0 && !write_plot_image(writer, chart, io::combine(output_dir,
+                        plot_image_name(metric_name+"-by-lane", run_name, metric_name, "", writer.extension()))))
+                    ++failed;
+            }
+        }
+        catch(const std::exception& ex)
+        {
+            std::cerr << "Skipping " << metric_name << ": " << ex.what() << std::endl;
+            ++failed;
+        }
+    }
+    if(run.get<q_metric>().empty()) return failed;
+    try
+    {
+        model::plot::plot_data<model::plot::bar_point> histogram;
+        logic::plot::plot_qscore_histogram(run, options, histogram);
+        if(histogram.size() > 0 && !write_plot_image(writer, histogram, io::combine(output_dir,
+                plot_image_name("q-histogram", run_name, "", "", writer.extension()))))
+            ++failed;
+        model::plot::heatmap_data heatmap;
+        logic::plot::plot_qscore_heatmap(run, options, heatmap);
+        if(heatmap.length() > 0 && !write_plot_image(writer, heatmap, io::combine(output_dir,
+                plot_image_name("q-heat-map", run_name, "", "", writer.extension()))))
+            ++failed;
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << "Skipping q-score plots: " << ex.what() << std::endl;
+        ++failed;
+    }
+    return failed;
+}
+
+int main(int argc, const char** argv)
+{
+    if(argc <= 1)
+    {
+        std::cerr << "No arguments specified!" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    std::string output_dir = ".";
+    std::string image_format = "png";
+    size_t image_width = 800;
+    size_t image_height = 600;
+    size_t image_thread_count = 1;
+    size_t thread_count = 1;
+    util::option_parser description;
+    description
+            (output_dir, "output-dir", "Directory where the images are written")
+            (thread_count, "thread-count", "Number of threads used to load the run folder");
+    add_image_options(description, image_format, image_width, image_height, image_thread_count);
+    if(description.is_help_requested(argc, argv))
+    {
+        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [--option1=value1] [--option2=value2]" << std::endl;
+        description.display_help(std::cout);
+        return SUCCESS;
+    }
+    try{
+        description.parse(argc, argv);
+        description.check_for_unknown_options(argc, argv);
+    }
+    catch(const util::option_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    io::plot::image_writer image_writer;
+    if(image_format == "" ||
+       !create_image_writer(image_format, image_width, image_height, image_thread_count, image_writer))
+    {
+        std::cerr << "Unknown image format: " << image_format << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    std::cout << "# Version: " << INTEROP_VERSION << std::endl;
+
+    int ret = SUCCESS;
+    for(int i=1;i<argc;i++)
+    {
+        if(argv[i][0] == '-') continue;
+        run_metrics run;
+        const std::string run_name = io::basename(argv[i]);
+        std::cout << "# Run Folder: " << run_name << std::endl;
+        const int status = read_run_metrics(argv[i], run, thread_count);
+        if(status != SUCCESS)
+        {
+            ret = status;
+            continue;
+        }
+        if(render_plots(run, run_name, output_dir, image_writer) > 0) ret = UNEXPECTED_EXCEPTION;
+    }
+    return ret;
+}
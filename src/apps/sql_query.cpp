@@ -0,0 +1,144 @@
+/** @page sql_query Query InterOp data with SQL
+ *
+ * This application loads one or more run folders and runs a SQL query over the loaded metrics, without exporting
+ * them to text first. Each loaded metric group is a table named after the group, with the same columns as the
+ * dumptext output. When several run folders are given, the tables of the first run are prefixed with `run1_`,
+ * those of the second with `run2_` and so on.
+ *
+ * This application is only built when SQLite 3 is found.
+ *
+ * ### Running the Program
+ *
+ * The program runs as follows:
+ *
+ *      $ sql_query 140131_1287_0851_A01n401drr --query="SELECT Tile, ErrorRate FROM Error WHERE Lane=1 AND Cycle=25"
+ *
+ *      # Version: v3.0.35-src
+ *      Tile,ErrorRate
+ *      1110,0.162742
+ *      1111,0.161539
+ *
+ * Equality constraints on Lane, Tile and Cycle (or Read) are answered from the id index of the loaded metrics, so
+ * such queries do not scan every record.
+ */
+
+#include <iostream>
+#include <sqlite3.h>
+#include "interop/util/filesystem.h"
+#include "interop/util/option_parser.h"
+#include "interop/util/lexical_cast.h"
+#include "interop/io/sqlite_module.h"
+#include "interop/model/run_metrics.h"
+#include "interop/version.h"
+#include "inc/application.h"
+
+using namespace illumina::interop::model::metrics;
+using namespace illumina::interop;
+
+/** Write the rows of a query as comma separated values
+ *
+ * @param out output stream
+ * @param statement prepared statement
+ * @return SQLite status of the last step
+ */
+static int write_rows(std::ostream& out, sqlite3_stmt* statement)
+{
+    const int column_count = sqlite3_column_count(statement);
+    for(int i=0;i<column_count;++i)
+        out << (i > 0 ? "," : "") << sqlite3_column_name(statement, i);
+    out << std::endl;
+    int status;
+    while((status = sqlite3_step(statement)) == SQLITE_ROW)
+    {
+        for(int i=0;i<column_count;++i)
+        {
+            if(i > 0) out << ",";
+            const unsigned char* text = sqlite3_column_text(statement, i);
+            out << (text == 0 ? "-" : reinterpret_cast<const char*>(text));
+        }
+        out << "\n";
+    }
+    out.flush();
+    return status;
+}
+
+int main(int argc, const char** argv)
+{
+    if(argc <= 1)
+    {
+        std::cerr << "No arguments specified!" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    std::string query;
+    size_t thread_count = 1;
+    util::option_parser description;
+    description
+            (query, "query", "SQL query to run over the loaded metrics")
+            (thread_count, "thread-count", "Number of threads used to load each run folder");
+    if(description.is_help_requested(argc, argv))
+    {
+        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder1 [run_folder2] --query=\"SELECT ...\""
+                  << std::endl;
+        description.display_help(std::cout);
+        return SUCCESS;
+    }
+    try{
+        description.parse(argc, argv);
+        description.check_for_unknown_options(argc, argv);
+    }
+    catch(const util::option_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    if(query.empty())
+    {
+        std::cerr << "No query specified" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    std::cout << "# Version: " << INTEROP_VERSION << std::endl;
+
+    std::vector<std::string> run_folders;
+    for(int i=1;i<argc;++i)
+    {
+        if(argv[i][0] != '-') run_folders.push_back(argv[i]);
+    }
+    // Tables reference the loaded metrics, so every run is kept loaded until the database is closed
+    std::vector<run_metrics> runs(run_folders.size());
+    sqlite3* db = 0;
+    if(sqlite3_open(":memory:", &db) != SQLITE_OK)
+    {
+        std::cerr << "Unable to open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return UNEXPECTED_EXCEPTION;
+    }
+    int ret = SUCCESS;
+    for(size_t i=0;i<run_folders.size() && ret == SUCCESS;++i)
+    {
+        ret = read_run_metrics(run_folders[i].c_str(), runs[i], thread_count);
+        if(ret != SUCCESS) break;
+        const std::string prefix = run_folders.size() > 1 ? "run" + util::lexical_cast<std::string>(i+1) + "_" : "";
+        try
+        {
+            io::attach_run_metrics(db, runs[i], prefix);
+        }
+        catch(const io::sqlite_exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            ret = UNEXPECTED_EXCEPTION;
+        }
+    }
+    if(ret == SUCCESS)
+    {
+        sqlite3_stmt* statement = 0;
+        if(sqlite3_prepare_v2(db, query.c_str(), -1, &statement, 0) != SQLITE_OK ||
+           write_rows(std::cout, statement) != SQLITE_DONE)
+        {
+            std::cerr << "Query failed: " << sqlite3_errmsg(db) << std::endl;
+            ret = INVALID_ARGUMENTS;
+        }
+        sqlite3_finalize(statement);
+    }
+    sqlite3_close(db);
+    return ret;
+}
@@ -82,6 +82,7 @@ METRICS_EXCEPTION_WRAPPER(WRAP_EXCEPTION)
 %include "interop/model/metric_base/base_cycle_metric.h"
 %include "interop/model/metric_base/base_read_metric.h"
 %include "interop/model/metric_base/metric_set.h"
+%include "interop/model/metric_base/tile_filter.h"
 
 
 %include "interop/model/metric_base/point2d.h"
@@ -140,6 +141,7 @@ METRICS_EXCEPTION_WRAPPER(WRAP_EXCEPTION)
     WRAPPER(index_metric)
     WRAPPER(q_collapsed_metric)
     WRAPPER(q_by_lane_metric)
+    WRAPPER(q_by_tile_read_metric)
 %enddef
 
 
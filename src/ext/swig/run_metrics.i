@@ -93,8 +93,11 @@ RUN_METRICS_EXCEPTION_WRAPPER(WRAP_EXCEPTION)
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 %{
+#include "interop/io/load_scheduler.h"
 #include "interop/model/run_metrics.h"
 %}
+%ignore illumina::interop::io::load_scheduler::run;
+%include "interop/io/load_scheduler.h"
 %include "interop/model/run_metrics.h"
 
 %define WRAP_RUN_METRICS(metric_t)
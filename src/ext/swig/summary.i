@@ -11,6 +11,7 @@
 // Don't wrap it, just use it with %import
 //////////////////////////////////////////////
 %import "src/ext/swig/exceptions/exceptions_impl.i"
+%include "src/ext/swig/arrays/arrays_impl.i"
 %import "src/ext/swig/run.i"
 %import "src/ext/swig/metrics.i"
 %import "src/ext/swig/run_metrics.i"
@@ -63,6 +64,7 @@ RUN_METRICS_EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
 #include "interop/model/summary/metric_stat.h"
 #include "interop/model/summary/read_summary.h"
 #include "interop/model/summary/run_summary.h"
+#include "interop/model/summary/columnar_summary.h"
 #include "interop/logic/metric/q_metric.h"
 %}
 
@@ -72,6 +74,9 @@ RUN_METRICS_EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
 %ignore illumina::interop::model::summary::run_summary::total_summary()const;
 %ignore illumina::interop::model::summary::run_summary::nonindex_summary()const;
 %ignore illumina::interop::model::summary::run_summary::cycle_state()const;
+// Export the columns with copy_values, which fills a NumPy or C# array in a single call
+%ignore illumina::interop::model::summary::columnar_summary::column_data;
+%ignore illumina::interop::model::summary::columnar_summary::values;
 
 %include "interop/model/summary/cycle_state_summary.h"
 %include "interop/model/summary/stat_summary.h"
@@ -81,6 +86,7 @@ RUN_METRICS_EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
 %include "interop/model/summary/metric_stat.h"
 %include "interop/model/summary/read_summary.h"
 %include "interop/model/summary/run_summary.h"
+%include "interop/model/summary/columnar_summary.h"
 
 //
 // Setup typemaps for summary metrics
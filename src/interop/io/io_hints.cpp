@@ -0,0 +1,316 @@
+/** Kernel I/O hints for reading InterOp files
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/io/io_hints.h"
+
+#include <algorithm>
+#include <fstream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#endif
+
+namespace illumina { namespace interop { namespace io
+{
+    bool io_hints::s_use_hints = false;
+    size_t io_hints::s_prefetch_depth = 4;
+    cache_drop_policy io_hints::s_drop_policy = DropCacheWhenConstrained;
+
+    /** Enable or disable I/O hints
+     *
+     * @param enable true to give the kernel I/O hints
+     */
+    void io_hints::use_hints(const bool enable)
+    {
+        s_use_hints = enable;
+    }
+    /** Test if I/O hints are enabled
+     *
+     * @return true if I/O hints are enabled
+     */
+    bool io_hints::use_hints()
+    {
+        return s_use_hints;
+    }
+    /** Set the number of files to prefetch ahead of the file being decoded
+     *
+     * @param depth number of files
+     */
+    void io_hints::prefetch_depth(const size_t depth)
+    {
+        s_prefetch_depth = depth;
+    }
+    /** Get the number of files to prefetch ahead of the file being decoded
+     *
+     * @return number of files
+     */
+    size_t io_hints::prefetch_depth()
+    {
+        return s_prefetch_depth;
+    }
+    /** Set the policy for dropping decoded files from the page cache
+     *
+     * @param policy drop policy
+     */
+    void io_hints::drop_policy(const cache_drop_policy policy)
+    {
+        s_drop_policy = policy;
+    }
+    /** Get the policy for dropping decoded files from the page cache
+     *
+     * @return drop policy
+     */
+    cache_drop_policy io_hints::drop_policy()
+    {
+        return s_drop_policy;
+    }
+    /** Test if the platform supports I/O hints
+     *
+     * @return true if I/O hints are supported
+     */
+    bool io_hints::is_supported()
+    {
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    }
+    /** Start reading a whole file into the page cache
+     *
+     * @param file_name path to the file
+     * @return true if the hint was given
+     */
+    bool io_hints::will_need(const std::string& file_name)
+    {
+#ifdef __linux__
+        const int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat status;
+        bool given = fstat(fd, &status) == 0;
+        // readahead reads the whole file in one request, posix_fadvise is the portable fallback
+        if (given && readahead(fd, 0, static_cast<size_t>(status.st_size)) != 0)
+            given = posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0;
+        close(fd);
+        return given;
+#else
+        (void)file_name;
+        return false;
+#endif
+    }
+    /** Drop the clean pages of a file from the page cache
+     *
+     * @param file_name path to the file
+     * @return true if the hint was given
+     */
+    bool io_hints::dont_need(const std::string& file_name)
+    {
+#ifdef __linux__
+        const int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        const bool given = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        close(fd);
+        return given;
+#else
+        (void)file_name;
+        return false;
+#endif
+    }
+    /** Test if the memory available to the page cache is low
+     *
+     * @return true if memory is constrained, false if not or unknown
+     */
+    bool io_hints::is_memory_constrained()
+    {
+#ifdef __linux__
+        std::ifstream fin("/proc/meminfo");
+        std::string key;
+        size_t value;
+        std::string unit;
+        size_t total = 0;
+        size_t available = 0;
+        while (fin >> key >> value >> unit)
+        {
+            if (key == "MemTotal:") total = value;
+            else if (key == "MemAvailable:") available = value;
+        }
+        return total > 0 && available > 0 && available < total / 8;
+#else
+        return false;
+#endif
+    }
+
+#ifdef __linux__
+    namespace detail
+    {
+        /** State shared between a prefetcher and its helper thread */
+        struct prefetch_state
+        {
+            /** Constructor
+             *
+             * @param names files to prefetch
+             */
+            explicit prefetch_state(const std::vector<std::string>& names) :
+                    file_names(names),
+                    next(0),
+                    limit(0),
+                    count(0),
+                    stop(false)
+            {
+                pthread_mutex_init(&mutex, 0);
+                pthread_cond_init(&ready, 0);
+            }
+            /** Destructor */
+            ~prefetch_state()
+            {
+                pthread_cond_destroy(&ready);
+                pthread_mutex_destroy(&mutex);
+            }
+            /** Files to prefetch */
+            const std::vector<std::string>& file_names;
+            /** Index of the next file to prefetch */
+            size_t next;
+            /** Index past the last file that may be prefetched */
+            size_t limit;
+            /** Number of files prefetched */
+            size_t count;
+            /** Flag to stop the helper thread */
+            bool stop;
+            /** Guard for the indices and the flag */
+            pthread_mutex_t mutex;
+            /** Signaled when the limit is raised or the thread is stopped */
+            pthread_cond_t ready;
+            /** Helper thread */
+            pthread_t thread;
+        };
+
+        /** Prefetch files up to the limit until stopped
+         *
+         * @param arg prefetch state
+         * @return null
+         */
+        extern "C" void* prefetch_files(void* arg)
+        {
+            prefetch_state& state = *static_cast<prefetch_state*>(arg);
+            pthread_mutex_lock(&state.mutex);
+            for (;;)
+            {
+                while (!state.stop && state.next >= state.limit)
+                    pthread_cond_wait(&state.ready, &state.mutex);
+                if (state.stop) break;
+                const size_t index = state.next++;
+                pthread_mutex_unlock(&state.mutex);
+                io_hints::will_need(state.file_names[index]);
+                pthread_mutex_lock(&state.mutex);
+                ++state.count;
+            }
+            pthread_mutex_unlock(&state.mutex);
+            return 0;
+        }
+    }
+#endif
+
+    /** Constructor
+     *
+     * @param file_names files in the order they are decoded, must outlive the prefetcher
+     */
+    cycle_prefetcher::cycle_prefetcher(const std::vector<std::string>& file_names) :
+            m_file_names(file_names),
+            m_drop(false),
+            m_state(0)
+    {
+        if (!io_hints::use_hints() || !io_hints::is_supported()) return;
+        const cache_drop_policy policy = io_hints::drop_policy();
+        m_drop = policy == AlwaysDropCache || (policy == DropCacheWhenConstrained && io_hints::is_memory_constrained());
+#ifdef __linux__
+        if (file_names.size() < 2 || io_hints::prefetch_depth() == 0) return;
+        detail::prefetch_state* state = new detail::prefetch_state(file_names);
+        if (pthread_create(&state->thread, 0, detail::prefetch_files, state) != 0)
+        {
+            delete state;
+            return;
+        }
+        m_state = state;
+#endif
+    }
+    /** Destructor, stop and join the helper thread */
+    cycle_prefetcher::~cycle_prefetcher()
+    {
+#ifdef __linux__
+        if (m_state == 0) return;
+        detail::prefetch_state* state = static_cast<detail::prefetch_state*>(m_state);
+        pthread_mutex_lock(&state->mutex);
+        state->stop = true;
+        pthread_cond_signal(&state->ready);
+        pthread_mutex_unlock(&state->mutex);
+        pthread_join(state->thread, 0);
+        delete state;
+#endif
+    }
+    /** Signal that a file is about to be decoded
+     *
+     * The helper thread skips the file being decoded, since it is already read by the decoder.
+     *
+     * @param index index of the file
+     */
+    void cycle_prefetcher::advance(const size_t index)
+    {
+#ifdef __linux__
+        if (m_state == 0) return;
+        detail::prefetch_state* state = static_cast<detail::prefetch_state*>(m_state);
+        const size_t limit = std::min(index + 1 + io_hints::prefetch_depth(), m_file_names.size());
+        pthread_mutex_lock(&state->mutex);
+        state->next = std::max(state->next, index + 1);
+        if (limit > state->limit)
+        {
+            state->limit = limit;
+            pthread_cond_signal(&state->ready);
+        }
+        pthread_mutex_unlock(&state->mutex);
+#else
+        (void)index;
+#endif
+    }
+    /** Signal that a file was decoded and will not be read again
+     *
+     * @param index index of the file
+     */
+    void cycle_prefetcher::done(const size_t index)
+    {
+        if (m_drop && index < m_file_names.size()) io_hints::dont_need(m_file_names[index]);
+    }
+    /** Test if a helper thread is prefetching files
+     *
+     * @return true if a helper thread is running
+     */
+    bool cycle_prefetcher::is_active()const
+    {
+        return m_state != 0;
+    }
+    /** Get the number of files read into the page cache by the helper thread
+     *
+     * @return number of files prefetched so far
+     */
+    size_t cycle_prefetcher::prefetch_count()const
+    {
+#ifdef __linux__
+        if (m_state == 0) return 0;
+        detail::prefetch_state* state = static_cast<detail::prefetch_state*>(m_state);
+        pthread_mutex_lock(&state->mutex);
+        const size_t count = state->count;
+        pthread_mutex_unlock(&state->mutex);
+        return count;
+#else
+        return 0;
+#endif
+    }
+
+}}}
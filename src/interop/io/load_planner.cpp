@@ -0,0 +1,482 @@
+/** Plan how to load the InterOp files of a run folder
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <climits>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+#ifdef __linux__
+#include <sys/vfs.h>
+#include <sys/sysmacros.h>
+#endif
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include "interop/io/load_planner.h"
+#include "interop/io/io_hints.h"
+#include "interop/logic/utils/enums.h"
+#include "interop/util/filesystem.h"
+#include "interop/util/timer.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    namespace detail
+    {
+        /** Get the name of a class of storage
+         *
+         * @param storage class of storage
+         * @return name
+         */
+        const char* storage_name(const storage_type storage)
+        {
+            switch(storage)
+            {
+                case LocalStorage: return "local";
+                case RotationalStorage: return "rotational";
+                case NetworkStorage: return "network";
+                default: return "unknown";
+            }
+        }
+        /** Get the name of a load path
+         *
+         * @param path load path
+         * @return name
+         */
+        const char* load_path_name(const load_path path)
+        {
+            switch(path)
+            {
+                case StreamLoad: return "stream";
+                case BufferedLoad: return "buffered";
+                case ByCycleLoad: return "by-cycle";
+                default: return "skip";
+            }
+        }
+        /** Time reading a region of a file with one or more threads
+         *
+         * The clean pages of the file are dropped from the page cache first, where supported, so the read is timed
+         * from the storage. Each thread reads an equal part of the region through its own stream buffer.
+         *
+         * @param file_name path to the file
+         * @param offset offset of the region in bytes
+         * @param byte_count number of bytes in the region
+         * @param buffer_size size of the stream buffer of each thread
+         * @param thread_count number of threads
+         * @return number of seconds taken
+         */
+        double time_region_read(const std::string& file_name,
+                                const size_t offset,
+                                const size_t byte_count,
+                                const size_t buffer_size,
+                                const size_t thread_count)
+        {
+            io_hints::dont_need(file_name);
+            const size_t part_size = byte_count / thread_count;
+            double seconds = 0;
+            {
+                util::scoped_timer timer(seconds);
+#ifdef _OPENMP
+#               pragma omp parallel for num_threads(static_cast<int>(thread_count)) schedule(static, 1)
+#endif
+                for(int part=0;part<static_cast<int>(thread_count);++part)
+                {
+                    std::vector<char> buffer(buffer_size);
+                    std::vector<char> record(4096);
+                    std::ifstream fin;
+                    fin.rdbuf()->pubsetbuf(&buffer.front(), static_cast<std::streamsize>(buffer.size()));
+                    fin.open(file_name.c_str(), std::ios::binary);
+                    fin.seekg(static_cast<std::streamoff>(offset + static_cast<size_t>(part)*part_size));
+                    const std::streamsize record_size = static_cast<std::streamsize>(record.size());
+                    for(size_t n=0;n<part_size && fin.read(&record.front(), record_size);)
+                        n += record.size();
+                }
+            }
+            return seconds;
+        }
+#ifdef __linux__
+        /** Test if a file system type is a network file system
+         *
+         * @param type magic number of the file system
+         * @return true for NFS, SMB/CIFS, FUSE, Lustre, GPFS and AFS
+         */
+        bool is_network_file_system(const long type)
+        {
+            switch(static_cast<unsigned long>(type) & 0xFFFFFFFFul)
+            {
+                case 0x6969ul:      // NFS
+                case 0x517Bul:      // SMB
+                case 0xFF534D42ul:  // CIFS
+                case 0xFE534D42ul:  // SMB2
+                case 0x65735546ul:  // FUSE
+                case 0x0BD00BD0ul:  // Lustre
+                case 0x47504653ul:  // GPFS
+                case 0x5346414Ful:  // AFS
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        /** Test if the block device holding a file is a spinning disk
+         *
+         * @param device device number
+         * @return true if the kernel reports the device as rotational
+         */
+        bool is_rotational_device(const dev_t device)
+        {
+            std::ostringstream sout;
+            sout << "/sys/dev/block/" << major(device) << ":" << minor(device);
+            const std::string device_path = sout.str();
+            std::ifstream fin(combine(device_path, "queue/rotational").c_str());
+            // A partition has no queue, its parent device does
+            if(!fin.good()) fin.open(combine(device_path, "../queue/rotational").c_str());
+            int rotational = 0;
+            return (fin >> rotational) && rotational == 1;
+        }
+#endif
+    }
+
+    /** Find the plan for a metric group
+     *
+     * @param group metric group
+     * @return plan for the group or null if the group has no files
+     */
+    const group_load_plan* load_plan::find(const constants::metric_group group)const
+    {
+        for(size_t i=0;i<groups.size();++i)
+            if(groups[i].group == group) return &groups[i];
+        return 0;
+    }
+    /** Write the plan as a table
+     *
+     * @param out output stream
+     */
+    void load_plan::write(std::ostream& out)const
+    {
+        out << "# Mount point: " << mount_point << "\n";
+        out << "# Storage: " << detail::storage_name(storage) << "\n";
+        out << "# Cores: " << core_count << "\n";
+        out << "# Threads: " << thread_count << "\n";
+        out << std::left
+            << std::setw(18) << "Group"
+            << std::setw(10) << "Path"
+            << std::setw(8) << "Files"
+            << std::setw(14) << "Bytes"
+            << std::setw(12) << "Records"
+            << "Buffer" << "\n";
+        for(size_t i=0;i<groups.size();++i)
+        {
+            out << std::setw(18) << constants::to_string(groups[i].group)
+                << std::setw(10) << detail::load_path_name(groups[i].path)
+                << std::setw(8) << groups[i].file_count
+                << std::setw(14) << groups[i].byte_count
+                << std::setw(12) << groups[i].record_count
+                << groups[i].buffer_size << "\n";
+        }
+        out << std::right;
+    }
+
+    /** Constructor
+     *
+     * @param tuning tuned parameters
+     */
+    load_planner::load_planner(const load_tuning& tuning) : m_tuning(tuning){}
+
+    /** Begin a plan for a run folder
+     *
+     * @param run_folder run folder path
+     * @return plan with the storage and core count, and without any group
+     */
+    load_plan load_planner::begin(const std::string& run_folder)const
+    {
+        load_plan plan;
+        plan.mount_point = mount_point_of(run_folder);
+        plan.storage = storage_of(run_folder);
+        plan.core_count = core_count();
+        return plan;
+    }
+    /** Plan a single metric group
+     *
+     * @param group metric group
+     * @param aggregate_size size of the aggregate file in bytes, negative if missing
+     * @param cycle_file_count number of cycle files
+     * @param cycle_byte_count total size of the cycle files in bytes
+     * @param record_size size of a record in bytes, 0 if unknown
+     * @return plan for the group
+     */
+    group_load_plan load_planner::plan_group(const constants::metric_group group,
+                                             const ::int64_t aggregate_size,
+                                             const size_t cycle_file_count,
+                                             const ::uint64_t cycle_byte_count,
+                                             const size_t record_size)const
+    {
+        group_load_plan plan;
+        plan.group = group;
+        if(aggregate_size >= 0)
+        {
+            plan.file_count = 1;
+            plan.byte_count = static_cast< ::uint64_t >(aggregate_size);
+            if(plan.byte_count < m_tuning.small_file_size) plan.path = StreamLoad;
+            else
+            {
+                plan.path = BufferedLoad;
+                plan.buffer_size = static_cast<size_t>(std::min< ::uint64_t >(m_tuning.buffer_size, plan.byte_count));
+            }
+        }
+        else if(cycle_file_count > 0)
+        {
+            plan.path = ByCycleLoad;
+            plan.file_count = cycle_file_count;
+            plan.byte_count = cycle_byte_count;
+        }
+        if(record_size > 0) plan.record_count = static_cast<size_t>(plan.byte_count / record_size);
+        return plan;
+    }
+    /** Complete a plan by choosing the number of threads
+     *
+     * A thread is only worth starting for a group that is not a single small file, and the storage caps the
+     * number of threads.
+     *
+     * @param plan plan with every group
+     */
+    void load_planner::finish(load_plan& plan)const
+    {
+        size_t limit = plan.core_count;
+        if(plan.storage == NetworkStorage) limit = m_tuning.network_thread_limit;
+        else if(plan.storage == RotationalStorage) limit = m_tuning.rotational_thread_limit;
+        else if(m_tuning.local_thread_limit > 0) limit = m_tuning.local_thread_limit;
+        limit = std::min(limit, plan.core_count);
+
+        size_t large_group_count = 0;
+        for(size_t i=0;i<plan.groups.size();++i)
+        {
+            if(plan.groups[i].path == BufferedLoad || plan.groups[i].path == ByCycleLoad)
+                ++large_group_count;
+        }
+        plan.thread_count = std::max<size_t>(1, std::min(limit, large_group_count));
+    }
+    /** Time short reads of a file with several buffer sizes and thread counts and tune both
+     *
+     * Each probe reads at most 16 MiB from its own region of the file, and the clean pages of the file are dropped
+     * from the page cache before each probe where supported, so every probe times the storage rather than memory
+     * copies. The buffer sizes are probed first with a single thread. The thread counts are then probed with the
+     * best buffer size, and the best count becomes the thread limit for the class of storage holding the file.
+     *
+     * @note The thread count is only calibrated when built with OpenMP
+     *
+     * @param probe_file path to a large file on the storage to calibrate
+     * @return tuned parameters
+     */
+    load_tuning load_planner::calibrate(const std::string& probe_file)const
+    {
+        static const size_t buffer_sizes[] = {64*1024, 256*1024, 1024*1024, 4*1024*1024};
+        static const size_t buffer_probe_count = sizeof(buffer_sizes)/sizeof(buffer_sizes[0]);
+        static const size_t thread_counts[] = {1, 2, 4, 8};
+        static const size_t thread_probe_count = sizeof(thread_counts)/sizeof(thread_counts[0]);
+        static const size_t probe_byte_count = 16*1024*1024;
+        static const size_t min_region_size = 1024*1024;
+        load_tuning tuning = m_tuning;
+        const ::int64_t probe_file_size = file_size(probe_file);
+        if(probe_file_size <= 0) return tuning;
+        const size_t file_byte_count = static_cast<size_t>(std::min< ::int64_t >(probe_file_size,
+                static_cast< ::int64_t >(probe_byte_count*(buffer_probe_count+thread_probe_count))));
+        // Give each probe its own region, unless the file is too small and every probe must read its start
+        size_t region_size = file_byte_count / (buffer_probe_count+thread_probe_count);
+        const bool share_region = region_size < min_region_size;
+        if(share_region) region_size = std::min(file_byte_count, probe_byte_count);
+        size_t region = 0;
+
+        double best_seconds = -1;
+        for(size_t i=0;i<buffer_probe_count;++i, ++region)
+        {
+            const size_t offset = share_region ? 0 : region*region_size;
+            const double seconds = detail::time_region_read(probe_file, offset, region_size, buffer_sizes[i], 1);
+            if(best_seconds < 0 || seconds < best_seconds)
+            {
+                best_seconds = seconds;
+                tuning.buffer_size = buffer_sizes[i];
+            }
+        }
+#ifdef _OPENMP
+        const size_t max_thread_count = core_count();
+        size_t best_thread_count = 1;
+        best_seconds = -1;
+        for(size_t i=0;i<thread_probe_count && thread_counts[i] <= max_thread_count;++i, ++region)
+        {
+            const size_t offset = share_region ? 0 : region*region_size;
+            const double seconds = detail::time_region_read(probe_file,
+                                                            offset,
+                                                            region_size,
+                                                            tuning.buffer_size,
+                                                            thread_counts[i]);
+            if(best_seconds < 0 || seconds < best_seconds)
+            {
+                best_seconds = seconds;
+                best_thread_count = thread_counts[i];
+            }
+        }
+        const storage_type storage = storage_of(probe_file);
+        if(storage == NetworkStorage) tuning.network_thread_limit = best_thread_count;
+        else if(storage == RotationalStorage) tuning.rotational_thread_limit = best_thread_count;
+        else tuning.local_thread_limit = best_thread_count;
+#endif
+        return tuning;
+    }
+    /** Get the tuned parameters
+     *
+     * @return tuned parameters
+     */
+    const load_tuning& load_planner::tuning()const
+    {
+        return m_tuning;
+    }
+    /** Determine the class of storage holding a path
+     *
+     * @param path file path
+     * @return class of storage
+     */
+    storage_type load_planner::storage_of(const std::string& path)
+    {
+#ifdef __linux__
+        struct statfs fs;
+        if(statfs(path.c_str(), &fs) != 0) return UnknownStorage;
+        if(detail::is_network_file_system(static_cast<long>(fs.f_type))) return NetworkStorage;
+        struct stat buf;
+        if(stat(path.c_str(), &buf) != 0) return UnknownStorage;
+        return detail::is_rotational_device(buf.st_dev) ? RotationalStorage : LocalStorage;
+#else
+        (void)path;
+        return UnknownStorage;
+#endif
+    }
+    /** Determine the mount point holding a path
+     *
+     * @param path file path
+     * @return mount point or empty string if unknown
+     */
+    std::string load_planner::mount_point_of(const std::string& path)
+    {
+#ifdef _WIN32
+        char full_path[MAX_PATH];
+        if(GetFullPathNameA(path.c_str(), MAX_PATH, full_path, 0) == 0) return "";
+        char volume[MAX_PATH];
+        if(!GetVolumePathNameA(full_path, volume, MAX_PATH)) return "";
+        return volume;
+#else
+        char resolved[PATH_MAX];
+        if(realpath(path.c_str(), resolved) == 0) return "";
+        std::string mount_point = resolved;
+        struct stat buf;
+        if(stat(mount_point.c_str(), &buf) != 0) return "";
+        const dev_t device = buf.st_dev;
+        // Walk up the directory tree until the parent is on another device
+        while(mount_point != "/")
+        {
+            std::string parent = dirname(mount_point);
+            if(parent.size() > 1 && parent[parent.size()-1] == '/') parent.erase(parent.size()-1);
+            if(parent.empty()) parent = "/";
+            if(stat(parent.c_str(), &buf) != 0 || buf.st_dev != device) break;
+            mount_point = parent;
+        }
+        return mount_point;
+#endif
+    }
+    /** Get the number of cores
+     *
+     * @return number of cores
+     */
+    size_t load_planner::core_count()
+    {
+#if defined(_OPENMP)
+        return static_cast<size_t>(std::max(1, omp_get_num_procs()));
+#elif defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return std::max<size_t>(1, static_cast<size_t>(info.dwNumberOfProcessors));
+#else
+        const long count = sysconf(_SC_NPROCESSORS_ONLN);
+        return count > 0 ? static_cast<size_t>(count) : 1;
+#endif
+    }
+
+    /** Read the tuned parameters for a mount point
+     *
+     * Each line of the file holds the parameters of a single mount point, separated by tabs.
+     *
+     * @param config_file path to the tuning file
+     * @param mount_point mount point
+     * @param tuning destination parameters, unchanged if the mount point is not found
+     * @return true if the mount point was found
+     */
+    bool read_load_tuning(const std::string& config_file, const std::string& mount_point, load_tuning& tuning)
+    {
+        std::ifstream fin(config_file.c_str());
+        std::string line;
+        while(std::getline(fin, line))
+        {
+            const size_t tab = line.find('\t');
+            if(tab == std::string::npos || line.substr(0, tab) != mount_point) continue;
+            std::istringstream sin(line.substr(tab+1));
+            load_tuning values;
+            if(!(sin >> values.small_file_size
+                     >> values.buffer_size
+                     >> values.local_thread_limit
+                     >> values.rotational_thread_limit
+                     >> values.network_thread_limit)) return false;
+            tuning = values;
+            return true;
+        }
+        return false;
+    }
+    /** Write the tuned parameters for a mount point
+     *
+     * The parameters of other mount points in the file are kept.
+     *
+     * @param config_file path to the tuning file
+     * @param mount_point mount point
+     * @param tuning tuned parameters
+     * @return true if the file was written
+     */
+    bool write_load_tuning(const std::string& config_file, const std::string& mount_point, const load_tuning& tuning)
+    {
+        std::vector<std::string> lines;
+        {
+            std::ifstream fin(config_file.c_str());
+            std::string line;
+            while(std::getline(fin, line))
+            {
+                const size_t tab = line.find('\t');
+                if(tab != std::string::npos && line.substr(0, tab) == mount_point) continue;
+                if(!line.empty()) lines.push_back(line);
+            }
+        }
+        std::ostringstream sout;
+        sout << mount_point << '\t'
+             << tuning.small_file_size << '\t'
+             << tuning.buffer_size << '\t'
+             << tuning.local_thread_limit << '\t'
+             << tuning.rotational_thread_limit << '\t'
+             << tuning.network_thread_limit;
+        lines.push_back(sout.str());
+        std::ofstream fout(config_file.c_str());
+        for(size_t i=0;i<lines.size();++i)
+            fout << lines[i] << "\n";
+        return fout.good();
+    }
+
+}}}
@@ -0,0 +1,297 @@
+/** Shared scheduler for loading InterOp files across concurrent runs
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <deque>
+#include <algorithm>
+#include <limits>
+#include "interop/io/load_scheduler.h"
+#include "interop/model/model_exceptions.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    namespace detail
+    {
+        /** Type of exception thrown by a task, so it can be rethrown on the thread that started the load */
+        enum task_error_t
+        {
+            NoError,
+            FileNotFoundError,
+            IncompleteFileError,
+            BadFormatError,
+            InvalidParameterError,
+            OtherError
+        };
+
+        /** Execute a task and record the type and message of any exception it throws
+         *
+         * @param task task to execute
+         * @param message destination for the exception message
+         * @return type of exception thrown or NoError
+         */
+        inline task_error_t execute_task(load_task& task, std::string& message)
+        {
+            try
+            {
+                task();
+                return NoError;
+            }
+            catch(const file_not_found_exception& ex)
+            {
+                message = ex.what();
+                return FileNotFoundError;
+            }
+            catch(const incomplete_file_exception& ex)
+            {
+                message = ex.what();
+                return IncompleteFileError;
+            }
+            catch(const bad_format_exception& ex)
+            {
+                message = ex.what();
+                return BadFormatError;
+            }
+            catch(const model::invalid_parameter& ex)
+            {
+                message = ex.what();
+                return InvalidParameterError;
+            }
+            catch(const std::exception& ex)
+            {
+                message = ex.what();
+            }
+            if(message.empty()) message = "Unknown error loading InterOp";
+            return OtherError;
+        }
+    }
+
+    /** Bookkeeping for a single load in the scheduler queue */
+    struct load_scheduler::load_entry
+    {
+        /** Constructor
+         *
+         * @param tasks array of tasks
+         * @param task_count number of tasks
+         * @param priority_class priority class of the load
+         */
+        load_entry(load_task* const* tasks, const size_t task_count, const priority_t priority_class) :
+                pending(tasks, tasks+task_count),
+                in_flight(0),
+                priority(priority_class),
+                last_served(0),
+                error_kind(detail::NoError)
+        {}
+        /** Test if all tasks in the load have completed
+         *
+         * @return true if no task is queued or in flight
+         */
+        bool is_complete()const
+        {
+            return pending.empty() && in_flight == 0;
+        }
+        /** Tasks not yet dispatched */
+        std::deque<load_task*> pending;
+        /** Number of tasks currently executing */
+        size_t in_flight;
+        /** Priority class */
+        priority_t priority;
+        /** Tick when this load last had a task dispatched */
+        ::uint64_t last_served;
+        /** Type of the first exception thrown by a task */
+        detail::task_error_t error_kind;
+        /** Message of the first task that failed */
+        std::string error;
+    };
+
+    /** Constructor
+     *
+     * @param max_open_files maximum number of tasks (open files) in flight across all loads
+     */
+    load_scheduler::load_scheduler(const size_t max_open_files) :
+            m_max_open_files(std::max(max_open_files, static_cast<size_t>(1))),
+            m_open_files(0),
+            m_tick(0)
+    {
+    }
+    /** Destructor
+     */
+    load_scheduler::~load_scheduler()
+    {
+    }
+
+    /** Get the process wide scheduler
+     *
+     * @return process wide scheduler
+     */
+    load_scheduler& load_scheduler::instance()
+    {
+        static load_scheduler scheduler;
+        return scheduler;
+    }
+
+    /** Execute a set of tasks for a single load
+     *
+     * @param tasks array of tasks
+     * @param task_count number of tasks
+     * @param priority priority class of the load
+     * @param thread_count number of threads this load contributes
+     */
+    void load_scheduler::run(load_task* const* tasks,
+                             const size_t task_count,
+                             const priority_t priority,
+                             const size_t thread_count) INTEROP_THROW_SPEC((io::file_not_found_exception,
+                                                                            io::incomplete_file_exception,
+                                                                            io::bad_format_exception,
+                                                                            model::invalid_parameter))
+    {
+        if(task_count == 0) return;
+        load_entry entry(tasks, task_count, priority);
+        {
+            util::scoped_lock guard(m_mutex);
+            m_loads.push_back(&entry);
+        }
+        // Threads of other loads may be waiting for a task they are allowed to dispatch
+        m_changed.notify_all();
+#ifdef _OPENMP
+        const int thread_limit = static_cast<int>(std::max(std::min(thread_count, task_count), static_cast<size_t>(1)));
+#       pragma omp parallel default(shared) num_threads(thread_limit)
+        work(entry);
+#else
+        (void)thread_count;
+        work(entry);
+#endif
+        {
+            util::scoped_lock guard(m_mutex);
+            m_loads.erase(std::find(m_loads.begin(), m_loads.end(), &entry));
+        }
+        switch(entry.error_kind)
+        {
+            case detail::NoError:
+                break;
+            case detail::FileNotFoundError:
+                INTEROP_THROW(io::file_not_found_exception, entry.error);
+            case detail::IncompleteFileError:
+                INTEROP_THROW(io::incomplete_file_exception, entry.error);
+            case detail::InvalidParameterError:
+                INTEROP_THROW(model::invalid_parameter, entry.error);
+            default:
+                INTEROP_THROW(io::bad_format_exception, entry.error);
+        }
+    }
+
+    /** Set the maximum number of tasks (open files) in flight across all loads
+     *
+     * @param count maximum number of open files, must be greater than 0
+     */
+    void load_scheduler::max_open_files(const size_t count) INTEROP_THROW_SPEC((model::invalid_parameter))
+    {
+        if(count == 0) INTEROP_THROW(model::invalid_parameter, "Maximum number of open files must be greater than 0");
+        {
+            util::scoped_lock guard(m_mutex);
+            m_max_open_files = count;
+        }
+        m_changed.notify_all();
+    }
+    /** Get the maximum number of tasks (open files) in flight across all loads
+     *
+     * @return maximum number of open files
+     */
+    size_t load_scheduler::max_open_files()const
+    {
+        return m_max_open_files;
+    }
+    /** Get the number of tasks (open files) currently in flight
+     *
+     * @return number of open files
+     */
+    size_t load_scheduler::open_files()const
+    {
+        util::scoped_lock guard(m_mutex);
+        return m_open_files;
+    }
+    /** Get the number of queued tasks for the given priority class
+     *
+     * @param priority priority class
+     * @return number of queued tasks
+     */
+    size_t load_scheduler::pending_count(const priority_t priority)const
+    {
+        size_t count = 0;
+        util::scoped_lock guard(m_mutex);
+        for(load_vector_t::const_iterator it = m_loads.begin();it != m_loads.end();++it)
+            if((*it)->priority == priority) count += (*it)->pending.size();
+        return count;
+    }
+
+    /** Execute tasks from the shared queue until the given load completes
+     *
+     * @param entry load owned by the calling thread
+     */
+    void load_scheduler::work(load_entry& entry)
+    {
+        m_mutex.lock();
+        while(!entry.is_complete())
+        {
+            load_entry* owner = 0;
+            load_task* task = acquire(entry, owner);
+            if(task == 0)
+            {
+                // Sleep until a task completes, a load is added or the open file limit changes
+                m_changed.wait(m_mutex);
+                continue;
+            }
+            m_mutex.unlock();
+            std::string error;
+            const detail::task_error_t error_kind = detail::execute_task(*task, error);
+            m_mutex.lock();
+            --owner->in_flight;
+            --m_open_files;
+            if(error_kind != detail::NoError && owner->error_kind == detail::NoError)
+            {
+                owner->error_kind = error_kind;
+                owner->error = error;
+                owner->pending.clear();
+            }
+            m_changed.notify_all();
+        }
+        m_mutex.unlock();
+    }
+
+    /** Select the next task to execute
+     *
+     * @note The lock must be held by the caller
+     * @param entry load owned by the calling thread
+     * @param owner load that owns the selected task
+     * @return selected task or null if no task can be dispatched
+     */
+    load_task* load_scheduler::acquire(const load_entry& entry, load_entry*& owner)
+    {
+        if(m_open_files >= m_max_open_files) return 0;
+        owner = 0;
+        for(load_vector_t::iterator it = m_loads.begin();it != m_loads.end();++it)
+        {
+            load_entry* candidate = *it;
+            if(candidate->pending.empty()) continue;
+            // Never block a load on work of a lower priority
+            if(candidate->priority > entry.priority) continue;
+            if(owner == 0 ||
+               candidate->priority < owner->priority ||
+               (candidate->priority == owner->priority && candidate->last_served < owner->last_served))
+                owner = candidate;
+        }
+        if(owner == 0) return 0;
+        load_task* task = owner->pending.front();
+        owner->pending.pop_front();
+        owner->last_served = ++m_tick;
+        ++owner->in_flight;
+        ++m_open_files;
+        return task;
+    }
+
+}}}
@@ -0,0 +1,899 @@
+/** Render plot data directly to PNG or SVG images
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/io/plot/image_writer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <vector>
+#include "interop/util/length_of.h"
+#include "interop/util/math.h"
+
+namespace illumina { namespace interop { namespace io { namespace plot
+{
+    namespace
+    {
+        /** A rectangle, line or label in image coordinates
+         */
+        struct shape
+        {
+            /** Kind of shape */
+            enum shape_type
+            {
+                /** Filled rectangle between two corners */
+                Rectangle,
+                /** One pixel wide line between two points */
+                Line,
+                /** Label anchored at the first point */
+                Text
+            };
+            /** Constructor
+             *
+             * @param type kind of shape
+             * @param x0 first x-coordinate
+             * @param y0 first y-coordinate
+             * @param x1 second x-coordinate
+             * @param y1 second y-coordinate
+             * @param color fill, stroke or text color
+             */
+            shape(const shape_type type,
+                  const float x0,
+                  const float y0,
+                  const float x1,
+                  const float y1,
+                  const rgb_color& color) :
+                    type(type), x0(x0), y0(y0), x1(x1), y1(y1), color(color), anchor(0)
+            { }
+            /** Kind of shape */
+            shape_type type;
+            /** First x-coordinate */
+            float x0;
+            /** First y-coordinate */
+            float y0;
+            /** Second x-coordinate */
+            float x1;
+            /** Second y-coordinate */
+            float y1;
+            /** Fill, stroke or text color */
+            rgb_color color;
+            /** Label text */
+            std::string text;
+            /** Horizontal alignment of a label: -1 start, 0 middle, 1 end */
+            int anchor;
+        };
+        /** List of shapes drawn in order */
+        typedef std::vector<shape> scene_t;
+
+        /** Plot area within the image */
+        struct frame
+        {
+            /** Left edge */
+            float left;
+            /** Top edge */
+            float top;
+            /** Right edge */
+            float right;
+            /** Bottom edge */
+            float bottom;
+        };
+
+        const float title_height = 30;
+        const rgb_color black(0, 0, 0);
+        const rgb_color missing_color(224, 224, 224);
+
+        void add_rectangle(scene_t& scene,
+                           const float x0,
+                           const float y0,
+                           const float x1,
+                           const float y1,
+                           const rgb_color& color)
+        {
+            scene.push_back(shape(shape::Rectangle, x0, y0, x1, y1, color));
+        }
+        void add_line(scene_t& scene,
+                      const float x0,
+                      const float y0,
+                      const float x1,
+                      const float y1,
+                      const rgb_color& color=black)
+        {
+            scene.push_back(shape(shape::Line, x0, y0, x1, y1, color));
+        }
+        void add_text(scene_t& scene, const float x, const float y, const std::string& text, const int anchor=0)
+        {
+            if (text.empty()) return;
+            scene.push_back(shape(shape::Text, x, y, x, y, black));
+            scene.back().text = text;
+            scene.back().anchor = anchor;
+        }
+        void add_box(scene_t& scene, const frame& area)
+        {
+            add_line(scene, area.left, area.top, area.right, area.top);
+            add_line(scene, area.right, area.top, area.right, area.bottom);
+            add_line(scene, area.right, area.bottom, area.left, area.bottom);
+            add_line(scene, area.left, area.bottom, area.left, area.top);
+        }
+
+        /** Format a number for a tick label
+         *
+         * @param value number
+         * @return label
+         */
+        std::string format_value(const float value)
+        {
+            std::ostringstream out;
+            out << std::setprecision(4) << value;
+            return out.str();
+        }
+
+        /** Interpolate a color from a palette
+         *
+         * @param stops increasing positions of the palette colors, from 0 to 1
+         * @param colors palette colors
+         * @param count number of palette colors
+         * @param position position in the palette, from 0 to 1
+         * @return interpolated color
+         */
+        rgb_color interpolate(const float* stops, const rgb_color* colors, const size_t count, float position)
+        {
+            position = std::max(0.0f, std::min(1.0f, position));
+            size_t i = 1;
+            while (i < count - 1 && stops[i] < position) ++i;
+            const float span = stops[i] - stops[i - 1];
+            const float t = span > 0 ? (position - stops[i - 1]) / span : 0;
+            return rgb_color(static_cast< ::uint8_t >(colors[i - 1].r + t * (colors[i].r - colors[i - 1].r) + 0.5f),
+                             static_cast< ::uint8_t >(colors[i - 1].g + t * (colors[i].g - colors[i - 1].g) + 0.5f),
+                             static_cast< ::uint8_t >(colors[i - 1].b + t * (colors[i].b - colors[i - 1].b) + 0.5f));
+        }
+        /** Color of a flowcell tile, using the palette of the GNUPlot flowcell script
+         *
+         * @param position position of the value in the color range, from 0 to 1
+         * @return color
+         */
+        rgb_color flowcell_color(const float position)
+        {
+            static const float stops[] = {0.0f, 0.143f, 0.286f, 0.429f, 0.572f, 0.715f, 0.858f, 1.0f};
+            static const rgb_color colors[] = {rgb_color(138, 43, 226), rgb_color(0, 0, 255), rgb_color(0, 255, 255),
+                                               rgb_color(144, 238, 144), rgb_color(50, 205, 50),
+                                               rgb_color(0, 255, 0), rgb_color(255, 255, 0),
+                                               rgb_color(255, 165, 0)};
+            return interpolate(stops, colors, util::length_of(stops), position);
+        }
+        /** Color of a heat map cell, using the palette of the GNUPlot heat map script
+         *
+         * @param position position of the value in the color range, from 0 to 1
+         * @return color
+         */
+        rgb_color heatmap_color(const float position)
+        {
+            static const float stops[] = {0.0f, 0.333f, 0.667f, 1.0f};
+            static const rgb_color colors[] = {rgb_color(255, 255, 255), rgb_color(0, 255, 0),
+                                               rgb_color(255, 255, 0), rgb_color(255, 0, 0)};
+            return interpolate(stops, colors, util::length_of(stops), position);
+        }
+        /** Convert the name or hex code of a series color to RGB
+         *
+         * @param name camel case color name, e.g. DarkGreen, or hex code, e.g. #01FFFE
+         * @return color, black if the name is unknown
+         */
+        rgb_color parse_color(const std::string& name)
+        {
+            if (name.length() == 7 && name[0] == '#')
+            {
+                const unsigned long value = std::strtoul(name.c_str() + 1, 0, 16);
+                return rgb_color(static_cast< ::uint8_t >(value >> 16),
+                                 static_cast< ::uint8_t >(value >> 8),
+                                 static_cast< ::uint8_t >(value));
+            }
+            std::string lower;
+            for (size_t i = 0; i < name.length(); ++i) lower += static_cast<char>(::tolower(name[i]));
+            if (lower == "red") return rgb_color(255, 0, 0);
+            if (lower == "green") return rgb_color(0, 255, 0);
+            if (lower == "blue") return rgb_color(0, 0, 255);
+            if (lower == "darkgreen") return rgb_color(0, 100, 0);
+            if (lower == "orange") return rgb_color(255, 165, 0);
+            if (lower == "yellow") return rgb_color(255, 255, 0);
+            if (lower == "cyan") return rgb_color(0, 255, 255);
+            if (lower == "gray" || lower == "grey") return rgb_color(128, 128, 128);
+            return black;
+        }
+        /** Map a value to its position in a range
+         *
+         * @param value value
+         * @param vmin lower end of the range
+         * @param vmax upper end of the range
+         * @return position from 0 to 1
+         */
+        float range_position(const float value, const float vmin, const float vmax)
+        {
+            return vmax > vmin ? (value - vmin) / (vmax - vmin) : 0.5f;
+        }
+        /** Extend a range with a value, ignoring NaN
+         *
+         * @param value value
+         * @param vmin lower end of the range
+         * @param vmax upper end of the range
+         */
+        void extend_range(const float value, float& vmin, float& vmax)
+        {
+            if (std::isnan(value)) return;
+            vmin = std::min(vmin, value);
+            vmax = std::max(vmax, value);
+        }
+        /** Add a vertical color bar with its range labels
+         *
+         * @param scene destination scene
+         * @param area area of the color bar
+         * @param vmin value at the bottom
+         * @param vmax value at the top
+         * @param palette palette function
+         */
+        void add_color_bar(scene_t& scene, const frame& area, const float vmin, const float vmax,
+                           rgb_color (*palette)(const float))
+        {
+            const size_t steps = 64;
+            const float step_height = (area.bottom - area.top) / steps;
+            for (size_t i = 0; i < steps; ++i)
+            {
+                const float y = area.bottom - (i + 1) * step_height;
+                add_rectangle(scene, area.left, y, area.right, y + step_height,
+                              palette((i + 0.5f) / steps));
+            }
+            add_box(scene, area);
+            add_text(scene, area.right + 4, area.top + 10, format_value(vmax), -1);
+            add_text(scene, area.right + 4, area.bottom, format_value(vmin), -1);
+        }
+
+        /** Lay out the flowcell heat map in the same arrangement as the GNUPlot script
+         *
+         * Each lane is a group of swath columns with a tile per row, and lanes are separated by an empty column.
+         *
+         * @param data flowcell heatmap data
+         * @param width image width
+         * @param height image height
+         * @param scene destination scene
+         */
+        void layout_flowcell(const model::plot::flowcell_data& data,
+                             const size_t width,
+                             const size_t height,
+                             scene_t& scene)
+        {
+            add_text(scene, width / 2.0f, 20, data.title());
+            if (data.length() == 0 || data.tile_count() == 0) return;
+            float vmin = data.saxis().min(), vmax = data.saxis().max();
+            if (std::isnan(vmin) || std::isnan(vmax))
+            {
+                vmin = std::numeric_limits<float>::max();
+                vmax = -std::numeric_limits<float>::max();
+                for (size_t i = 0; i < data.length(); ++i) extend_range(data[i], vmin, vmax);
+            }
+            const size_t swath_count = data.column_count() / data.tile_count();
+            const size_t column_count = data.row_count() * (swath_count + 1) - 1;
+            frame area = {10.0f, title_height, width - 80.0f, height - 25.0f};
+            const float cell_width = (area.right - area.left) / column_count;
+            const float cell_height = (area.bottom - area.top) / data.tile_count();
+            scene.reserve(scene.size() + data.length() + 128);
+            for (size_t lane = 0; lane < data.row_count(); ++lane)
+            {
+                const float lane_left = area.left + lane * (swath_count + 1) * cell_width;
+                for (size_t swath = 0; swath < swath_count; ++swath)
+                {
+                    const float x = lane_left + swath * cell_width;
+                    for (size_t tile = 0; tile < data.tile_count(); ++tile)
+                    {
+                        const float value = data(lane, tile + swath * data.tile_count());
+                        const float y = area.top + tile * cell_height;
+                        add_rectangle(scene, x, y, x + cell_width, y + cell_height,
+                                      std::isnan(value) ? missing_color :
+                                      flowcell_color(range_position(value, vmin, vmax)));
+                    }
+                }
+                std::ostringstream label;
+                label << "L" << (lane + 1);
+                add_text(scene, lane_left + swath_count * cell_width / 2, area.bottom + 17, label.str());
+            }
+            const frame bar = {width - 70.0f, title_height, width - 55.0f, height - 25.0f};
+            add_color_bar(scene, bar, vmin, vmax, flowcell_color);
+        }
+
+        /** Add ticks and labels to the axes of a chart
+         *
+         * @param scene destination scene
+         * @param area plot area
+         * @param axes labels of both axes
+         * @param xmin lower end of the x-axis
+         * @param xmax upper end of the x-axis
+         * @param ymin lower end of the y-axis
+         * @param ymax upper end of the y-axis
+         */
+        void add_axes(scene_t& scene,
+                      const frame& area,
+                      const model::plot::axes& axes,
+                      const float xmin,
+                      const float xmax,
+                      const float ymin,
+                      const float ymax)
+        {
+            const size_t tick_count = 5;
+            add_box(scene, area);
+            for (size_t i = 0; i < tick_count; ++i)
+            {
+                const float t = static_cast<float>(i) / (tick_count - 1);
+                const float x = area.left + t * (area.right - area.left);
+                const float y = area.bottom - t * (area.bottom - area.top);
+                add_line(scene, x, area.bottom, x, area.bottom - 5);
+                add_line(scene, area.left, y, area.left + 5, y);
+                add_text(scene, x, area.bottom + 15, format_value(xmin + t * (xmax - xmin)));
+                add_text(scene, area.left - 4, y + 4, format_value(ymin + t * (ymax - ymin)), 1);
+            }
+            add_text(scene, (area.left + area.right) / 2, area.bottom + 32, axes.x().label());
+            add_text(scene, 4, area.top - 8, axes.y().label(), -1);
+        }
+
+        /** Lay out a heat map in the same orientation as the GNUPlot script
+         *
+         * @param data heat map data
+         * @param width image width
+         * @param height image height
+         * @param scene destination scene
+         */
+        void layout_heatmap(const model::plot::heatmap_data& data,
+                            const size_t width,
+                            const size_t height,
+                            scene_t& scene)
+        {
+            add_text(scene, width / 2.0f, 20, data.title());
+            if (data.length() == 0) return;
+            float vmin = std::numeric_limits<float>::max(), vmax = -std::numeric_limits<float>::max();
+            for (size_t i = 0; i < data.length(); ++i) extend_range(data[i], vmin, vmax);
+            if (vmin > vmax) vmin = vmax = 0;
+            const frame area = {60.0f, title_height, width - 90.0f, height - 45.0f};
+            const float cell_width = (area.right - area.left) / data.row_count();
+            const float cell_height = (area.bottom - area.top) / data.column_count();
+            scene.reserve(scene.size() + data.length() + 128);
+            for (size_t x = 0; x < data.row_count(); ++x)
+            {
+                for (size_t y = 0; y < data.column_count(); ++y)
+                {
+                    const float value = data(x, y);
+                    if (std::isnan(value)) continue;
+                    const float left = area.left + x * cell_width;
+                    const float top = area.bottom - (y + 1) * cell_height;
+                    add_rectangle(scene, left, top, left + cell_width, top + cell_height,
+                                  heatmap_color(range_position(value, vmin, vmax)));
+                }
+            }
+            const model::plot::axes& axes = data.xyaxes();
+            const float xmin = std::isnan(axes.x().min()) ? 0 : axes.x().min();
+            const float xmax = std::isnan(axes.x().max()) ? static_cast<float>(data.row_count()) : axes.x().max();
+            const float ymin = std::isnan(axes.y().min()) ? 0 : axes.y().min();
+            const float ymax = std::isnan(axes.y().max()) ? static_cast<float>(data.column_count()) : axes.y().max();
+            add_axes(scene, area, axes, xmin, xmax, ymin, ymax);
+            const frame bar = {width - 80.0f, title_height, width - 65.0f, height - 45.0f};
+            add_color_bar(scene, bar, vmin, vmax, heatmap_color);
+        }
+
+        /** Maps chart coordinates to image coordinates
+         */
+        class chart_mapping
+        {
+        public:
+            chart_mapping(const frame& area, const float xmin, const float xmax, const float ymin, const float ymax) :
+                    m_area(area), m_xmin(xmin), m_xmax(xmax), m_ymin(ymin), m_ymax(ymax)
+            { }
+            float x(const float value) const
+            {
+                return m_area.left + range_position(value, m_xmin, m_xmax) * (m_area.right - m_area.left);
+            }
+            float y(const float value) const
+            {
+                const float position = std::max(0.0f, std::min(1.0f, range_position(value, m_ymin, m_ymax)));
+                return m_area.bottom - position * (m_area.bottom - m_area.top);
+            }
+            float width(const float value) const
+            {
+                return m_xmax > m_xmin ? value / (m_xmax - m_xmin) * (m_area.right - m_area.left) : 0;
+            }
+            bool contains_x(const float value) const
+            {
+                return value >= m_xmin && value <= m_xmax;
+            }
+
+        private:
+            frame m_area;
+            float m_xmin;
+            float m_xmax;
+            float m_ymin;
+            float m_ymax;
+        };
+
+        /** Lowest value drawn for a point */
+        template<class Point>
+        float point_min(const Point& point)
+        {
+            return point.y();
+        }
+        float point_min(const model::plot::candle_stick_point& point)
+        {
+            return std::isnan(point.lower()) ? point.p25() : std::min(point.lower(), point.min_value());
+        }
+        float point_min(const model::plot::bar_point& point)
+        {
+            return std::min(0.0f, point.y());
+        }
+        /** Highest value drawn for a point */
+        template<class Point>
+        float point_max(const Point& point)
+        {
+            return point.y();
+        }
+        float point_max(const model::plot::candle_stick_point& point)
+        {
+            return std::isnan(point.upper()) ? point.p75() : std::max(point.upper(), point.max_value());
+        }
+        /** Width of a bar */
+        template<class Point>
+        float bar_width(const Point&)
+        {
+            return 1;
+        }
+        float bar_width(const model::plot::bar_point& point)
+        {
+            return point.width();
+        }
+
+        /** Draw a series as connected line segments
+         *
+         * @param scene destination scene
+         * @param mapping chart to image coordinates
+         * @param series series of points
+         * @param color line color
+         */
+        template<class Point>
+        void add_polyline(scene_t& scene, const chart_mapping& mapping, const model::plot::series<Point>& series,
+                          const rgb_color& color)
+        {
+            bool has_previous = false;
+            float previous_x = 0, previous_y = 0;
+            for (size_t i = 0; i < series.size(); ++i)
+            {
+                if (std::isnan(series[i].x()) || std::isnan(series[i].y()) || !mapping.contains_x(series[i].x()))
+                {
+                    has_previous = false;
+                    continue;
+                }
+                const float x = mapping.x(series[i].x()), y = mapping.y(series[i].y());
+                if (has_previous) add_line(scene, previous_x, previous_y, x, y, color);
+                previous_x = x;
+                previous_y = y;
+                has_previous = true;
+            }
+        }
+        /** Draw a series of points without quartiles as a line
+         *
+         * @param scene destination scene
+         * @param mapping chart to image coordinates
+         * @param series series of points
+         * @param color line color
+         */
+        template<class Point>
+        void add_candlesticks(scene_t& scene, const chart_mapping& mapping, const model::plot::series<Point>& series,
+                              const rgb_color& color)
+        {
+            add_polyline(scene, mapping, series, color);
+        }
+        /** Draw a series as candlesticks with whiskers and outliers
+         *
+         * @param scene destination scene
+         * @param mapping chart to image coordinates
+         * @param series series of candlestick points
+         * @param color line color
+         */
+        void add_candlesticks(scene_t& scene,
+                              const chart_mapping& mapping,
+                              const model::plot::series<model::plot::candle_stick_point>& series,
+                              const rgb_color& color)
+        {
+            // Matches the box width of the GNUPlot script
+            const float half_width = std::max(1.0f, mapping.width(0.3f) / 2);
+            for (size_t i = 0; i < series.size(); ++i)
+            {
+                const model::plot::candle_stick_point& point = series[i];
+                if (std::isnan(point.x()) || std::isnan(point.p50()) || !mapping.contains_x(point.x())) continue;
+                const float x = mapping.x(point.x());
+                const float top = mapping.y(point.p75()), bottom = mapping.y(point.p25());
+                if (!std::isnan(point.upper())) add_line(scene, x, mapping.y(point.upper()), x, top, color);
+                if (!std::isnan(point.lower())) add_line(scene, x, bottom, x, mapping.y(point.lower()), color);
+                add_line(scene, x - half_width, top, x + half_width, top, color);
+                add_line(scene, x + half_width, top, x + half_width, bottom, color);
+                add_line(scene, x + half_width, bottom, x - half_width, bottom, color);
+                add_line(scene, x - half_width, bottom, x - half_width, top, color);
+                add_line(scene, x - half_width, mapping.y(point.p50()), x + half_width, mapping.y(point.p50()), color);
+                for (size_t o = 0; o < point.outliers().size(); ++o)
+                {
+                    const float y = mapping.y(point.outliers()[o]);
+                    add_rectangle(scene, x - 1, y - 1, x + 2, y + 2, color);
+                }
+            }
+        }
+        /** Draw a series as bars
+         *
+         * @param scene destination scene
+         * @param mapping chart to image coordinates
+         * @param series series of points
+         * @param color fill color
+         */
+        template<class Point>
+        void add_bars(scene_t& scene, const chart_mapping& mapping, const model::plot::series<Point>& series,
+                      const rgb_color& color)
+        {
+            const float baseline = mapping.y(0);
+            for (size_t i = 0; i < series.size(); ++i)
+            {
+                if (std::isnan(series[i].x()) || std::isnan(series[i].y())) continue;
+                const float half_width = mapping.width(bar_width(series[i])) / 2;
+                const float x = mapping.x(series[i].x()), y = mapping.y(series[i].y());
+                add_rectangle(scene, x - half_width, std::min(y, baseline), x + half_width, std::max(y, baseline),
+                              color);
+                add_line(scene, x - half_width, y, x + half_width, y);
+            }
+        }
+
+        /** Lay out a line, candlestick or bar chart
+         *
+         * @param data plot data
+         * @param width image width
+         * @param height image height
+         * @param scene destination scene
+         */
+        template<class Point>
+        void layout_chart(const model::plot::plot_data<Point>& data,
+                          const size_t width,
+                          const size_t height,
+                          scene_t& scene)
+        {
+            typedef model::plot::series<Point> series_t;
+            add_text(scene, width / 2.0f, 20, data.title());
+            float xmin = data.x_axis().min(), xmax = data.x_axis().max();
+            float ymin = data.y_axis().min(), ymax = data.y_axis().max();
+            if (std::isnan(xmin) || std::isnan(xmax) || std::isnan(ymin) || std::isnan(ymax))
+            {
+                float dxmin = std::numeric_limits<float>::max(), dxmax = -std::numeric_limits<float>::max();
+                float dymin = dxmin, dymax = dxmax;
+                for (size_t s = 0; s < data.size(); ++s)
+                {
+                    for (size_t i = 0; i < data[s].size(); ++i)
+                    {
+                        extend_range(data[s][i].x(), dxmin, dxmax);
+                        extend_range(point_min(data[s][i]), dymin, dymax);
+                        extend_range(point_max(data[s][i]), dymin, dymax);
+                    }
+                }
+                if (std::isnan(xmin)) xmin = dxmin;
+                if (std::isnan(xmax)) xmax = dxmax;
+                if (std::isnan(ymin)) ymin = dymin;
+                if (std::isnan(ymax)) ymax = dymax;
+            }
+            if (xmin > xmax) xmin = xmax = 0;
+            if (ymin > ymax) ymin = ymax = 0;
+            if (xmin == xmax) xmax = xmin + 1;
+            if (ymin == ymax) ymax = ymin + 1;
+
+            const frame area = {60.0f, title_height, width - 20.0f, height - 45.0f};
+            const chart_mapping mapping(area, xmin, xmax, ymin, ymax);
+            for (size_t s = 0; s < data.size(); ++s)
+            {
+                const rgb_color color = parse_color(data[s].color());
+                switch (data[s].series_type())
+                {
+                    case series_t::Bar:
+                        add_bars(scene, mapping, data[s], color);
+                        break;
+                    case series_t::Candlestick:
+                        add_candlesticks(scene, mapping, data[s], color);
+                        break;
+                    case series_t::Line:
+                        add_polyline(scene, mapping, data[s], color);
+                        break;
+                }
+                if (data[s].title().empty()) continue;
+                const float y = area.top + 14 + 16 * s;
+                add_line(scene, area.right - 30, y - 4, area.right - 10, y - 4, color);
+                add_text(scene, area.right - 34, y, data[s].title(), 1);
+            }
+            add_axes(scene, area, data.xyaxes(), xmin, xmax, ymin, ymax);
+        }
+
+        /** Round an image coordinate to the nearest pixel edge, clamped to the image
+         *
+         * @param value image coordinate
+         * @param limit size of the image along the coordinate
+         * @return pixel index
+         */
+        size_t to_pixel(const float value, const size_t limit)
+        {
+            if (!(value > 0)) return 0;
+            const float rounded = std::floor(value + 0.5f);
+            return rounded >= static_cast<float>(limit) ? limit : static_cast<size_t>(rounded);
+        }
+        /** Draw a shape within a band of rows
+         *
+         * @param item shape
+         * @param image destination image
+         * @param row_begin first row of the band
+         * @param row_end one past the last row of the band
+         */
+        void draw(const shape& item, raster_image& image, const size_t row_begin, const size_t row_end)
+        {
+            switch (item.type)
+            {
+                case shape::Rectangle:
+                {
+                    size_t x0 = to_pixel(std::min(item.x0, item.x1), image.width());
+                    size_t x1 = to_pixel(std::max(item.x0, item.x1), image.width());
+                    size_t y0 = to_pixel(std::min(item.y0, item.y1), image.height());
+                    size_t y1 = to_pixel(std::max(item.y0, item.y1), image.height());
+                    // Thin rectangles are still drawn one pixel wide
+                    if (x1 == x0 && x0 < image.width()) ++x1;
+                    if (y1 == y0 && y0 < image.height()) ++y1;
+                    y0 = std::max(y0, row_begin);
+                    y1 = std::min(y1, row_end);
+                    for (size_t y = y0; y < y1; ++y)
+                        for (size_t x = x0; x < x1; ++x) image.set(x, y, item.color);
+                    break;
+                }
+                case shape::Line:
+                {
+                    const float dx = item.x1 - item.x0, dy = item.y1 - item.y0;
+                    if (std::max(item.y0, item.y1) + 1 < static_cast<float>(row_begin) ||
+                        std::min(item.y0, item.y1) - 1 > static_cast<float>(row_end)) break;
+                    const size_t steps = static_cast<size_t>(std::max(std::fabs(dx), std::fabs(dy))) + 1;
+                    for (size_t i = 0; i <= steps; ++i)
+                    {
+                        const float t = static_cast<float>(i) / steps;
+                        const float x = std::floor(item.x0 + t * dx), y = std::floor(item.y0 + t * dy);
+                        if (x < 0 || y < static_cast<float>(row_begin) || y >= static_cast<float>(row_end)) continue;
+                        image.set(static_cast<size_t>(x), static_cast<size_t>(y), item.color);
+                    }
+                    break;
+                }
+                case shape::Text:
+                    break;
+            }
+        }
+        /** Rasterize a scene, drawing bands of rows in parallel
+         *
+         * Each band draws every shape clipped to its rows, so no two threads write the same pixel.
+         *
+         * @param scene list of shapes
+         * @param image destination image
+         * @param thread_count number of threads
+         */
+        void rasterize(const scene_t& scene, raster_image& image, const size_t thread_count)
+        {
+            const size_t band_count = std::max(size_t(1), std::min(image.height(), thread_count * 4));
+            const size_t band_height = (image.height() + band_count - 1) / std::max(size_t(1), band_count);
+            const int band_total = static_cast<int>(band_count);
+#ifdef _OPENMP
+#           pragma omp parallel for default(shared) num_threads(static_cast<int>(thread_count)) schedule(dynamic) if(thread_count > 1)
+#endif
+            for (int band = 0; band < band_total; ++band)
+            {
+                const size_t row_begin = static_cast<size_t>(band) * band_height;
+                const size_t row_end = std::min(image.height(), row_begin + band_height);
+                for (scene_t::const_iterator it = scene.begin(); it != scene.end(); ++it)
+                    draw(*it, image, row_begin, row_end);
+            }
+        }
+
+        /** Escape the XML special characters of a label
+         *
+         * @param text label
+         * @return escaped label
+         */
+        std::string escape_xml(const std::string& text)
+        {
+            std::string escaped;
+            for (size_t i = 0; i < text.length(); ++i)
+            {
+                switch (text[i])
+                {
+                    case '&': escaped += "&amp;"; break;
+                    case '<': escaped += "&lt;"; break;
+                    case '>': escaped += "&gt;"; break;
+                    case '"': escaped += "&quot;"; break;
+                    default: escaped += text[i]; break;
+                }
+            }
+            return escaped;
+        }
+        /** Write a color as an SVG hex code
+         *
+         * @param out output stream
+         * @param color color
+         */
+        void write_svg_color(std::ostream& out, const rgb_color& color)
+        {
+            const char* digits = "0123456789abcdef";
+            out << '#' << digits[color.r >> 4] << digits[color.r & 15] << digits[color.g >> 4]
+                << digits[color.g & 15] << digits[color.b >> 4] << digits[color.b & 15];
+        }
+        /** Write a scene as an SVG document
+         *
+         * @param out output stream
+         * @param scene list of shapes
+         * @param width image width
+         * @param height image height
+         */
+        void write_svg(std::ostream& out, const scene_t& scene, const size_t width, const size_t height)
+        {
+            out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+            out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height
+                << "\" viewBox=\"0 0 " << width << " " << height << "\">\n";
+            out << "<rect width=\"100%\" height=\"100%\" fill=\"#ffffff\"/>\n";
+            out << std::setprecision(6);
+            for (scene_t::const_iterator it = scene.begin(); it != scene.end(); ++it)
+            {
+                switch (it->type)
+                {
+                    case shape::Rectangle:
+                        out << "<rect x=\"" << std::min(it->x0, it->x1) << "\" y=\"" << std::min(it->y0, it->y1)
+                            << "\" width=\"" << std::fabs(it->x1 - it->x0) << "\" height=\""
+                            << std::fabs(it->y1 - it->y0) << "\" fill=\"";
+                        write_svg_color(out, it->color);
+                        out << "\"/>\n";
+                        break;
+                    case shape::Line:
+                        out << "<line x1=\"" << it->x0 << "\" y1=\"" << it->y0 << "\" x2=\"" << it->x1
+                            << "\" y2=\"" << it->y1 << "\" stroke=\"";
+                        write_svg_color(out, it->color);
+                        out << "\"/>\n";
+                        break;
+                    case shape::Text:
+                        out << "<text x=\"" << it->x0 << "\" y=\"" << it->y0
+                            << "\" font-family=\"sans-serif\" font-size=\"12\" text-anchor=\""
+                            << (it->anchor < 0 ? "start" : (it->anchor > 0 ? "end" : "middle")) << "\">"
+                            << escape_xml(it->text) << "</text>\n";
+                        break;
+                }
+            }
+            out << "</svg>\n";
+        }
+    }
+
+    /** Write the flowcell heat map of a specific metric to the output stream
+     *
+     * @param out output stream opened in binary mode
+     * @param data flowcell heatmap data
+     */
+    void image_writer::write_flowcell(std::ostream &out, const model::plot::flowcell_data &data) const
+    {
+        if (m_format == SVG)
+        {
+            scene_t scene;
+            layout_flowcell(data, m_width, m_height, scene);
+            write_svg(out, scene, m_width, m_height);
+            return;
+        }
+        raster_image image;
+        render_flowcell(data, image);
+        write_png(out, image);
+    }
+    /** Write a heat map to the output stream
+     *
+     * @param out output stream opened in binary mode
+     * @param data heat map data
+     */
+    void image_writer::write_heatmap(std::ostream &out, const model::plot::heatmap_data &data) const
+    {
+        if (m_format == SVG)
+        {
+            scene_t scene;
+            layout_heatmap(data, m_width, m_height, scene);
+            write_svg(out, scene, m_width, m_height);
+            return;
+        }
+        raster_image image;
+        render_heatmap(data, image);
+        write_png(out, image);
+    }
+    /** Write a candlestick or line chart to the output stream
+     *
+     * @param out output stream opened in binary mode
+     * @param data plot data for a line or candlestick plot
+     */
+    void image_writer::write_chart(std::ostream &out,
+                                   const model::plot::plot_data<model::plot::candle_stick_point> &data) const
+    {
+        if (m_format == SVG)
+        {
+            scene_t scene;
+            layout_chart(data, m_width, m_height, scene);
+            write_svg(out, scene, m_width, m_height);
+            return;
+        }
+        raster_image image;
+        render_chart(data, image);
+        write_png(out, image);
+    }
+    /** Write a bar chart to the output stream
+     *
+     * @param out output stream opened in binary mode
+     * @param data plot data for a bar plot
+     */
+    void image_writer::write_chart(std::ostream &out, const model::plot::plot_data<model::plot::bar_point> &data) const
+    {
+        if (m_format == SVG)
+        {
+            scene_t scene;
+            layout_chart(data, m_width, m_height, scene);
+            write_svg(out, scene, m_width, m_height);
+            return;
+        }
+        raster_image image;
+        render_chart(data, image);
+        write_png(out, image);
+    }
+    /** Rasterize the flowcell heat map of a specific metric
+     *
+     * @param data flowcell heatmap data
+     * @param image destination image, resized to the size of the writer
+     */
+    void image_writer::render_flowcell(const model::plot::flowcell_data &data, raster_image& image) const
+    {
+        scene_t scene;
+        layout_flowcell(data, m_width, m_height, scene);
+        image.resize(m_width, m_height);
+        rasterize(scene, image, m_thread_count);
+    }
+    /** Rasterize a heat map
+     *
+     * @param data heat map data
+     * @param image destination image, resized to the size of the writer
+     */
+    void image_writer::render_heatmap(const model::plot::heatmap_data &data, raster_image& image) const
+    {
+        scene_t scene;
+        layout_heatmap(data, m_width, m_height, scene);
+        image.resize(m_width, m_height);
+        rasterize(scene, image, m_thread_count);
+    }
+    /** Rasterize a candlestick or line chart
+     *
+     * @param data plot data for a line or candlestick plot
+     * @param image destination image, resized to the size of the writer
+     */
+    void image_writer::render_chart(const model::plot::plot_data<model::plot::candle_stick_point> &data,
+                                    raster_image& image) const
+    {
+        scene_t scene;
+        layout_chart(data, m_width, m_height, scene);
+        image.resize(m_width, m_height);
+        rasterize(scene, image, m_thread_count);
+    }
+    /** Rasterize a bar chart
+     *
+     * @param data plot data for a bar plot
+     * @param image destination image, resized to the size of the writer
+     */
+    void image_writer::render_chart(const model::plot::plot_data<model::plot::bar_point> &data,
+                                    raster_image& image) const
+    {
+        scene_t scene;
+        layout_chart(data, m_width, m_height, scene);
+        image.resize(m_width, m_height);
+        rasterize(scene, image, m_thread_count);
+    }
+
+}}}}
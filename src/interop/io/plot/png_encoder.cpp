@@ -0,0 +1,312 @@
+/** Minimal PNG encoder for rendered plots
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/io/plot/png_encoder.h"
+
+#include <algorithm>
+#include <ostream>
+
+namespace illumina { namespace interop { namespace io { namespace plot
+{
+    namespace
+    {
+        /** Size of the LZ77 sliding window */
+        const size_t window_size = 32768;
+        /** Number of bits in the hash of three bytes */
+        const size_t hash_bits = 15;
+        /** Shortest match encoded as a length/distance pair */
+        const size_t min_match = 3;
+        /** Longest match encoded as a length/distance pair */
+        const size_t max_match = 258;
+        /** Number of earlier positions tested for each match */
+        const size_t max_chain = 32;
+
+        /** Write bits to a byte buffer, least significant bit first
+         */
+        class bit_writer
+        {
+        public:
+            /** Constructor
+             *
+             * @param out destination buffer
+             */
+            bit_writer(std::vector< ::uint8_t >& out) : m_out(out), m_buffer(0), m_count(0)
+            { }
+
+        public:
+            /** Write the low bits of a value, least significant bit first
+             *
+             * @param value bits to write
+             * @param count number of bits
+             */
+            void write(const ::uint32_t value, const size_t count)
+            {
+                m_buffer |= value << m_count;
+                m_count += count;
+                while (m_count >= 8)
+                {
+                    m_out.push_back(static_cast< ::uint8_t >(m_buffer & 0xff));
+                    m_buffer >>= 8;
+                    m_count -= 8;
+                }
+            }
+            /** Write a Huffman code, most significant bit first
+             *
+             * @param code Huffman code
+             * @param count number of bits in the code
+             */
+            void write_code(const ::uint32_t code, const size_t count)
+            {
+                ::uint32_t reversed = 0;
+                for (size_t i = 0; i < count; ++i) reversed |= ((code >> i) & 1) << (count - 1 - i);
+                write(reversed, count);
+            }
+            /** Write the remaining bits padded to a byte
+             */
+            void flush()
+            {
+                if (m_count > 0) m_out.push_back(static_cast< ::uint8_t >(m_buffer & 0xff));
+                m_buffer = 0;
+                m_count = 0;
+            }
+
+        private:
+            std::vector< ::uint8_t >& m_out;
+            ::uint32_t m_buffer;
+            size_t m_count;
+        };
+
+        /** Write a literal/length symbol with the fixed Huffman code
+         *
+         * @param out bit writer
+         * @param symbol literal (0-255), end of block (256) or length code (257-285)
+         */
+        void write_fixed_symbol(bit_writer& out, const ::uint32_t symbol)
+        {
+            if (symbol < 144) out.write_code(0x30 + symbol, 8);
+            else if (symbol < 256) out.write_code(0x190 + symbol - 144, 9);
+            else if (symbol < 280) out.write_code(symbol - 256, 7);
+            else out.write_code(0xc0 + symbol - 280, 8);
+        }
+
+        /** Write a match as a length/distance pair with the fixed Huffman codes
+         *
+         * @param out bit writer
+         * @param length match length (3-258)
+         * @param distance match distance (1-32768)
+         */
+        void write_match(bit_writer& out, const size_t length, const size_t distance)
+        {
+            static const ::uint16_t length_base[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43,
+                                                     51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+            static const ::uint8_t length_extra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4,
+                                                     4, 4, 4, 5, 5, 5, 5, 0};
+            static const ::uint16_t distance_base[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257,
+                                                       385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193,
+                                                       12289, 16385, 24577};
+            static const ::uint8_t distance_extra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9,
+                                                       9, 10, 10, 11, 11, 12, 12, 13, 13};
+            size_t length_code = 28;
+            while (length_base[length_code] > length) --length_code;
+            write_fixed_symbol(out, static_cast< ::uint32_t >(257 + length_code));
+            out.write(static_cast< ::uint32_t >(length - length_base[length_code]), length_extra[length_code]);
+            size_t distance_code = 29;
+            while (distance_base[distance_code] > distance) --distance_code;
+            out.write_code(static_cast< ::uint32_t >(distance_code), 5);
+            out.write(static_cast< ::uint32_t >(distance - distance_base[distance_code]), distance_extra[distance_code]);
+        }
+
+        /** Hash the three bytes at a position
+         *
+         * @param data buffer
+         * @return hash of the three bytes
+         */
+        inline size_t hash3(const ::uint8_t* data)
+        {
+            const ::uint32_t value = (static_cast< ::uint32_t >(data[0]) << 16) |
+                                     (static_cast< ::uint32_t >(data[1]) << 8) | data[2];
+            return static_cast<size_t>((value * 2654435761u) >> (32 - hash_bits));
+        }
+
+        /** Compute the Adler-32 checksum of a buffer
+         *
+         * @param data buffer
+         * @param size number of bytes
+         * @return checksum
+         */
+        ::uint32_t adler32(const ::uint8_t* data, const size_t size)
+        {
+            ::uint32_t a = 1, b = 0;
+            for (size_t i = 0; i < size;)
+            {
+                // 5552 is the largest block that cannot overflow before the modulo
+                const size_t end = std::min(size, i + 5552);
+                for (; i < end; ++i)
+                {
+                    a += data[i];
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+            }
+            return (b << 16) | a;
+        }
+
+        /** Compute the CRC-32 of a buffer
+         *
+         * @param table CRC lookup table
+         * @param crc running CRC
+         * @param data buffer
+         * @param size number of bytes
+         * @return updated CRC
+         */
+        ::uint32_t update_crc(const ::uint32_t* table, ::uint32_t crc, const ::uint8_t* data, const size_t size)
+        {
+            for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+            return crc;
+        }
+
+        /** Append a big-endian 32-bit integer
+         *
+         * @param out destination buffer
+         * @param value integer to append
+         */
+        void append_uint32(std::vector< ::uint8_t >& out, const ::uint32_t value)
+        {
+            out.push_back(static_cast< ::uint8_t >(value >> 24));
+            out.push_back(static_cast< ::uint8_t >(value >> 16));
+            out.push_back(static_cast< ::uint8_t >(value >> 8));
+            out.push_back(static_cast< ::uint8_t >(value));
+        }
+
+        /** Write a PNG chunk with its length and CRC
+         *
+         * @param out output stream
+         * @param table CRC lookup table
+         * @param type four character chunk type
+         * @param data chunk data
+         */
+        void write_chunk(std::ostream& out,
+                         const ::uint32_t* table,
+                         const char* type,
+                         const std::vector< ::uint8_t >& data)
+        {
+            std::vector< ::uint8_t > chunk;
+            chunk.reserve(data.size() + 12);
+            append_uint32(chunk, static_cast< ::uint32_t >(data.size()));
+            chunk.insert(chunk.end(), type, type + 4);
+            chunk.insert(chunk.end(), data.begin(), data.end());
+            const ::uint32_t crc = update_crc(table, 0xffffffffu, &chunk[4], chunk.size() - 4) ^ 0xffffffffu;
+            append_uint32(chunk, crc);
+            out.write(reinterpret_cast<const char*>(&chunk.front()), static_cast<std::streamsize>(chunk.size()));
+        }
+    }
+
+    /** Compress a buffer into a zlib stream
+     *
+     * @param data bytes to compress
+     * @param size number of bytes to compress
+     * @param compressed destination zlib stream (header, deflate data and Adler-32 checksum)
+     */
+    void zlib_compress(const ::uint8_t* data, const size_t size, std::vector< ::uint8_t >& compressed)
+    {
+        compressed.clear();
+        compressed.reserve(size / 4 + 64);
+        compressed.push_back(0x78); // Deflate, 32K window
+        compressed.push_back(0x01); // Fastest compression, no dictionary
+        bit_writer out(compressed);
+        out.write(1, 1); // Final block
+        out.write(1, 2); // Fixed Huffman codes
+
+        const size_t no_position = static_cast<size_t>(-1);
+        std::vector<size_t> head(size_t(1) << hash_bits, no_position);
+        std::vector<size_t> previous(window_size, no_position);
+        for (size_t i = 0; i < size;)
+        {
+            size_t best_length = 0;
+            size_t best_distance = 0;
+            if (i + min_match <= size)
+            {
+                const size_t hash = hash3(data + i);
+                const size_t max_length = std::min(max_match, size - i);
+                size_t candidate = head[hash];
+                for (size_t chain = 0; chain < max_chain && candidate != no_position && i - candidate <= window_size;
+                     ++chain)
+                {
+                    size_t length = 0;
+                    while (length < max_length && data[candidate + length] == data[i + length]) ++length;
+                    if (length > best_length)
+                    {
+                        best_length = length;
+                        best_distance = i - candidate;
+                        if (length == max_length) break;
+                    }
+                    const size_t next = previous[candidate % window_size];
+                    if (next == no_position || next >= candidate) break;
+                    candidate = next;
+                }
+            }
+            const size_t advance = best_length >= min_match ? best_length : 1;
+            if (best_length >= min_match) write_match(out, best_length, best_distance);
+            else write_fixed_symbol(out, data[i]);
+            for (size_t end = i + advance; i < end; ++i)
+            {
+                if (i + min_match > size) continue;
+                const size_t hash = hash3(data + i);
+                previous[i % window_size] = head[hash];
+                head[hash] = i;
+            }
+        }
+        write_fixed_symbol(out, 256);
+        out.flush();
+        append_uint32(compressed, adler32(data, size));
+    }
+
+    /** Write an image as a PNG file to the output stream
+     *
+     * @param out output stream opened in binary mode
+     * @param image source image
+     */
+    void write_png(std::ostream& out, const raster_image& image)
+    {
+        ::uint32_t table[256];
+        for (::uint32_t n = 0; n < 256; ++n)
+        {
+            ::uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        static const ::uint8_t signature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+        out.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+        std::vector< ::uint8_t > header;
+        append_uint32(header, static_cast< ::uint32_t >(image.width()));
+        append_uint32(header, static_cast< ::uint32_t >(image.height()));
+        header.push_back(8); // Bit depth
+        header.push_back(2); // Truecolor
+        header.push_back(0); // Deflate
+        header.push_back(0); // Adaptive filtering
+        header.push_back(0); // No interlace
+        write_chunk(out, table, "IHDR", header);
+
+        // Rows of a plot repeat, so the unfiltered rows compress well as matches against the previous row
+        const size_t stride = image.width() * 3;
+        std::vector< ::uint8_t > scanlines;
+        scanlines.reserve((stride + 1) * image.height());
+        for (size_t y = 0; y < image.height(); ++y)
+        {
+            scanlines.push_back(0); // No filter
+            if (stride > 0) scanlines.insert(scanlines.end(), image.row(y), image.row(y) + stride);
+        }
+        std::vector< ::uint8_t > compressed;
+        zlib_compress(scanlines.empty() ? 0 : &scanlines.front(), scanlines.size(), compressed);
+        write_chunk(out, table, "IDAT", compressed);
+        write_chunk(out, table, "IEND", std::vector< ::uint8_t >());
+    }
+
+}}}}
@@ -0,0 +1,1151 @@
+/** SQLite virtual tables over loaded run metrics
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/io/sqlite_module.h"
+
+#include <sqlite3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include "interop/util/math.h"
+#include "interop/util/length_of.h"
+#include "interop/util/lexical_cast.h"
+#include "interop/logic/utils/enums.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    namespace detail
+    {
+        /** Column of a virtual table beyond the id columns */
+        struct column_def
+        {
+            /** Constructor
+             *
+             * @param n name of the column
+             * @param f field of the record
+             * @param i index of the channel, base, read or bin
+             * @param real true if the values are floating point
+             */
+            column_def(const std::string& n, const int f, const size_t i, const bool real) :
+                    name(n), field(f), index(i), is_real(real){}
+            /** Name of the column */
+            std::string name;
+            /** Field of the record, specific to each metric type */
+            int field;
+            /** Index of the channel, base, read or bin */
+            size_t index;
+            /** True if the values are floating point */
+            bool is_real;
+        };
+        /** List of columns */
+        typedef std::vector<column_def> column_vector;
+
+        /** Set the result of a column to a floating point value, NULL if the value is missing
+         *
+         * @param context SQLite context
+         * @param value column value
+         */
+        inline void set_result(sqlite3_context* context, const float value)
+        {
+            if (std::isnan(value)) sqlite3_result_null(context);
+            else sqlite3_result_double(context, static_cast<double>(value));
+        }
+        /** Set the result of a column to an integer value
+         *
+         * @param context SQLite context
+         * @param value column value
+         */
+        inline void set_result(sqlite3_context* context, const ::uint64_t value)
+        {
+            sqlite3_result_int64(context, static_cast<sqlite3_int64>(value));
+        }
+        /** Set the result of a column to an element of an array, NULL if the element is missing
+         *
+         * @param context SQLite context
+         * @param values array of values
+         * @param index index of the element
+         */
+        template<class T>
+        void set_result(sqlite3_context* context, const std::vector<T>& values, const size_t index)
+        {
+            if (index >= values.size()) sqlite3_result_null(context);
+            else set_result(context, values[index]);
+        }
+        /** Set the result of a column to an element of an array of integers, NULL if the element is missing
+         *
+         * @param context SQLite context
+         * @param values array of values
+         * @param index index of the element
+         */
+        template<class T>
+        void set_integer_result(sqlite3_context* context, const std::vector<T>& values, const size_t index)
+        {
+            if (index >= values.size()) sqlite3_result_null(context);
+            else set_result(context, static_cast< ::uint64_t >(values[index]));
+        }
+        /** Add a column for each channel
+         *
+         * @param columns destination columns
+         * @param prefix prefix of the column names
+         * @param field field of the record
+         * @param channels name of each channel
+         * @param real true if the values are floating point
+         */
+        inline void add_channel_columns(column_vector& columns,
+                                        const std::string& prefix,
+                                        const int field,
+                                        const std::vector<std::string>& channels,
+                                        const bool real)
+        {
+            for (size_t i = 0; i < channels.size(); ++i)
+                columns.push_back(column_def(prefix + "_" + channels[i], field, i, real));
+        }
+        /** Name each channel after the run info, or after its index if the run info does not name them all
+         *
+         * @param names channel names from the run info
+         * @param count number of channels
+         * @return name of each channel
+         */
+        inline std::vector<std::string> channel_names(const std::vector<std::string>& names, const size_t count)
+        {
+            if (names.size() >= count) return std::vector<std::string>(names.begin(), names.begin() + count);
+            std::vector<std::string> indexed;
+            for (size_t i = 0; i < count; ++i) indexed.push_back(util::lexical_cast<std::string>(i + 1));
+            return indexed;
+        }
+
+        /** Columns of a metric set beyond the id columns
+         *
+         * This template class must be specialized for each metric type exposed as a table.
+         */
+        template<class Metric>
+        struct table_layout;
+
+        /** Columns of the error metrics */
+        template<>
+        struct table_layout<model::metrics::error_metric>
+        {
+            /** Describe the columns
+             *
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::error_metric>&,
+                                 const std::vector<std::string>&,
+                                 column_vector& columns)
+            {
+                columns.push_back(column_def("ErrorRate", 0, 0, true));
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             */
+            static void value(sqlite3_context* context, const model::metrics::error_metric& metric, const column_def&)
+            {
+                set_result(context, metric.error_rate());
+            }
+        };
+
+        /** Columns of the extraction metrics */
+        template<>
+        struct table_layout<model::metrics::extraction_metric>
+        {
+            /** Describe the columns
+             *
+             * @param metrics metric set
+             * @param channels channel names from the run info
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::extraction_metric>& metrics,
+                                 const std::vector<std::string>& channels,
+                                 column_vector& columns)
+            {
+                size_t channel_count = 0;
+                for (size_t i = 0; i < metrics.size(); ++i)
+                    channel_count = std::max(channel_count, metrics[i].channel_count());
+                const std::vector<std::string> names = channel_names(channels, channel_count);
+                columns.push_back(column_def("TimeStamp", 0, 0, false));
+                add_channel_columns(columns, "MaxIntensity", 1, names, false);
+                add_channel_columns(columns, "Focus", 2, names, true);
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context,
+                              const model::metrics::extraction_metric& metric,
+                              const column_def& column)
+            {
+                switch (column.field)
+                {
+                    case 0:
+                        set_result(context, static_cast< ::uint64_t >(metric.date_time()));
+                        break;
+                    case 1:
+                        set_integer_result(context, metric.max_intensity_values(), column.index);
+                        break;
+                    default:
+                        set_result(context, metric.focus_scores(), column.index);
+                        break;
+                }
+            }
+        };
+
+        /** Columns of the image metrics */
+        template<>
+        struct table_layout<model::metrics::image_metric>
+        {
+            /** Describe the columns
+             *
+             * @param metrics metric set
+             * @param channels channel names from the run info
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::image_metric>& metrics,
+                                 const std::vector<std::string>& channels,
+                                 column_vector& columns)
+            {
+                size_t channel_count = 0;
+                for (size_t i = 0; i < metrics.size(); ++i)
+                    channel_count = std::max(channel_count, static_cast<size_t>(metrics[i].channel_count()));
+                const std::vector<std::string> names = channel_names(channels, channel_count);
+                add_channel_columns(columns, "MinContrast", 0, names, false);
+                add_channel_columns(columns, "MaxContrast", 1, names, false);
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context,
+                              const model::metrics::image_metric& metric,
+                              const column_def& column)
+            {
+                if (column.field == 0) set_integer_result(context, metric.min_contrast_array(), column.index);
+                else set_integer_result(context, metric.max_contrast_array(), column.index);
+            }
+        };
+
+        /** Columns of the corrected intensity metrics */
+        template<>
+        struct table_layout<model::metrics::corrected_intensity_metric>
+        {
+            /** Describe the columns
+             *
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::corrected_intensity_metric>&,
+                                 const std::vector<std::string>&,
+                                 column_vector& columns)
+            {
+                const char* bases[] = {"NC", "A", "C", "G", "T"};
+                columns.push_back(column_def("AverageCycleIntensity", 0, 0, false));
+                columns.push_back(column_def("SignalToNoise", 1, 0, true));
+                for (size_t i = 0; i < util::length_of(bases); ++i)
+                    columns.push_back(column_def(std::string("CalledCount_") + bases[i], 2, i, false));
+                for (size_t i = 1; i < util::length_of(bases); ++i)
+                    columns.push_back(column_def(std::string("CalledIntensity_") + bases[i], 3, i - 1, true));
+                for (size_t i = 1; i < util::length_of(bases); ++i)
+                    columns.push_back(column_def(std::string("AllIntensity_") + bases[i], 4, i - 1, false));
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context,
+                              const model::metrics::corrected_intensity_metric& metric,
+                              const column_def& column)
+            {
+                switch (column.field)
+                {
+                    case 0:
+                        set_result(context, static_cast< ::uint64_t >(metric.average_cycle_intensity()));
+                        break;
+                    case 1:
+                        set_result(context, metric.signal_to_noise());
+                        break;
+                    case 2:
+                        set_integer_result(context, metric.called_counts_array(), column.index);
+                        break;
+                    case 3:
+                        set_result(context, metric.corrected_int_called_array(), column.index);
+                        break;
+                    default:
+                        set_integer_result(context, metric.corrected_int_all_array(), column.index);
+                        break;
+                }
+            }
+        };
+
+        /** Columns of the Q-metrics, one for each bin of the histogram */
+        template<>
+        struct table_layout<model::metrics::q_metric>
+        {
+            /** Describe the columns
+             *
+             * @param metrics metric set
+             * @param columns destination columns
+             */
+            template<class MetricSet>
+            static void describe(const MetricSet& metrics, const std::vector<std::string>&, column_vector& columns)
+            {
+                size_t bin_count = 0;
+                for (size_t i = 0; i < metrics.size(); ++i) bin_count = std::max(bin_count, metrics[i].size());
+                for (size_t i = 0; i < bin_count; ++i)
+                    columns.push_back(column_def("Bin_" + util::lexical_cast<std::string>(i + 1), 0, i, false));
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context, const model::metrics::q_metric& metric, const column_def& column)
+            {
+                set_integer_result(context, metric.qscore_hist(), column.index);
+            }
+        };
+
+        /** Columns of the Q-metrics by lane, one for each bin of the histogram */
+        template<>
+        struct table_layout<model::metrics::q_by_lane_metric> : table_layout<model::metrics::q_metric>
+        {
+        };
+
+        /** Columns of the Q-metrics by tile and read, one for each bin of the histogram */
+        template<>
+        struct table_layout<model::metrics::q_by_tile_read_metric>
+        {
+            /** Describe the columns
+             *
+             * @param metrics metric set
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::q_by_tile_read_metric>& metrics,
+                                 const std::vector<std::string>&,
+                                 column_vector& columns)
+            {
+                table_layout<model::metrics::q_metric>::describe(metrics, std::vector<std::string>(), columns);
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context,
+                              const model::metrics::q_by_tile_read_metric& metric,
+                              const column_def& column)
+            {
+                if (column.index >= metric.size()) sqlite3_result_null(context);
+                else set_result(context, static_cast< ::uint64_t >(metric.qscore_hist(column.index)));
+            }
+        };
+
+        /** Columns of the collapsed Q-metrics */
+        template<>
+        struct table_layout<model::metrics::q_collapsed_metric>
+        {
+            /** Describe the columns
+             *
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::q_collapsed_metric>&,
+                                 const std::vector<std::string>&,
+                                 column_vector& columns)
+            {
+                const char* names[] =
+                {
+                    "Q20", "Q30", "Total", "MedianQScore", "CumulativeQ20", "CumulativeQ30", "CumulativeTotal"
+                };
+                for (size_t i = 0; i < util::length_of(names); ++i)
+                    columns.push_back(column_def(names[i], static_cast<int>(i), 0, false));
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context,
+                              const model::metrics::q_collapsed_metric& metric,
+                              const column_def& column)
+            {
+                ::uint64_t result = 0;
+                switch (column.field)
+                {
+                    case 0: result = metric.q20(); break;
+                    case 1: result = metric.q30(); break;
+                    case 2: result = metric.total(); break;
+                    case 3: result = metric.median_qscore(); break;
+                    case 4: result = metric.cumulative_q20(); break;
+                    case 5: result = metric.cumulative_q30(); break;
+                    default: result = metric.cumulative_total(); break;
+                }
+                set_result(context, result);
+            }
+        };
+
+        /** Columns of the tile metrics, with the alignment and phasing of each read */
+        template<>
+        struct table_layout<model::metrics::tile_metric>
+        {
+            /** Describe the columns
+             *
+             * @param metrics metric set
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::tile_metric>& metrics,
+                                 const std::vector<std::string>&,
+                                 column_vector& columns)
+            {
+                const char* names[] = {"ClusterCount", "ClusterCountPF", "Density", "DensityPF"};
+                for (size_t i = 0; i < util::length_of(names); ++i)
+                    columns.push_back(column_def(names[i], static_cast<int>(i), 0, true));
+                size_t read_count = 0;
+                for (size_t i = 0; i < metrics.size(); ++i)
+                {
+                    const model::metrics::tile_metric::read_metric_vector& reads = metrics[i].read_metrics();
+                    for (size_t j = 0; j < reads.size(); ++j)
+                        read_count = std::max(read_count, static_cast<size_t>(reads[j].read()));
+                }
+                const char* read_names[] = {"Aligned", "Prephasing", "Phasing"};
+                for (size_t i = 0; i < util::length_of(read_names); ++i)
+                {
+                    for (size_t read = 1; read <= read_count; ++read)
+                    {
+                        columns.push_back(column_def(std::string(read_names[i]) + "_R" +
+                                                     util::lexical_cast<std::string>(read),
+                                                     static_cast<int>(util::length_of(names) + i), read, true));
+                    }
+                }
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context,
+                              const model::metrics::tile_metric& metric,
+                              const column_def& column)
+            {
+                switch (column.field)
+                {
+                    case 0: set_result(context, metric.cluster_count()); break;
+                    case 1: set_result(context, metric.cluster_count_pf()); break;
+                    case 2: set_result(context, metric.cluster_density()); break;
+                    case 3: set_result(context, metric.cluster_density_pf()); break;
+                    case 4: set_result(context, metric.percent_aligned_at(column.index)); break;
+                    case 5: set_result(context, metric.percent_prephasing_at(column.index)); break;
+                    default: set_result(context, metric.percent_phasing_at(column.index)); break;
+                }
+            }
+        };
+
+        /** Columns of the extended tile metrics */
+        template<>
+        struct table_layout<model::metrics::extended_tile_metric>
+        {
+            /** Describe the columns
+             *
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::extended_tile_metric>&,
+                                 const std::vector<std::string>&,
+                                 column_vector& columns)
+            {
+                columns.push_back(column_def("ClusterCountOccupied", 0, 0, true));
+                columns.push_back(column_def("PercentOccupied", 1, 0, true));
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context,
+                              const model::metrics::extended_tile_metric& metric,
+                              const column_def& column)
+            {
+                if (column.field == 0) set_result(context, metric.cluster_count_occupied());
+                else set_result(context, metric.percent_occupied());
+            }
+        };
+
+        /** Columns of the empirical phasing metrics */
+        template<>
+        struct table_layout<model::metrics::phasing_metric>
+        {
+            /** Describe the columns
+             *
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::phasing_metric>&,
+                                 const std::vector<std::string>&,
+                                 column_vector& columns)
+            {
+                columns.push_back(column_def("PhasingWeight", 0, 0, true));
+                columns.push_back(column_def("PrephasingWeight", 1, 0, true));
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context,
+                              const model::metrics::phasing_metric& metric,
+                              const column_def& column)
+            {
+                if (column.field == 0) set_result(context, metric.phasing_weight());
+                else set_result(context, metric.prephasing_weight());
+            }
+        };
+
+        /** Columns of the dynamic phasing metrics */
+        template<>
+        struct table_layout<model::metrics::dynamic_phasing_metric>
+        {
+            /** Describe the columns
+             *
+             * @param columns destination columns
+             */
+            static void describe(const model::metric_base::metric_set<model::metrics::dynamic_phasing_metric>&,
+                                 const std::vector<std::string>&,
+                                 column_vector& columns)
+            {
+                const char* names[] = {"PhasingSlope", "PhasingOffset", "PrephasingSlope", "PrephasingOffset"};
+                for (size_t i = 0; i < util::length_of(names); ++i)
+                    columns.push_back(column_def(names[i], static_cast<int>(i), 0, true));
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param metric record
+             * @param column column description
+             */
+            static void value(sqlite3_context* context,
+                              const model::metrics::dynamic_phasing_metric& metric,
+                              const column_def& column)
+            {
+                switch (column.field)
+                {
+                    case 0: set_result(context, metric.phasing_slope()); break;
+                    case 1: set_result(context, metric.phasing_offset()); break;
+                    case 2: set_result(context, metric.prephasing_slope()); break;
+                    default: set_result(context, metric.prephasing_offset()); break;
+                }
+            }
+        };
+
+        /** Name of the third id column of a tile metric
+         *
+         * @return null, tile metrics have no third id column
+         */
+        inline const char* key_column(const constants::base_tile_t*){return 0;}
+        /** Name of the third id column of a cycle metric
+         *
+         * @return name of the column
+         */
+        inline const char* key_column(const constants::base_cycle_t*){return "Cycle";}
+        /** Name of the third id column of a read metric
+         *
+         * @return name of the column
+         */
+        inline const char* key_column(const constants::base_read_t*){return "Read";}
+        /** Name of the third id column of a lane metric, which is also a cycle metric
+         *
+         * @return name of the column
+         */
+        inline const char* key_column(const constants::base_lane_t*){return "Cycle";}
+        /** Third id of a tile metric
+         *
+         * @return 0
+         */
+        template<class Metric>
+        ::uint64_t key_of(const Metric&, const constants::base_tile_t*){return 0;}
+        /** Third id of a cycle metric
+         *
+         * @param metric record
+         * @return cycle
+         */
+        template<class Metric>
+        ::uint64_t key_of(const Metric& metric, const constants::base_cycle_t*){return metric.cycle();}
+        /** Third id of a read metric
+         *
+         * @param metric record
+         * @return read
+         */
+        template<class Metric>
+        ::uint64_t key_of(const Metric& metric, const constants::base_read_t*){return metric.read();}
+        /** Third id of a lane metric
+         *
+         * @param metric record
+         * @return cycle
+         */
+        template<class Metric>
+        ::uint64_t key_of(const Metric& metric, const constants::base_lane_t*){return metric.cycle();}
+
+        /** Bit of the plan for each id column constrained by equality */
+        enum constraint_bits
+        {
+            /** Lane is constrained */
+            LaneConstraint = 1,
+            /** Tile is constrained */
+            TileConstraint = 2,
+            /** Cycle or read is constrained */
+            KeyConstraint = 4
+        };
+
+        /** Virtual table over a metric set, independent of the metric type
+         *
+         * The SQLite table structure is the first base, so SQLite may hold the table as a plain sqlite3_vtab.
+         */
+        class abstract_table : public sqlite3_vtab
+        {
+        public:
+            /** Constructor */
+            abstract_table()
+            {
+                std::memset(static_cast<sqlite3_vtab*>(this), 0, sizeof(sqlite3_vtab));
+            }
+            /** Destructor */
+            virtual ~abstract_table(){}
+
+        public:
+            /** Get the declaration of the table
+             *
+             * @return CREATE TABLE statement
+             */
+            virtual std::string declaration()const=0;
+            /** Get the number of records
+             *
+             * @return number of records
+             */
+            virtual size_t size()const=0;
+            /** Test if the table has a third id column, cycle or read
+             *
+             * @return true if the table has a cycle or read column
+             */
+            virtual bool has_key()const=0;
+            /** Find a record through the id index
+             *
+             * @param lane lane
+             * @param tile tile
+             * @param key cycle or read, ignored for tile metrics
+             * @return index of the record or the number of records
+             */
+            virtual size_t find(const ::uint64_t lane, const ::uint64_t tile, const ::uint64_t key)const=0;
+            /** Test if a record matches the id constraints
+             *
+             * @param row index of the record
+             * @param plan bits of the constrained columns
+             * @param ids constrained lane, tile and key
+             * @return true if the record matches
+             */
+            virtual bool matches(const size_t row, const int plan, const ::uint64_t* ids)const=0;
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param row index of the record
+             * @param column index of the column
+             */
+            virtual void value(sqlite3_context* context, const size_t row, const int column)const=0;
+        };
+
+        /** Virtual table over the metric set of a single metric type */
+        template<class Metric>
+        class metric_table : public abstract_table
+        {
+            typedef model::metric_base::metric_set<Metric> metric_set_t;
+            typedef typename Metric::base_t base_t;
+        public:
+            /** Constructor
+             *
+             * @param metrics metric set
+             * @param channels channel names from the run info
+             */
+            metric_table(const metric_set_t& metrics, const std::vector<std::string>& channels) :
+                    m_metrics(metrics),
+                    m_key_column(key_column(static_cast<const base_t*>(0)))
+            {
+                table_layout<Metric>::describe(metrics, channels, m_columns);
+            }
+
+        public:
+            /** Get the declaration of the table
+             *
+             * @return CREATE TABLE statement
+             */
+            std::string declaration()const
+            {
+                std::ostringstream sql;
+                sql << "CREATE TABLE x(\"Lane\" INTEGER, \"Tile\" INTEGER";
+                if (m_key_column != 0) sql << ", \"" << m_key_column << "\" INTEGER";
+                for (size_t i = 0; i < m_columns.size(); ++i)
+                    sql << ", \"" << m_columns[i].name << "\" " << (m_columns[i].is_real ? "REAL" : "INTEGER");
+                sql << ")";
+                return sql.str();
+            }
+            /** Get the number of records
+             *
+             * @return number of records
+             */
+            size_t size()const
+            {
+                return m_metrics.size();
+            }
+            /** Test if the table has a third id column, cycle or read
+             *
+             * @return true if the table has a cycle or read column
+             */
+            bool has_key()const
+            {
+                return m_key_column != 0;
+            }
+            /** Find a record through the id index
+             *
+             * @param lane lane
+             * @param tile tile
+             * @param key cycle or read, ignored for tile metrics
+             * @return index of the record or the number of records
+             */
+            size_t find(const ::uint64_t lane, const ::uint64_t tile, const ::uint64_t key)const
+            {
+                return m_metrics.find(Metric::create_id(lane, tile, key));
+            }
+            /** Test if a record matches the id constraints
+             *
+             * @param row index of the record
+             * @param plan bits of the constrained columns
+             * @param ids constrained lane, tile and key
+             * @return true if the record matches
+             */
+            bool matches(const size_t row, const int plan, const ::uint64_t* ids)const
+            {
+                const Metric& metric = m_metrics[row];
+                if ((plan & LaneConstraint) && metric.lane() != ids[0]) return false;
+                if ((plan & TileConstraint) && metric.tile() != ids[1]) return false;
+                if ((plan & KeyConstraint) && key_of(metric, static_cast<const base_t*>(0)) != ids[2]) return false;
+                return true;
+            }
+            /** Set the value of a column
+             *
+             * @param context SQLite context
+             * @param row index of the record
+             * @param column index of the column
+             */
+            void value(sqlite3_context* context, const size_t row, const int column)const
+            {
+                const Metric& metric = m_metrics[row];
+                const int id_count = m_key_column != 0 ? 3 : 2;
+                if (column == 0) set_result(context, static_cast< ::uint64_t >(metric.lane()));
+                else if (column == 1) set_result(context, static_cast< ::uint64_t >(metric.tile()));
+                else if (column < id_count) set_result(context, key_of(metric, static_cast<const base_t*>(0)));
+                else table_layout<Metric>::value(context, metric, m_columns[column - id_count]);
+            }
+
+        private:
+            const metric_set_t& m_metrics;
+            const char* m_key_column;
+            column_vector m_columns;
+        };
+
+        /** Cursor over the records of a virtual table */
+        struct table_cursor : public sqlite3_vtab_cursor
+        {
+            /** Constructor */
+            table_cursor() : row(0), end(0), plan(0)
+            {
+                std::memset(static_cast<sqlite3_vtab_cursor*>(this), 0, sizeof(sqlite3_vtab_cursor));
+                ids[0] = ids[1] = ids[2] = 0;
+            }
+            /** Get the table of the cursor
+             *
+             * @return virtual table
+             */
+            const abstract_table& table()const
+            {
+                return *static_cast<const abstract_table*>(pVtab);
+            }
+            /** Skip the records that do not match the constraints */
+            void skip()
+            {
+                while (row < end && !table().matches(row, plan, ids)) ++row;
+            }
+            /** Index of the current record */
+            size_t row;
+            /** Index past the last record to visit */
+            size_t end;
+            /** Bits of the constrained columns */
+            int plan;
+            /** Constrained lane, tile and key */
+            ::uint64_t ids[3];
+        };
+
+        /** Create a virtual table for a named metric group
+         *
+         * Metric sets without records are skipped.
+         */
+        class create_table
+        {
+        public:
+            /** Constructor
+             *
+             * @param group name of the metric group
+             * @param channels channel names from the run info
+             */
+            create_table(const std::string& group, const std::vector<std::string>& channels) :
+                    m_group(group), m_channels(channels), m_table(0){}
+            /** Create the table if the metric set matches the group
+             *
+             * @param metrics metric set
+             */
+            template<class MetricSet>
+            void operator()(const MetricSet& metrics)
+            {
+                create(metrics, static_cast<const typename MetricSet::metric_type*>(0));
+            }
+            /** Get the table
+             *
+             * @return virtual table or null if no metric set matches
+             */
+            abstract_table* table()const
+            {
+                return m_table;
+            }
+            /** Test if a metric set should be exposed as a table
+             *
+             * @param metrics metric set
+             * @return true if the metric set holds records and has a table layout
+             */
+            template<class MetricSet>
+            static bool is_exposed(const MetricSet& metrics)
+            {
+                return !metrics.empty() && is_supported(static_cast<const typename MetricSet::metric_type*>(0));
+            }
+
+        private:
+            template<class MetricSet, class Metric>
+            void create(const MetricSet& metrics, const Metric*)
+            {
+                if (m_table != 0 || !is_exposed(metrics)) return;
+                if (constants::to_string(static_cast<constants::metric_group>(MetricSet::TYPE)) != m_group) return;
+                m_table = new metric_table<Metric>(metrics, m_channels);
+            }
+            template<class MetricSet>
+            void create(const MetricSet&, const model::metrics::index_metric*){}
+            template<class Metric>
+            static bool is_supported(const Metric*){return true;}
+            static bool is_supported(const model::metrics::index_metric*){return false;}
+
+        private:
+            std::string m_group;
+            const std::vector<std::string>& m_channels;
+            abstract_table* m_table;
+        };
+
+        /** Collect the names of the metric groups exposed as tables */
+        class list_groups
+        {
+        public:
+            /** Constructor
+             *
+             * @param groups destination group names
+             */
+            list_groups(std::vector<std::string>& groups) : m_groups(groups){}
+            /** Add the group of a metric set if it is exposed as a table
+             *
+             * @param metrics metric set
+             */
+            template<class MetricSet>
+            void operator()(const MetricSet& metrics)const
+            {
+                if (create_table::is_exposed(metrics))
+                    m_groups.push_back(constants::to_string(static_cast<constants::metric_group>(MetricSet::TYPE)));
+            }
+
+        private:
+            std::vector<std::string>& m_groups;
+        };
+
+        /** Create or connect to a virtual table
+         *
+         * The arguments are the module, database and table names, followed by the name of the metric group.
+         */
+        extern "C" int metric_table_connect(sqlite3* db,
+                                            void* aux,
+                                            int argc,
+                                            const char* const* argv,
+                                            sqlite3_vtab** vtab,
+                                            char** error)
+        {
+            if (argc < 4)
+            {
+                *error = sqlite3_mprintf("Missing metric group");
+                return SQLITE_ERROR;
+            }
+            const model::metrics::run_metrics& metrics = *static_cast<const model::metrics::run_metrics*>(aux);
+            create_table create(argv[3], metrics.run_info().channels());
+            metrics.metrics_callback(create);
+            abstract_table* table = create.table();
+            if (table == 0)
+            {
+                *error = sqlite3_mprintf("No metrics for group: %s", argv[3]);
+                return SQLITE_ERROR;
+            }
+            const int status = sqlite3_declare_vtab(db, table->declaration().c_str());
+            if (status != SQLITE_OK)
+            {
+                delete table;
+                return status;
+            }
+            *vtab = table;
+            return SQLITE_OK;
+        }
+        /** Disconnect from or destroy a virtual table */
+        extern "C" int metric_table_disconnect(sqlite3_vtab* vtab)
+        {
+            delete static_cast<abstract_table*>(vtab);
+            return SQLITE_OK;
+        }
+        /** Plan a query
+         *
+         * Equality constraints on the lane, tile and cycle (or read) are consumed by the table. When all of them are
+         * given, the record is found through the id index.
+         */
+        extern "C" int metric_table_best_index(sqlite3_vtab* vtab, sqlite3_index_info* info)
+        {
+            const abstract_table& table = *static_cast<const abstract_table*>(vtab);
+            const int id_count = table.has_key() ? 3 : 2;
+            int constraint_of[3] = {-1, -1, -1};
+            for (int i = 0; i < info->nConstraint; ++i)
+            {
+                const sqlite3_index_info::sqlite3_index_constraint& constraint = info->aConstraint[i];
+                if (!constraint.usable || constraint.op != SQLITE_INDEX_CONSTRAINT_EQ) continue;
+                if (constraint.iColumn < 0 || constraint.iColumn >= id_count) continue;
+                if (constraint_of[constraint.iColumn] < 0) constraint_of[constraint.iColumn] = i;
+            }
+            int plan = 0;
+            int argument = 0;
+            for (int column = 0; column < id_count; ++column)
+            {
+                if (constraint_of[column] < 0) continue;
+                plan |= 1 << column;
+                info->aConstraintUsage[constraint_of[column]].argvIndex = ++argument;
+                info->aConstraintUsage[constraint_of[column]].omit = 1;
+            }
+            info->idxNum = plan;
+            const double record_count = static_cast<double>(std::max<size_t>(table.size(), 1));
+            if (argument == id_count)
+            {
+                info->estimatedCost = 1;
+                info->estimatedRows = 1;
+                info->idxFlags = SQLITE_INDEX_SCAN_UNIQUE;
+            }
+            else
+            {
+                // A filtered scan still visits every record, but reads no column of the records it skips
+                info->estimatedCost = record_count / (1 + argument);
+                info->estimatedRows = static_cast<sqlite3_int64>(record_count / (1 << (2 * argument)));
+            }
+            return SQLITE_OK;
+        }
+        /** Open a cursor */
+        extern "C" int metric_table_open(sqlite3_vtab*, sqlite3_vtab_cursor** cursor)
+        {
+            *cursor = new table_cursor;
+            return SQLITE_OK;
+        }
+        /** Close a cursor */
+        extern "C" int metric_table_close(sqlite3_vtab_cursor* cursor)
+        {
+            delete static_cast<table_cursor*>(cursor);
+            return SQLITE_OK;
+        }
+        /** Start a scan following the plan chosen by metric_table_best_index */
+        extern "C" int metric_table_filter(sqlite3_vtab_cursor* base_cursor,
+                                           int plan,
+                                           const char*,
+                                           int argc,
+                                           sqlite3_value** argv)
+        {
+            table_cursor& cursor = *static_cast<table_cursor*>(base_cursor);
+            const abstract_table& table = cursor.table();
+            const int id_count = table.has_key() ? 3 : 2;
+            cursor.plan = plan;
+            cursor.row = 0;
+            cursor.end = table.size();
+            int argument = 0;
+            for (int column = 0; column < id_count && argument < argc; ++column)
+            {
+                if ((plan & (1 << column)) == 0) continue;
+                const int type = sqlite3_value_numeric_type(argv[argument]);
+                const double real_id = sqlite3_value_double(argv[argument]);
+                const sqlite3_int64 id = sqlite3_value_int64(argv[argument]);
+                ++argument;
+                // The constraint is omitted by SQLite, so a real equal to an integer, e.g. Lane = 1.0, must still
+                // match as SQL comparison would
+                const bool is_integer = type == SQLITE_INTEGER ||
+                        (type == SQLITE_FLOAT && real_id == std::floor(real_id) && real_id == static_cast<double>(id));
+                // An id that is not a valid unsigned integer matches no record
+                if (!is_integer || id < 0 || id > static_cast<sqlite3_int64>(0xFFFFFFFFu))
+                {
+                    cursor.end = 0;
+                    return SQLITE_OK;
+                }
+                cursor.ids[column] = static_cast< ::uint64_t >(id);
+            }
+            if (plan == (1 << id_count) - 1)
+            {
+                cursor.row = table.find(cursor.ids[0], cursor.ids[1], cursor.ids[2]);
+                cursor.end = std::min(cursor.row + 1, table.size());
+                return SQLITE_OK;
+            }
+            cursor.skip();
+            return SQLITE_OK;
+        }
+        /** Move a cursor to the next matching record */
+        extern "C" int metric_table_next(sqlite3_vtab_cursor* base_cursor)
+        {
+            table_cursor& cursor = *static_cast<table_cursor*>(base_cursor);
+            ++cursor.row;
+            cursor.skip();
+            return SQLITE_OK;
+        }
+        /** Test if a cursor is past the last record */
+        extern "C" int metric_table_eof(sqlite3_vtab_cursor* base_cursor)
+        {
+            const table_cursor& cursor = *static_cast<const table_cursor*>(base_cursor);
+            return cursor.row >= cursor.end;
+        }
+        /** Read a column of the current record */
+        extern "C" int metric_table_column(sqlite3_vtab_cursor* base_cursor, sqlite3_context* context, int column)
+        {
+            const table_cursor& cursor = *static_cast<const table_cursor*>(base_cursor);
+            cursor.table().value(context, cursor.row, column);
+            return SQLITE_OK;
+        }
+        /** Get the row id of the current record, its index in the metric set */
+        extern "C" int metric_table_rowid(sqlite3_vtab_cursor* base_cursor, sqlite3_int64* rowid)
+        {
+            *rowid = static_cast<sqlite3_int64>(static_cast<const table_cursor*>(base_cursor)->row);
+            return SQLITE_OK;
+        }
+
+        /** Get the read only virtual table module
+         *
+         * @return module
+         */
+        inline sqlite3_module* metric_module()
+        {
+            static sqlite3_module module;
+            static bool is_initialized = false;
+            if (!is_initialized)
+            {
+                std::memset(&module, 0, sizeof(module));
+                module.iVersion = 1;
+                module.xCreate = metric_table_connect;
+                module.xConnect = metric_table_connect;
+                module.xBestIndex = metric_table_best_index;
+                module.xDisconnect = metric_table_disconnect;
+                module.xDestroy = metric_table_disconnect;
+                module.xOpen = metric_table_open;
+                module.xClose = metric_table_close;
+                module.xFilter = metric_table_filter;
+                module.xNext = metric_table_next;
+                module.xEof = metric_table_eof;
+                module.xColumn = metric_table_column;
+                module.xRowid = metric_table_rowid;
+                is_initialized = true;
+            }
+            return &module;
+        }
+        /** Quote an identifier for SQL
+         *
+         * @param name identifier
+         * @return quoted identifier
+         */
+        inline std::string quote(const std::string& name)
+        {
+            std::string quoted = "\"";
+            for (size_t i = 0; i < name.size(); ++i)
+            {
+                if (name[i] == '"') quoted += '"';
+                quoted += name[i];
+            }
+            return quoted + "\"";
+        }
+        /** Execute a statement
+         *
+         * @param db database connection
+         * @param sql statement
+         */
+        inline void execute(sqlite3* db, const std::string& sql)
+        {
+            char* error = 0;
+            if (sqlite3_exec(db, sql.c_str(), 0, 0, &error) != SQLITE_OK)
+            {
+                const std::string message = error != 0 ? error : sqlite3_errmsg(db);
+                sqlite3_free(error);
+                INTEROP_THROW(sqlite_exception, "Failed to execute: " << sql << " - " << message);
+            }
+        }
+    }
+
+    /** Attach the run metrics to a SQLite database connection
+     *
+     * @param db open database connection
+     * @param metrics loaded run metrics
+     * @param prefix prefix of the table names, unique for each attached run
+     * @return number of tables created
+     */
+    size_t attach_run_metrics(sqlite3* db, const model::metrics::run_metrics& metrics, const std::string& prefix)
+    INTEROP_THROW_SPEC((sqlite_exception))
+    {
+        const std::string module_name = prefix + "interop";
+        if (sqlite3_create_module_v2(db, module_name.c_str(), detail::metric_module(),
+                                     const_cast<model::metrics::run_metrics*>(&metrics), 0) != SQLITE_OK)
+            INTEROP_THROW(sqlite_exception, "Failed to register module: " << module_name << " - " << sqlite3_errmsg(db));
+        std::vector<std::string> groups;
+        detail::list_groups list(groups);
+        metrics.metrics_callback(list);
+        for (size_t i = 0; i < groups.size(); ++i)
+        {
+            detail::execute(db, "CREATE VIRTUAL TABLE temp." + detail::quote(prefix + groups[i]) + " USING " +
+                                detail::quote(module_name) + "(" + groups[i] + ")");
+        }
+        return groups.size();
+    }
+    /** Drop the virtual tables created by attach_run_metrics
+     *
+     * @param db open database connection
+     * @param metrics run metrics given to attach_run_metrics
+     * @param prefix prefix given to attach_run_metrics
+     */
+    void detach_run_metrics(sqlite3* db, const model::metrics::run_metrics& metrics, const std::string& prefix)
+    INTEROP_THROW_SPEC((sqlite_exception))
+    {
+        std::vector<std::string> groups;
+        detail::list_groups list(groups);
+        metrics.metrics_callback(list);
+        for (size_t i = 0; i < groups.size(); ++i)
+            detail::execute(db, "DROP TABLE IF EXISTS temp." + detail::quote(prefix + groups[i]));
+        const std::string module_name = prefix + "interop";
+        sqlite3_create_module_v2(db, module_name.c_str(), 0, 0, 0);
+    }
+
+}}}
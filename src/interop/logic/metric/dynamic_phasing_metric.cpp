@@ -7,17 +7,27 @@
  */
 #include "interop/logic/metric/dynamic_phasing_metric.h"
 #include "interop/util/map.h"
+#include "interop/util/statistics.h"
 
 namespace illumina { namespace interop { namespace logic { namespace metric
 {
-    /** Compute the linear fit online
+    /** Compute a linear fit over the points added so far
+     *
+     * The points are kept in the order they were added and reduced with util::deterministic_linear_fit_sums, so the
+     * fit does not depend on how the sums are split across threads.
      */
     class linear_fit
     {
-    public:
-        /** Constructor */
-        linear_fit() : m_sx(0), m_sy(0), m_sxy(0), m_sxx(0), m_sample_count(0){}
-
+        typedef std::pair<float, float> point_t;
+        typedef std::vector<point_t> point_vector_t;
+        struct x_of
+        {
+            float operator()(const point_t& point)const{return point.first;}
+        };
+        struct y_of
+        {
+            float operator()(const point_t& point)const{return point.second;}
+        };
     public:
         /** Add a point to the linear fit model
          *
@@ -26,11 +36,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
          */
         void add(const float x, const float y)
         {
-            m_sx += x;
-            m_sy += y;
-            m_sxy += x*y;
-            m_sxx += x*x;
-            m_sample_count++;
+            m_points.push_back(point_t(x, y));
         }
 
         /** Slope of the line
@@ -39,10 +45,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
          */
         float slope()const
         {
-            const float den = denominator();
-            if (den <= std::numeric_limits<float>::epsilon())
-                return std::numeric_limits<float>::quiet_NaN();
-            return (m_sample_count * m_sxy - m_sx * m_sy) / den;
+            return sums().slope();
         }
 
         /** Offset of the line
@@ -51,10 +54,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
          */
         float offset()const
         {
-            const float den = denominator();
-            if (den <= std::numeric_limits<float>::epsilon())
-                return std::numeric_limits<float>::quiet_NaN();
-            return (m_sy * m_sxx - m_sx * m_sxy) / den;
+            return sums().offset();
         }
         /** Get the current sample count
          *
@@ -62,21 +62,17 @@ namespace illumina { namespace interop { namespace logic { namespace metric
          */
         size_t sample_count()const
         {
-            return m_sample_count;
+            return m_points.size();
         }
 
     private:
-        float denominator()const
+        util::linear_fit_sums<float> sums()const
         {
-            return  m_sample_count * m_sxx - m_sx * m_sx;
+            return util::deterministic_linear_fit_sums<float>(m_points.begin(), m_points.end(), x_of(), y_of());
         }
 
     private:
-        float m_sx;
-        float m_sy;
-        float m_sxy;
-        float m_sxx;
-        size_t m_sample_count;
+        point_vector_t m_points;
     };
 
     /** Container for both phasing and prephasing linear fits
@@ -0,0 +1,314 @@
+/** Logic to copy the values of a metric for a whole metric set into an array
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include "interop/logic/metric/metric_array.h"
+#include "interop/logic/metric/q_metric.h"
+#include "interop/logic/summary/map_cycle_to_read.h"
+#include "interop/logic/plot/plot_metric_proxy.h"
+#include "interop/logic/utils/metric_type_ext.h"
+
+namespace illumina { namespace interop { namespace logic { namespace metric
+{
+    /** Get the cycle of a metric recorded by cycle
+     *
+     * @param metric metric record
+     * @return cycle number
+     */
+    template<class Metric>
+    ::uint32_t record_cycle(const Metric& metric, const constants::base_cycle_t*)
+    {
+        return static_cast< ::uint32_t >(metric.cycle());
+    }
+    /** Get the cycle of a metric not recorded by cycle
+     *
+     * @return 0
+     */
+    template<class Metric>
+    ::uint32_t record_cycle(const Metric&, const void*)
+    {
+        return 0;
+    }
+
+    /** Copy the values or ids of the selected records of a metric set into an array
+     *
+     * If both arrays are null, the selected records are only counted.
+     */
+    class metric_array_copier
+    {
+    public:
+        /** Constructor
+         *
+         * @param values destination array for values (may be null)
+         * @param ids destination array for lane, tile and cycle ids (may be null)
+         * @param stride number of values in each row
+         * @param offset offset of the copied value in each row
+         */
+        metric_array_copier(float* values=0, ::uint32_t* ids=0, const size_t stride=1, const size_t offset=0) :
+                m_values(values), m_ids(ids), m_stride(stride), m_offset(offset), m_count(0){}
+
+    public:
+        /** Copy the values or ids of the selected records of a metric set
+         *
+         * @param metrics set of metric records
+         * @param options filter for metric records
+         * @param proxy functor that takes a metric record and returns a metric value
+         */
+        template<typename MetricSet, typename MetricProxy>
+        void operator()(const MetricSet& metrics,
+                        const model::plot::filter_options& options,
+                        const MetricProxy& proxy)
+        {
+            typedef typename MetricSet::base_t base_t;
+            m_count = 0;
+            for(typename MetricSet::const_iterator it = metrics.begin(), end = metrics.end();it != end;++it)
+            {
+                if(!options.valid_tile_cycle(*it) || !options.valid_read(*it)) continue;
+                if(m_values != 0) m_values[m_count*m_stride+m_offset] = proxy(*it);
+                if(m_ids != 0)
+                {
+                    ::uint32_t* row = m_ids + m_count*3;
+                    row[0] = static_cast< ::uint32_t >(it->lane());
+                    row[1] = static_cast< ::uint32_t >(it->tile());
+                    row[2] = record_cycle(*it, base_t::null());
+                }
+                ++m_count;
+            }
+        }
+        /** Get the number of selected records
+         *
+         * @return number of selected records
+         */
+        size_t count()const
+        {
+            return m_count;
+        }
+
+    private:
+        float* m_values;
+        ::uint32_t* m_ids;
+        size_t m_stride;
+        size_t m_offset;
+        size_t m_count;
+    };
+
+    /** Validate the filter options and create the derived metrics required by the metric type
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     */
+    inline void prepare_metric_array(const model::metrics::run_metrics& metrics,
+                                     const constants::metric_type type,
+                                     const model::plot::filter_options& options)
+    {
+        if(type >= constants::MetricTypeCount)
+            INTEROP_THROW(model::invalid_metric_type, "Unsupported metric type: " << constants::to_string(type));
+        options.validate(type, metrics.run_info());
+        metrics.ensure_derived_metrics();
+    }
+    /** Count the records selected by the filter options
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     * @return number of selected records
+     */
+    inline size_t count_metric_array_rows(const model::metrics::run_metrics& metrics,
+                                          const constants::metric_type type,
+                                          const model::plot::filter_options& options)
+    {
+        metric_array_copier counter;
+        plot::plot_metric_proxy::select(metrics, options, type, counter);
+        return counter.count();
+    }
+
+    /** Get the number of values copied for each record
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     * @return number of values for each record
+     */
+    size_t metric_array_fanout(const model::metrics::run_metrics& metrics,
+                               const constants::metric_type type,
+                               const model::plot::filter_options& options)
+    {
+        if(options.all_channels(type)) return metrics.run_info().channels().size();
+        if(options.all_bases(type)) return static_cast<size_t>(constants::NUM_OF_BASES);
+        if(utils::is_read_metric(type) && options.all_reads()) return metrics.run_info().reads().size();
+        return 1;
+    }
+    /** Get the size of the array required to copy the values of a metric
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     * @return number of selected records times the number of values for each record
+     */
+    size_t metric_array_size(const model::metrics::run_metrics& metrics,
+                             const constants::metric_type type,
+                             const model::plot::filter_options& options)
+                            INTEROP_THROW_SPEC((model::invalid_metric_type,
+                            model::invalid_filter_option))
+    {
+        prepare_metric_array(metrics, type, options);
+        return count_metric_array_rows(metrics, type, options) * metric_array_fanout(metrics, type, options);
+    }
+    /** Copy the values of a metric for every selected record into an array
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     * @param buffer destination array
+     * @param buffer_size size of the destination array
+     * @return number of records copied
+     */
+    size_t copy_metric_values(const model::metrics::run_metrics& metrics,
+                              const constants::metric_type type,
+                              const model::plot::filter_options& options,
+                              float* buffer,
+                              size_t buffer_size)
+                            INTEROP_THROW_SPEC((model::invalid_metric_type,
+                            model::invalid_filter_option,
+                            model::invalid_parameter))
+    {
+        prepare_metric_array(metrics, type, options);
+        const size_t row_count = count_metric_array_rows(metrics, type, options);
+        const size_t fanout = metric_array_fanout(metrics, type, options);
+        if(buffer_size < row_count*fanout)
+            INTEROP_THROW(model::invalid_parameter, "Buffer size too small for metric set: "
+                    << buffer_size << " < " << row_count*fanout);
+        if(row_count == 0) return 0;
+        model::plot::filter_options updated_options(options);
+        for(size_t i=0;i<fanout;++i)
+        {
+            if(options.all_channels(type))
+                updated_options.channel(static_cast<model::plot::filter_options::channel_t>(i));
+            else if(options.all_bases(type))
+                updated_options.dna_base(static_cast<constants::dna_bases>(i));
+            else if(fanout > 1)
+                updated_options.read(static_cast<model::plot::filter_options::id_t>(metrics.run_info().reads()[i].number()));
+            metric_array_copier copier(buffer, 0, fanout, i);
+            plot::plot_metric_proxy::select(metrics, updated_options, type, copier);
+        }
+        return row_count;
+    }
+    /** Copy the values of a metric for every selected record into an array
+     *
+     * @param metrics run metrics
+     * @param metric_name name of the metric type
+     * @param options options to filter the data
+     * @param buffer destination array
+     * @param buffer_size size of the destination array
+     * @return number of records copied
+     */
+    size_t copy_metric_values(const model::metrics::run_metrics& metrics,
+                              const std::string& metric_name,
+                              const model::plot::filter_options& options,
+                              float* buffer,
+                              size_t buffer_size)
+                            INTEROP_THROW_SPEC((model::invalid_metric_type,
+                            model::invalid_filter_option,
+                            model::invalid_parameter))
+    {
+        const constants::metric_type type = constants::parse<constants::metric_type>(metric_name);
+        if(type == constants::UnknownMetricType)
+            INTEROP_THROW(model::invalid_metric_type, "Unsupported metric type: " << metric_name);
+        return copy_metric_values(metrics, type, options, buffer, buffer_size);
+    }
+    /** Copy the lane, tile and cycle of every record selected by `copy_metric_values`
+     *
+     * @param metrics run metrics
+     * @param type metric type
+     * @param options options to filter the data
+     * @param id_buffer destination array, must hold 3 ids for each selected record
+     * @param id_buffer_size size of the destination array
+     * @return number of records copied
+     */
+    size_t copy_metric_ids(const model::metrics::run_metrics& metrics,
+                           const constants::metric_type type,
+                           const model::plot::filter_options& options,
+                           ::uint32_t* id_buffer,
+                           size_t id_buffer_size)
+                            INTEROP_THROW_SPEC((model::invalid_metric_type,
+                            model::invalid_filter_option,
+                            model::invalid_parameter))
+    {
+        prepare_metric_array(metrics, type, options);
+        const size_t row_count = count_metric_array_rows(metrics, type, options);
+        if(id_buffer_size < row_count*3)
+            INTEROP_THROW(model::invalid_parameter, "Buffer size too small for metric set: "
+                    << id_buffer_size << " < " << row_count*3);
+        if(row_count == 0) return 0;
+        metric_array_copier copier(0, id_buffer);
+        plot::plot_metric_proxy::select(metrics, options, type, copier);
+        return copier.count();
+    }
+    /** Test if a q-metric record passes the tile, cycle and read filters
+     *
+     * @param metric q-metric record
+     * @param options options to filter the data
+     * @param cycle_to_read map that takes a cycle and returns the read-number cycle-in-read pair
+     * @return true if the record should be copied
+     */
+    inline bool is_selected_qscore_record(const model::metrics::q_metric& metric,
+                                          const model::plot::filter_options& options,
+                                          const summary::read_cycle_vector_t& cycle_to_read)
+    {
+        if(!options.valid_tile_cycle(metric)) return false;
+        if(options.all_reads()) return true;
+        if(metric.cycle() == 0 || metric.cycle() > cycle_to_read.size()) return false;
+        typedef model::plot::filter_options::id_t id_t;
+        return options.valid_read(static_cast<id_t>(cycle_to_read[metric.cycle()-1].number));
+    }
+    /** Copy the q-score histogram of every selected q-metric record into an array
+     *
+     * @param metrics run metrics
+     * @param options options to filter the data
+     * @param buffer destination array, must hold a value for each bin of each selected record
+     * @param buffer_size size of the destination array
+     * @return number of records copied
+     */
+    size_t copy_qscore_histograms(const model::metrics::run_metrics& metrics,
+                                  const model::plot::filter_options& options,
+                                  float* buffer,
+                                  size_t buffer_size)
+                                INTEROP_THROW_SPEC((model::invalid_parameter))
+    {
+        typedef model::metric_base::metric_set<model::metrics::q_metric> q_metric_set_t;
+        typedef q_metric_set_t::const_iterator const_iterator;
+        const q_metric_set_t& q_metrics = metrics.get<model::metrics::q_metric>();
+        if(q_metrics.empty()) return 0;
+        summary::read_cycle_vector_t cycle_to_read;
+        if(!options.all_reads())
+            summary::map_read_to_cycle_number(metrics.run_info().reads().begin(),
+                                              metrics.run_info().reads().end(),
+                                              cycle_to_read);
+        size_t bin_count = 0;
+        size_t row_count = 0;
+        for(const_iterator it = q_metrics.begin();it != q_metrics.end();++it)
+        {
+            if(!is_selected_qscore_record(*it, options, cycle_to_read)) continue;
+            if(row_count == 0) bin_count = it->size();
+            else if(it->size() != bin_count)
+                INTEROP_THROW(model::invalid_parameter, "Q-score histograms differ in bin count: "
+                        << it->size() << " != " << bin_count);
+            ++row_count;
+        }
+        if(buffer_size < row_count*bin_count)
+            INTEROP_THROW(model::invalid_parameter, "Buffer size too small for metric set: "
+                    << buffer_size << " < " << row_count*bin_count);
+        for(const_iterator it = q_metrics.begin();it != q_metrics.end();++it)
+        {
+            if(!is_selected_qscore_record(*it, options, cycle_to_read)) continue;
+            for(size_t i=0;i<bin_count;++i,++buffer)
+                *buffer = static_cast<float>(it->qscore_hist(i));
+        }
+        return row_count;
+    }
+
+}}}}
@@ -269,6 +269,65 @@ namespace illumina { namespace interop { namespace logic { namespace metric
         bylane.set_version(model::metrics::q_by_lane_metric::LATEST_VERSION);
     }
 
+    /** Generate the q-score histogram for each tile and read from Q-metrics
+     *
+     * @param metric_set Q-metrics
+     * @param cycle_to_read map that takes a cycle and returns the read-number cycle-in-read pair
+     * @param by_tile_read destination q-score histograms by tile and read
+     */
+    void create_q_metrics_by_tile_read(const model::metric_base::metric_set<model::metrics::q_metric>& metric_set,
+                                       const logic::summary::read_cycle_vector_t& cycle_to_read,
+                                       model::metric_base::metric_set<model::metrics::q_by_tile_read_metric>& by_tile_read)
+    {
+        typedef model::metric_base::metric_set<model::metrics::q_metric>::const_iterator const_iterator;
+        typedef model::metric_base::metric_set<model::metrics::q_by_tile_read_metric> by_tile_read_set_t;
+        typedef model::metrics::q_by_tile_read_metric::uint64_vector uint64_vector;
+        typedef model::metric_base::base_read_metric::id_t id_t;
+        typedef INTEROP_UNORDERED_MAP(id_t, size_t) lookup_map_t;
+        typedef lookup_map_t::const_iterator lookup_iterator;
+
+        const model::metrics::q_by_tile_read_header::qscore_bin_vector_type empty_bins;
+        // Version 0 marks the set as derived, like dynamic phasing, so it is never written to disk
+        by_tile_read = by_tile_read_set_t(
+                model::metrics::q_by_tile_read_header(is_compressed(metric_set) ? metric_set.get_bins() : empty_bins),
+                0);
+        if(metric_set.empty()) return;
+
+        lookup_map_t tile_read_map;
+        std::vector<model::metric_base::base_read_metric> keys;
+        std::vector<uint64_vector> histograms;
+        for(const_iterator beg = metric_set.begin(), end = metric_set.end();beg != end;++beg)
+        {
+            if(beg->cycle() == 0 || beg->cycle() > cycle_to_read.size()) continue;
+            const size_t read = cycle_to_read[beg->cycle()-1].number;
+            if(read == 0) continue;
+            const id_t id = model::metric_base::base_read_metric::create_id(beg->lane(), beg->tile(), read);
+            lookup_iterator it = tile_read_map.find(id);
+            size_t offset;
+            if(it == tile_read_map.end())
+            {
+                offset = histograms.size();
+                tile_read_map[id] = offset;
+                keys.push_back(model::metric_base::base_read_metric(beg->lane(), beg->tile(), read));
+                histograms.push_back(uint64_vector(beg->size(), 0));
+            }
+            else offset = it->second;
+            uint64_vector& histogram = histograms[offset];
+            if(histogram.size() < beg->size()) histogram.resize(beg->size(), 0);
+            for(size_t i=0;i<beg->size();++i)
+                histogram[i] += beg->qscore_hist()[i];
+        }
+        by_tile_read.resize(histograms.size());
+        for(size_t i=0;i<histograms.size();++i)
+        {
+            by_tile_read[i] = model::metrics::q_by_tile_read_metric(keys[i].lane(),
+                                                                    keys[i].tile(),
+                                                                    keys[i].read(),
+                                                                    histograms[i]);
+        }
+        by_tile_read.rebuild_index(true);
+    }
+
     /** Compress the q-metric set using the bins in the header
      *
      * @param q_metric_set q-metric set
@@ -283,6 +342,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
         {
             it->compress(q_metric_set);
         }
+        q_metric_set.clear_tracking();
     }
 
     /** Compress the q-metric set using the bins in the header
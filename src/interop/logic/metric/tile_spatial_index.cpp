@@ -0,0 +1,342 @@
+/** Spatial index over the physical location of tiles
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "interop/logic/metric/tile_spatial_index.h"
+
+namespace illumina { namespace interop { namespace logic { namespace metric
+{
+    /** Constructor
+     */
+    tile_spatial_index::tile_spatial_index(){}
+    /** Constructor
+     *
+     * @param locations collection of tile locations
+     */
+    tile_spatial_index::tile_spatial_index(const location_vector_t& locations)
+    {
+        build(locations);
+    }
+
+    /** Build the index over a collection of tile locations
+     *
+     * @param locations collection of tile locations
+     */
+    void tile_spatial_index::build(const location_vector_t& locations)
+    {
+        clear();
+        m_locations.reserve(locations.size());
+        ::uint32_t max_lane = 0;
+        for(location_vector_t::const_iterator it = locations.begin();it != locations.end();++it)
+        {
+            if(std::isnan(it->x()) || std::isnan(it->y())) continue;
+            m_locations.push_back(*it);
+            max_lane = std::max(max_lane, it->lane());
+        }
+        if(m_locations.empty()) return;
+
+        const float limit = std::numeric_limits<float>::max();
+        std::vector<size_t> lane_count(max_lane+1, 0);
+        std::vector<float> xmax(max_lane+1, -limit);
+        std::vector<float> ymax(max_lane+1, -limit);
+        m_grids.resize(max_lane+1);
+        for(size_t lane=0;lane<m_grids.size();++lane)
+        {
+            m_grids[lane].xmin = limit;
+            m_grids[lane].ymin = limit;
+        }
+        for(size_t i=0;i<m_locations.size();++i)
+        {
+            const tile_location& location = m_locations[i];
+            lane_grid& grid = m_grids[location.lane()];
+            ++lane_count[location.lane()];
+            grid.xmin = std::min(grid.xmin, location.x());
+            grid.ymin = std::min(grid.ymin, location.y());
+            xmax[location.lane()] = std::max(xmax[location.lane()], location.x());
+            ymax[location.lane()] = std::max(ymax[location.lane()], location.y());
+        }
+        for(size_t lane=0;lane<m_grids.size();++lane)
+        {
+            lane_grid& grid = m_grids[lane];
+            if(lane_count[lane] == 0) continue;
+            const float width = xmax[lane] - grid.xmin;
+            const float height = ymax[lane] - grid.ymin;
+            // Size the cells to hold about one tile each
+            const float count = static_cast<float>(lane_count[lane]);
+            float cell_size = std::sqrt(width * height / count);
+            if(!(cell_size > 0)) cell_size = std::max(width, height) / count;
+            if(!(cell_size > 0)) cell_size = 1;
+            // Tiles packed along a line would otherwise spread over many empty cells
+            while((width / cell_size + 1) * (height / cell_size + 1) > 4 * count + 4) cell_size *= 2;
+            grid.cell_size = cell_size;
+            grid.column_count = static_cast<size_t>(width / cell_size) + 1;
+            grid.row_count = static_cast<size_t>(height / cell_size) + 1;
+            grid.cell_start.assign(grid.column_count*grid.row_count+1, 0);
+            grid.entries.resize(lane_count[lane]);
+        }
+        // Counting sort of the tiles by cell
+        for(size_t i=0;i<m_locations.size();++i)
+        {
+            const lane_grid& grid = m_grids[m_locations[i].lane()];
+            const size_t cell = grid.row(m_locations[i].y())*grid.column_count + grid.column(m_locations[i].x());
+            ++m_grids[m_locations[i].lane()].cell_start[cell+1];
+        }
+        for(size_t lane=0;lane<m_grids.size();++lane)
+        {
+            std::vector<size_t>& cell_start = m_grids[lane].cell_start;
+            for(size_t cell=1;cell<cell_start.size();++cell) cell_start[cell] += cell_start[cell-1];
+        }
+        std::vector< std::vector<size_t> > next(m_grids.size());
+        for(size_t lane=0;lane<m_grids.size();++lane) next[lane] = m_grids[lane].cell_start;
+        for(size_t i=0;i<m_locations.size();++i)
+        {
+            lane_grid& grid = m_grids[m_locations[i].lane()];
+            const size_t cell = grid.row(m_locations[i].y())*grid.column_count + grid.column(m_locations[i].x());
+            grid.entries[next[m_locations[i].lane()][cell]++] = i;
+        }
+
+        m_keys.resize(m_locations.size());
+        for(size_t i=0;i<m_locations.size();++i)
+            m_keys[i] = key_index_t(model::metric_base::base_metric::create_id(m_locations[i].lane(),
+                                                                                m_locations[i].tile()), i);
+        std::sort(m_keys.begin(), m_keys.end());
+    }
+    /** Remove all tiles from the index
+     */
+    void tile_spatial_index::clear()
+    {
+        m_locations.clear();
+        m_grids.clear();
+        m_keys.clear();
+    }
+
+    /** Find the tile nearest to a point in a lane
+     *
+     * The cells are visited in rings of increasing distance around the cell holding the point. The search stops
+     * once the nearest tile found is closer than any tile in the next ring could be.
+     *
+     * @param lane lane number
+     * @param x horizontal coordinate of the point
+     * @param y vertical coordinate of the point
+     * @param tile destination for the nearest tile id
+     * @return false if the lane has no tiles
+     */
+    bool tile_spatial_index::nearest(const ::uint32_t lane, const float x, const float y, ::uint32_t& tile)const
+    {
+        const lane_grid* grid = this->grid(lane);
+        if(grid == 0) return false;
+        const long column = static_cast<long>(grid->column(x));
+        const long row = static_cast<long>(grid->row(y));
+        const long ring_count = static_cast<long>(std::max(grid->column_count, grid->row_count));
+        float best = std::numeric_limits<float>::max();
+        size_t best_index = m_locations.size();
+        for(long ring=0;ring<ring_count;++ring)
+        {
+            for(long r=row-ring;r<=row+ring;++r)
+            {
+                if(r < 0 || r >= static_cast<long>(grid->row_count)) continue;
+                const bool edge_row = (r == row-ring || r == row+ring);
+                for(long c=column-ring;c<=column+ring;c += (edge_row ? 1 : 2*ring))
+                {
+                    if(c >= 0 && c < static_cast<long>(grid->column_count))
+                    {
+                        const size_t cell = static_cast<size_t>(r)*grid->column_count + static_cast<size_t>(c);
+                        for(size_t e=grid->cell_start[cell];e<grid->cell_start[cell+1];++e)
+                        {
+                            const tile_location& location = m_locations[grid->entries[e]];
+                            const float dx = location.x() - x;
+                            const float dy = location.y() - y;
+                            const float distance = dx*dx + dy*dy;
+                            if(distance < best || (distance == best && grid->entries[e] < best_index))
+                            {
+                                best = distance;
+                                best_index = grid->entries[e];
+                            }
+                        }
+                    }
+                    if(ring == 0) break;
+                }
+            }
+            // Any tile in the next ring is at least this far from the point
+            const float bound = static_cast<float>(ring) * grid->cell_size;
+            if(best_index < m_locations.size() && best <= bound*bound) break;
+        }
+        if(best_index == m_locations.size()) return false;
+        tile = m_locations[best_index].tile();
+        return true;
+    }
+    /** Find all tiles in a lane within a distance of a point
+     *
+     * @param lane lane number
+     * @param x horizontal coordinate of the point
+     * @param y vertical coordinate of the point
+     * @param radius maximum distance from the point
+     * @param tiles destination for the tile ids
+     */
+    void tile_spatial_index::within_radius(const ::uint32_t lane,
+                                           const float x,
+                                           const float y,
+                                           const float radius,
+                                           id_vector_t& tiles)const
+    {
+        tiles.clear();
+        const lane_grid* grid = this->grid(lane);
+        if(grid == 0 || radius < 0) return;
+        collect(*grid, x-radius, y-radius, x+radius, y+radius, x, y, radius*radius, tiles);
+    }
+    /** Find all tiles in a lane within a rectangular window
+     *
+     * @param lane lane number
+     * @param xmin minimum horizontal coordinate of the window
+     * @param ymin minimum vertical coordinate of the window
+     * @param xmax maximum horizontal coordinate of the window
+     * @param ymax maximum vertical coordinate of the window
+     * @param tiles destination for the tile ids
+     */
+    void tile_spatial_index::within_window(const ::uint32_t lane,
+                                           const float xmin,
+                                           const float ymin,
+                                           const float xmax,
+                                           const float ymax,
+                                           id_vector_t& tiles)const
+    {
+        tiles.clear();
+        const lane_grid* grid = this->grid(lane);
+        if(grid == 0) return;
+        collect(*grid, xmin, ymin, xmax, ymax, 0, 0, -1, tiles);
+    }
+    /** Find the tiles in the same lane within a distance of a tile, not including the tile itself
+     *
+     * @param lane lane number
+     * @param tile tile id
+     * @param radius maximum distance from the tile
+     * @param tiles destination for the tile ids
+     * @return false if the tile is not indexed
+     */
+    bool tile_spatial_index::neighbors(const ::uint32_t lane,
+                                       const ::uint32_t tile,
+                                       const float radius,
+                                       id_vector_t& tiles)const
+    {
+        const tile_location* location = find(lane, tile);
+        if(location == 0)
+        {
+            tiles.clear();
+            return false;
+        }
+        within_radius(lane, location->x(), location->y(), radius, tiles);
+        tiles.erase(std::remove(tiles.begin(), tiles.end(), tile), tiles.end());
+        return true;
+    }
+    /** Find the location of a tile
+     *
+     * @param lane lane number
+     * @param tile tile id
+     * @return location of the tile or null if the tile is not indexed
+     */
+    const tile_location* tile_spatial_index::find(const ::uint32_t lane, const ::uint32_t tile)const
+    {
+        const key_index_t key(model::metric_base::base_metric::create_id(lane, tile), 0);
+        key_index_vector_t::const_iterator it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+        if(it == m_keys.end() || it->first != key.first) return 0;
+        return &m_locations[it->second];
+    }
+
+    /** Get the grid of a lane
+     *
+     * @param lane lane number
+     * @return grid of the lane or null if the lane has no tiles
+     */
+    const tile_spatial_index::lane_grid* tile_spatial_index::grid(const ::uint32_t lane)const
+    {
+        if(lane >= m_grids.size() || m_grids[lane].entries.empty()) return 0;
+        return &m_grids[lane];
+    }
+    /** Collect the tiles in the cells overlapping a window
+     *
+     * @param grid grid of the lane
+     * @param xmin minimum horizontal coordinate of the window
+     * @param ymin minimum vertical coordinate of the window
+     * @param xmax maximum horizontal coordinate of the window
+     * @param ymax maximum vertical coordinate of the window
+     * @param x horizontal coordinate of the center of a radius query
+     * @param y vertical coordinate of the center of a radius query
+     * @param radius2 squared radius, or negative for a window query
+     * @param tiles destination for the tile ids
+     */
+    void tile_spatial_index::collect(const lane_grid& grid,
+                                     const float xmin,
+                                     const float ymin,
+                                     const float xmax,
+                                     const float ymax,
+                                     const float x,
+                                     const float y,
+                                     const float radius2,
+                                     id_vector_t& tiles)const
+    {
+        if(xmax < xmin || ymax < ymin) return;
+        const size_t column_end = grid.column(xmax)+1;
+        const size_t row_end = grid.row(ymax)+1;
+        for(size_t r=grid.row(ymin);r<row_end;++r)
+        {
+            for(size_t c=grid.column(xmin);c<column_end;++c)
+            {
+                const size_t cell = r*grid.column_count + c;
+                for(size_t e=grid.cell_start[cell];e<grid.cell_start[cell+1];++e)
+                {
+                    const tile_location& location = m_locations[grid.entries[e]];
+                    if(location.x() < xmin || location.x() > xmax || location.y() < ymin || location.y() > ymax)
+                        continue;
+                    if(radius2 >= 0)
+                    {
+                        const float dx = location.x() - x;
+                        const float dy = location.y() - y;
+                        if(dx*dx + dy*dy > radius2) continue;
+                    }
+                    tiles.push_back(location.tile());
+                }
+            }
+        }
+    }
+
+    /** List the location of every tile in the layout by its column and row in the flowcell map
+     *
+     * @param layout flowcell layout with a list of tile names
+     * @param locations destination collection of tile locations
+     */
+    void list_tile_locations(const model::run::flowcell_layout& layout,
+                             tile_spatial_index::location_vector_t& locations)
+    {
+        locations.clear();
+        locations.reserve(layout.tiles().size());
+        for(size_t i=0;i<layout.tiles().size();++i)
+        {
+            const ::uint32_t tile = tile_from_name(layout.tiles()[i]);
+            locations.push_back(tile_location(lane_from_name(layout.tiles()[i]),
+                                              tile,
+                                              static_cast<float>(physical_location_column(tile, layout, true)),
+                                              static_cast<float>(physical_location_row(tile, layout))));
+        }
+    }
+    /** List the location of every tile in the extended tile metrics by its upper left fiducial
+     *
+     * @param metrics extended tile metric set
+     * @param locations destination collection of tile locations
+     */
+    void list_tile_locations(const model::metric_base::metric_set<model::metrics::extended_tile_metric>& metrics,
+                             tile_spatial_index::location_vector_t& locations)
+    {
+        typedef model::metric_base::metric_set<model::metrics::extended_tile_metric>::const_iterator const_iterator;
+        locations.clear();
+        locations.reserve(metrics.size());
+        for(const_iterator it = metrics.begin();it != metrics.end();++it)
+            locations.push_back(tile_location(it->lane(), it->tile(), it->upper_left().x(), it->upper_left().y()));
+    }
+
+}}}}
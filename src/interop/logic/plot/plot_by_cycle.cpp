@@ -115,9 +115,13 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         /** Constructor
          *
          * @param points reference to collection of points
+         * @param tile_by_cycle scratch buffer for the values of each tile grouped by cycle
+         * @param outliers scratch buffer for outlier values
          */
-        by_cycle_candle_stick_plot(model::plot::data_point_collection<Point>&  points) :
-            m_points(points), m_max_cycle(0), m_empty(true){}
+        by_cycle_candle_stick_plot(model::plot::data_point_collection<Point>&  points,
+                                   utils::workspace::float_vector2d_t& tile_by_cycle,
+                                   utils::workspace::float_vector_t& outliers) :
+            m_points(points), m_tile_by_cycle(tile_by_cycle), m_outliers(outliers), m_max_cycle(0), m_empty(true){}
 
 
         /** Plot the candle stick over all tiles of a specific metric by cycle
@@ -166,9 +170,16 @@ namespace illumina { namespace interop { namespace logic { namespace plot
             m_max_cycle= metrics.max_cycle();
             m_empty = metrics.empty();
             const size_t tile_count = static_cast<size_t>(std::ceil(static_cast<float>(metrics.size())/m_max_cycle));
-            std::vector< std::vector<float> > tile_by_cycle(m_max_cycle);
-            for(size_t i=0;i<m_max_cycle;++i) tile_by_cycle[i].reserve(tile_count);
-            std::vector<float> outliers;
+            utils::workspace::float_vector2d_t& tile_by_cycle = m_tile_by_cycle;
+            // Never shrink the outer vector, so the capacity of each cycle is kept for the next call
+            if(tile_by_cycle.size() < m_max_cycle) tile_by_cycle.resize(m_max_cycle);
+            for(size_t i=0;i<m_max_cycle;++i)
+            {
+                tile_by_cycle[i].clear();
+                tile_by_cycle[i].reserve(tile_count);
+            }
+            std::vector<float>& outliers = m_outliers;
+            outliers.clear();
             outliers.reserve(10); // TODO: use as flag for keeping outliers
 
             for(typename MetricSet::const_iterator b = metrics.begin(), e = metrics.end();b != e;++b)
@@ -199,6 +210,8 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                   const void*){}
     private:
         model::plot::data_point_collection<Point>& m_points;
+        utils::workspace::float_vector2d_t& m_tile_by_cycle;
+        utils::workspace::float_vector_t& m_outliers;
         size_t m_max_cycle;
         bool m_empty;
     };
@@ -249,15 +262,18 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param type specific metric value to plot by cycle
      * @param options options to filter the data
      * @param data output plot data
+     * @param workspace scratch buffers reused across calls
      * @param skip_empty set false for testing purposes
      */
     template<class Point>
-    void plot_by_cycle_t(model::metrics::run_metrics& metrics,
+    void plot_by_cycle_t(const model::metrics::run_metrics& metrics,
                        const constants::metric_type type,
                        const model::plot::filter_options& options,
                        model::plot::plot_data<Point>& data,
+                         utils::workspace& workspace,
                          const bool skip_empty)
     {
+        utils::workspace::call_scope scope(workspace);
         data.clear();
         if(skip_empty && metrics.empty()) return;
         if(!options.all_cycles())
@@ -270,12 +286,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         size_t max_cycle=0;
         bool is_empty = true;
 
-        if(logic::utils::to_group(type) == constants::Q)
-        {
-            if(0 == metrics.get<model::metrics::q_collapsed_metric>().size())
-                logic::metric::create_collapse_q_metrics(metrics.get<model::metrics::q_metric>(),
-                                                         metrics.get<model::metrics::q_collapsed_metric>());
-        }
+        metrics.ensure_derived_metrics();
         if(options.all_channels(type))
         {
             setup_series_by_channel(metrics.run_info().channels(), data);
@@ -305,7 +316,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         else
         {
             data.assign(1, model::plot::series<Point>());
-            by_cycle_candle_stick_plot<Point> plot(data[0]);
+            by_cycle_candle_stick_plot<Point> plot(data[0], workspace.values_by_cycle(), workspace.outliers());
             plot_metric_proxy::select(metrics, options, type, plot);
             max_cycle = plot.max_cycle();
             is_empty = plot.empty();
@@ -353,19 +364,21 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param metric_name name of metric value to plot by cycle
      * @param options options to filter the data
      * @param data output plot data
+     * @param workspace scratch buffers reused across calls
      * @param skip_empty set false for testing purposes
      */
     template<class Point>
-    void plot_by_cycle_t(model::metrics::run_metrics& metrics,
+    void plot_by_cycle_t(const model::metrics::run_metrics& metrics,
                          const std::string& metric_name,
                          const model::plot::filter_options& options,
                          model::plot::plot_data<Point>& data,
+                         utils::workspace& workspace,
                          const bool skip_empty)
     {
         const constants::metric_type type = constants::parse<constants::metric_type>(metric_name);
         if(type == constants::UnknownMetricType)
             INTEROP_THROW(model::invalid_metric_type, "Unsupported metric type: " << metric_name);
-        plot_by_cycle_t(metrics, type, options, data, skip_empty);
+        plot_by_cycle_t(metrics, type, options, data, workspace, skip_empty);
     }
 
     /** Plot a specified metric value by cycle
@@ -377,7 +390,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     * @param data output plot data
     * @param skip_empty set false for testing purposes
     */
-    void plot_by_cycle(model::metrics::run_metrics& metrics,
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
                        const constants::metric_type type,
                        const model::plot::filter_options& options,
                        model::plot::plot_data<model::plot::candle_stick_point>& data,
@@ -388,7 +401,32 @@ namespace illumina { namespace interop { namespace logic { namespace plot
             model::invalid_filter_option,
             model::invalid_read_exception))
     {
-        plot_by_cycle_t(metrics, type, options, data, skip_empty);
+        utils::workspace workspace;
+        plot_by_cycle_t(metrics, type, options, data, workspace, skip_empty);
+    }
+    /** Plot a specified metric value by cycle reusing the scratch buffers in a workspace
+    *
+    * @ingroup plot_logic
+    * @param metrics run metrics
+    * @param type specific metric value to plot by cycle
+    * @param options options to filter the data
+    * @param data output plot data
+    * @param workspace scratch buffers reused across calls
+    * @param skip_empty set false for testing purposes
+    */
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
+                       const constants::metric_type type,
+                       const model::plot::filter_options& options,
+                       model::plot::plot_data<model::plot::candle_stick_point>& data,
+                       utils::workspace& workspace,
+                       const bool skip_empty)
+            INTEROP_THROW_SPEC((model::index_out_of_bounds_exception,
+            model::invalid_metric_type,
+            model::invalid_channel_exception,
+            model::invalid_filter_option,
+            model::invalid_read_exception))
+    {
+        plot_by_cycle_t(metrics, type, options, data, workspace, skip_empty);
     }
 
     /** Plot a specified metric value by cycle using the candle stick model
@@ -401,17 +439,41 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param data output plot data
      * @param skip_empty set false for testing purposes
      */
-    void plot_by_cycle(model::metrics::run_metrics& metrics,
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
+                       const std::string& metric_name,
+                       const model::plot::filter_options& options,
+                       model::plot::plot_data<model::plot::candle_stick_point>& data,
+                       const bool skip_empty)
+            INTEROP_THROW_SPEC((model::index_out_of_bounds_exception,
+            model::invalid_filter_option,
+            model::invalid_channel_exception,
+            model::invalid_metric_type))
+    {
+        utils::workspace workspace;
+        plot_by_cycle_t(metrics, metric_name, options, data, workspace, skip_empty);
+    }
+    /** Plot a specified metric value by cycle using the candle stick model reusing the scratch buffers in a workspace
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param metric_name name of metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data
+     * @param workspace scratch buffers reused across calls
+     * @param skip_empty set false for testing purposes
+     */
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
                        const std::string& metric_name,
                        const model::plot::filter_options& options,
                        model::plot::plot_data<model::plot::candle_stick_point>& data,
+                       utils::workspace& workspace,
                        const bool skip_empty)
             INTEROP_THROW_SPEC((model::index_out_of_bounds_exception,
             model::invalid_filter_option,
             model::invalid_channel_exception,
             model::invalid_metric_type))
     {
-        plot_by_cycle_t(metrics, metric_name, options, data, skip_empty);
+        plot_by_cycle_t(metrics, metric_name, options, data, workspace, skip_empty);
     }
 
     /** List metric types available for by cycle plots
@@ -88,7 +88,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param tile_buffer preallocated memory for tile ids
      * @param skip_empty set false for testing purposes
      */
-    void plot_flowcell_map(model::metrics::run_metrics &metrics,
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
                            const constants::metric_type type,
                            const model::plot::filter_options &options,
                            model::plot::flowcell_data &data,
@@ -99,6 +99,35 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     model::invalid_metric_type,
     model::index_out_of_bounds_exception))
     {
+        utils::workspace workspace;
+        plot_flowcell_map(metrics, type, options, data, workspace, buffer, tile_buffer, skip_empty);
+    }
+
+    /** Plot a flowcell map reusing the scratch buffers in a workspace
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output flowcell map
+     * @param workspace scratch buffers reused across calls
+     * @param buffer preallocated memory for data
+     * @param tile_buffer preallocated memory for tile ids
+     * @param skip_empty set false for testing purposes
+     */
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
+                           const constants::metric_type type,
+                           const model::plot::filter_options &options,
+                           model::plot::flowcell_data &data,
+                           utils::workspace& workspace,
+                           float *buffer,
+                           ::uint32_t *tile_buffer,
+                           const bool skip_empty)
+    INTEROP_THROW_SPEC((model::invalid_filter_option,
+    model::invalid_metric_type,
+    model::index_out_of_bounds_exception))
+    {
+        utils::workspace::call_scope scope(workspace);
         data.clear();
         if (skip_empty && metrics.empty()) return;
         options.validate(type, metrics.run_info());
@@ -119,7 +148,8 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                             layout.total_swaths(layout.surface_count() > 1 && !options.is_specific_surface()),
                             layout.tiles_per_lane());
         }
-        std::vector<float> values_for_scaling;
+        std::vector<float>& values_for_scaling = workspace.values();
+        values_for_scaling.clear();
         values_for_scaling.reserve(data.length());
 
 
@@ -133,12 +163,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         if (options.all_bases(type))
             INTEROP_THROW(model::invalid_filter_option, "All bases is unsupported");
 
-        if(logic::utils::to_group(type) == constants::Q)
-        {
-            if(0 == metrics.get<model::metrics::q_collapsed_metric>().size())
-                logic::metric::create_collapse_q_metrics(metrics.get<model::metrics::q_metric>(),
-                                                         metrics.get<model::metrics::q_collapsed_metric>());
-        }
+        metrics.ensure_derived_metrics();
         flowcell_plot plot(data, values_for_scaling, layout);
         plot_metric_proxy::select(metrics, options, type, plot);
         const bool is_empty = plot.empty();
@@ -194,7 +219,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param tile_buffer preallocated memory for tile ids
      * @param skip_empty set false for testing purposes
      */
-    void plot_flowcell_map(model::metrics::run_metrics &metrics,
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
                            const std::string &metric_name,
                            const model::plot::filter_options &options,
                            model::plot::flowcell_data &data,
@@ -210,6 +235,35 @@ namespace illumina { namespace interop { namespace logic { namespace plot
             INTEROP_THROW(model::invalid_metric_type, "Unsupported metric type: " << metric_name);
         plot_flowcell_map(metrics, type, options, data, buffer, tile_buffer, skip_empty);
     }
+    /** Plot a flowcell map reusing the scratch buffers in a workspace
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param metric_name specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output flowcell map
+     * @param workspace scratch buffers reused across calls
+     * @param buffer preallocated memory for data
+     * @param tile_buffer preallocated memory for tile ids
+     * @param skip_empty set false for testing purposes
+     */
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
+                           const std::string &metric_name,
+                           const model::plot::filter_options &options,
+                           model::plot::flowcell_data &data,
+                           utils::workspace& workspace,
+                           float *buffer,
+                           ::uint32_t *tile_buffer,
+                           const bool skip_empty)
+    INTEROP_THROW_SPEC((model::invalid_filter_option,
+    model::invalid_metric_type,
+    model::index_out_of_bounds_exception))
+    {
+        const constants::metric_type type = constants::parse<constants::metric_type>(metric_name);
+        if (type == constants::UnknownMetricType)
+            INTEROP_THROW(model::invalid_metric_type, "Unsupported metric type: " << metric_name);
+        plot_flowcell_map(metrics, type, options, data, workspace, buffer, tile_buffer, skip_empty);
+    }
 
     /** List metric type names available for flowcell
      *
@@ -0,0 +1,622 @@
+/** Plot a metric for many runs on the same chart
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <limits>
+#include "interop/logic/plot/plot_overlay.h"
+#include "interop/logic/plot/plot_by_cycle.h"
+#include "interop/logic/plot/plot_qscore_histogram.h"
+#include "interop/logic/plot/plot_data.h"
+#include "interop/logic/utils/metrics_to_load.h"
+#include "interop/logic/utils/workspace.h"
+#include "interop/util/lexical_cast.h"
+#include "interop/util/xml_exceptions.h"
+#include "interop/io/stream_exceptions.h"
+#include "interop/model/plot/plot_exceptions.h"
+#include "interop/model/run/run_exceptions.h"
+
+namespace illumina { namespace interop { namespace logic { namespace plot
+{
+    /** Plot a single run by cycle */
+    class by_cycle_overlay_plot
+    {
+    public:
+        /** Define the point type */
+        typedef model::plot::candle_stick_point point_t;
+
+    public:
+        /** Constructor
+         *
+         * @param type specific metric value to plot by cycle
+         * @param options options to filter the data
+         */
+        by_cycle_overlay_plot(const constants::metric_type type, const model::plot::filter_options& options) :
+                m_type(type), m_options(options){}
+
+    public:
+        /** Plot a single run by cycle
+         *
+         * @param metrics run metrics
+         * @param data output plot data
+         * @param workspace scratch buffers reused across runs
+         */
+        void operator()(const model::metrics::run_metrics& metrics,
+                        model::plot::plot_data<point_t>& data,
+                        utils::workspace& workspace)const
+        {
+            plot_by_cycle(metrics, m_type, m_options, data, workspace);
+        }
+        /** List the metric groups required by the plot
+         *
+         * @param valid_to_load list of metrics to load on demand
+         */
+        void list_metrics_to_load(std::vector<unsigned char>& valid_to_load)const
+        {
+            utils::list_metrics_to_load(m_type, valid_to_load);
+        }
+        /** Test if the series of each run should be drawn as lines
+         *
+         * @return false, candle sticks are kept
+         */
+        bool as_lines()const
+        {
+            return false;
+        }
+
+    private:
+        constants::metric_type m_type;
+        const model::plot::filter_options& m_options;
+    };
+
+    /** Plot the q-score histogram of a single run */
+    class qscore_histogram_overlay_plot
+    {
+    public:
+        /** Define the point type */
+        typedef model::plot::bar_point point_t;
+
+    public:
+        /** Constructor
+         *
+         * @param options options to filter the data
+         */
+        qscore_histogram_overlay_plot(const model::plot::filter_options& options) : m_options(options){}
+
+    public:
+        /** Plot the q-score histogram of a single run
+         *
+         * @param metrics run metrics
+         * @param data output plot data
+         */
+        void operator()(const model::metrics::run_metrics& metrics,
+                        model::plot::plot_data<point_t>& data,
+                        utils::workspace&)const
+        {
+            plot_qscore_histogram(metrics, m_options, data);
+        }
+        /** List the metric groups required by the plot
+         *
+         * @param valid_to_load list of metrics to load on demand
+         */
+        void list_metrics_to_load(std::vector<unsigned char>& valid_to_load)const
+        {
+            utils::list_metrics_to_load(constants::Q, valid_to_load);
+        }
+        /** Test if the series of each run should be drawn as lines
+         *
+         * @return true, overlaid bars would hide each other
+         */
+        bool as_lines()const
+        {
+            return true;
+        }
+
+    private:
+        const model::plot::filter_options& m_options;
+    };
+
+    /** Plot runs that are already loaded */
+    template<class Plot>
+    class loaded_run_overlay
+    {
+    public:
+        /** Constructor
+         *
+         * @param runs collection of loaded runs
+         * @param plot functor that plots a single run
+         */
+        loaded_run_overlay(const std::vector<model::metrics::run_metrics*>& runs, const Plot& plot) :
+                m_runs(runs), m_plot(plot){}
+
+    public:
+        /** Plot a single run
+         *
+         * @param index index of the run
+         * @param data output plot data
+         * @param workspace scratch buffers reused across runs
+         * @param label destination for the run label
+         * @param barcode destination for the flowcell barcode
+         */
+        void operator()(const size_t index,
+                        model::plot::plot_data<typename Plot::point_t>& data,
+                        utils::workspace& workspace,
+                        std::string& label,
+                        std::string& barcode)const
+        {
+            const model::metrics::run_metrics& metrics = *m_runs[index];
+            label = metrics.run_info().name();
+            barcode = metrics.run_info().flowcell().barcode();
+            m_plot(metrics, data, workspace);
+        }
+        /** Get the number of runs
+         *
+         * @return number of runs
+         */
+        size_t size()const
+        {
+            return m_runs.size();
+        }
+        /** Get the index of the first occurrence of the same run
+         *
+         * @param index index of the run
+         * @return index of the first occurrence of the run
+         */
+        size_t source(const size_t index)const
+        {
+            for(size_t i=0;i<index;++i)
+                if(m_runs[i] == m_runs[index]) return i;
+            return index;
+        }
+
+    private:
+        const std::vector<model::metrics::run_metrics*>& m_runs;
+        const Plot& m_plot;
+    };
+
+    /** Load and plot runs from their run folders */
+    template<class Plot>
+    class run_folder_overlay
+    {
+    public:
+        /** Constructor
+         *
+         * @param run_folders collection of run folder paths
+         * @param plot functor that plots a single run
+         */
+        run_folder_overlay(const std::vector<std::string>& run_folders, const Plot& plot) :
+                m_run_folders(run_folders), m_plot(plot)
+        {
+            plot.list_metrics_to_load(m_valid_to_load);
+        }
+
+    public:
+        /** Load only the metrics required by the plot, then plot the run
+         *
+         * @param index index of the run
+         * @param data output plot data
+         * @param workspace scratch buffers reused across runs
+         * @param label destination for the run label
+         * @param barcode destination for the flowcell barcode
+         */
+        void operator()(const size_t index,
+                        model::plot::plot_data<typename Plot::point_t>& data,
+                        utils::workspace& workspace,
+                        std::string& label,
+                        std::string& barcode)const
+        {
+            model::metrics::run_metrics metrics;
+            metrics.read(m_run_folders[index], m_valid_to_load);
+            label = metrics.run_info().name();
+            if(label == "") label = m_run_folders[index];
+            barcode = metrics.run_info().flowcell().barcode();
+            m_plot(metrics, data, workspace);
+        }
+        /** Get the number of runs
+         *
+         * @return number of runs
+         */
+        size_t size()const
+        {
+            return m_run_folders.size();
+        }
+        /** Get the index of the first occurrence of the same run folder
+         *
+         * @param index index of the run
+         * @return index of the first occurrence of the run folder
+         */
+        size_t source(const size_t index)const
+        {
+            for(size_t i=0;i<index;++i)
+                if(m_run_folders[i] == m_run_folders[index]) return i;
+            return index;
+        }
+
+    private:
+        const std::vector<std::string>& m_run_folders;
+        const Plot& m_plot;
+        std::vector<unsigned char> m_valid_to_load;
+    };
+
+    /** Exception thrown while plotting a single run
+     *
+     * The library does not rely on C++11, so an exception cannot be carried out of a parallel region as is. Instead,
+     * the type and message of each exception the overlay may throw are captured, and the same type is thrown again
+     * after the parallel region.
+     */
+    class overlay_error
+    {
+        enum error_t
+        {
+            NoError,
+            XmlFileNotFound,
+            BadXmlFormat,
+            EmptyXmlFormat,
+            MissingXmlElement,
+            XmlParse,
+            FileNotFound,
+            BadFormat,
+            IncompleteFile,
+            InvalidRunInfo,
+            IndexOutOfBounds,
+            InvalidMetricType,
+            InvalidChannel,
+            InvalidFilterOption,
+            InvalidRead,
+            InvalidParameter
+        };
+    public:
+        /** Constructor */
+        overlay_error() : m_error(NoError){}
+    public:
+        /** Plot a single run and capture any exception it throws
+         *
+         * @param overlay source of the runs to plot
+         * @param index index of the run
+         * @param data output plot data
+         * @param workspace scratch buffers reused across runs
+         * @param label destination for the run label
+         * @param barcode destination for the flowcell barcode
+         */
+        template<class Overlay, class Point>
+        void run(const Overlay& overlay,
+                 const size_t index,
+                 model::plot::plot_data<Point>& data,
+                 utils::workspace& workspace,
+                 std::string& label,
+                 std::string& barcode)
+        {
+            try
+            {
+                overlay(index, data, workspace, label, barcode);
+            }
+            catch(const xml::xml_file_not_found_exception& ex){set(XmlFileNotFound, ex);}
+            catch(const xml::bad_xml_format_exception& ex){set(BadXmlFormat, ex);}
+            catch(const xml::empty_xml_format_exception& ex){set(EmptyXmlFormat, ex);}
+            catch(const xml::missing_xml_element_exception& ex){set(MissingXmlElement, ex);}
+            catch(const xml::xml_parse_exception& ex){set(XmlParse, ex);}
+            catch(const io::file_not_found_exception& ex){set(FileNotFound, ex);}
+            catch(const io::bad_format_exception& ex){set(BadFormat, ex);}
+            catch(const io::incomplete_file_exception& ex){set(IncompleteFile, ex);}
+            catch(const model::invalid_run_info_exception& ex){set(InvalidRunInfo, ex);}
+            catch(const model::index_out_of_bounds_exception& ex){set(IndexOutOfBounds, ex);}
+            catch(const model::invalid_metric_type& ex){set(InvalidMetricType, ex);}
+            catch(const model::invalid_channel_exception& ex){set(InvalidChannel, ex);}
+            catch(const model::invalid_filter_option& ex){set(InvalidFilterOption, ex);}
+            catch(const model::invalid_read_exception& ex){set(InvalidRead, ex);}
+            catch(const std::exception& ex){set(InvalidParameter, ex);}
+        }
+        /** Test if the run failed
+         *
+         * @return true if an exception was captured
+         */
+        bool failed()const
+        {
+            return m_error != NoError;
+        }
+        /** Throw the captured exception again with its original type
+         *
+         * Exceptions of any other type are thrown as invalid_parameter.
+         */
+        void rethrow()const
+        {
+            switch(m_error)
+            {
+                case NoError: return;
+                case XmlFileNotFound: INTEROP_THROW(xml::xml_file_not_found_exception, m_message);
+                case BadXmlFormat: INTEROP_THROW(xml::bad_xml_format_exception, m_message);
+                case EmptyXmlFormat: INTEROP_THROW(xml::empty_xml_format_exception, m_message);
+                case MissingXmlElement: INTEROP_THROW(xml::missing_xml_element_exception, m_message);
+                case XmlParse: INTEROP_THROW(xml::xml_parse_exception, m_message);
+                case FileNotFound: INTEROP_THROW(io::file_not_found_exception, m_message);
+                case BadFormat: INTEROP_THROW(io::bad_format_exception, m_message);
+                case IncompleteFile: INTEROP_THROW(io::incomplete_file_exception, m_message);
+                case InvalidRunInfo: INTEROP_THROW(model::invalid_run_info_exception, m_message);
+                case IndexOutOfBounds: INTEROP_THROW(model::index_out_of_bounds_exception, m_message);
+                case InvalidMetricType: INTEROP_THROW(model::invalid_metric_type, m_message);
+                case InvalidChannel: INTEROP_THROW(model::invalid_channel_exception, m_message);
+                case InvalidFilterOption: INTEROP_THROW(model::invalid_filter_option, m_message);
+                case InvalidRead: INTEROP_THROW(model::invalid_read_exception, m_message);
+                default: INTEROP_THROW(model::invalid_parameter, m_message);
+            }
+        }
+    private:
+        void set(const error_t error, const std::exception& ex)
+        {
+            m_error = error;
+            m_message = ex.what();
+        }
+    private:
+        error_t m_error;
+        std::string m_message;
+    };
+    /** Rescale q-score histograms reported in millions when any run is reported in billions
+     *
+     * @param run_data plot data for each run
+     */
+    inline void share_histogram_scale(std::vector< model::plot::plot_data<model::plot::bar_point> >& run_data)
+    {
+        const std::string billion = "Total (billion)";
+        bool has_billion = false;
+        for(size_t i=0;i<run_data.size();++i)
+            if(run_data[i].size() > 0 && run_data[i].y_axis().label() == billion) has_billion = true;
+        if(!has_billion) return;
+        for(size_t i=0;i<run_data.size();++i)
+        {
+            if(run_data[i].size() == 0 || run_data[i].y_axis().label() == billion) continue;
+            for(size_t s=0;s<run_data[i].size();++s)
+            {
+                for(size_t p=0;p<run_data[i][s].size();++p)
+                {
+                    model::plot::bar_point& point = run_data[i][s][p];
+                    point.set(point.x(), point.y()/1000, point.width());
+                }
+            }
+            run_data[i].set_yrange(run_data[i].y_axis().min()/1000, run_data[i].y_axis().max()/1000);
+            run_data[i].set_ylabel(billion);
+        }
+    }
+    /** Share the histogram scale, nothing to do for candle sticks
+     */
+    inline void share_histogram_scale(std::vector< model::plot::plot_data<model::plot::candle_stick_point> >&){}
+
+    /** Merge the plot data of each run into one plot with shared axes
+     *
+     * @param run_data plot data for each run
+     * @param labels label of each run
+     * @param barcodes flowcell barcode of each run
+     * @param as_lines if true, draw each series as a line
+     * @param data output plot data with a series for each run
+     */
+    template<class Point>
+    void merge_overlay(const std::vector< model::plot::plot_data<Point> >& run_data,
+                       const std::vector<std::string>& labels,
+                       const std::vector<std::string>& barcodes,
+                       const bool as_lines,
+                       model::plot::plot_data<Point>& data)
+    {
+        typedef model::plot::series<Point> series_t;
+        float xmin = std::numeric_limits<float>::max();
+        float xmax = -std::numeric_limits<float>::max();
+        float ymin = std::numeric_limits<float>::max();
+        float ymax = -std::numeric_limits<float>::max();
+        const model::plot::plot_data<Point>* first = 0;
+        size_t first_index = 0;
+        for(size_t i=0;i<run_data.size();++i)
+        {
+            const model::plot::plot_data<Point>& run = run_data[i];
+            if(run.size() == 0) continue;
+            if(first == 0)
+            {
+                first = &run;
+                first_index = i;
+            }
+            xmin = std::min(xmin, run.x_axis().min());
+            xmax = std::max(xmax, run.x_axis().max());
+            ymin = std::min(ymin, run.y_axis().min());
+            ymax = std::max(ymax, run.y_axis().max());
+            for(size_t s=0;s<run.size();++s)
+            {
+                const series_t& source = run[s];
+                std::string title = labels[i];
+                if(run.size() > 1) title += " " + source.title();
+                data.push_back(series_t(title,
+                                        color_name_for_index(data.size()),
+                                        as_lines ? series_t::Line : source.series_type()));
+                series_t& destination = data[data.size()-1];
+                for(size_t o=0;o<source.options().size();++o) destination.add_option(source.options()[o]);
+                destination.resize(source.size());
+                for(size_t p=0;p<source.size();++p) destination[p] = source[p];
+            }
+        }
+        if(first == 0) return;
+        data.set_range(xmin, xmax, ymin, ymax);
+        data.set_xlabel(first->x_axis().label());
+        data.set_ylabel(first->y_axis().label());
+        // The title of a single run starts with its flowcell barcode, which does not apply to the overlay
+        std::string title = first->title();
+        const std::string& barcode = barcodes[first_index];
+        if(barcode != "" && title.compare(0, barcode.size()+1, barcode + " ") == 0) title = title.substr(barcode.size()+1);
+        data.set_title(title);
+    }
+
+    /** Plot each run in parallel, then merge the series into one plot
+     *
+     * @param overlay source of the runs to plot
+     * @param as_lines if true, draw each series as a line
+     * @param data output plot data with a series for each run
+     * @param thread_count number of runs to plot in parallel
+     */
+    template<class Overlay, class Point>
+    void plot_overlay_t(const Overlay& overlay,
+                        const bool as_lines,
+                        model::plot::plot_data<Point>& data,
+                        const size_t thread_count)
+    {
+        const size_t run_count = overlay.size();
+        std::vector< model::plot::plot_data<Point> > run_data(run_count);
+        std::vector<std::string> labels(run_count);
+        std::vector<std::string> barcodes(run_count);
+        data.clear();
+#ifdef _OPENMP
+        if(thread_count > 1 && run_count > 1)
+        {
+            std::vector<overlay_error> errors(run_count);
+            bool exception_thrown = false;
+#           pragma omp parallel default(shared) num_threads(static_cast<int>(std::min(thread_count, run_count)))
+            {
+                utils::workspace workspace;
+#               pragma omp for schedule(dynamic)
+                for(int i=0;i<static_cast<int>(run_count);++i)
+                {
+#                   pragma omp flush(exception_thrown)
+                    if(exception_thrown) continue;
+                    // A run listed more than once is plotted once and copied below
+                    if(overlay.source(static_cast<size_t>(i)) != static_cast<size_t>(i)) continue;
+                    errors[i].run(overlay, static_cast<size_t>(i), run_data[i], workspace, labels[i], barcodes[i]);
+                    if(errors[i].failed())
+                    {
+                        exception_thrown = true;
+#pragma                 omp flush(exception_thrown)
+                    }
+                }
+            }
+            // Throw the exception of the first run that failed, so the result does not depend on the schedule
+            for(size_t i=0;i<run_count;++i) errors[i].rethrow();
+            for(size_t i=0;i<run_count;++i)
+            {
+                const size_t source = overlay.source(i);
+                if(source == i) continue;
+                run_data[i] = run_data[source];
+                labels[i] = labels[source];
+                barcodes[i] = barcodes[source];
+            }
+        }
+        else
+        {
+#else
+        (void)thread_count;
+#endif
+            utils::workspace workspace;
+            for(size_t i=0;i<run_count;++i)
+                overlay(i, run_data[i], workspace, labels[i], barcodes[i]);
+#ifdef _OPENMP
+        }
+#endif
+        for(size_t i=0;i<run_count;++i)
+            if(labels[i] == "") labels[i] = "Run " + util::lexical_cast<std::string>(i+1);
+        share_histogram_scale(run_data);
+        merge_overlay(run_data, labels, barcodes, as_lines, data);
+    }
+
+    /** Plot a specified metric value by cycle for many loaded runs
+     *
+     * @ingroup plot_logic
+     * @param runs collection of loaded runs
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data with a series for each run
+     * @param thread_count number of runs to plot in parallel
+     */
+    void plot_by_cycle_overlay(const std::vector<model::metrics::run_metrics*>& runs,
+                               const constants::metric_type type,
+                               const model::plot::filter_options& options,
+                               model::plot::plot_data<model::plot::candle_stick_point>& data,
+                               const size_t thread_count)
+                                INTEROP_THROW_SPEC((model::index_out_of_bounds_exception,
+                                model::invalid_metric_type,
+                                model::invalid_channel_exception,
+                                model::invalid_filter_option,
+                                model::invalid_read_exception,
+                                model::invalid_parameter))
+    {
+        const by_cycle_overlay_plot plot(type, options);
+        plot_overlay_t(loaded_run_overlay<by_cycle_overlay_plot>(runs, plot), plot.as_lines(), data, thread_count);
+    }
+    /** Plot a specified metric value by cycle for many runs loaded on demand
+     *
+     * @ingroup plot_logic
+     * @param run_folders collection of run folder paths
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data with a series for each run
+     * @param thread_count number of runs to load and plot in parallel
+     */
+    void plot_by_cycle_overlay(const std::vector<std::string>& run_folders,
+                               const constants::metric_type type,
+                               const model::plot::filter_options& options,
+                               model::plot::plot_data<model::plot::candle_stick_point>& data,
+                               const size_t thread_count)
+                                INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+                                xml::bad_xml_format_exception,
+                                xml::empty_xml_format_exception,
+                                xml::missing_xml_element_exception,
+                                xml::xml_parse_exception,
+                                io::file_not_found_exception,
+                                io::bad_format_exception,
+                                io::incomplete_file_exception,
+                                model::index_out_of_bounds_exception,
+                                model::invalid_metric_type,
+                                model::invalid_channel_exception,
+                                model::invalid_filter_option,
+                                model::invalid_read_exception,
+                                model::invalid_parameter))
+    {
+        const by_cycle_overlay_plot plot(type, options);
+        plot_overlay_t(run_folder_overlay<by_cycle_overlay_plot>(run_folders, plot), plot.as_lines(), data, thread_count);
+    }
+    /** Plot the q-score histogram for many loaded runs
+     *
+     * @ingroup plot_logic
+     * @param runs collection of loaded runs
+     * @param options options to filter the data
+     * @param data output plot data with a series for each run
+     * @param thread_count number of runs to plot in parallel
+     */
+    void plot_qscore_histogram_overlay(const std::vector<model::metrics::run_metrics*>& runs,
+                                       const model::plot::filter_options& options,
+                                       model::plot::plot_data<model::plot::bar_point>& data,
+                                       const size_t thread_count)
+                                        INTEROP_THROW_SPEC((model::invalid_read_exception,
+                                        model::index_out_of_bounds_exception,
+                                        model::invalid_filter_option,
+                                        model::invalid_parameter))
+    {
+        const qscore_histogram_overlay_plot plot(options);
+        plot_overlay_t(loaded_run_overlay<qscore_histogram_overlay_plot>(runs, plot), plot.as_lines(), data, thread_count);
+    }
+    /** Plot the q-score histogram for many runs loaded on demand
+     *
+     * @ingroup plot_logic
+     * @param run_folders collection of run folder paths
+     * @param options options to filter the data
+     * @param data output plot data with a series for each run
+     * @param thread_count number of runs to load and plot in parallel
+     */
+    void plot_qscore_histogram_overlay(const std::vector<std::string>& run_folders,
+                                       const model::plot::filter_options& options,
+                                       model::plot::plot_data<model::plot::bar_point>& data,
+                                       const size_t thread_count)
+                                        INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+                                        xml::bad_xml_format_exception,
+                                        xml::empty_xml_format_exception,
+                                        xml::missing_xml_element_exception,
+                                        xml::xml_parse_exception,
+                                        io::file_not_found_exception,
+                                        io::bad_format_exception,
+                                        io::incomplete_file_exception,
+                                        model::invalid_read_exception,
+                                        model::index_out_of_bounds_exception,
+                                        model::invalid_filter_option,
+                                        model::invalid_parameter))
+    {
+        const qscore_histogram_overlay_plot plot(options);
+        plot_overlay_t(run_folder_overlay<qscore_histogram_overlay_plot>(run_folders, plot), plot.as_lines(), data, thread_count);
+    }
+
+}}}}
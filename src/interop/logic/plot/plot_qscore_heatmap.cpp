@@ -140,7 +140,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param data output heat map data
      * @param buffer preallocated memory
      */
-    void plot_qscore_heatmap(model::metrics::run_metrics& metrics,
+    void plot_qscore_heatmap(const model::metrics::run_metrics& metrics,
                                     const model::plot::filter_options& options,
                                     model::plot::heatmap_data& data,
                                     float* buffer,
@@ -149,6 +149,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     model::invalid_filter_option))
     {
         data.clear();
+        metrics.ensure_derived_metrics();
         if(options.is_specific_surface())
         {
             typedef model::metrics::q_metric metric_t;
@@ -159,10 +160,6 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         else
         {
             typedef model::metrics::q_by_lane_metric metric_t;
-            if(0 == metrics.get<metric_t>().size())
-                logic::metric::create_q_metrics_by_lane(metrics.get<model::metrics::q_metric>(),
-                                                        metrics.get<metric_t>(),
-                                                        metrics.run_parameters().instrument_type());
             if (metrics.get<metric_t>().size() == 0)return;
             options.validate(constants::QScore, metrics.run_info());
             populate_heatmap(metrics.get<metric_t>(), options, data, buffer);
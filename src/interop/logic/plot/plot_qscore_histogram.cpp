@@ -144,7 +144,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param data output plot data
      * @param boundary index of bin to create the boundary sub plots (0 means do nothing)
      */
-    void plot_qscore_histogram(model::metrics::run_metrics& metrics,
+    void plot_qscore_histogram(const model::metrics::run_metrics& metrics,
                                const model::plot::filter_options& options,
                                model::plot::plot_data<model::plot::bar_point>& data,
                                const size_t boundary)
@@ -182,6 +182,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         std::vector<float> histogram;
         float max_x_value;
 
+        metrics.ensure_derived_metrics();
         if(options.is_specific_surface())
         {
             typedef model::metrics::q_metric metric_t;
@@ -197,9 +198,9 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                     last_cycle,
                     histogram);
             axis_scale = scale_histogram(histogram);
-            if(!metrics.get<metric_t>().bins().empty())
-                max_x_value=plot_binned_histogram(metrics.get<metric_t>().bins().begin(),
-                                                  metrics.get<metric_t>().bins().end(),
+            if(!metrics.get<metric_t>().get_bins().empty())
+                max_x_value=plot_binned_histogram(metrics.get<metric_t>().get_bins().begin(),
+                                                  metrics.get<metric_t>().get_bins().end(),
                                                   histogram,
                                                   data[0]);
             else max_x_value=plot_unbinned_histogram(histogram, data[0]);
@@ -207,10 +208,6 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         else
         {
             typedef model::metrics::q_by_lane_metric metric_t;
-            if(0 == metrics.get<metric_t>().size())
-                logic::metric::create_q_metrics_by_lane(metrics.get<model::metrics::q_metric>(),
-                                                        metrics.get<metric_t>(),
-                                                        metrics.run_parameters().instrument_type());
             if(0 == metrics.get<metric_t>().size()) return;
             const size_t last_cycle = get_last_filtered_cycle(metrics.run_info(),
                                                               options,
@@ -224,9 +221,9 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                     last_cycle,
                     histogram);
             axis_scale = scale_histogram(histogram);
-            if(!metrics.get<metric_t>().bins().empty())
-                max_x_value=plot_binned_histogram(metrics.get<metric_t>().bins().begin(),
-                                                  metrics.get<metric_t>().bins().end(),
+            if(!metrics.get<metric_t>().get_bins().empty())
+                max_x_value=plot_binned_histogram(metrics.get<metric_t>().get_bins().begin(),
+                                                  metrics.get<metric_t>().get_bins().end(),
                                                   histogram,
                                                   data[0]);
             else max_x_value=plot_unbinned_histogram(histogram, data[0]);
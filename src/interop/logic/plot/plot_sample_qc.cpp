@@ -15,14 +15,13 @@ namespace illumina { namespace interop { namespace logic { namespace plot
 
     /** Populate reads identified versus the index
      *
+     * @note The indices must already be populated from the tile metrics
      * @param index_metrics set of metric records
-     * @param tile_metrics source collection of tile metrics
      * @param lane lane index
      * @param points collection of points where x is lane number and y is the candle stick metric values
      */
     template<typename Point>
-    float populate_reads_identified(model::metric_base::metric_set<model::metrics::index_metric> &index_metrics,
-                                    const model::metric_base::metric_set<model::metrics::tile_metric> &tile_metrics,
+    float populate_reads_identified(const model::metric_base::metric_set<model::metrics::index_metric> &index_metrics,
                                     const size_t lane,
                                     model::plot::data_point_collection<Point> &points)
     {
@@ -32,7 +31,6 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         typedef typename model::metrics::index_metric::const_iterator const_index_iterator;
         const size_t kAllLanes = 0;
 
-        logic::metric::populate_indices(tile_metrics, index_metrics);
         index_count_map_t index_count_map;
         ::uint64_t pf_cluster_count_total = 0;
         for (typename index_metric_set_t::const_iterator b = index_metrics.begin(), e = index_metrics.end();
@@ -77,7 +75,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param lane lane number
      * @param data output plot data
      */
-    void plot_sample_qc(model::metrics::run_metrics &metrics,
+    void plot_sample_qc(const model::metrics::run_metrics& metrics,
                         const size_t lane,
                         model::plot::plot_data<model::plot::bar_point> &data)
     INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
@@ -92,6 +90,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         data.assign(1, bar_series_t("% reads", "Green", bar_series_t::Bar));
         data[0].add_option(constants::to_string(constants::Centered));
 
+        metrics.ensure_derived_metrics();
         if (metrics.get<model::metrics::index_metric>().size() == 0)
         {
             if (metrics.run_info().is_indexed())
@@ -107,7 +106,6 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         }
 
         const float max_height = populate_reads_identified(metrics.get<model::metrics::index_metric>(),
-                                                           metrics.get<model::metrics::tile_metric>(),
                                                            lane,
                                                            data[0]);
         auto_scale(data);
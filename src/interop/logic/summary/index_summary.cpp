@@ -15,12 +15,13 @@ namespace illumina { namespace interop { namespace logic { namespace summary {
 
     /** Summarize a index metrics for a specific lane
      *
+     * @note The indices must already be populated from the tile metrics
      * @param index_metrics set of index metrics
      * @param tile_metrics source collection of tile metrics
      * @param lane lane number
      * @param summary destination index flowcell summary
      */
-    void summarize_index_metrics(model::metric_base::metric_set<model::metrics::index_metric>& index_metrics,
+    void summarize_index_metrics(const model::metric_base::metric_set<model::metrics::index_metric>& index_metrics,
                                  const model::metric_base::metric_set<model::metrics::tile_metric>& tile_metrics,
                                  const size_t lane,
                                  model::summary::index_lane_summary &summary)
@@ -36,7 +37,6 @@ namespace illumina { namespace interop { namespace logic { namespace summary {
 
         summary.clear();
         if(index_metrics.empty() || tile_metrics.empty()) return;
-        logic::metric::populate_indices(tile_metrics, index_metrics);
         index_count_map_t index_count_map;
         ::uint64_t total_mapped_reads = 0;
         read_count_t pf_cluster_count_total = 0;
@@ -109,16 +109,37 @@ namespace illumina { namespace interop { namespace logic { namespace summary {
      * @param lane lane number
      * @param summary destination index lane summary
      */
-    void summarize_index_metrics(model::metrics::run_metrics &metrics,
+    void summarize_index_metrics(const model::metrics::run_metrics& metrics,
                                         const size_t lane,
                                         model::summary::index_lane_summary &summary)
     INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
     {
+        metrics.ensure_derived_metrics();
         summarize_index_metrics(metrics.get<model::metrics::index_metric>(),
                                 metrics.get<model::metrics::tile_metric>(),
                                 lane,
                                 summary);
     }
+    /** Summarize every lane of a collection index metrics
+     *
+     * @note The indices must already be populated from the tile metrics
+     * @param index_metrics source collection of index metrics
+     * @param tile_metrics source collection of tile metrics
+     * @param lane_count number of lanes
+     * @param summary destination index flowcell summary
+     */
+    static void summarize_index_lanes(const model::metric_base::metric_set<model::metrics::index_metric>& index_metrics,
+                                      const model::metric_base::metric_set<model::metrics::tile_metric>& tile_metrics,
+                                      const size_t lane_count,
+                                      model::summary::index_flowcell_summary &summary)
+    {
+        if(index_metrics.empty() || tile_metrics.empty()) return;
+        summary.resize(lane_count);
+        for(size_t lane=1;lane <= lane_count;++lane)
+        {
+            summarize_index_metrics(index_metrics, tile_metrics, lane, summary[lane-1]);
+        }
+    }
     /** Summarize a collection index metrics
      *
      * @ingroup summary_logic
@@ -133,12 +154,8 @@ namespace illumina { namespace interop { namespace logic { namespace summary {
                                         model::summary::index_flowcell_summary &summary)
     INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
     {
-        if(index_metrics.empty() || tile_metrics.empty()) return;
-        summary.resize(lane_count);
-        for(size_t lane=1;lane <= lane_count;++lane)
-        {
-            summarize_index_metrics(index_metrics, tile_metrics, lane, summary[lane-1]);
-        }
+        logic::metric::populate_indices(tile_metrics, index_metrics);
+        summarize_index_lanes(index_metrics, tile_metrics, lane_count, summary);
     }
 
     /** Summarize index metrics from run metrics
@@ -147,15 +164,16 @@ namespace illumina { namespace interop { namespace logic { namespace summary {
      * @param metrics source collection of all metrics
      * @param summary destination index flowcell summary
      */
-    void summarize_index_metrics(model::metrics::run_metrics &metrics,
+    void summarize_index_metrics(const model::metrics::run_metrics& metrics,
                                         model::summary::index_flowcell_summary &summary)
     INTEROP_THROW_SPEC((model::index_out_of_bounds_exception))
     {
         const size_t lane_count = metrics.run_info().flowcell().lane_count();
-        summarize_index_metrics(metrics.get<model::metrics::index_metric>(),
-                                metrics.get<model::metrics::tile_metric>(),
-                                lane_count,
-                                summary);
+        metrics.ensure_derived_metrics();
+        summarize_index_lanes(metrics.get<model::metrics::index_metric>(),
+                              metrics.get<model::metrics::tile_metric>(),
+                              lane_count,
+                              summary);
     }
 
 }}}}
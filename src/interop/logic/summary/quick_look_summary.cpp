@@ -0,0 +1,285 @@
+/** Approximate summary logic computed over a stratified sample of tiles
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <algorithm>
+#include <cmath>
+#include "interop/logic/summary/quick_look_summary.h"
+#include "interop/logic/summary/run_summary.h"
+#include "interop/logic/metric/tile_metric.h"
+#include "interop/logic/utils/metrics_to_load.h"
+
+
+namespace illumina { namespace interop { namespace logic { namespace summary
+{
+    namespace detail
+    {
+        /** Tile numbers in a single lane/surface stratum */
+        typedef std::vector< ::uint32_t > tile_vector_t;
+
+        /** Generate all tile numbers in a lane from the flowcell layout
+         *
+         * @param layout flowcell layout
+         * @param naming_method tile naming method
+         * @param strata destination tile numbers for each surface of the lane
+         */
+        inline void generate_tiles_for_lane(const model::run::flowcell_layout& layout,
+                                            const constants::tile_naming_method naming_method,
+                                            std::vector<tile_vector_t>& strata)
+        {
+            const ::uint32_t section_count = naming_method == constants::FiveDigit ? layout.sections_per_lane() : 1;
+            for(::uint32_t surface=1;surface<=layout.surface_count();++surface)
+            {
+                for(::uint32_t swath=1;swath<=layout.swath_count();++swath)
+                {
+                    for(::uint32_t section=1;section<=section_count;++section)
+                    {
+                        for(::uint32_t tile=1;tile<=layout.tile_count();++tile)
+                        {
+                            ::uint32_t tile_number;
+                            if(naming_method == constants::FiveDigit)
+                                tile_number = surface*10000 + swath*1000 + section*100 + tile;
+                            else if(naming_method == constants::FourDigit)
+                                tile_number = surface*1000 + swath*100 + tile;
+                            else
+                                tile_number = (swath-1)*layout.tile_count() + tile;
+                            strata[surface-1].push_back(tile_number);
+                        }
+                    }
+                }
+            }
+        }
+        /** Select tiles from a stratum at an even stride
+         *
+         * @param lane lane number
+         * @param tiles all tiles in the stratum
+         * @param tiles_per_surface maximum number of tiles to select
+         * @param sample destination tile filter
+         * @return number of tiles selected
+         */
+        inline size_t sample_stratum(const ::uint32_t lane,
+                                     tile_vector_t& tiles,
+                                     const size_t tiles_per_surface,
+                                     model::metric_base::tile_filter& sample)
+        {
+            if(tiles.empty() || tiles_per_surface == 0) return 0;
+            std::sort(tiles.begin(), tiles.end());
+            tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+            const size_t total = tiles.size();
+            const size_t count = std::min(tiles_per_surface, total);
+            for(size_t i=0;i<count;++i)
+            {
+                // Center of the i-th of `count` equal intervals
+                sample.insert(lane, tiles[((2*i+1)*total)/(2*count)]);
+            }
+            return count;
+        }
+    }
+
+    /** Select a deterministic, stratified sample of tiles from the flowcell layout
+     *
+     * Each lane and surface forms a stratum. The tiles in a stratum are ordered by swath, section and tile
+     * number and then sampled at an even stride, so the sample covers the whole length and width of each lane.
+     *
+     * If RunInfo.xml lists the tiles, then the list is sampled. Otherwise, the tiles are generated from
+     * the flowcell layout and tile naming method.
+     *
+     * @param run_info run info
+     * @param tiles_per_surface maximum number of tiles to select from each lane surface
+     * @param sample destination tile filter
+     * @param sampling destination sampling summary (number of tiles sampled per lane)
+     */
+    void select_tile_sample(const model::run::info& run_info,
+                            const size_t tiles_per_surface,
+                            model::metric_base::tile_filter& sample,
+                            model::summary::sampling_summary& sampling)
+    INTEROP_THROW_SPEC(( model::invalid_tile_naming_method ))
+    {
+        typedef model::run::flowcell_layout::str_vector_t str_vector_t;
+        const model::run::flowcell_layout& layout = run_info.flowcell();
+        const size_t lane_count = layout.lane_count();
+        const size_t surface_count = std::max<size_t>(layout.surface_count(), 1);
+        constants::tile_naming_method naming_method = layout.naming_method();
+
+        std::vector< std::vector<detail::tile_vector_t> > strata(lane_count,
+                                                                 std::vector<detail::tile_vector_t>(surface_count));
+        if(!layout.tiles().empty())
+        {
+            for(str_vector_t::const_iterator it = layout.tiles().begin();it != layout.tiles().end();++it)
+            {
+                const ::uint32_t lane = metric::lane_from_name(*it);
+                const ::uint32_t tile = metric::tile_from_name(*it);
+                if(lane == 0 || lane > lane_count || tile == 0) continue;
+                if(naming_method == constants::UnknownTileNamingMethod)
+                    naming_method = metric::tile_naming_method_from_metric(model::metric_base::base_metric(lane, tile));
+                const size_t surface = std::min<size_t>(metric::surface(tile, naming_method), surface_count);
+                strata[lane-1][surface > 0 ? surface-1 : 0].push_back(tile);
+            }
+        }
+        else
+        {
+            if(naming_method == constants::UnknownTileNamingMethod)
+                INTEROP_THROW(model::invalid_tile_naming_method,
+                              "Tile sampling requires either a tile list or a tile naming method in the RunInfo.xml");
+            for(size_t lane=0;lane<lane_count;++lane)
+                detail::generate_tiles_for_lane(layout, naming_method, strata[lane]);
+        }
+
+        sample.clear();
+        sampling.resize(lane_count);
+        for(size_t lane=0;lane<lane_count;++lane)
+        {
+            size_t total = 0;
+            size_t selected = 0;
+            for(size_t surface=0;surface<surface_count;++surface)
+            {
+                selected += detail::sample_stratum(static_cast< ::uint32_t >(lane+1),
+                                                   strata[lane][surface],
+                                                   tiles_per_surface,
+                                                   sample);
+                total += strata[lane][surface].size();
+                sampling[lane].surface_total_tile_count(surface+1, strata[lane][surface].size());
+            }
+            sampling[lane].total_tile_count(total);
+            sampling[lane].sampled_tile_count(selected);
+        }
+    }
+
+    /** Scale a summary computed over a tile sample to the whole flowcell
+     *
+     * @param sampling sampling summary, the sampled tile count is updated to the tiles actually summarized
+     * @param summary run summary computed over the tile sample
+     */
+    void extrapolate_sampled_summary(model::summary::sampling_summary& sampling,
+                                     model::summary::run_summary& summary)
+    INTEROP_THROW_SPEC(( model::index_out_of_bounds_exception ))
+    {
+        if(summary.size() == 0) return;
+        for(size_t lane=0;lane<summary[0].size();++lane)
+        {
+            const size_t lane_number = summary[0][lane].lane();
+            INTEROP_BOUNDS_CHECK(lane_number-1, sampling.size(), "Lane number exceeds lane count in sampling summary");
+            // Tiles selected for the sample may be missing from the run folder
+            if(summary[0][lane].tile_count() > 0)
+                sampling[lane_number-1].sampled_tile_count(summary[0][lane].tile_count());
+        }
+
+        float yield_g = 0;
+        float projected_yield_g = 0;
+        float yield_g_nonindex = 0;
+        float projected_yield_g_nonindex = 0;
+        for(size_t read=0;read<summary.size();++read)
+        {
+            float read_yield_g = 0;
+            float read_projected_yield_g = 0;
+            for(size_t lane=0;lane<summary[read].size();++lane)
+            {
+                model::summary::lane_summary& lane_stat = summary[read][lane];
+                const model::summary::lane_sampling_summary& lane_sample = sampling[lane_stat.lane()-1];
+                if(lane_stat.tile_count() == 0) continue;
+                const float scale = lane_sample.scale();
+                lane_stat.reads(lane_stat.reads()*scale);
+                lane_stat.reads_pf(lane_stat.reads_pf()*scale);
+                lane_stat.yield_g(lane_stat.yield_g()*scale);
+                lane_stat.projected_yield_g(lane_stat.projected_yield_g()*scale);
+                lane_stat.tile_count(lane_sample.total_tile_count());
+                size_t surface_total_count = 0;
+                float reads = 0, reads_pf = 0;
+                for(size_t surface=0;surface<lane_stat.size();++surface)
+                {
+                    model::summary::surface_summary& surface_stat = lane_stat[surface];
+                    // Each surface is a stratum, so it is scaled by its own sampling ratio
+                    const float surface_scale = lane_sample.surface_scale(surface_stat.surface(),
+                                                                          surface_stat.tile_count());
+                    surface_stat.reads(surface_stat.reads()*surface_scale);
+                    surface_stat.reads_pf(surface_stat.reads_pf()*surface_scale);
+                    surface_stat.yield_g(surface_stat.yield_g()*surface_scale);
+                    surface_stat.projected_yield_g(surface_stat.projected_yield_g()*surface_scale);
+                    const size_t surface_total = lane_sample.surface_total_tile_count(surface_stat.surface());
+                    surface_stat.tile_count(surface_total > 0 ? surface_total :
+                                            static_cast<size_t>(surface_stat.tile_count()*surface_scale+0.5f));
+                    surface_total_count += surface_total;
+                    reads += surface_stat.reads();
+                    reads_pf += surface_stat.reads_pf();
+                }
+                // When every surface of the lane was sampled, the stratified estimate is the sum over surfaces
+                if(lane_stat.size() > 0 && surface_total_count == lane_sample.total_tile_count() &&
+                   !std::isnan(reads) && !std::isnan(reads_pf))
+                {
+                    // Yields count the bases of the clusters passing filter
+                    const float ratio = lane_stat.reads_pf() > 0 ? reads_pf / lane_stat.reads_pf() : 1.0f;
+                    lane_stat.reads(reads);
+                    lane_stat.reads_pf(reads_pf);
+                    lane_stat.yield_g(lane_stat.yield_g()*ratio);
+                    lane_stat.projected_yield_g(lane_stat.projected_yield_g()*ratio);
+                }
+                if(!std::isnan(lane_stat.yield_g())) read_yield_g += lane_stat.yield_g();
+                if(!std::isnan(lane_stat.projected_yield_g())) read_projected_yield_g += lane_stat.projected_yield_g();
+            }
+            summary[read].summary().yield_g(read_yield_g);
+            summary[read].summary().projected_yield_g(read_projected_yield_g);
+            yield_g += read_yield_g;
+            projected_yield_g += read_projected_yield_g;
+            if(!summary[read].read().is_index())
+            {
+                yield_g_nonindex += read_yield_g;
+                projected_yield_g_nonindex += read_projected_yield_g;
+            }
+        }
+        summary.total_summary().yield_g(yield_g);
+        summary.total_summary().projected_yield_g(projected_yield_g);
+        summary.nonindex_summary().yield_g(yield_g_nonindex);
+        summary.nonindex_summary().projected_yield_g(projected_yield_g_nonindex);
+    }
+
+    /** Read a stratified sample of tiles from a run folder and summarize it
+     *
+     * @param run_folder run folder path
+     * @param tiles_per_surface maximum number of tiles to select from each lane surface
+     * @param metrics destination run metrics holding only the sampled tiles
+     * @param summary destination run summary
+     * @param sampling destination sampling summary
+     * @param thread_count number of threads to use for network loading
+     */
+    void summarize_quick_look(const std::string& run_folder,
+                              const size_t tiles_per_surface,
+                              model::metrics::run_metrics& metrics,
+                              model::summary::run_summary& summary,
+                              model::summary::sampling_summary& sampling,
+                              const size_t thread_count)
+    INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception,
+    xml::empty_xml_format_exception,
+    xml::missing_xml_element_exception,
+    xml::xml_parse_exception,
+    io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    model::invalid_channel_exception,
+    model::index_out_of_bounds_exception,
+    model::invalid_tile_naming_method,
+    model::invalid_tile_list_exception,
+    model::invalid_run_info_exception,
+    model::invalid_run_info_cycle_exception,
+    model::invalid_parameter))
+    {
+        metrics.clear();
+        metrics.read_run_info(run_folder);
+        model::metric_base::tile_filter sample;
+        select_tile_sample(metrics.run_info(), tiles_per_surface, sample, sampling);
+
+        std::vector<unsigned char> valid_to_load;
+        utils::list_summary_metrics_to_load(valid_to_load);
+        metrics.read_metrics(run_folder, metrics.run_info().total_cycles(), valid_to_load, thread_count, false, &sample);
+        const size_t count = metrics.read_run_parameters(run_folder);
+        metrics.finalize_after_load(count);
+
+        summarize_run_metrics(metrics, summary);
+        extrapolate_sampled_summary(sampling, summary);
+    }
+
+}}}}
+
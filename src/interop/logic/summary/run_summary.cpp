@@ -22,11 +22,13 @@ namespace illumina { namespace interop { namespace logic { namespace summary
      *
      * @param metrics run metrics
      * @param summary run summary
+     * @param tile_numbers scratch buffer for tile numbers
      */
-    void summarize_tile_count(const model::metrics::run_metrics& metrics, model::summary::run_summary& summary)
+    void summarize_tile_count(const model::metrics::run_metrics& metrics,
+                              model::summary::run_summary& summary,
+                              utils::workspace::id_vector_t& tile_numbers)
     {
         using namespace model::metrics;
-        model::metrics::run_metrics::id_set_t tile_count_set;
         const size_t surface_count = metrics.run_info().flowcell().surface_count();
         const constants::tile_naming_method naming_convention = metrics.run_info().flowcell().naming_method();
         for(unsigned int lane=0;lane<summary.lane_count();++lane)
@@ -34,38 +36,41 @@ namespace illumina { namespace interop { namespace logic { namespace summary
             size_t tile_count_for_lane = 0;
             for(unsigned int surface=0;surface < surface_count;++surface)
             {
-                metrics.get<tile_metric>().populate_tile_numbers_for_lane_surface(tile_count_set,
+                tile_numbers.clear();
+                metrics.get<tile_metric>().append_tile_numbers_for_lane_surface(tile_numbers,
                                                                              lane+1,
                                                                              surface+1,
                                                                              naming_convention);
-                metrics.get<error_metric>().populate_tile_numbers_for_lane_surface(tile_count_set,
+                metrics.get<error_metric>().append_tile_numbers_for_lane_surface(tile_numbers,
                                                                              lane+1,
                                                                              surface+1,
                                                                              naming_convention);
-                metrics.get<extraction_metric>().populate_tile_numbers_for_lane_surface(tile_count_set,
+                metrics.get<extraction_metric>().append_tile_numbers_for_lane_surface(tile_numbers,
                                                                              lane+1,
                                                                              surface+1,
                                                                              naming_convention);
-                metrics.get<q_metric>().populate_tile_numbers_for_lane_surface(tile_count_set,
+                metrics.get<q_metric>().append_tile_numbers_for_lane_surface(tile_numbers,
                                                                              lane+1,
                                                                              surface+1,
                                                                              naming_convention);
-                metrics.get<corrected_intensity_metric>().populate_tile_numbers_for_lane_surface(tile_count_set,
+                metrics.get<corrected_intensity_metric>().append_tile_numbers_for_lane_surface(tile_numbers,
                                                                                lane+1,
                                                                                surface+1,
                                                                                naming_convention);
-                metrics.get<phasing_metric>().populate_tile_numbers_for_lane_surface(tile_count_set,
+                metrics.get<phasing_metric>().append_tile_numbers_for_lane_surface(tile_numbers,
                                                                                      lane+1,
                                                                                      surface+1,
                                                                                      naming_convention);
+                std::sort(tile_numbers.begin(), tile_numbers.end());
+                const size_t tile_count = static_cast<size_t>(
+                        std::distance(tile_numbers.begin(), std::unique(tile_numbers.begin(), tile_numbers.end())));
 
                 if(surface_count > 1)
                 {
                     for (size_t read = 0; read < summary.size(); ++read)
-                        summary[read][lane][surface].tile_count(tile_count_set.size());
+                        summary[read][lane][surface].tile_count(tile_count);
                 }
-                tile_count_for_lane += tile_count_set.size();
-                tile_count_set.clear();
+                tile_count_for_lane += tile_count;
             }
             for(size_t read=0;read<summary.size();++read)
                 summary[read][lane].tile_count(tile_count_for_lane);
@@ -105,23 +110,47 @@ namespace illumina { namespace interop { namespace logic { namespace summary
      * @param skip_median skip the median calculation
      * @param trim removed unset lanes
      */
-    void summarize_run_metrics(model::metrics::run_metrics& metrics,
+    void summarize_run_metrics(const model::metrics::run_metrics& metrics,
                                model::summary::run_summary& summary,
                                const bool skip_median,
                                const bool trim)
     INTEROP_THROW_SPEC(( model::index_out_of_bounds_exception,
     model::invalid_channel_exception,
     model::invalid_run_info_exception ))
+    {
+        utils::workspace workspace;
+        summarize_run_metrics(metrics, summary, workspace, skip_median, trim);
+    }
+
+    /** Summarize a collection run metrics reusing the scratch buffers in a workspace
+     *
+     * @ingroup summary_logic
+     * @param metrics source collection of all metrics
+     * @param summary destination run summary
+     * @param workspace scratch buffers reused across calls
+     * @param skip_median skip the median calculation
+     * @param trim removed unset lanes
+     */
+    void summarize_run_metrics(const model::metrics::run_metrics& metrics,
+                               model::summary::run_summary& summary,
+                               utils::workspace& workspace,
+                               const bool skip_median,
+                               const bool trim)
+    INTEROP_THROW_SPEC(( model::index_out_of_bounds_exception,
+    model::invalid_channel_exception,
+    model::invalid_run_info_exception ))
     {
         using namespace model::metrics;
+        utils::workspace::call_scope scope(workspace);
         if(metrics.empty())
         {
             summary.clear();
             return;
         }
         summary.initialize(metrics.run_info());
+        metrics.ensure_derived_metrics();
 
-        read_cycle_vector_t cycle_to_read;
+        read_cycle_vector_t& cycle_to_read = workspace.cycle_to_read();
         const constants::tile_naming_method naming_method = metrics.run_info().flowcell().naming_method();
         map_read_to_cycle_number(summary.begin(), summary.end(), cycle_to_read);
         summarize_tile_metrics(metrics.get<tile_metric>().begin(),
@@ -144,15 +173,12 @@ namespace illumina { namespace interop { namespace logic { namespace summary
                                      summary,
                                      skip_median);
 
-        if(0 == metrics.get<q_collapsed_metric>().size())
-            logic::metric::create_collapse_q_metrics(metrics.get<q_metric>(),
-                                                     metrics.get<q_collapsed_metric>());
         summarize_collapsed_quality_metrics(metrics.get<q_collapsed_metric>().begin(),
                                             metrics.get<q_collapsed_metric>().end(),
                                             cycle_to_read,
                                             naming_method,
                                             summary);
-        summarize_tile_count(metrics, summary);
+        summarize_tile_count(metrics, summary, workspace.tile_numbers());
 
         summarize_cycle_state(metrics.get<tile_metric>(),
                               metrics.get<error_metric>(),
@@ -175,11 +201,6 @@ namespace illumina { namespace interop { namespace logic { namespace summary
                               cycle_to_read,
                               &model::summary::cycle_state_summary::called_cycle_range,
                               summary);
-        if(0 == metrics.get<dynamic_phasing_metric>().size())
-            logic::metric::populate_dynamic_phasing_metrics(metrics.get<model::metrics::phasing_metric>(),
-                                                            cycle_to_read,
-                                                            metrics.get<model::metrics::dynamic_phasing_metric>(),
-                                                            metrics.get<model::metrics::tile_metric>());
         summarize_phasing_metrics(metrics.get<dynamic_phasing_metric>().begin(),
                                   metrics.get<dynamic_phasing_metric>().end(),
                                   summary,
@@ -203,5 +224,83 @@ namespace illumina { namespace interop { namespace logic { namespace summary
         }
     }
 
+    /** Copy the statistics shared by lanes and surfaces to a row of the columns
+     *
+     * @param stats source lane or surface statistics
+     * @param tile_count number of tiles in the lane or surface
+     * @param row row index
+     * @param columns destination columnar summary
+     */
+    static void copy_stat_summary(const model::summary::stat_summary& stats,
+                                  const size_t tile_count,
+                                  const size_t row,
+                                  model::summary::columnar_summary& columns)
+    {
+        typedef model::summary::columnar_summary columnar_summary;
+        columns.set(columnar_summary::Density, row, stats.density());
+        columns.set(columnar_summary::DensityPf, row, stats.density_pf());
+        columns.set(columnar_summary::ClusterCount, row, stats.cluster_count());
+        columns.set(columnar_summary::ClusterCountPf, row, stats.cluster_count_pf());
+        columns.set(columnar_summary::PercentPf, row, stats.percent_pf());
+        columns.set(columnar_summary::Phasing, row, stats.phasing());
+        columns.set(columnar_summary::Prephasing, row, stats.prephasing());
+        columns.set(columnar_summary::PercentAligned, row, stats.percent_aligned());
+        columns.set(columnar_summary::ErrorRate, row, stats.error_rate());
+        columns.set(columnar_summary::ErrorRate35, row, stats.error_rate_35());
+        columns.set(columnar_summary::ErrorRate50, row, stats.error_rate_50());
+        columns.set(columnar_summary::ErrorRate75, row, stats.error_rate_75());
+        columns.set(columnar_summary::ErrorRate100, row, stats.error_rate_100());
+        columns.set(columnar_summary::FirstCycleIntensity, row, stats.first_cycle_intensity());
+        columns.set(columnar_summary::PhasingSlope, row, stats.phasing_slope());
+        columns.set(columnar_summary::PhasingOffset, row, stats.phasing_offset());
+        columns.set(columnar_summary::PrephasingSlope, row, stats.prephasing_slope());
+        columns.set(columnar_summary::PrephasingOffset, row, stats.prephasing_offset());
+        columns.set(columnar_summary::column(columnar_summary::PercentGtQ30), row, stats.percent_gt_q30());
+        columns.set(columnar_summary::column(columnar_summary::YieldG), row, stats.yield_g());
+        columns.set(columnar_summary::column(columnar_summary::ProjectedYieldG), row, stats.projected_yield_g());
+        columns.set(columnar_summary::column(columnar_summary::Reads), row, stats.reads());
+        columns.set(columnar_summary::column(columnar_summary::ReadsPf), row, stats.reads_pf());
+        columns.set(columnar_summary::column(columnar_summary::TileCount), row, static_cast<float>(tile_count));
+    }
+
+    /** Copy the read, lane and surface statistics of a run summary to flat columns
+     *
+     * @ingroup summary_logic
+     * @param summary source run summary
+     * @param columns destination columnar summary
+     */
+    void create_columnar_summary(const model::summary::run_summary& summary,
+                                 model::summary::columnar_summary& columns)
+    {
+        size_t lane_count = summary.lane_count();
+        size_t surface_count = summary.surface_count();
+        for (size_t read = 0; read < summary.size(); ++read)
+        {
+            for (size_t lane = 0; lane < summary[read].size(); ++lane)
+            {
+                lane_count = std::max(lane_count, std::max(summary[read][lane].lane(), lane+1));
+                surface_count = std::max(surface_count, summary[read][lane].size());
+            }
+        }
+        columns.resize(summary.size(), lane_count, surface_count);
+        for (size_t read = 0; read < summary.size(); ++read)
+        {
+            for (size_t lane = 0; lane < summary[read].size(); ++lane)
+            {
+                const model::summary::lane_summary& lane_summary = summary[read][lane];
+                const size_t lane_index = lane_summary.lane() > 0 ? lane_summary.lane() - 1 : lane;
+                copy_stat_summary(lane_summary, lane_summary.tile_count(), columns.row(read, lane_index), columns);
+                for (size_t surface = 0; surface < lane_summary.size(); ++surface)
+                {
+                    const model::summary::surface_summary& surface_summary = lane_summary[surface];
+                    copy_stat_summary(surface_summary,
+                                      surface_summary.tile_count(),
+                                      columns.row(read, lane_index, surface + 1),
+                                      columns);
+                }
+            }
+        }
+    }
+
 }}}}
 
@@ -7,6 +7,7 @@
  */
 #include "interop/logic/table/create_imaging_table.h"
 
+#include <algorithm>
 #include "interop/logic/summary/map_cycle_to_read.h"
 #include "interop/logic/table/create_imaging_table_columns.h"
 #include "interop/logic/table/table_populator.h"
@@ -134,13 +135,15 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param row_offset offset for each metric into the sorted table
      * @param data_beg iterator to start of table data
      * @param data_end iterator to end of table data
+     * @param workspace scratch buffers reused across calls
      */
     template<typename I>
     void create_imaging_table_data(const model::metrics::run_metrics& metrics,
                                    const std::vector<model::table::imaging_column>& columns,
                                    const row_offset_map_t& row_offset,
                                    I data_beg,
-                                   I data_end)
+                                   I data_end,
+                                   utils::workspace& workspace)
     {
         typedef typename model::metrics::run_metrics::id_t id_t;
         typedef model::metric_base::metric_set< model::metrics::tile_metric > tile_metric_set_t;
@@ -148,13 +151,15 @@ namespace illumina { namespace interop { namespace logic { namespace table
         typedef model::metric_base::metric_set< model::metrics::extended_tile_metric > extended_tile_metric_set_t;
 
         if(columns.empty())return;
+        metrics.ensure_derived_metrics();
         const size_t column_count = columns.back().column_count();
         const constants::tile_naming_method naming_method = metrics.run_info().flowcell().naming_method();
         const size_t q20_idx = metric::index_for_q_value(metrics.get<model::metrics::q_metric>(), 20);
         const size_t q30_idx = metric::index_for_q_value(metrics.get<model::metrics::q_metric>(), 30);
-        std::vector<size_t> cmap(model::table::ImagingColumnCount, std::numeric_limits<size_t>::max());
+        std::vector<size_t>& cmap = workspace.column_map();
+        summary::read_cycle_vector_t& cycle_to_read = workspace.cycle_to_read();
+        cmap.assign(model::table::ImagingColumnCount, std::numeric_limits<size_t>::max());
         for(size_t i=0;i<columns.size();++i) cmap[columns[i].id()] = columns[i].offset();
-        summary::read_cycle_vector_t cycle_to_read;
         summary::map_read_to_cycle_number(metrics.run_info().reads().begin(),
                                           metrics.run_info().reads().end(),
                                           cycle_to_read);
@@ -218,18 +223,32 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                              column_count,
                                              data_beg, data_end);
 
-        const tile_metric_set_t& tile_metrics = metrics.get<model::metrics::tile_metric>();
+        // Join the tile, extended tile and dynamic phasing metrics to each row with batched lookups
+        const size_t row_count = row_offset.size();
+        utils::workspace::key_vector_t& keys = workspace.keys();
+        utils::workspace::index_vector_t& indices = workspace.indices();
+        keys.clear();
         for(typename row_offset_map_t::const_iterator it = row_offset.begin();it != row_offset.end();++it)
+            keys.push_back(model::metric_base::base_cycle_metric::tile_hash_from_id(it->first));
+        indices.resize(2*row_count);
+        const tile_metric_set_t& tile_metrics = metrics.get<model::metrics::tile_metric>();
+        const extended_tile_metric_set_t& extended_tile_metrics = metrics.get<model::metrics::extended_tile_metric>();
+        if(row_count > 0)
         {
-            const id_t tid = model::metric_base::base_cycle_metric::tile_hash_from_id(it->first);
-            if (!tile_metrics.has_metric(tid)) continue;
+            tile_metrics.find(&keys[0], row_count, &indices[0]);
+            extended_tile_metrics.find(&keys[0], row_count, &indices[row_count]);
+        }
+        size_t r = 0;
+        for(typename row_offset_map_t::const_iterator it = row_offset.begin();it != row_offset.end();++it, ++r)
+        {
+            if (indices[r] >= tile_metrics.size()) continue;
             const id_t cycle = model::metric_base::base_cycle_metric::cycle_from_id(it->first);
             const ::uint64_t row = it->second;
             INTEROP_ASSERTMSG(cycle <= cycle_to_read.size(),
                               cycle << " <= " << cycle_to_read.size()
                                     <<  " tile: " << model::metric_base::base_cycle_metric::tile_from_id(it->first));
             const summary::read_cycle& read = cycle_to_read[static_cast<size_t>(cycle-1)];
-            table_populator::populate(tile_metrics.get_metric(tid),
+            table_populator::populate(tile_metrics[indices[r]],
                                       read.number,
                                       q20_idx,
                                       q30_idx,
@@ -238,15 +257,14 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                       data_beg+row*column_count,
                                       data_end);
         }
-        const extended_tile_metric_set_t& extended_tile_metrics = metrics.get<model::metrics::extended_tile_metric>();
-        for(typename row_offset_map_t::const_iterator it = row_offset.begin();it != row_offset.end();++it)
+        r = 0;
+        for(typename row_offset_map_t::const_iterator it = row_offset.begin();it != row_offset.end();++it, ++r)
         {
-            const id_t tid = model::metric_base::base_cycle_metric::tile_hash_from_id(it->first);
-            if (!tile_metrics.has_metric(tid) || !extended_tile_metrics.has_metric(tid)) continue;
+            if (indices[r] >= tile_metrics.size() || indices[row_count+r] >= extended_tile_metrics.size()) continue;
             const id_t cycle = model::metric_base::base_cycle_metric::cycle_from_id(it->first);
             const ::uint64_t row = it->second;
             const summary::read_cycle& read = cycle_to_read[static_cast<size_t>(cycle-1)];
-            table_populator::populate(extended_tile_metrics.get_metric(tid),
+            table_populator::populate(extended_tile_metrics[indices[row_count+r]],
                                       read.number,
                                       q20_idx,
                                       q30_idx,
@@ -256,15 +274,26 @@ namespace illumina { namespace interop { namespace logic { namespace table
         }
         const dynamic_phasing_metric_set_t& dynamic_phasing_metrics =
                 metrics.get<model::metrics::dynamic_phasing_metric>();
+        keys.clear();
         for(typename row_offset_map_t::const_iterator it = row_offset.begin();it != row_offset.end();++it)
         {
             const id_t lane = model::metric_base::base_read_metric::lane_from_id(it->first);
             const id_t tile = model::metric_base::base_read_metric::tile_from_id(it->first);
             const id_t cycle = model::metric_base::base_cycle_metric::cycle_from_id(it->first);
+            const summary::read_cycle& read = cycle_to_read[static_cast<size_t>(cycle-1)];
+            keys.push_back(model::metric_base::base_read_metric::create_id(static_cast<uint32_t>(lane),
+                                                                          static_cast<uint32_t>(tile),
+                                                                          static_cast<uint32_t>(read.number)));
+        }
+        if(row_count > 0) dynamic_phasing_metrics.find(&keys[0], row_count, &indices[0]);
+        r = 0;
+        for(typename row_offset_map_t::const_iterator it = row_offset.begin();it != row_offset.end();++it, ++r)
+        {
+            if (indices[r] >= dynamic_phasing_metrics.size()) continue;
+            const id_t cycle = model::metric_base::base_cycle_metric::cycle_from_id(it->first);
             const ::uint64_t row = it->second;
             const summary::read_cycle& read = cycle_to_read[static_cast<size_t>(cycle-1)];
-            if (!dynamic_phasing_metrics.has_metric(static_cast<uint32_t>(lane), static_cast<uint32_t>(tile), static_cast<uint32_t>(read.number))) continue;
-            table_populator::populate(dynamic_phasing_metrics.get_metric(static_cast<uint32_t>(lane), static_cast<uint32_t>(tile), static_cast<uint32_t>(read.number)),
+            table_populator::populate(dynamic_phasing_metrics[indices[r]],
                                       read.number,
                                       q20_idx,
                                       q30_idx,
@@ -288,7 +317,8 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                        const row_offset_map_t& row_offset,
                                      I data_beg, const size_t n)
     {
-        create_imaging_table_data(metrics, columns, row_offset, data_beg, data_beg+n);
+        utils::workspace workspace;
+        create_imaging_table_data(metrics, columns, row_offset, data_beg, data_beg+n, workspace);
     }
     /** Populate the imaging table with all the metrics in the run
      *
@@ -305,23 +335,86 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                      const size_t n) INTEROP_THROW_SPEC((model::index_out_of_bounds_exception, model::invalid_parameter))
     {
         std::fill(data_beg, data_beg+n, std::numeric_limits<float>::quiet_NaN());
-        create_imaging_table_data(metrics, columns, row_offset, data_beg, data_beg+n);
+        utils::workspace workspace;
+        create_imaging_table_data(metrics, columns, row_offset, data_beg, data_beg+n, workspace);
     }
+    /** Append the unique id of every record of the by cycle metric sets
+     */
+    class append_cycle_ids
+    {
+    public:
+        /** Constructor
+         *
+         * @param ids destination ids
+         */
+        append_cycle_ids(utils::workspace::key_vector_t& ids) : m_ids(ids){}
+        /** Append the ids of a metric set
+         *
+         * @param metrics metric set
+         */
+        template<class MetricSet>
+        void operator()(const MetricSet& metrics)const
+        {
+            typedef typename MetricSet::base_t base_t;
+            append(metrics, base_t::null());
+        }
+
+    private:
+        template<class MetricSet>
+        void append(const MetricSet& metrics, const constants::base_cycle_t*)const
+        {
+            for(typename MetricSet::const_iterator it = metrics.begin();it != metrics.end();++it)
+                m_ids.push_back(it->cycle_hash());
+        }
+        template<class MetricSet>
+        void append(const MetricSet&, const void*)const{}
+
+    private:
+        utils::workspace::key_vector_t& m_ids;
+    };
     /** Count the number of rows in the imaging table and setup an ordering
+     *
+     * The map is only rebuilt when the set of rows changes, so a repeated call on the same run does not
+     * allocate map nodes.
      *
      * @param metrics collections of InterOp metric sets
      * @param row_offset ordering for the rows
+     * @param ids scratch buffer for the unique ids
      */
     void count_table_rows(const model::metrics::run_metrics& metrics,
-                          row_offset_map_t& row_offset)
+                          row_offset_map_t& row_offset,
+                          utils::workspace::key_vector_t& ids)
     {
-        typedef model::metrics::run_metrics::cycle_metric_map_t cycle_metric_map_t;
-        cycle_metric_map_t hash_set;
-        metrics.populate_id_map(hash_set);
+        ids.clear();
+        append_cycle_ids func(ids);
+        metrics.metrics_callback(func);
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        if(ids.size() == row_offset.size())
+        {
+            size_t i = 0;
+            row_offset_map_t::const_iterator it = row_offset.begin();
+            while(it != row_offset.end() && it->first == ids[i])
+            {
+                ++it;
+                ++i;
+            }
+            if(it == row_offset.end()) return;
+        }
         row_offset.clear();
-        ::uint64_t row = 0;
-        for(cycle_metric_map_t::const_iterator it = hash_set.begin();it != hash_set.end();++it,++row)
-            row_offset[it->first]=row;
+        for(size_t i=0;i<ids.size();++i)
+            row_offset.insert(row_offset.end(), row_offset_map_t::value_type(ids[i], i));
+    }
+    /** Count the number of rows in the imaging table and setup an ordering
+     *
+     * @param metrics collections of InterOp metric sets
+     * @param row_offset ordering for the rows
+     */
+    void count_table_rows(const model::metrics::run_metrics& metrics,
+                          row_offset_map_t& row_offset)
+    {
+        utils::workspace::key_vector_t ids;
+        count_table_rows(metrics, row_offset, ids);
     }
     /** Count the total number of columns for the data table
      *
@@ -338,19 +431,43 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param metrics source run metrics
      * @param table destination imaging table
      */
-    void create_imaging_table(model::metrics::run_metrics& metrics, model::table::imaging_table& table)
+    void create_imaging_table(const model::metrics::run_metrics& metrics, model::table::imaging_table& table)
+                                        INTEROP_THROW_SPEC((model::invalid_column_type, model::index_out_of_bounds_exception, model::invalid_parameter))
+    {
+        utils::workspace workspace;
+        create_imaging_table(metrics, table, workspace);
+    }
+    /** Create an imaging table from run metrics reusing the scratch buffers in a workspace
+     *
+     * The table data is swapped with the workspace, so the buffer of the previous table is reused by the next
+     * call with the same workspace.
+     *
+     * @param metrics source run metrics
+     * @param table destination imaging table
+     * @param workspace scratch buffers reused across calls
+     */
+    void create_imaging_table(const model::metrics::run_metrics& metrics,
+                              model::table::imaging_table& table,
+                              utils::workspace& workspace)
                                         INTEROP_THROW_SPEC((model::invalid_column_type, model::index_out_of_bounds_exception, model::invalid_parameter))
     {
         typedef model::table::imaging_table::column_vector_t column_vector_t;
         typedef model::table::imaging_table::data_vector_t data_vector_t;
 
-        row_offset_map_t row_offset;
+        utils::workspace::call_scope scope(workspace);
+        row_offset_map_t& row_offset = workspace.row_offsets();
         column_vector_t columns;
         create_imaging_table_columns(metrics, columns);
         if(columns.empty())return;
-        count_table_rows(metrics, row_offset);
-        data_vector_t data(row_offset.size()*count_table_columns(columns), std::numeric_limits<float>::quiet_NaN());
-        create_imaging_table_data(metrics, columns, row_offset, data.begin(), data.end());
+        count_table_rows(metrics, row_offset, workspace.keys());
+        data_vector_t& data = workspace.table_data();
+        data.assign(row_offset.size()*count_table_columns(columns), std::numeric_limits<float>::quiet_NaN());
+        create_imaging_table_data(metrics,
+                                  columns,
+                                  row_offset,
+                                  data.begin(),
+                                  data.end(),
+                                  workspace);
         table.set_data(row_offset.size(), columns, data);
     }
 
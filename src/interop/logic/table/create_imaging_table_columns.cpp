@@ -8,7 +8,6 @@
 #include "interop/logic/table/create_imaging_table_columns.h"
 
 
-#include "interop/logic/summary/map_cycle_to_read.h"
 #include "interop/logic/table/check_imaging_table_column.h"
 #include "interop/logic/metric/q_metric.h"
 #include "interop/logic/metric/dynamic_phasing_metric.h"
@@ -21,7 +20,7 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param tile_hash map between the tile has and base metric
      * @param filled destination array that indicates whether a column should be filled
      */
-    void determine_filled_columns(model::metrics::run_metrics& metrics,
+    void determine_filled_columns(const model::metrics::run_metrics& metrics,
                                   const model::metrics::run_metrics::tile_metric_map_t& tile_hash,
                                   std::vector< bool >& filled)
     {
@@ -39,12 +38,23 @@ namespace illumina { namespace interop { namespace logic { namespace table
         const constants::tile_naming_method naming_method = metrics.run_info().flowcell().naming_method();
         const size_t q20_idx = metric::index_for_q_value(metrics.get<model::metrics::q_metric>(), 20);
         const size_t q30_idx = metric::index_for_q_value(metrics.get<model::metrics::q_metric>(), 30);
+        const model::metric_base::metric_set<model::metrics::extended_tile_metric>& extended_tile_metrics =
+                metrics.get<model::metrics::extended_tile_metric>();
+        // Join the tile and extended tile metrics to each tile with batched lookups
+        std::vector< ::uint64_t > keys;
+        keys.reserve(tile_hash.size());
         for(tile_metric_map_t::const_iterator it = tile_hash.begin();it != tile_hash.end();++it)
+            keys.push_back(it->first);
+        std::vector<size_t> tile_indices;
+        std::vector<size_t> extended_tile_indices;
+        tile_metrics.find(keys, tile_indices);
+        extended_tile_metrics.find(keys, extended_tile_indices);
+        for(size_t i=0;i<tile_indices.size();++i)
         {
-            if(!tile_metrics.has_metric(it->first)) continue;
+            if(tile_indices[i] >= tile_metrics.size()) continue;
             for(model::run::info::const_read_iterator read_it = metrics.run_info().reads().begin();read_it != metrics.run_info().reads().end();++read_it)
             {
-                check_imaging_table_column::set_filled_for_metric(tile_metrics.get_metric(it->first),
+                check_imaging_table_column::set_filled_for_metric(tile_metrics[tile_indices[i]],
                                                                   read_it->number(),
                                                                   q20_idx,
                                                                   q30_idx,
@@ -52,12 +62,10 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                                                   filled);
             }
         }
-        const model::metric_base::metric_set<model::metrics::extended_tile_metric>& extended_tile_metrics =
-                metrics.get<model::metrics::extended_tile_metric>();
-        for(tile_metric_map_t::const_iterator it = tile_hash.begin();it != tile_hash.end();++it)
+        for(size_t i=0;i<extended_tile_indices.size();++i)
         {
-            if (!extended_tile_metrics.has_metric(it->first) || !tile_metrics.has_metric(it->first)) continue;
-            check_imaging_table_column::set_filled_for_metric(extended_tile_metrics.get_metric(it->first),
+            if (extended_tile_indices[i] >= extended_tile_metrics.size() || tile_indices[i] >= tile_metrics.size()) continue;
+            check_imaging_table_column::set_filled_for_metric(extended_tile_metrics[extended_tile_indices[i]],
                                                               1,
                                                               q20_idx,
                                                               q30_idx,
@@ -65,18 +73,6 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                                               filled);
         }
 
-        summary::read_cycle_vector_t cycle_to_read;
-        summary::map_read_to_cycle_number(metrics.run_info().reads().begin(),
-                                          metrics.run_info().reads().end(),
-                                          cycle_to_read);
-
-        if(metrics.get<model::metrics::dynamic_phasing_metric>().empty())
-        {
-            logic::metric::populate_dynamic_phasing_metrics(metrics.get<model::metrics::phasing_metric>(),
-                                                            cycle_to_read,
-                                                            metrics.get<model::metrics::dynamic_phasing_metric>(),
-                                                            metrics.get<model::metrics::tile_metric>());
-        }
         const model::metric_base::metric_set<model::metrics::dynamic_phasing_metric>& dynamic_phasing_metrics =
                 metrics.get<model::metrics::dynamic_phasing_metric>();
         for(tile_metric_map_t::const_iterator it = tile_hash.begin();it != tile_hash.end();++it)
@@ -200,7 +196,7 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param metrics source collection of InterOp metrics from the run
      * @param columns destination vector of column descriptors
      */
-    void create_imaging_table_columns(model::metrics::run_metrics& metrics,
+    void create_imaging_table_columns(const model::metrics::run_metrics& metrics,
                                       std::vector< model::table::imaging_column >& columns)
                                       INTEROP_THROW_SPEC((model::invalid_column_type,
                                       model::index_out_of_bounds_exception,
@@ -209,6 +205,7 @@ namespace illumina { namespace interop { namespace logic { namespace table
         typedef model::metrics::run_metrics::tile_metric_map_t tile_metric_map_t;
         std::vector< bool > filled;
         tile_metric_map_t tile_hash;
+        metrics.ensure_derived_metrics();
         metrics.populate_id_map(tile_hash);
         determine_filled_columns(metrics, tile_hash, filled);
         create_imaging_table_columns(metrics.run_info().channels(),
@@ -88,6 +88,17 @@ namespace illumina { namespace interop { namespace io
             return count;
         }
 
+        /** Record the non-zero columns of the decoded histogram in the header
+         *
+         * @param metric decoded metric
+         * @param header metric set header
+         */
+        template<class Metric>
+        static void track_decoded(const Metric& metric, q_metric::header_type& header)
+        {
+            header.track_histogram(metric.qscore_hist());
+        }
+
         /** Compute the layout size
          *
          * @return size of the record
@@ -234,6 +245,17 @@ namespace illumina { namespace interop { namespace io
             INTEROP_THROW(std::runtime_error, "Function not implemented");
         }
 
+        /** Record the non-zero columns of the decoded histogram in the header
+         *
+         * @param metric decoded metric
+         * @param header metric set header
+         */
+        template<class Metric>
+        static void track_decoded(const Metric& metric, q_metric::header_type& header)
+        {
+            header.track_histogram(metric.qscore_hist());
+        }
+
         /** Compute the layout size
          *
          * @return size of the record
@@ -447,6 +469,17 @@ namespace illumina { namespace interop { namespace io
             return count;
         }
 
+        /** Record the non-zero columns of the decoded histogram in the header
+         *
+         * @param metric decoded metric
+         * @param header metric set header
+         */
+        template<class Metric>
+        static void track_decoded(const Metric& metric, q_metric::header_type& header)
+        {
+            header.track_histogram(metric.qscore_hist());
+        }
+
         /** Compute the layout size
          *
          * @return size of the record
@@ -697,6 +730,17 @@ namespace illumina { namespace interop { namespace io
             return stream_map<count_t>(stream, metric.m_qscore_hist, header.bin_count());
         }
 
+        /** Record the non-zero columns of the decoded histogram in the header
+         *
+         * @param metric decoded metric
+         * @param header metric set header
+         */
+        template<class Metric>
+        static void track_decoded(const Metric& metric, q_metric::header_type& header)
+        {
+            header.track_histogram(metric.qscore_hist());
+        }
+
         /** Compute the layout size
          *
          * @return size of the record
@@ -9,6 +9,7 @@
 #include <omp.h>
 #endif
 
+#include <algorithm>
 #include "interop/model/run_metrics.h"
 
 #include "interop/logic/metric/q_metric.h"
@@ -17,10 +18,18 @@
 #include "interop/logic/utils/channel.h"
 #include "interop/logic/metric/dynamic_phasing_metric.h"
 #include "interop/logic/metric/extended_tile_metric.h"
+#include "interop/util/mutex.h"
 
 namespace illumina { namespace interop { namespace model { namespace metrics
 {
 
+    /** Guard for the creation of derived metric sets
+     *
+     * A single lock is shared by all runs: it is only held long enough to check that the derived sets exist,
+     * except for the first query on a run that was not finalized.
+     */
+    static util::mutex s_derived_metrics_mutex;
+
     struct clear_metric
     {
         template<class MetricSet>
@@ -33,11 +42,15 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     struct read_func
     {
         typedef const unsigned char* bool_pointer;
-        read_func(const std::string &f, bool_pointer load_metric_check=0, const bool skip_loaded=false) :
+        read_func(const std::string &f,
+                  bool_pointer load_metric_check=0,
+                  const bool skip_loaded=false,
+                  const metric_base::tile_filter* filter=0) :
                 m_run_folder(f),
                 m_load_metric_check(load_metric_check),
                 m_are_all_files_missing(true),
-                m_skip_loaded(skip_loaded)
+                m_skip_loaded(skip_loaded),
+                m_filter(filter)
         {}
 
         template<class MetricSet>
@@ -60,21 +73,11 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             {
                 metrics.clear();
             }
-            try
-            {
-                io::read_interop(m_run_folder, metrics);
-                if(m_are_all_files_missing && !is_aggregated_always) m_are_all_files_missing=false;
-            }
-            catch (const io::file_not_found_exception &)
-            {
-                return 1;
-            }
-            catch (const io::incomplete_file_exception &)
-            {
-                if(m_are_all_files_missing && !is_aggregated_always) m_are_all_files_missing=false;
-                return 2;
-            }
-            return 0;
+            // Files that are still written are read up to the last complete record, without unwinding the stack
+            const io::read_status status = io::read_available_interop(m_run_folder, metrics, true, m_filter);
+            if(status.code() == io::read_status::FileNotFound) return 1;
+            if(m_are_all_files_missing && !is_aggregated_always) m_are_all_files_missing=false;
+            return status.is_incomplete() ? 2 : 0;
         }
 
         bool are_all_files_missing()const
@@ -86,21 +89,50 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         bool_pointer m_load_metric_check;
         mutable bool m_are_all_files_missing;
         bool m_skip_loaded;
+        const metric_base::tile_filter* m_filter;
     };
 
     struct write_func
     {
-        write_func(const std::string &f, const bool use_out) : m_run_folder(f), m_use_out(use_out)
+        typedef const unsigned char* bool_pointer;
+        write_func(const std::string &f, const bool use_out, bool_pointer write_metric_check=0) :
+                m_run_folder(f),
+                m_use_out(use_out),
+                m_write_metric_check(write_metric_check)
         {}
 
         template<class MetricSet>
         void operator()(const MetricSet &metrics) const
         {
-            io::write_interop(m_run_folder, metrics, m_use_out);
+            if(m_write_metric_check != 0 && m_write_metric_check[MetricSet::TYPE] == 0) return;
+            if(metrics.empty() || metrics.version() == 0) return;
+            if(!io::write_interop(m_run_folder, metrics, m_use_out, -1, /*sync_parent=*/ false))
+                INTEROP_THROW(io::bad_format_exception, "Failed to write: "
+                        << io::interop_filename<MetricSet>(m_run_folder, m_use_out));
+            add_directory(io::dirname(io::interop_filename<MetricSet>(m_run_folder, m_use_out)));
+        }
+
+        /** Get the directories holding the files that were written
+         *
+         * @return directories to flush
+         */
+        const std::vector<std::string>& directories()const
+        {
+            return m_directories;
+        }
+
+    private:
+        void add_directory(const std::string& directory)const
+        {
+            if(std::find(m_directories.begin(), m_directories.end(), directory) == m_directories.end())
+                m_directories.push_back(directory);
         }
 
+    private:
         std::string m_run_folder;
         bool m_use_out;
+        bool_pointer m_write_metric_check;
+        mutable std::vector<std::string> m_directories;
     };
 
     struct validate_run_info
@@ -202,8 +234,11 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     {
         typedef const unsigned char* bool_pointer;
 
-        read_by_cycle_func(const std::string &f, const size_t last_cycle, bool_pointer load_metric_check=0) :
-                m_run_folder(f), m_last_cycle(last_cycle), m_load_metric_check(load_metric_check)
+        read_by_cycle_func(const std::string &f,
+                           const size_t last_cycle,
+                           bool_pointer load_metric_check=0,
+                           const metric_base::tile_filter* filter=0) :
+                m_run_folder(f), m_last_cycle(last_cycle), m_load_metric_check(load_metric_check), m_filter(filter)
         {}
 
         template<class MetricSet>
@@ -216,13 +251,263 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             {
                 return 0;
             }
-            io::read_interop_by_cycle(m_run_folder, metrics, m_last_cycle);
+            io::read_interop_by_cycle(m_run_folder, metrics, m_last_cycle, true, m_filter);
             return 0;
         }
 
         std::string m_run_folder;
         size_t m_last_cycle;
         bool_pointer m_load_metric_check;
+        const metric_base::tile_filter* m_filter;
+    };
+
+    /** Load task that reads a single metric group of a run
+     */
+    class read_group_task : public io::load_task
+    {
+    public:
+        /** Constructor
+         *
+         * @param metrics destination run metrics
+         * @param run_folder run folder path
+         * @param group index of the metric group to load
+         * @param last_cycle last cycle to search for by cycle interops
+         * @param skip_loaded skip metrics that are already loaded
+         * @param by_cycle read the by cycle interops rather than the aggregate file
+         */
+        read_group_task(run_metrics& metrics,
+                        const std::string& run_folder,
+                        const size_t group,
+                        const size_t last_cycle,
+                        const bool skip_loaded,
+                        const bool by_cycle) :
+                m_metrics(&metrics),
+                m_run_folder(run_folder),
+                m_valid_to_load(constants::MetricCount, 0),
+                m_last_cycle(last_cycle),
+                m_skip_loaded(skip_loaded),
+                m_by_cycle(by_cycle),
+                m_are_all_files_missing(true)
+        {
+            m_valid_to_load[group] = 1;
+        }
+        /** Read the metric group
+         */
+        void operator()()
+        {
+            if(m_by_cycle)
+            {
+                read_by_cycle_func read_functor(m_run_folder, m_last_cycle, &m_valid_to_load.front());
+                m_metrics->metrics_callback(read_functor);
+            }
+            else
+            {
+                read_func read_functor(m_run_folder, &m_valid_to_load.front(), m_skip_loaded);
+                m_metrics->metrics_callback(read_functor);
+                m_are_all_files_missing = read_functor.are_all_files_missing();
+            }
+        }
+        /** Test if the InterOp file for the group is missing
+         *
+         * @return true if the file is missing
+         */
+        bool are_all_files_missing()const
+        {
+            return m_are_all_files_missing;
+        }
+
+    private:
+        run_metrics* m_metrics;
+        std::string m_run_folder;
+        std::vector<unsigned char> m_valid_to_load;
+        size_t m_last_cycle;
+        bool m_skip_loaded;
+        bool m_by_cycle;
+        bool m_are_all_files_missing;
+    };
+
+    /** Load task that writes a single metric group of a run
+     */
+    class write_group_task : public io::load_task
+    {
+    public:
+        /** Constructor
+         *
+         * @param metrics source run metrics
+         * @param run_folder run folder path
+         * @param group index of the metric group to write
+         * @param use_out use the copied version
+         */
+        write_group_task(const run_metrics& metrics,
+                         const std::string& run_folder,
+                         const size_t group,
+                         const bool use_out) :
+                m_metrics(&metrics),
+                m_run_folder(run_folder),
+                m_valid_to_write(constants::MetricCount, 0),
+                m_use_out(use_out)
+        {
+            m_valid_to_write[group] = 1;
+        }
+        /** Write the metric group
+         */
+        void operator()()
+        {
+            write_func write_functor(m_run_folder, m_use_out, &m_valid_to_write.front());
+            m_metrics->metrics_callback(write_functor);
+            m_directories = write_functor.directories();
+        }
+        /** Get the directories holding the files that were written
+         *
+         * @return directories to flush
+         */
+        const std::vector<std::string>& directories()const
+        {
+            return m_directories;
+        }
+
+    private:
+        const run_metrics* m_metrics;
+        std::string m_run_folder;
+        std::vector<unsigned char> m_valid_to_write;
+        bool m_use_out;
+        std::vector<std::string> m_directories;
+    };
+
+    /** Plan how to load each metric group of a run
+     */
+    class plan_group_func
+    {
+    public:
+        /** Constructor
+         *
+         * @param run_folder run folder path
+         * @param last_cycle last cycle to search for by cycle interops
+         * @param planner load planner
+         * @param plan destination plan
+         */
+        plan_group_func(const std::string& run_folder,
+                        const size_t last_cycle,
+                        const io::load_planner& planner,
+                        io::load_plan& plan) :
+                m_run_folder(run_folder),
+                m_last_cycle(last_cycle),
+                m_planner(planner),
+                m_plan(plan)
+        {}
+        /** Plan the metric group of the given set
+         *
+         * @param metrics metric set
+         */
+        template<class MetricSet>
+        void operator()(const MetricSet& metrics)const
+        {
+            (void)metrics;
+            std::string file_name = io::interop_filename<MetricSet>(m_run_folder, true);
+            ::int64_t aggregate_size = io::file_size(file_name);
+            if(aggregate_size < 0)
+            {
+                file_name = io::interop_filename<MetricSet>(m_run_folder, false);
+                aggregate_size = io::file_size(file_name);
+            }
+            size_t cycle_file_count = 0;
+            ::uint64_t cycle_byte_count = 0;
+            if(aggregate_size < 0)
+            {
+                file_name.clear();
+                for(size_t cycle=1;cycle <= m_last_cycle;++cycle)
+                {
+                    const std::string cycle_file_name = io::interop_filename<MetricSet>(m_run_folder, cycle, true);
+                    const ::int64_t cycle_file_size = io::file_size(cycle_file_name);
+                    if(cycle_file_size < 0) continue;
+                    if(file_name.empty()) file_name = cycle_file_name;
+                    ++cycle_file_count;
+                    cycle_byte_count += static_cast< ::uint64_t >(cycle_file_size);
+                }
+            }
+            const size_t record_size = file_name.empty() ? 0 : io::peek_record_size(file_name);
+            const io::group_load_plan group_plan = m_planner.plan_group(
+                    static_cast<constants::metric_group>(MetricSet::TYPE),
+                    aggregate_size,
+                    cycle_file_count,
+                    cycle_byte_count,
+                    record_size);
+            if(group_plan.path != io::SkipLoad) m_plan.groups.push_back(group_plan);
+        }
+
+    private:
+        std::string m_run_folder;
+        size_t m_last_cycle;
+        const io::load_planner& m_planner;
+        io::load_plan& m_plan;
+    };
+
+    /** Read a single metric group following its load plan
+     */
+    class planned_read_func
+    {
+    public:
+        /** Constructor
+         *
+         * @param run_folder run folder path
+         * @param last_cycle last cycle to search for by cycle interops
+         * @param plan plan of the metric group
+         */
+        planned_read_func(const std::string& run_folder, const size_t last_cycle, const io::group_load_plan& plan) :
+                m_run_folder(run_folder),
+                m_last_cycle(last_cycle),
+                m_plan(plan)
+        {}
+        /** Read the metric set if it belongs to the planned group
+         *
+         * @param metrics destination metric set
+         */
+        template<class MetricSet>
+        void operator()(MetricSet& metrics)const
+        {
+            if(m_plan.group != static_cast<constants::metric_group>(MetricSet::TYPE)) return;
+            metrics.clear();
+            if(m_plan.path == io::ByCycleLoad)
+                io::read_available_interop_by_cycle(m_run_folder, metrics, m_last_cycle, true);
+            else
+                io::read_available_interop(m_run_folder, metrics, true, 0, m_plan.buffer_size);
+        }
+
+    private:
+        std::string m_run_folder;
+        size_t m_last_cycle;
+        io::group_load_plan m_plan;
+    };
+
+    /** Load task that reads a single metric group following its load plan
+     */
+    class planned_read_task : public io::load_task
+    {
+    public:
+        /** Constructor
+         *
+         * @param metrics destination run metrics
+         * @param run_folder run folder path
+         * @param last_cycle last cycle to search for by cycle interops
+         * @param plan plan of the metric group
+         */
+        planned_read_task(run_metrics& metrics,
+                          const std::string& run_folder,
+                          const size_t last_cycle,
+                          const io::group_load_plan& plan) :
+                m_metrics(&metrics),
+                m_read_functor(run_folder, last_cycle, plan)
+        {}
+        /** Read the metric group
+         */
+        void operator()()
+        {
+            m_metrics->metrics_callback(m_read_functor);
+        }
+
+    private:
+        run_metrics* m_metrics;
+        planned_read_func m_read_functor;
     };
 
     class read_metric_set_from_binary_buffer
@@ -314,6 +599,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      */
     void run_metrics::append_tiles(const run_metrics& metrics, const metric_base::base_metric& tile_id)
     {
+        m_has_derived_metrics = false;
         m_metrics.apply(append_tiles_functor(metrics, tile_id));
     }
 
@@ -379,6 +665,74 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         check_for_data_sources(run_folder, run_info().total_cycles());
     }
 
+    /** Read binary metrics and XML files from the run folder using a shared load scheduler
+     *
+     * @param run_folder run folder path
+     * @param scheduler shared load scheduler
+     * @param priority priority class of this load
+     * @param thread_count number of threads this load contributes to the scheduler
+     */
+    void run_metrics::read(const std::string &run_folder,
+                           io::load_scheduler& scheduler,
+                           const io::load_scheduler::priority_t priority,
+                           const size_t thread_count)
+    INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception,
+    xml::empty_xml_format_exception,
+    xml::missing_xml_element_exception,
+    xml::xml_parse_exception,
+    io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    model::invalid_channel_exception,
+    model::index_out_of_bounds_exception,
+    model::invalid_tile_naming_method,
+    model::invalid_tile_list_exception,
+    model::invalid_run_info_exception,
+    model::invalid_run_info_cycle_exception,
+    invalid_parameter))
+    {
+        clear();
+        const size_t count = read_xml(run_folder);
+        const std::vector<unsigned char> valid_to_load(constants::MetricCount, 1);
+        read_metrics(run_folder, run_info().total_cycles(), valid_to_load, scheduler, priority, thread_count);
+        finalize_after_load(count);
+    }
+
+    /** Read binary metrics and XML files from the run folder following a load plan
+     *
+     * The planner chooses the number of threads and the decode path of each group from the size of the
+     * files, the storage holding the run folder and the number of cores.
+     *
+     * @param run_folder run folder path
+     * @param planner load planner
+     * @return plan that was executed
+     */
+    io::load_plan run_metrics::read(const std::string &run_folder, const io::load_planner& planner)
+    INTEROP_THROW_SPEC((xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception,
+    xml::empty_xml_format_exception,
+    xml::missing_xml_element_exception,
+    xml::xml_parse_exception,
+    io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    model::invalid_channel_exception,
+    model::index_out_of_bounds_exception,
+    model::invalid_tile_naming_method,
+    model::invalid_tile_list_exception,
+    model::invalid_run_info_exception,
+    model::invalid_run_info_cycle_exception,
+    invalid_parameter))
+    {
+        clear();
+        const size_t count = read_xml(run_folder);
+        const io::load_plan plan = plan_load(run_folder, run_info().total_cycles(), planner);
+        read_metrics(run_folder, run_info().total_cycles(), plan);
+        finalize_after_load(count);
+        return plan;
+    }
+
     /** Read XML files: RunInfo.xml and possibly RunParameters.xml
      *
      * @param run_folder run folder path
@@ -498,6 +852,14 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         logic::metric::populate_cumulative_distribution(get<q_metric>());
         logic::metric::populate_cumulative_distribution(get<q_by_lane_metric>());
         logic::metric::populate_cumulative_distribution(get<q_collapsed_metric>());
+        if (get<q_metric>().size() > 0 && get<q_by_tile_read_metric>().size() == 0)
+        {
+            logic::summary::read_cycle_vector_t cycle_to_read;
+            logic::summary::map_read_to_cycle_number(run_info().reads().begin(),
+                                                     run_info().reads().end(),
+                                                     cycle_to_read);
+            logic::metric::create_q_metrics_by_tile_read(get<q_metric>(), cycle_to_read, get<q_by_tile_read_metric>());
+        }
 
         if(!get<model::metrics::phasing_metric>().empty())
         {
@@ -546,12 +908,66 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             validate();
             m_run_info.validate_tiles();
         }
+        m_has_derived_metrics = true;
+    }
+
+    /** Create the metric sets derived from the loaded metrics that are still missing
+     *
+     * The plot, summary and table logic take a constant run and call this function before reading any metric
+     * set. Missing derived sets are created at most once, under a lock.
+     */
+    void run_metrics::ensure_derived_metrics()const
+    {
+        util::scoped_lock lock(s_derived_metrics_mutex);
+        if(m_has_derived_metrics) return;
+        create_missing_derived_metrics();
+        m_has_derived_metrics = true;
+    }
+    /** Create the derived metric sets that are missing
+     *
+     * Each set is only created when it is empty, so sets filled by the caller are kept. The derived sets are a cache
+     * of the loaded metrics, so they are written through the mutable metric list.
+     */
+    void run_metrics::create_missing_derived_metrics()const
+    {
+        typedef metric_base::metric_set<tile_metric> tile_metric_set_t;
+        typedef metric_base::metric_set<index_metric> index_metric_set_t;
+        typedef metric_base::metric_set<q_metric> q_metric_set_t;
+        typedef metric_base::metric_set<phasing_metric> phasing_metric_set_t;
+        tile_metric_set_t& tile_metrics = m_metrics.get<tile_metric_set_t>();
+        index_metric_set_t& index_metrics = m_metrics.get<index_metric_set_t>();
+        const q_metric_set_t& q_metrics = m_metrics.get<q_metric_set_t>();
+        const phasing_metric_set_t& phasing_metrics = m_metrics.get<phasing_metric_set_t>();
+        if(!index_metrics.empty() && index_metrics.index_order().empty())
+            logic::metric::populate_indices(tile_metrics, index_metrics);
+        metric_base::metric_set<q_collapsed_metric>& collapsed_metrics =
+                m_metrics.get< metric_base::metric_set<q_collapsed_metric> >();
+        if(!q_metrics.empty() && collapsed_metrics.empty())
+            logic::metric::create_collapse_q_metrics(q_metrics, collapsed_metrics);
+        metric_base::metric_set<q_by_lane_metric>& by_lane_metrics =
+                m_metrics.get< metric_base::metric_set<q_by_lane_metric> >();
+        if(!q_metrics.empty() && by_lane_metrics.empty())
+            logic::metric::create_q_metrics_by_lane(q_metrics, by_lane_metrics, m_run_parameters.instrument_type());
+        metric_base::metric_set<dynamic_phasing_metric>& dynamic_phasing_metrics =
+                m_metrics.get< metric_base::metric_set<dynamic_phasing_metric> >();
+        if(!phasing_metrics.empty() && dynamic_phasing_metrics.empty())
+        {
+            logic::summary::read_cycle_vector_t cycle_to_read;
+            logic::summary::map_read_to_cycle_number(run_info().reads().begin(),
+                                                     run_info().reads().end(),
+                                                     cycle_to_read);
+            logic::metric::populate_dynamic_phasing_metrics(phasing_metrics,
+                                                            cycle_to_read,
+                                                            dynamic_phasing_metrics,
+                                                            tile_metrics);
+        }
     }
 
     /** Clear all the metrics
      */
     void run_metrics::clear()
     {
+        m_has_derived_metrics = false;
         m_run_info = run::info();
         m_run_parameters = run::parameters();
         m_metrics.apply(clear_metric());
@@ -592,6 +1008,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     io::bad_format_exception,
     io::incomplete_file_exception))
     {
+        m_has_derived_metrics = false;
 #ifdef _OPENMP
         if(thread_count > 1)
         {
@@ -623,17 +1040,20 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      * @param valid_to_load list of metrics to load
      * @param thread_count number of threads to use for network loading
      * @param skip_loaded skip metrics that are already loaded
+     * @param filter optional filter that selects the tiles to read (null reads all tiles)
      */
     void run_metrics::read_metrics(const std::string &run_folder,
                                    const size_t last_cycle,
                                    const std::vector<unsigned char>& valid_to_load,
                                    const size_t thread_count,
-                                   const bool skip_loaded)
+                                   const bool skip_loaded,
+                                   const metric_base::tile_filter* filter)
     INTEROP_THROW_SPEC((io::file_not_found_exception,
     io::bad_format_exception,
     io::incomplete_file_exception,
     model::invalid_parameter))
     {
+        m_has_derived_metrics = false;
         if(valid_to_load.empty())return;
         if(valid_to_load.size() != constants::MetricCount)
             INTEROP_THROW(invalid_parameter, "Boolean array valid_to_load does not match expected number of metrics: "
@@ -657,7 +1077,10 @@ namespace illumina { namespace interop { namespace model { namespace metrics
 #               pragma omp flush(exception_thrown)
                 if(exception_thrown) continue;
                 valid_to_load_local[ omp_get_thread_num() ][offset[i]] = 1;
-                read_func read_functor_l(run_folder, &valid_to_load_local[ omp_get_thread_num() ].front(), skip_loaded);
+                read_func read_functor_l(run_folder,
+                                         &valid_to_load_local[ omp_get_thread_num() ].front(),
+                                         skip_loaded,
+                                         filter);
                 try{
                     m_metrics.apply(read_functor_l);
                 }
@@ -679,7 +1102,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         }
         else{
 #endif
-            read_func read_functor(run_folder, &valid_to_load.front(), skip_loaded);
+            read_func read_functor(run_folder, &valid_to_load.front(), skip_loaded, filter);
             m_metrics.apply(read_functor);
             all_files_are_missing = read_functor.are_all_files_missing();
 #ifdef _OPENMP
@@ -703,7 +1126,10 @@ namespace illumina { namespace interop { namespace model { namespace metrics
 #               pragma omp flush(exception_thrown)
                     valid_to_load_local[ omp_get_thread_num() ][offset[i]] = 1;
                     try{
-                        m_metrics.apply(read_by_cycle_func(run_folder, last_cycle, &valid_to_load_local[ omp_get_thread_num() ].front()));
+                        m_metrics.apply(read_by_cycle_func(run_folder,
+                                                           last_cycle,
+                                                           &valid_to_load_local[ omp_get_thread_num() ].front(),
+                                                           filter));
                     }
                     catch(const std::exception& ex)
                     {
@@ -721,23 +1147,151 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             else
             {
 #endif
-                m_metrics.apply(read_by_cycle_func(run_folder, last_cycle, &valid_to_load.front()));
+                m_metrics.apply(read_by_cycle_func(run_folder, last_cycle, &valid_to_load.front(), filter));
 #ifdef _OPENMP
             }
 #endif
         }
     }
 
+    /** Read binary metrics from the run folder using a shared load scheduler
+     *
+     * This function ignores:
+     *  - Missing InterOp files
+     *  - Incomplete InterOp files
+     *  - Missing RunParameters.xml for non-legacy run folders
+     *
+     * @param run_folder run folder path
+     * @param last_cycle last cycle to search for by cycle interops
+     * @param valid_to_load list of metrics to load
+     * @param scheduler shared load scheduler
+     * @param priority priority class of this load
+     * @param thread_count number of threads this load contributes to the scheduler
+     * @param skip_loaded skip metrics that are already loaded
+     */
+    void run_metrics::read_metrics(const std::string &run_folder,
+                                   const size_t last_cycle,
+                                   const std::vector<unsigned char>& valid_to_load,
+                                   io::load_scheduler& scheduler,
+                                   const io::load_scheduler::priority_t priority,
+                                   const size_t thread_count,
+                                   const bool skip_loaded)
+    INTEROP_THROW_SPEC((io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    model::invalid_parameter))
+    {
+        m_has_derived_metrics = false;
+        if(valid_to_load.empty())return;
+        if(valid_to_load.size() != constants::MetricCount)
+            INTEROP_THROW(invalid_parameter, "Boolean array valid_to_load does not match expected number of metrics: "
+                    << valid_to_load.size() << " != " << constants::MetricCount);
+
+        std::vector<read_group_task> tasks;
+        tasks.reserve(valid_to_load.size());
+        for(size_t i=0;i<valid_to_load.size();++i)
+            if(valid_to_load[i]) tasks.push_back(read_group_task(*this, run_folder, i, last_cycle, skip_loaded, false));
+        std::vector<io::load_task*> task_pointers(tasks.size());
+        for(size_t i=0;i<tasks.size();++i) task_pointers[i] = &tasks[i];
+        scheduler.run(task_pointers, priority, thread_count);
+
+        bool all_files_are_missing = true;
+        for(size_t i=0;i<tasks.size();++i)
+            all_files_are_missing = all_files_are_missing && tasks[i].are_all_files_missing();
+        if (all_files_are_missing)
+        {
+            tasks.clear();
+            for(size_t i=0;i<valid_to_load.size();++i)
+                if(valid_to_load[i]) tasks.push_back(read_group_task(*this, run_folder, i, last_cycle, skip_loaded, true));
+            for(size_t i=0;i<tasks.size();++i) task_pointers[i] = &tasks[i];
+            scheduler.run(task_pointers, priority, thread_count);
+        }
+    }
+
+    /** Plan how to load the binary metrics of a run folder
+     *
+     * @param run_folder run folder path
+     * @param last_cycle last cycle to search for by cycle interops
+     * @param planner load planner
+     * @return plan for each metric group
+     */
+    io::load_plan run_metrics::plan_load(const std::string &run_folder,
+                                         const size_t last_cycle,
+                                         const io::load_planner& planner)const
+    {
+        io::load_plan plan = planner.begin(run_folder);
+        plan_group_func plan_functor(run_folder, last_cycle, planner, plan);
+        metrics_callback(plan_functor);
+        planner.finish(plan);
+        return plan;
+    }
+
+    /** Read binary metrics from the run folder following a load plan
+     *
+     * Each planned group is queued as a separate task on the process wide load scheduler.
+     *
+     * @param run_folder run folder path
+     * @param last_cycle last cycle to search for by cycle interops
+     * @param plan load plan from plan_load
+     */
+    void run_metrics::read_metrics(const std::string &run_folder,
+                                   const size_t last_cycle,
+                                   const io::load_plan& plan)
+    INTEROP_THROW_SPEC((io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception))
+    {
+        m_has_derived_metrics = false;
+        std::vector<planned_read_task> tasks;
+        tasks.reserve(plan.groups.size());
+        for(size_t i=0;i<plan.groups.size();++i)
+            tasks.push_back(planned_read_task(*this, run_folder, last_cycle, plan.groups[i]));
+        std::vector<io::load_task*> task_pointers(tasks.size());
+        for(size_t i=0;i<tasks.size();++i) task_pointers[i] = &tasks[i];
+        io::load_scheduler::instance().run(task_pointers, io::load_scheduler::Interactive, plan.thread_count);
+    }
+
     /** Write binary metrics to the run folder
+     *
+     * Each metric group is written to a temporary file that is flushed to disk and renamed over the InterOp file,
+     * so a reader never sees a partially written file. With more than one thread, the groups are written
+     * concurrently through the process wide load scheduler, which bounds the number of open files. The InterOp
+     * directory is flushed once after all groups are written.
      *
      * @param run_folder run folder path
-         * @param use_out use the copied version
+     * @param use_out use the copied version
+     * @param thread_count number of threads to use for writing
      */
-    void run_metrics::write_metrics(const std::string &run_folder, const bool use_out) const
+    void run_metrics::write_metrics(const std::string &run_folder, const bool use_out, const size_t thread_count) const
     INTEROP_THROW_SPEC((io::file_not_found_exception,
     io::bad_format_exception))
     {
-        m_metrics.apply(write_func(run_folder, use_out));
+        std::vector<std::string> directories;
+        if(thread_count > 1)
+        {
+            std::vector<write_group_task> tasks;
+            tasks.reserve(constants::MetricCount);
+            for(size_t i=0;i<static_cast<size_t>(constants::MetricCount);++i)
+                tasks.push_back(write_group_task(*this, run_folder, i, use_out));
+            std::vector<io::load_task*> task_pointers(tasks.size());
+            for(size_t i=0;i<tasks.size();++i) task_pointers[i] = &tasks[i];
+            io::load_scheduler::instance().run(task_pointers, io::load_scheduler::Background, thread_count);
+            for(size_t i=0;i<tasks.size();++i)
+            {
+                const std::vector<std::string>& written = tasks[i].directories();
+                for(size_t j=0;j<written.size();++j)
+                    if(std::find(directories.begin(), directories.end(), written[j]) == directories.end())
+                        directories.push_back(written[j]);
+            }
+        }
+        else
+        {
+            write_func write_functor(run_folder, use_out);
+            static_cast<const metric_list_t&>(m_metrics).apply(write_functor);
+            directories = write_functor.directories();
+        }
+        for(size_t i=0;i<directories.size();++i)
+            io::sync_directory(directories[i]);
     }
 
     /** Read a single metric set from a binary buffer
@@ -754,6 +1308,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     io::incomplete_file_exception,
     model::index_out_of_bounds_exception))
     {
+        m_has_derived_metrics = false;
         m_metrics.apply(read_metric_set_from_binary_buffer(group, buffer, buffer_size));
     }
     /** Write a single metric set to a binary buffer
@@ -769,7 +1324,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     io::bad_format_exception,
     io::incomplete_file_exception))
     {
-        m_metrics.apply(write_metric_set_to_binary_buffer(group, buffer, buffer_size));
+        static_cast<const metric_list_t&>(m_metrics).apply(write_metric_set_to_binary_buffer(group, buffer, buffer_size));
     }
 
     /** Validate whether the RunInfo.xml matches the InterOp files
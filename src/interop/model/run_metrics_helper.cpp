@@ -98,6 +98,64 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          constants::metric_group m_group;
      };
 
+     struct set_track_changes
+     {
+         set_track_changes(const bool enable) : m_enable(enable) {}
+
+         template<class MetricSet>
+         void operator()(MetricSet &metrics) const {
+             metrics.track_changes(m_enable);
+         }
+
+         bool m_enable;
+     };
+
+     struct set_retain_capacity
+     {
+         set_retain_capacity(const bool enable) : m_enable(enable) {}
+
+         template<class MetricSet>
+         void operator()(MetricSet &metrics) const {
+             metrics.retain_capacity(m_enable);
+         }
+
+         bool m_enable;
+     };
+
+     struct changed_since_for_groupid
+     {
+         changed_since_for_groupid(const constants::metric_group group,
+                                   const ::uint64_t generation,
+                                   std::vector< ::uint64_t >& ids) :
+                 m_group(group), m_generation(generation), m_ids(ids) {}
+
+         template<class MetricSet>
+         void operator()(const MetricSet &metrics) {
+             if (m_group == static_cast<constants::metric_group>(MetricSet::TYPE)) {
+                 metrics.changed_since(m_generation, m_ids);
+             }
+         }
+
+         constants::metric_group m_group;
+         ::uint64_t m_generation;
+         std::vector< ::uint64_t >& m_ids;
+     };
+
+     struct generation_for_groupid
+     {
+         generation_for_groupid(const constants::metric_group group) : m_generation(0), m_group(group) {}
+
+         template<class MetricSet>
+         void operator()(const MetricSet &metrics) {
+             if (m_group == static_cast<constants::metric_group>(MetricSet::TYPE)) {
+                 m_generation = metrics.generation();
+             }
+         }
+
+         ::uint64_t m_generation;
+         constants::metric_group m_group;
+     };
+
      struct check_if_group_is_empty
      {
          check_if_group_is_empty(const std::string &name) : m_empty(true), m_prefix(name) {}
@@ -342,6 +400,47 @@ namespace illumina { namespace interop { namespace model { namespace metrics
                     m_metrics.apply(func);
                     return func.empty();
                 }
+                /** Enable or disable change tracking in every metric set
+                 *
+                 * @param enable true to stamp inserted and updated records
+                 */
+                void run_metrics::track_changes(const bool enable)
+                {
+                    m_metrics.apply(set_track_changes(enable));
+                }
+                /** Enable or disable retaining the allocated capacity of every metric set when the run is cleared
+                 *
+                 * @param enable true to keep the allocated capacity when the run is cleared
+                 */
+                void run_metrics::retain_capacity(const bool enable)
+                {
+                    m_metrics.apply(set_retain_capacity(enable));
+                }
+                /** Get the current generation of a metric group
+                 *
+                 * @param group_id id of interop group metric
+                 * @return current generation of the group, 0 if the group is not found
+                 */
+                ::uint64_t run_metrics::generation(const constants::metric_group group_id) const
+                {
+                    generation_for_groupid func(group_id);
+                    m_metrics.apply(func);
+                    return func.m_generation;
+                }
+                /** Get the ids of the records of a metric group changed since a generation
+                 *
+                 * @param group_id id of interop group metric
+                 * @param generation generation saved by the consumer
+                 * @param ids destination ids of the records stamped after the given generation
+                 */
+                void run_metrics::changed_since(const constants::metric_group group_id,
+                                                const ::uint64_t generation,
+                                                std::vector< ::uint64_t >& ids) const
+                {
+                    ids.clear();
+                    changed_since_for_groupid func(group_id, generation, ids);
+                    m_metrics.apply(func);
+                }
 
                 /** Populate a map of valid tiles and cycles
                  *
@@ -11,19 +11,25 @@
 #include "interop/util/filesystem.h"
 
 #ifdef WIN32
+#include <windows.h>
 #include <direct.h>
+#include <io.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 /** Platform dependent path separator */
 #define INTEROP_OS_SEP '\\'
 #else
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 /** Platform dependent path separator */
 #define INTEROP_OS_SEP '/'
 #endif
 
 #include <algorithm>
 #include <fstream>
+#include <cstdio>
 
 namespace illumina { namespace interop { namespace io
 {
@@ -166,6 +172,59 @@ namespace illumina { namespace interop { namespace io
 #       endif
 
     }
+    /** Flush the contents of a file to the storage device
+     *
+     * @param path path to the target file
+     * @return true if the file was flushed
+     */
+    bool sync_file(const std::string& path)
+    {
+#       ifdef WIN32
+            const int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+            if (fd < 0) return false;
+            const bool synced = _commit(fd) == 0;
+            return (_close(fd) == 0) && synced;
+#       else
+            const int fd = ::open(path.c_str(), O_RDWR);
+            if (fd < 0) return false;
+            const bool synced = ::fsync(fd) == 0;
+            return (::close(fd) == 0) && synced;
+#       endif
+    }
+    /** Flush the entries of a directory to the storage device
+     *
+     * This makes a file created or renamed in the directory durable. It does nothing on Windows, where a
+     * directory cannot be flushed.
+     *
+     * @param path path to the target directory, an empty path is the current directory
+     * @return true if the directory was flushed
+     */
+    bool sync_directory(const std::string& path)
+    {
+#       ifdef WIN32
+            (void)path;
+            return true;
+#       else
+            const int fd = ::open(path.empty() ? "." : path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            const bool synced = ::fsync(fd) == 0;
+            return (::close(fd) == 0) && synced;
+#       endif
+    }
+    /** Rename a file, replacing the destination if it exists
+     *
+     * On the same file system, the destination either refers to the old file or the new file, never a partial file.
+     *
+     * @param from path to the source file
+     * @param to path to the destination file
+     * @return true if the file was renamed
+     */
+    bool rename_file(const std::string& from, const std::string& to)
+    {
+#       ifdef WIN32
+            return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#       else
+            return ::rename(from.c_str(), to.c_str()) == 0;
+#       endif
+    }
 }}}
-
-
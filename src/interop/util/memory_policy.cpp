@@ -0,0 +1,106 @@
+/** Placement policy for large metric buffers
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/util/memory_policy.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <dirent.h>
+#include <cstring>
+#endif
+
+#include "interop/util/cstdint.h"
+
+namespace illumina { namespace interop { namespace util
+{
+    bool memory_policy::s_use_huge_pages = false;
+
+    /** Enable or disable huge page advice for large buffers
+     *
+     * @param enable true to advise huge pages for large buffers
+     */
+    void memory_policy::use_huge_pages(const bool enable)
+    {
+        s_use_huge_pages = enable;
+    }
+    /** Test if huge page advice is enabled
+     *
+     * @return true if huge page advice is enabled
+     */
+    bool memory_policy::use_huge_pages()
+    {
+        return s_use_huge_pages;
+    }
+    /** Test if the platform supports huge page advice
+     *
+     * @return true if huge page advice is supported
+     */
+    bool memory_policy::is_huge_page_supported()
+    {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        return true;
+#else
+        return false;
+#endif
+    }
+    /** Get the size of a huge page
+     *
+     * @return size of a huge page in bytes
+     */
+    size_t memory_policy::huge_page_size()
+    {
+        return static_cast<size_t>(2) * 1024 * 1024;
+    }
+    /** Get the number of NUMA nodes on this machine
+     *
+     * @return number of NUMA nodes, 1 if unknown
+     */
+    size_t memory_policy::numa_node_count()
+    {
+#ifdef __linux__
+        DIR* dir = opendir("/sys/devices/system/node");
+        if (dir == 0) return 1;
+        size_t count = 0;
+        for (struct dirent* entry = readdir(dir); entry != 0; entry = readdir(dir))
+        {
+            if (std::strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9')
+                ++count;
+        }
+        closedir(dir);
+        return count == 0 ? 1 : count;
+#else
+        return 1;
+#endif
+    }
+    /** Advise the kernel to back a large buffer with huge pages
+     *
+     * Only the huge page aligned interior of the buffer is advised. Buffers smaller than a huge page are left
+     * alone, as is every buffer when the policy is disabled.
+     *
+     * @param ptr pointer to the buffer
+     * @param byte_count size of the buffer in bytes
+     * @return true if the advice was given
+     */
+    bool memory_policy::advise(const void* ptr, const size_t byte_count)
+    {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (!s_use_huge_pages || ptr == 0) return false;
+        const ::uintptr_t page_size = static_cast< ::uintptr_t >(huge_page_size());
+        const ::uintptr_t beg = reinterpret_cast< ::uintptr_t >(ptr);
+        const ::uintptr_t first = (beg + page_size - 1) & ~(page_size - 1);
+        const ::uintptr_t last = (beg + byte_count) & ~(page_size - 1);
+        if (last <= first) return false;
+        return madvise(reinterpret_cast<void*>(first), static_cast<size_t>(last - first), MADV_HUGEPAGE) == 0;
+#else
+        (void)ptr;
+        (void)byte_count;
+        return false;
+#endif
+    }
+
+}}}
@@ -0,0 +1,108 @@
+/** Portable mutex and condition variable
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/util/mutex.h"
+
+#if defined(_WIN32)
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#   include <pthread.h>
+#   define INTEROP_HAS_PTHREAD 1
+#endif
+
+namespace illumina { namespace interop { namespace util
+{
+#if defined(_WIN32)
+    mutex::mutex() : m_handle(new CRITICAL_SECTION)
+    {
+        InitializeCriticalSection(static_cast<CRITICAL_SECTION*>(m_handle));
+    }
+    mutex::~mutex()
+    {
+        DeleteCriticalSection(static_cast<CRITICAL_SECTION*>(m_handle));
+        delete static_cast<CRITICAL_SECTION*>(m_handle);
+    }
+    void mutex::lock()
+    {
+        EnterCriticalSection(static_cast<CRITICAL_SECTION*>(m_handle));
+    }
+    void mutex::unlock()
+    {
+        LeaveCriticalSection(static_cast<CRITICAL_SECTION*>(m_handle));
+    }
+
+    condition_variable::condition_variable() : m_handle(new CONDITION_VARIABLE)
+    {
+        InitializeConditionVariable(static_cast<CONDITION_VARIABLE*>(m_handle));
+    }
+    condition_variable::~condition_variable()
+    {
+        delete static_cast<CONDITION_VARIABLE*>(m_handle);
+    }
+    void condition_variable::wait(mutex& lock)
+    {
+        SleepConditionVariableCS(static_cast<CONDITION_VARIABLE*>(m_handle),
+                                 static_cast<CRITICAL_SECTION*>(lock.m_handle),
+                                 INFINITE);
+    }
+    void condition_variable::notify_all()
+    {
+        WakeAllConditionVariable(static_cast<CONDITION_VARIABLE*>(m_handle));
+    }
+#elif defined(INTEROP_HAS_PTHREAD)
+    mutex::mutex() : m_handle(new pthread_mutex_t)
+    {
+        pthread_mutex_init(static_cast<pthread_mutex_t*>(m_handle), 0);
+    }
+    mutex::~mutex()
+    {
+        pthread_mutex_destroy(static_cast<pthread_mutex_t*>(m_handle));
+        delete static_cast<pthread_mutex_t*>(m_handle);
+    }
+    void mutex::lock()
+    {
+        pthread_mutex_lock(static_cast<pthread_mutex_t*>(m_handle));
+    }
+    void mutex::unlock()
+    {
+        pthread_mutex_unlock(static_cast<pthread_mutex_t*>(m_handle));
+    }
+
+    condition_variable::condition_variable() : m_handle(new pthread_cond_t)
+    {
+        pthread_cond_init(static_cast<pthread_cond_t*>(m_handle), 0);
+    }
+    condition_variable::~condition_variable()
+    {
+        pthread_cond_destroy(static_cast<pthread_cond_t*>(m_handle));
+        delete static_cast<pthread_cond_t*>(m_handle);
+    }
+    void condition_variable::wait(mutex& lock)
+    {
+        pthread_cond_wait(static_cast<pthread_cond_t*>(m_handle), static_cast<pthread_mutex_t*>(lock.m_handle));
+    }
+    void condition_variable::notify_all()
+    {
+        pthread_cond_broadcast(static_cast<pthread_cond_t*>(m_handle));
+    }
+#else
+    mutex::mutex() : m_handle(0){}
+    mutex::~mutex(){}
+    void mutex::lock(){}
+    void mutex::unlock(){}
+
+    condition_variable::condition_variable() : m_handle(0){}
+    condition_variable::~condition_variable(){}
+    void condition_variable::wait(mutex&){}
+    void condition_variable::notify_all(){}
+#endif
+}}}
+
@@ -0,0 +1,98 @@
+/** Unit tests for the built-in PNG and SVG plot renderer
+ *
+ *  @file
+ *  @date  10/19/2026
+ *  @version 1.0
+ *  @copyright GNU Public License
+ */
+#include <gtest/gtest.h>
+#include <limits>
+#include <sstream>
+#include "interop/io/plot/image_writer.h"
+
+using namespace illumina::interop;
+
+namespace
+{
+    /** Read a big-endian 32-bit integer from a string
+     *
+     * @param data string
+     * @param offset offset of the first byte
+     * @return integer
+     */
+    ::uint32_t read_uint32(const std::string& data, const size_t offset)
+    {
+        ::uint32_t value = 0;
+        for (size_t i = 0; i < 4; ++i) value = (value << 8) | static_cast< ::uint8_t >(data[offset + i]);
+        return value;
+    }
+}
+
+TEST(image_writer_test, png_header_and_compression)
+{
+    io::plot::raster_image image(300, 200, io::plot::rgb_color(10, 20, 30));
+    std::ostringstream out;
+    io::plot::write_png(out, image);
+    const std::string png = out.str();
+
+    ASSERT_GT(png.size(), 33u);
+    EXPECT_EQ("\x89PNG", png.substr(0, 4));
+    EXPECT_EQ("IHDR", png.substr(12, 4));
+    EXPECT_EQ(300u, read_uint32(png, 16));
+    EXPECT_EQ(200u, read_uint32(png, 20));
+    EXPECT_EQ("IDAT", png.substr(37, 4));
+    // A flat image is almost entirely encoded as matches
+    EXPECT_LT(read_uint32(png, 33), 300u * 200u * 3u / 50u);
+    EXPECT_EQ("IEND", png.substr(png.size() - 8, 4));
+}
+
+TEST(image_writer_test, render_flowcell_cells)
+{
+    model::plot::flowcell_data data;
+    data.resize(2, 1, 2);
+    data.set_data(0, 0, 1101, 1.0f);
+    data.set_data(0, 1, 1102, 3.0f);
+    data.set_data(1, 0, 2101, 2.0f);
+    data.set_data(1, 1, 2102, std::numeric_limits<float>::quiet_NaN());
+    data.set_range(1.0f, 3.0f);
+
+    io::plot::image_writer writer(io::plot::image_writer::PNG, 180, 155, 4);
+    io::plot::raster_image image;
+    writer.render_flowcell(data, image);
+    ASSERT_EQ(180u, image.width());
+    ASSERT_EQ(155u, image.height());
+    // Plot area spans x 10-100 and y 30-130: three columns (two lanes and a gap) by two tiles
+    const io::plot::rgb_color low = image.at(25, 55);
+    const io::plot::rgb_color high = image.at(25, 105);
+    const io::plot::rgb_color missing = image.at(85, 105);
+    const io::plot::rgb_color gap = image.at(55, 55);
+    EXPECT_EQ(138, low.r);
+    EXPECT_EQ(43, low.g);
+    EXPECT_EQ(226, low.b);
+    EXPECT_EQ(255, high.r);
+    EXPECT_EQ(165, high.g);
+    EXPECT_EQ(0, high.b);
+    EXPECT_EQ(224, missing.r);
+    EXPECT_EQ(255, gap.g);
+}
+
+TEST(image_writer_test, write_svg_chart)
+{
+    model::plot::plot_data<model::plot::bar_point> data;
+    data.push_back(model::plot::series<model::plot::bar_point>("Q <30", "DarkGreen",
+                                                               model::plot::series<model::plot::bar_point>::Bar));
+    data[0].push_back(model::plot::bar_point(10, 5, 1));
+    data[0].push_back(model::plot::bar_point(20, 7, 1));
+    data.set_range(0, 30, 0, 10);
+    data.set_title("Q-score & histogram");
+
+    io::plot::image_writer writer(io::plot::image_writer::SVG, 400, 300);
+    std::ostringstream out;
+    writer.write_chart(out, data);
+    const std::string svg = out.str();
+    EXPECT_NE(std::string::npos, svg.find("<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"400\" height=\"300\""));
+    EXPECT_NE(std::string::npos, svg.find(">Q-score &amp; histogram</text>"));
+    EXPECT_NE(std::string::npos, svg.find(">Q &lt;30</text>"));
+    EXPECT_NE(std::string::npos, svg.find("fill=\"#006400\""));
+    EXPECT_EQ("</svg>\n", svg.substr(svg.size() - 7));
+}
@@ -0,0 +1,92 @@
+/** Unit tests for the kernel I/O hints
+ *
+ *  @file
+ *  @date  10/19/2026
+ *  @version 1.0
+ *  @copyright GNU Public License
+ */
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "interop/io/io_hints.h"
+#include "interop/io/metric_file_stream.h"
+#include "interop/util/filesystem.h"
+#include "src/tests/interop/metrics/inc/error_metrics_test.h"
+
+using namespace illumina::interop;
+
+TEST(io_hints_test, prefetcher_is_inactive_without_files_or_hints)
+{
+    EXPECT_FALSE(io::io_hints::use_hints());
+    EXPECT_FALSE(io::io_hints::will_need("io_hints_test_missing_file.bin"));
+    EXPECT_FALSE(io::io_hints::dont_need("io_hints_test_missing_file.bin"));
+
+    const std::vector<std::string> one_file(1, "io_hints_test_missing_file.bin");
+    io::cycle_prefetcher single(one_file);
+    EXPECT_FALSE(single.is_active());
+
+    const std::vector<std::string> file_names(3, "io_hints_test_missing_file.bin");
+    io::io_hints::use_hints(false);
+    {
+        io::cycle_prefetcher disabled(file_names);
+        EXPECT_FALSE(disabled.is_active());
+        disabled.advance(0);
+        disabled.done(0);
+        EXPECT_EQ(0u, disabled.prefetch_count());
+    }
+    io::io_hints::use_hints(true);
+    {
+        io::cycle_prefetcher enabled(file_names);
+        EXPECT_EQ(io::io_hints::is_supported(), enabled.is_active());
+        enabled.advance(0);
+        EXPECT_LE(enabled.prefetch_count(), file_names.size());
+    }
+    io::io_hints::use_hints(false);
+}
+
+TEST(io_hints_test, read_by_cycle_with_prefetch)
+{
+    typedef model::metric_base::metric_set<model::metrics::error_metric> error_metric_set;
+    const std::string run_folder = "io_hints_test_run";
+    const size_t cycle_count = 3;
+    io::mkdir(run_folder);
+    io::mkdir(io::combine(run_folder, "InterOp"));
+    error_metric_set expected;
+    unittest::error_metric_v3::create_expected(expected);
+    std::vector<std::string> file_names;
+    for(size_t cycle=1;cycle<=cycle_count;++cycle)
+    {
+        file_names.push_back(io::interop_filename<error_metric_set>(run_folder, cycle));
+        io::mkdir(io::dirname(file_names.back()));
+        error_metric_set cycle_metrics(expected.version());
+        cycle_metrics.insert(expected[cycle-1]);
+        ASSERT_TRUE(io::write_interop(file_names.back(), cycle_metrics));
+    }
+
+    const size_t depth = io::io_hints::prefetch_depth();
+    const io::cache_drop_policy policy = io::io_hints::drop_policy();
+    io::io_hints::use_hints(true);
+    io::io_hints::prefetch_depth(1);
+    io::io_hints::drop_policy(io::AlwaysDropCache);
+    error_metric_set actual;
+    io::read_interop_by_cycle(run_folder, actual, cycle_count);
+    io::io_hints::use_hints(false);
+    io::io_hints::prefetch_depth(depth);
+    io::io_hints::drop_policy(policy);
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for(size_t i=0;i<expected.size();++i)
+    {
+        EXPECT_EQ(expected[i].id(), actual[i].id());
+        EXPECT_NEAR(expected[i].error_rate(), actual[i].error_rate(), 1e-7);
+    }
+
+    for(size_t i=0;i<file_names.size();++i)
+    {
+        std::remove(file_names[i].c_str());
+        std::remove(io::dirname(file_names[i]).c_str());
+    }
+    std::remove(io::combine(run_folder, "InterOp").c_str());
+    std::remove(run_folder.c_str());
+}
@@ -0,0 +1,148 @@
+/** Unit tests for the load planner
+ *
+ *  @file
+ *  @date  10/19/2026
+ *  @version 1.0
+ *  @copyright GNU Public License
+ */
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <string>
+#include "interop/io/load_planner.h"
+#include "interop/util/filesystem.h"
+#include "interop/model/run_metrics.h"
+#include "src/tests/interop/metrics/inc/error_metrics_test.h"
+
+using namespace illumina::interop;
+
+TEST(load_planner_test, plan_group_path)
+{
+    io::load_tuning tuning;
+    tuning.small_file_size = 1000;
+    tuning.buffer_size = 4096;
+    const io::load_planner planner(tuning);
+
+    const io::group_load_plan small = planner.plan_group(constants::Error, 500, 0, 0, 10);
+    EXPECT_EQ(io::StreamLoad, small.path);
+    EXPECT_EQ(0u, small.buffer_size);
+    EXPECT_EQ(50u, small.record_count);
+
+    const io::group_load_plan large = planner.plan_group(constants::Q, 100000, 0, 0, 10);
+    EXPECT_EQ(io::BufferedLoad, large.path);
+    EXPECT_EQ(4096u, large.buffer_size);
+
+    const io::group_load_plan by_cycle = planner.plan_group(constants::Extraction, -1, 25, 25000, 0);
+    EXPECT_EQ(io::ByCycleLoad, by_cycle.path);
+    EXPECT_EQ(25u, by_cycle.file_count);
+    EXPECT_EQ(0u, by_cycle.record_count);
+
+    EXPECT_EQ(io::SkipLoad, planner.plan_group(constants::Index, -1, 0, 0, 0).path);
+}
+
+TEST(load_planner_test, thread_count_by_storage)
+{
+    io::load_tuning tuning;
+    tuning.network_thread_limit = 2;
+    tuning.rotational_thread_limit = 1;
+    const io::load_planner planner(tuning);
+    io::load_plan plan;
+    plan.core_count = 8;
+    plan.storage = io::LocalStorage;
+    for(int i=0;i<5;++i) plan.groups.push_back(planner.plan_group(constants::Q, 1<<20, 0, 0, 0));
+    plan.groups.push_back(planner.plan_group(constants::Error, 10, 0, 0, 0));
+
+    planner.finish(plan);
+    EXPECT_EQ(5u, plan.thread_count);
+    plan.storage = io::NetworkStorage;
+    planner.finish(plan);
+    EXPECT_EQ(2u, plan.thread_count);
+    plan.storage = io::RotationalStorage;
+    planner.finish(plan);
+    EXPECT_EQ(1u, plan.thread_count);
+}
+
+TEST(load_planner_test, tuning_round_trip)
+{
+    const std::string config_file = "load_planner_test_tuning.txt";
+    io::load_tuning tuning;
+    tuning.buffer_size = 262144;
+    tuning.network_thread_limit = 3;
+    EXPECT_TRUE(io::write_load_tuning(config_file, "/mnt/a", tuning));
+    EXPECT_TRUE(io::write_load_tuning(config_file, "/mnt/b", io::load_tuning()));
+    tuning.small_file_size = 1234;
+    EXPECT_TRUE(io::write_load_tuning(config_file, "/mnt/a", tuning));
+
+    io::load_tuning actual;
+    EXPECT_TRUE(io::read_load_tuning(config_file, "/mnt/a", actual));
+    EXPECT_EQ(1234u, actual.small_file_size);
+    EXPECT_EQ(262144u, actual.buffer_size);
+    EXPECT_EQ(3u, actual.network_thread_limit);
+    EXPECT_TRUE(io::read_load_tuning(config_file, "/mnt/b", actual));
+    EXPECT_EQ(io::load_tuning().buffer_size, actual.buffer_size);
+    EXPECT_FALSE(io::read_load_tuning(config_file, "/mnt/c", actual));
+    std::remove(config_file.c_str());
+}
+
+TEST(load_planner_test, calibrate_buffer_size_and_threads)
+{
+    const std::string probe_file = "load_planner_test_probe.bin";
+    {
+        std::ofstream fout(probe_file.c_str(), std::ios::binary);
+        const std::vector<char> block(1024*1024, 'x');
+        for(size_t i=0;i<8;++i) fout.write(&block.front(), static_cast<std::streamsize>(block.size()));
+    }
+    io::load_tuning tuning;
+    tuning.local_thread_limit = 3;
+    tuning.rotational_thread_limit = 3;
+    tuning.network_thread_limit = 3;
+    const io::load_tuning actual = io::load_planner(tuning).calibrate(probe_file);
+    std::remove(probe_file.c_str());
+
+    EXPECT_TRUE(actual.buffer_size == 64*1024 || actual.buffer_size == 256*1024 ||
+                actual.buffer_size == 1024*1024 || actual.buffer_size == 4*1024*1024) << actual.buffer_size;
+    const size_t limits[] = {actual.local_thread_limit, actual.rotational_thread_limit, actual.network_thread_limit};
+    size_t calibrated_count = 0;
+    for(size_t i=0;i<3;++i)
+    {
+        if(limits[i] == 3) continue;
+        EXPECT_TRUE(limits[i] == 1 || limits[i] == 2 || limits[i] == 4 || limits[i] == 8) << limits[i];
+        ++calibrated_count;
+    }
+#ifdef _OPENMP
+    EXPECT_EQ(1u, calibrated_count);
+#else
+    EXPECT_EQ(0u, calibrated_count);
+#endif
+}
+
+TEST(load_planner_test, read_metrics_following_plan)
+{
+    typedef model::metric_base::metric_set<model::metrics::error_metric> error_metric_set;
+    const std::string run_folder = "load_planner_test_run";
+    io::mkdir(run_folder);
+    io::mkdir(io::combine(run_folder, "InterOp"));
+    error_metric_set expected;
+    unittest::error_metric_v3::create_expected(expected);
+    io::write_interop(run_folder, expected);
+
+    io::load_tuning tuning;
+    tuning.small_file_size = 1;
+    model::metrics::run_metrics run;
+    const io::load_plan plan = run.plan_load(run_folder, 3, io::load_planner(tuning));
+    ASSERT_EQ(1u, plan.groups.size());
+    EXPECT_EQ(constants::Error, plan.groups[0].group);
+    EXPECT_EQ(io::BufferedLoad, plan.groups[0].path);
+    EXPECT_EQ(expected.size(), plan.groups[0].record_count);
+    ASSERT_TRUE(plan.find(constants::Error) != 0);
+    EXPECT_TRUE(plan.find(constants::Q) == 0);
+
+    run.read_metrics(run_folder, 3, plan);
+    EXPECT_EQ(expected.size(), run.get<model::metrics::error_metric>().size());
+
+    const std::string file_name = io::interop_filename<error_metric_set>(run_folder);
+    std::remove(file_name.c_str());
+    std::remove(io::combine(run_folder, "InterOp").c_str());
+    std::remove(run_folder.c_str());
+}
@@ -0,0 +1,151 @@
+/** Unit tests for the shared load scheduler
+ *
+ *  @file
+ *  @date  10/19/2026
+ *  @version 1.0
+ *  @copyright GNU Public License
+ */
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include "interop/io/load_scheduler.h"
+#include "interop/model/run_metrics.h"
+
+using namespace illumina::interop;
+
+/** Task that records its name when executed */
+struct record_task : public io::load_task
+{
+    record_task(const std::string& name, std::vector<std::string>& log) : m_name(name), m_log(&log){}
+    void operator()()
+    {
+        m_log->push_back(m_name);
+    }
+    std::string m_name;
+    std::vector<std::string>* m_log;
+};
+
+/** Task that submits an interactive load while it executes */
+struct nested_interactive_task : public io::load_task
+{
+    nested_interactive_task(io::load_scheduler& scheduler, std::vector<io::load_task*>& tasks, std::vector<std::string>& log) :
+            m_scheduler(&scheduler), m_tasks(&tasks), m_log(&log){}
+    void operator()()
+    {
+        m_log->push_back("B1-start");
+        m_scheduler->run(*m_tasks, io::load_scheduler::Interactive);
+        m_log->push_back("B1-end");
+    }
+    io::load_scheduler* m_scheduler;
+    std::vector<io::load_task*>* m_tasks;
+    std::vector<std::string>* m_log;
+};
+
+/** Task that always fails */
+struct failing_task : public io::load_task
+{
+    void operator()()
+    {
+        throw std::runtime_error("failed task");
+    }
+};
+
+/** Task that fails because its file is missing */
+struct missing_file_task : public io::load_task
+{
+    void operator()()
+    {
+        INTEROP_THROW(io::file_not_found_exception, "missing file");
+    }
+};
+
+TEST(load_scheduler_test, runs_all_tasks_in_order)
+{
+    io::load_scheduler scheduler(2);
+    std::vector<std::string> log;
+    record_task t1("1", log), t2("2", log), t3("3", log);
+    std::vector<io::load_task*> tasks;
+    tasks.push_back(&t1);
+    tasks.push_back(&t2);
+    tasks.push_back(&t3);
+    scheduler.run(tasks, io::load_scheduler::Background);
+    ASSERT_EQ(log.size(), 3u);
+    EXPECT_EQ(log[0], "1");
+    EXPECT_EQ(log[2], "3");
+    EXPECT_EQ(scheduler.open_files(), 0u);
+    EXPECT_EQ(scheduler.pending_count(io::load_scheduler::Background), 0u);
+}
+
+TEST(load_scheduler_test, interactive_load_preempts_background)
+{
+    io::load_scheduler scheduler(4);
+    std::vector<std::string> log;
+    record_task i1("I1", log), i2("I2", log), b2("B2", log), b3("B3", log);
+    std::vector<io::load_task*> interactive_tasks;
+    interactive_tasks.push_back(&i1);
+    interactive_tasks.push_back(&i2);
+    nested_interactive_task b1(scheduler, interactive_tasks, log);
+    std::vector<io::load_task*> background_tasks;
+    background_tasks.push_back(&b1);
+    background_tasks.push_back(&b2);
+    background_tasks.push_back(&b3);
+    scheduler.run(background_tasks, io::load_scheduler::Background);
+
+    // The interactive load never picks up the queued background tasks
+    ASSERT_EQ(log.size(), 6u);
+    EXPECT_EQ(log[0], "B1-start");
+    EXPECT_EQ(log[1], "I1");
+    EXPECT_EQ(log[2], "I2");
+    EXPECT_EQ(log[3], "B1-end");
+    EXPECT_EQ(log[4], "B2");
+    EXPECT_EQ(log[5], "B3");
+}
+
+TEST(load_scheduler_test, failed_task_throws)
+{
+    io::load_scheduler scheduler;
+    std::vector<std::string> log;
+    failing_task fail;
+    record_task t2("2", log);
+    std::vector<io::load_task*> tasks;
+    tasks.push_back(&fail);
+    tasks.push_back(&t2);
+    EXPECT_THROW(scheduler.run(tasks, io::load_scheduler::Interactive), io::bad_format_exception);
+    EXPECT_TRUE(log.empty());
+    EXPECT_EQ(scheduler.open_files(), 0u);
+}
+
+TEST(load_scheduler_test, failed_task_keeps_exception_type)
+{
+    io::load_scheduler scheduler(1);
+    std::vector<std::string> log;
+    missing_file_task fail;
+    record_task t2("2", log);
+    std::vector<io::load_task*> tasks;
+    tasks.push_back(&t2);
+    tasks.push_back(&fail);
+    EXPECT_THROW(scheduler.run(tasks, io::load_scheduler::Interactive, 2), io::file_not_found_exception);
+    EXPECT_EQ(scheduler.open_files(), 0u);
+}
+
+TEST(load_scheduler_test, max_open_files)
+{
+    io::load_scheduler scheduler(3);
+    EXPECT_EQ(scheduler.max_open_files(), 3u);
+    scheduler.max_open_files(1);
+    EXPECT_EQ(scheduler.max_open_files(), 1u);
+    EXPECT_THROW(scheduler.max_open_files(0), model::invalid_parameter);
+}
+
+TEST(load_scheduler_test, run_metrics_missing_files)
+{
+    io::load_scheduler scheduler;
+    model::metrics::run_metrics metrics;
+    const std::vector<unsigned char> valid_to_load(constants::MetricCount, 1);
+    EXPECT_NO_THROW(metrics.read_metrics("/NO/RUN/FOLDER", 3, valid_to_load, scheduler, io::load_scheduler::Interactive, 2));
+    EXPECT_TRUE(metrics.empty());
+    EXPECT_THROW(metrics.read_metrics("/NO/RUN/FOLDER", 3, std::vector<unsigned char>(2, 1), scheduler,
+                                      io::load_scheduler::Interactive),
+                 model::invalid_parameter);
+}
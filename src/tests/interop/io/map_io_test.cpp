@@ -0,0 +1,88 @@
+/** Unit tests for the bulk array paths of map_io
+ *
+ *  @file
+ *  @date  10/19/2026
+ *  @version 1.0
+ *  @copyright GNU Public License
+ */
+#include <gtest/gtest.h>
+#include <vector>
+#include <sstream>
+#include "interop/io/format/map_io.h"
+
+using namespace illumina::interop;
+
+/** Build an array of 16-bit values that spans more than one conversion block
+ */
+static std::vector< ::uint16_t > ushort_values()
+{
+    std::vector< ::uint16_t > values(io::bulk_convert_block_size*2+13);
+    for(size_t i=0;i<values.size();++i) values[i] = static_cast< ::uint16_t >(i*257+3);
+    values[1] = 65535;
+    values[2] = 0;
+    return values;
+}
+
+TEST(map_io, bulk_convert_matches_scalar)
+{
+    const std::vector< ::uint16_t > ushorts = ushort_values();
+    std::vector<float> floats(ushorts.size());
+    io::bulk_convert(&ushorts[0], &floats[0], ushorts.size());
+    for(size_t i=0;i<ushorts.size();++i)
+        EXPECT_EQ(static_cast<float>(ushorts[i]), floats[i]) << i;
+
+    for(size_t i=0;i<floats.size();++i) floats[i] += 0.75f;
+    std::vector< ::uint16_t > narrowed(floats.size());
+    io::bulk_convert(&floats[0], &narrowed[0], floats.size());
+    for(size_t i=0;i<floats.size();++i)
+        EXPECT_EQ(static_cast< ::uint16_t >(floats[i]), narrowed[i]) << i;
+
+    std::vector< ::uint8_t > bytes(ushorts.size());
+    io::bulk_convert(&ushorts[0], &bytes[0], ushorts.size());
+    for(size_t i=0;i<ushorts.size();++i)
+        EXPECT_EQ(static_cast< ::uint8_t >(ushorts[i]), bytes[i]) << i;
+}
+
+TEST(map_io, read_write_array_round_trip)
+{
+    const std::vector< ::uint16_t > ushorts = ushort_values();
+    std::ostringstream out;
+    io::stream_map< ::uint16_t >(out, ushorts, ushorts.size());
+    const std::string buffer = out.str();
+    ASSERT_EQ(ushorts.size()*sizeof(::uint16_t), buffer.size());
+
+    std::vector<float> from_stream;
+    std::istringstream in(buffer);
+    EXPECT_EQ(static_cast<std::streamsize>(buffer.size()),
+              io::stream_map< ::uint16_t >(in, from_stream, ushorts.size()));
+    std::vector<float> from_buffer;
+    std::vector<char> copy(buffer.begin(), buffer.end());
+    char* ptr = &copy[0];
+    EXPECT_EQ(static_cast<std::streamsize>(buffer.size()),
+              io::stream_map< ::uint16_t >(ptr, from_buffer, 1, ushorts.size()));
+    EXPECT_EQ(&copy[0]+copy.size(), ptr);
+    ASSERT_EQ(ushorts.size(), from_stream.size());
+    ASSERT_EQ(ushorts.size()+1, from_buffer.size());
+    for(size_t i=0;i<ushorts.size();++i)
+    {
+        EXPECT_EQ(static_cast<float>(ushorts[i]), from_stream[i]) << i;
+        EXPECT_EQ(static_cast<float>(ushorts[i]), from_buffer[i+1]) << i;
+    }
+
+    std::ostringstream round_trip;
+    io::stream_map< ::uint16_t >(round_trip, from_stream, from_stream.size());
+    EXPECT_EQ(buffer, round_trip.str());
+}
+
+TEST(map_io, read_array_truncated)
+{
+    const std::vector< ::uint16_t > ushorts = ushort_values();
+    std::ostringstream out;
+    io::stream_map< ::uint16_t >(out, ushorts, ushorts.size());
+    const std::string buffer = out.str().substr(0, io::bulk_convert_block_size*sizeof(::uint16_t)+7);
+    std::istringstream in(buffer);
+    std::vector<float> values;
+    EXPECT_EQ(static_cast<std::streamsize>(buffer.size()), io::stream_map< ::uint16_t >(in, values, ushorts.size()));
+    for(size_t i=0;i<io::bulk_convert_block_size+3;++i)
+        EXPECT_EQ(static_cast<float>(ushorts[i]), values[i]) << i;
+}
@@ -0,0 +1,108 @@
+/** Unit tests for the SQLite virtual tables over loaded run metrics
+ *
+ *  @file
+ *  @date  10/19/2026
+ *  @version 1.0
+ *  @copyright GNU Public License
+ */
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <string>
+#include "interop/io/sqlite_module.h"
+#include "interop/model/run_metrics.h"
+#include "src/tests/interop/metrics/inc/error_metrics_test.h"
+#include "src/tests/interop/metrics/inc/tile_metrics_test.h"
+
+using namespace illumina::interop;
+
+namespace
+{
+    /** Run a query and get the first column of the first row as text
+     *
+     * @param db database connection
+     * @param sql query
+     * @return first column of the first row, "null" for NULL, "none" if there is no row
+     */
+    std::string query_text(sqlite3* db, const std::string& sql)
+    {
+        sqlite3_stmt* statement = 0;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &statement, 0) != SQLITE_OK) return sqlite3_errmsg(db);
+        std::string result = "none";
+        if (sqlite3_step(statement) == SQLITE_ROW)
+        {
+            const unsigned char* text = sqlite3_column_text(statement, 0);
+            result = text == 0 ? "null" : reinterpret_cast<const char*>(text);
+        }
+        sqlite3_finalize(statement);
+        return result;
+    }
+    /** Run a query and get the plan of its last step
+     *
+     * @param db database connection
+     * @param sql query
+     * @return detail of the last step of the query plan
+     */
+    std::string query_plan(sqlite3* db, const std::string& sql)
+    {
+        sqlite3_stmt* statement = 0;
+        if (sqlite3_prepare_v2(db, ("EXPLAIN QUERY PLAN " + sql).c_str(), -1, &statement, 0) != SQLITE_OK)
+            return sqlite3_errmsg(db);
+        std::string detail;
+        while (sqlite3_step(statement) == SQLITE_ROW)
+            detail = reinterpret_cast<const char*>(sqlite3_column_text(statement, sqlite3_column_count(statement) - 1));
+        sqlite3_finalize(statement);
+        return detail;
+    }
+}
+
+TEST(sqlite_module_test, query_metrics_in_place)
+{
+    model::metrics::run_metrics run;
+    unittest::error_metric_v3::create_expected(run.get<model::metrics::error_metric>());
+    unittest::tile_metric_v2::create_expected(run.get<model::metrics::tile_metric>());
+    sqlite3* db = 0;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(":memory:", &db));
+    EXPECT_EQ(2u, io::attach_run_metrics(db, run));
+
+    EXPECT_EQ("3", query_text(db, "SELECT COUNT(*) FROM Error"));
+    EXPECT_EQ("0.465621590614319", query_text(db, "SELECT ErrorRate FROM Error WHERE Lane=7 AND Tile=1114 AND Cycle=3"));
+    EXPECT_EQ("none", query_text(db, "SELECT ErrorRate FROM Error WHERE Lane=7 AND Tile=1114 AND Cycle=9"));
+    EXPECT_EQ("none", query_text(db, "SELECT ErrorRate FROM Error WHERE Lane=-7 AND Tile=1114 AND Cycle=3"));
+    EXPECT_EQ("2", query_text(db, "SELECT COUNT(*) FROM Error WHERE Tile=1114 AND Cycle>=2"));
+    EXPECT_EQ("3", query_text(db, "SELECT COUNT(*) FROM Error WHERE Lane=7.0"));
+    EXPECT_EQ("0", query_text(db, "SELECT COUNT(*) FROM Error WHERE Lane=7.5"));
+    EXPECT_EQ("0.465621590614319",
+              query_text(db, "SELECT ErrorRate FROM Error WHERE Lane=7.0 AND Tile=1114 AND Cycle=3.0"));
+    EXPECT_EQ("3", query_text(db, "SELECT COUNT(*) FROM Tile WHERE Lane=7"));
+    EXPECT_EQ("null", query_text(db, "SELECT Aligned_R2 FROM Tile WHERE Lane=7 AND Tile=1214"));
+    EXPECT_EQ("1", query_text(db, "SELECT COUNT(*) FROM Tile WHERE Aligned_R2 IS NOT NULL"));
+
+    EXPECT_NE(std::string::npos,
+              query_plan(db, "SELECT ErrorRate FROM Error WHERE Lane=7 AND Tile=1114 AND Cycle=3").find("INDEX 7"));
+    EXPECT_NE(std::string::npos, query_plan(db, "SELECT ErrorRate FROM Error WHERE Tile=1114").find("INDEX 2"));
+
+    io::detach_run_metrics(db, run);
+    EXPECT_NE("3", query_text(db, "SELECT COUNT(*) FROM Error"));
+    sqlite3_close(db);
+}
+
+TEST(sqlite_module_test, attach_runs_with_prefix)
+{
+    model::metrics::run_metrics run1;
+    model::metrics::run_metrics run2;
+    unittest::error_metric_v3::create_expected(run1.get<model::metrics::error_metric>());
+    unittest::error_metric_v3::create_expected(run2.get<model::metrics::error_metric>());
+    run2.get<model::metrics::error_metric>().resize(1);
+    run2.get<model::metrics::error_metric>().rebuild_index();
+    sqlite3* db = 0;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(":memory:", &db));
+    EXPECT_EQ(1u, io::attach_run_metrics(db, run1, "run1_"));
+    EXPECT_EQ(1u, io::attach_run_metrics(db, run2, "run2_"));
+
+    EXPECT_EQ("1", query_text(db, "SELECT COUNT(*) FROM run1_Error a JOIN run2_Error b "
+                                  "ON a.Lane=b.Lane AND a.Tile=b.Tile AND a.Cycle=b.Cycle"));
+
+    io::detach_run_metrics(db, run1, "run1_");
+    io::detach_run_metrics(db, run2, "run2_");
+    sqlite3_close(db);
+}
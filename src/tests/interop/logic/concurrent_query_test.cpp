@@ -0,0 +1,172 @@
+/** Unit tests for querying one run from many threads
+ *
+ *  @file
+ *  @date  10/19/2026
+ *  @version 1.0
+ *  @copyright GNU Public License
+ */
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "interop/logic/plot/plot_by_cycle.h"
+#include "interop/logic/plot/plot_qscore_histogram.h"
+#include "interop/logic/plot/plot_qscore_heatmap.h"
+#include "interop/logic/plot/plot_sample_qc.h"
+#include "interop/logic/summary/index_summary.h"
+#include "src/tests/interop/metrics/inc/extraction_metrics_test.h"
+#include "src/tests/interop/metrics/inc/tile_metrics_test.h"
+#include "src/tests/interop/metrics/inc/q_metrics_test.h"
+#include "src/tests/interop/metrics/inc/index_metrics_test.h"
+#include "src/tests/interop/run/info_test.h"
+
+using namespace illumina::interop;
+using namespace illumina::interop::unittest;
+
+namespace
+{
+    /** Number of different queries run by run_query */
+    const size_t kQueryCount = 5;
+
+    /** Append the y-values of every point in a plot
+     *
+     * @param data plot data
+     * @param values destination values
+     */
+    template<class Point>
+    void append_values(const model::plot::plot_data<Point>& data, std::vector<float>& values)
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+            for (size_t j = 0; j < data[i].size(); ++j) values.push_back(data[i][j].y());
+    }
+
+    /** Run one of the query entry points on a constant run
+     *
+     * @param metrics run metrics shared by all threads
+     * @param query index of the query
+     * @return values produced by the query
+     */
+    std::vector<float> run_query(const model::metrics::run_metrics& metrics, const size_t query)
+    {
+        std::vector<float> values;
+        const model::plot::filter_options options(constants::FourDigit);
+        switch (query)
+        {
+            case 0:
+            {
+                model::plot::plot_data<model::plot::bar_point> data;
+                logic::plot::plot_qscore_histogram(metrics, options, data);
+                append_values(data, values);
+                break;
+            }
+            case 1:
+            {
+                model::plot::heatmap_data data;
+                logic::plot::plot_qscore_heatmap(metrics, options, data);
+                for (size_t i = 0; i < data.length(); ++i) values.push_back(data.at(i));
+                break;
+            }
+            case 2:
+            {
+                model::plot::plot_data<model::plot::bar_point> data;
+                logic::plot::plot_sample_qc(metrics, 7, data);
+                append_values(data, values);
+                break;
+            }
+            case 3:
+            {
+                model::summary::index_flowcell_summary summary;
+                logic::summary::summarize_index_metrics(metrics, summary);
+                for (size_t lane = 0; lane < summary.size(); ++lane)
+                {
+                    values.push_back(static_cast<float>(summary[lane].size()));
+                    values.push_back(static_cast<float>(summary[lane].total_reads()));
+                }
+                break;
+            }
+            default:
+            {
+                model::plot::plot_data<model::plot::candle_stick_point> data;
+                logic::plot::plot_by_cycle(metrics, constants::FWHM, options, data);
+                append_values(data, values);
+                break;
+            }
+        }
+        return values;
+    }
+    /** Populate a run with metrics, without finalizing it, so the first queries create the derived sets
+     *
+     * @param metrics destination run metrics
+     */
+    void create_run(model::metrics::run_metrics& metrics)
+    {
+        model::run::info run_info;
+        hiseq4k_run_info::create_expected(run_info);
+        metrics.run_info(run_info);
+        extraction_metric_v2::create_expected(metrics.get<model::metrics::extraction_metric>());
+        q_metric_v6::create_expected(metrics.get<model::metrics::q_metric>());
+        index_metric_v1::create_expected(metrics.get<model::metrics::index_metric>());
+        tile_metric_v2::create_expected(metrics.get<model::metrics::tile_metric>());
+    }
+}
+
+/** Confirm concurrent mixed queries on one run give the same results as running them one at a time
+ *
+ * Every query takes the run by constant reference and the derived metric sets are created by whichever query
+ * runs first.
+ */
+TEST(concurrent_query_test, mixed_queries_match_serial)
+{
+    const size_t iteration_count = 64;
+    model::metrics::run_metrics serial_metrics;
+    create_run(serial_metrics);
+    std::vector< std::vector<float> > expected(kQueryCount);
+    for (size_t query = 0; query < kQueryCount; ++query)
+    {
+        expected[query] = run_query(serial_metrics, query);
+        EXPECT_FALSE(expected[query].empty()) << "query: " << query;
+    }
+
+    model::metrics::run_metrics metrics;
+    create_run(metrics);
+    const model::metrics::run_metrics& shared_metrics = metrics;
+    std::vector< std::vector<float> > actual(iteration_count);
+#ifdef _OPENMP
+#   pragma omp parallel for default(shared) num_threads(8) schedule(dynamic)
+#endif
+    for (int i = 0; i < static_cast<int>(iteration_count); ++i)
+    {
+        actual[i] = run_query(shared_metrics, static_cast<size_t>(i) % kQueryCount);
+    }
+
+    EXPECT_EQ(serial_metrics.get<model::metrics::q_by_lane_metric>().size(),
+              metrics.get<model::metrics::q_by_lane_metric>().size());
+    EXPECT_EQ(serial_metrics.get<model::metrics::q_collapsed_metric>().size(),
+              metrics.get<model::metrics::q_collapsed_metric>().size());
+    for (size_t i = 0; i < iteration_count; ++i)
+    {
+        const std::vector<float>& expected_values = expected[i % kQueryCount];
+        ASSERT_EQ(expected_values.size(), actual[i].size()) << "iteration: " << i;
+        for (size_t j = 0; j < expected_values.size(); ++j)
+        {
+            if (std::isnan(expected_values[j])) EXPECT_TRUE(std::isnan(actual[i][j]));
+            else EXPECT_EQ(expected_values[j], actual[i][j]) << "iteration: " << i << " value: " << j;
+        }
+    }
+}
+
+/** Confirm the derived metric sets are created again after a metric set is changed through a mutable reference
+ */
+TEST(concurrent_query_test, derived_metrics_after_change)
+{
+    model::metrics::run_metrics metrics;
+    create_run(metrics);
+    const model::metrics::run_metrics& shared_metrics = metrics;
+    shared_metrics.ensure_derived_metrics();
+    const size_t collapsed_count = shared_metrics.get<model::metrics::q_collapsed_metric>().size();
+    EXPECT_GT(collapsed_count, 0u);
+    EXPECT_TRUE(shared_metrics.get<model::metrics::dynamic_phasing_metric>().empty());
+
+    metrics.get<model::metrics::q_collapsed_metric>().clear();
+    shared_metrics.ensure_derived_metrics();
+    EXPECT_EQ(collapsed_count, shared_metrics.get<model::metrics::q_collapsed_metric>().size());
+}
@@ -211,4 +211,34 @@ TEST(imaging_table, create_imaging_table_error_metrics_tile_test)
     EXPECT_EQ(table(1, model::table::SwathColumn), 1.0f);
 }
 
+// Test that the table data buffer swapped into the workspace is reused by later calls
+TEST(imaging_table, create_imaging_table_workspace)
+{
+    model::metrics::run_metrics metrics;
+    simulate_read_error_metrics(metrics);
+
+    logic::utils::workspace workspace;
+    model::table::imaging_table table;
+    logic::table::create_imaging_table(metrics, table, workspace);
+    logic::table::create_imaging_table(metrics, table, workspace);
+    logic::table::create_imaging_table(metrics, table, workspace);
+    EXPECT_EQ(workspace.call_count(), 3u);
+    EXPECT_EQ(workspace.buffer_growth_count(), 0u);
+
+    model::table::imaging_table expected;
+    logic::table::create_imaging_table(metrics, expected);
+    ASSERT_EQ(table.row_count(), expected.row_count());
+    EXPECT_EQ(table(1, model::table::CycleColumn), expected(1, model::table::CycleColumn));
+    EXPECT_EQ(table(1, model::table::TileColumn), expected(1, model::table::TileColumn));
+
+    // A new row rebuilds the row ordering kept in the workspace
+    const model::metrics::error_metric& first = metrics.get<model::metrics::error_metric>()[0];
+    metrics.get<model::metrics::error_metric>().insert(
+            model::metrics::error_metric(first.lane(), first.tile(), 4, 1.0f));
+    logic::table::create_imaging_table(metrics, table, workspace);
+    logic::table::create_imaging_table(metrics, expected);
+    EXPECT_EQ(table.row_count(), expected.row_count());
+    EXPECT_EQ(workspace.row_offsets().size(), table.row_count());
+}
+
 
@@ -0,0 +1,124 @@
+/** Unit tests for copying metric values into arrays
+ *
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <gtest/gtest.h>
+#include "interop/logic/metric/metric_array.h"
+#include "interop/logic/metric/extraction_metric.h"
+#include "src/tests/interop/metrics/inc/extraction_metrics_test.h"
+#include "src/tests/interop/metrics/inc/q_metrics_test.h"
+#include "src/tests/interop/run/info_test.h"
+
+using namespace illumina::interop;
+using namespace illumina::interop::unittest;
+
+// Check that every channel of every record is copied, and matches the values of each record
+TEST(metric_array_test, copy_channel_values)
+{
+    model::run::info run_info;
+    hiseq4k_run_info::create_expected(run_info);
+    model::metrics::run_metrics metrics(run_info);
+    unittest::extraction_metric_v2::create_expected(metrics.get<model::metrics::extraction_metric>());
+    const model::metric_base::metric_set<model::metrics::extraction_metric>& extraction =
+            metrics.get<model::metrics::extraction_metric>();
+    model::plot::filter_options options(constants::FourDigit);
+
+    const size_t channel_count = run_info.channels().size();
+    EXPECT_EQ(logic::metric::metric_array_fanout(metrics, constants::Intensity, options), channel_count);
+    const size_t size = logic::metric::metric_array_size(metrics, constants::Intensity, options);
+    ASSERT_EQ(size, extraction.size()*channel_count);
+    std::vector<float> values(size);
+    EXPECT_EQ(logic::metric::copy_metric_values(metrics, "Intensity", options, &values[0], values.size()),
+              extraction.size());
+    for(size_t i=0;i<extraction.size();++i)
+        for(size_t channel=0;channel<channel_count;++channel)
+            EXPECT_EQ(values[i*channel_count+channel], extraction[i].max_intensity(channel));
+
+    std::vector< ::uint32_t > ids(extraction.size()*3);
+    EXPECT_EQ(logic::metric::copy_metric_ids(metrics, constants::Intensity, options, &ids[0], ids.size()),
+              extraction.size());
+    for(size_t i=0;i<extraction.size();++i)
+    {
+        EXPECT_EQ(ids[i*3], extraction[i].lane());
+        EXPECT_EQ(ids[i*3+1], extraction[i].tile());
+        EXPECT_EQ(ids[i*3+2], extraction[i].cycle());
+    }
+    EXPECT_THROW(logic::metric::copy_metric_values(metrics, constants::Intensity, options, &values[0], size-1),
+                 model::invalid_parameter);
+}
+
+// Check that a single channel matches copy_focus
+TEST(metric_array_test, copy_single_channel_matches_copy_focus)
+{
+    model::run::info run_info;
+    hiseq4k_run_info::create_expected(run_info);
+    model::metrics::run_metrics metrics(run_info);
+    unittest::extraction_metric_v2::create_expected(metrics.get<model::metrics::extraction_metric>());
+    const size_t count = metrics.get<model::metrics::extraction_metric>().size();
+    model::plot::filter_options options(constants::FourDigit);
+    options.channel(1);
+
+    std::vector<float> expected(count);
+    logic::metric::copy_focus(metrics.get<model::metrics::extraction_metric>(), &expected[0], 1, count);
+    std::vector<float> values(count);
+    EXPECT_EQ(logic::metric::copy_metric_values(metrics, constants::FWHM, options, &values[0], count), count);
+    for(size_t i=0;i<count;++i) EXPECT_EQ(values[i], expected[i]);
+}
+
+// Check that the q-score histograms and collapsed q-metric values are copied for the selected lane
+TEST(metric_array_test, copy_qscore_values)
+{
+    model::run::info run_info;
+    hiseq4k_run_info::create_expected(run_info);
+    model::metrics::run_metrics metrics(run_info);
+    unittest::q_metric_v6::create_expected(metrics.get<model::metrics::q_metric>());
+    metrics.finalize_after_load();
+    const model::metric_base::metric_set<model::metrics::q_metric>& q_metrics = metrics.get<model::metrics::q_metric>();
+    model::plot::filter_options options(constants::FourDigit);
+
+    const size_t bin_count = q_metrics[0].size();
+    std::vector<float> histograms(q_metrics.size()*bin_count);
+    EXPECT_EQ(logic::metric::copy_qscore_histograms(metrics, options, &histograms[0], histograms.size()),
+              q_metrics.size());
+    for(size_t i=0;i<q_metrics.size();++i)
+        for(size_t bin=0;bin<bin_count;++bin)
+            EXPECT_EQ(histograms[i*bin_count+bin], static_cast<float>(q_metrics[i].qscore_hist(bin)));
+
+    std::vector<float> values(logic::metric::metric_array_size(metrics, constants::Q30Percent, options));
+    ASSERT_EQ(values.size(), metrics.get<model::metrics::q_collapsed_metric>().size());
+    logic::metric::copy_metric_values(metrics, constants::Q30Percent, options, &values[0], values.size());
+    for(size_t i=0;i<values.size();++i)
+        EXPECT_EQ(values[i], metrics.get<model::metrics::q_collapsed_metric>()[i].percent_over_q30());
+
+    options.lane(2);
+    EXPECT_EQ(logic::metric::metric_array_size(metrics, constants::Q30Percent, options), 0u);
+}
+
+// Check that the q-score histograms are filtered by read and must share a bin count
+TEST(metric_array_test, copy_qscore_histograms_by_read)
+{
+    model::run::info run_info;
+    hiseq4k_run_info::create_expected(run_info);
+    model::metrics::run_metrics metrics(run_info);
+    unittest::q_metric_v6::create_expected(metrics.get<model::metrics::q_metric>());
+    metrics.finalize_after_load();
+    model::metric_base::metric_set<model::metrics::q_metric>& q_metrics = metrics.get<model::metrics::q_metric>();
+    const size_t bin_count = q_metrics[0].size();
+    std::vector<float> histograms(q_metrics.size()*bin_count);
+    model::plot::filter_options options(constants::FourDigit);
+
+    options.read(1);
+    EXPECT_EQ(logic::metric::copy_qscore_histograms(metrics, options, &histograms[0], histograms.size()),
+              q_metrics.size());
+    options.read(2);
+    EXPECT_EQ(logic::metric::copy_qscore_histograms(metrics, options, &histograms[0], histograms.size()), 0u);
+
+    q_metrics.insert(model::metrics::q_metric(7, 1114, 4, std::vector< ::uint32_t >(bin_count+1)));
+    options.read(1);
+    EXPECT_THROW(logic::metric::copy_qscore_histograms(metrics, options, &histograms[0], histograms.size()),
+                 model::invalid_parameter);
+}
@@ -14,6 +14,7 @@
 #include "interop/logic/plot/plot_flowcell_map.h"
 #include "interop/logic/plot/plot_sample_qc.h"
 #include "interop/logic/plot/plot_metric_list.h"
+#include "interop/logic/plot/plot_overlay.h"
 #include "src/tests/interop/metrics/inc/corrected_intensity_metrics_test.h"
 #include "src/tests/interop/metrics/inc/extraction_metrics_test.h"
 #include "src/tests/interop/metrics/inc/tile_metrics_test.h"
@@ -246,6 +247,80 @@ TEST(plot_logic, q_score_histogram)
     EXPECT_NEAR(data.y_axis().max(), 9.4780035018920898f, tol);
 }
 
+// Check that an overlay holds the series of every run that has data, and axes shared across runs
+TEST(plot_logic, plot_overlay)
+{
+    const float tol = 1e-3f;
+    model::plot::filter_options options(constants::FourDigit);
+    model::run::info run_info;
+    hiseq4k_run_info::create_expected(run_info);
+    model::metrics::run_metrics first(run_info);
+    model::metrics::run_metrics empty(run_info);
+    model::metrics::run_metrics second(run_info);
+    unittest::extraction_metric_v2::create_expected(first.get<model::metrics::extraction_metric>());
+    unittest::extraction_metric_v2::create_expected(second.get<model::metrics::extraction_metric>());
+    unittest::q_metric_v6::create_expected(first.get<model::metrics::q_metric>());
+    unittest::q_metric_v6::create_expected(second.get<model::metrics::q_metric>());
+    first.finalize_after_load();
+    second.finalize_after_load();
+    std::vector<model::metrics::run_metrics*> runs;
+    runs.push_back(&first);
+    runs.push_back(&empty);
+    runs.push_back(&second);
+
+    model::plot::plot_data<model::plot::candle_stick_point> expected;
+    logic::plot::plot_by_cycle(first, constants::Intensity, options, expected);
+    model::plot::plot_data<model::plot::candle_stick_point> data;
+    logic::plot::plot_by_cycle_overlay(runs, constants::Intensity, options, data, 2);
+    ASSERT_EQ(data.size(), 2*expected.size());
+    EXPECT_EQ(data.title(), "All Lanes All Channels");
+    EXPECT_EQ(data.y_axis().label(), expected.y_axis().label());
+    EXPECT_NEAR(data.x_axis().max(), expected.x_axis().max(), tol);
+    EXPECT_NEAR(data.y_axis().max(), expected.y_axis().max(), tol);
+    for(size_t i=0;i<data.size();++i)
+    {
+        const model::plot::series<model::plot::candle_stick_point>& series = expected[i % expected.size()];
+        EXPECT_NE(data[i].title().find(series.title()), std::string::npos);
+        ASSERT_EQ(data[i].size(), series.size());
+        for(size_t j=0;j<series.size();++j) EXPECT_EQ(data[i][j].y(), series[j].y());
+    }
+    EXPECT_NE(data[0].color(), data[expected.size()].color());
+
+    model::plot::plot_data<model::plot::bar_point> histogram;
+    logic::plot::plot_qscore_histogram_overlay(runs, options, histogram);
+    ASSERT_EQ(histogram.size(), 2u);
+    EXPECT_EQ(histogram[1].series_type(), model::plot::series<model::plot::bar_point>::Line);
+    EXPECT_EQ(histogram.y_axis().label(), "Total (million)");
+    EXPECT_EQ(histogram.title(), "All Lanes");
+    ASSERT_EQ(histogram[0].size(), histogram[1].size());
+    EXPECT_NEAR(histogram[1][3].y(), 8.61628f, tol);
+}
+
+// Check that a run listed twice is plotted for each entry, and that a failed run keeps its exception type
+TEST(plot_logic, plot_overlay_parallel_duplicates_and_errors)
+{
+    model::plot::filter_options options(constants::FourDigit);
+    model::run::info run_info;
+    hiseq4k_run_info::create_expected(run_info);
+    model::metrics::run_metrics first(run_info);
+    unittest::extraction_metric_v2::create_expected(first.get<model::metrics::extraction_metric>());
+    first.finalize_after_load();
+    std::vector<model::metrics::run_metrics*> runs(3, &first);
+
+    model::plot::plot_data<model::plot::candle_stick_point> expected;
+    logic::plot::plot_by_cycle(first, constants::Intensity, options, expected);
+    model::plot::plot_data<model::plot::candle_stick_point> data;
+    logic::plot::plot_by_cycle_overlay(runs, constants::Intensity, options, data, 2);
+    ASSERT_EQ(data.size(), 3*expected.size());
+    for(size_t i=0;i<data.size();++i)
+        ASSERT_EQ(data[i].size(), expected[i % expected.size()].size());
+
+    std::vector<std::string> run_folders(2, "/NO/RUN/FOLDER");
+    run_folders[1] = "/NO/OTHER/RUN/FOLDER";
+    EXPECT_THROW(logic::plot::plot_by_cycle_overlay(run_folders, constants::Intensity, options, data, 2),
+                 xml::xml_file_not_found_exception);
+}
+
 //Not reading an interop in for Q-score Hist causes the title and labels to go away (only here, not in cycle/lane)
 TEST(plot_logic, q_score_histogram_empty_interop)
 {
@@ -445,6 +520,41 @@ TEST(plot_logic, flowcell_map)
     EXPECT_NEAR(data.saxis().max(), 349.0f, tol);
 }
 
+// Test that repeated flowcell and by cycle plots reuse the scratch buffers in a workspace
+TEST(plot_logic, plot_workspace_reuse)
+{
+    const model::plot::filter_options::id_t ALL_IDS = model::plot::filter_options::ALL_IDS;
+    const float tol = 1e-3f;
+    model::metrics::run_metrics metrics;
+    model::run::info run_info;
+    hiseq4k_run_info::create_expected(run_info);
+    metrics.run_info(run_info);
+    unittest::extraction_metric_v2::create_expected(metrics.get<model::metrics::extraction_metric>());
+
+    logic::utils::workspace workspace;
+    const model::plot::filter_options map_options(constants::FourDigit, ALL_IDS, 0, constants::A, ALL_IDS, 1, 1);
+    model::plot::flowcell_data map;
+    logic::plot::plot_flowcell_map(metrics, constants::Intensity, map_options, map, workspace);
+    logic::plot::plot_flowcell_map(metrics, constants::Intensity, map_options, map, workspace);
+    EXPECT_EQ(workspace.buffer_growth_count(), 0u);
+    EXPECT_NEAR(map.saxis().min(), 302.0f, tol);
+    EXPECT_NEAR(map.saxis().max(), 349.0f, tol);
+
+    model::plot::filter_options cycle_options(constants::FourDigit);
+    cycle_options.channel(0);
+    model::plot::plot_data<model::plot::candle_stick_point> expected;
+    logic::plot::plot_by_cycle(metrics, constants::Intensity, cycle_options, expected);
+    model::plot::plot_data<model::plot::candle_stick_point> data;
+    logic::plot::plot_by_cycle(metrics, constants::Intensity, cycle_options, data, workspace);
+    logic::plot::plot_by_cycle(metrics, constants::Intensity, cycle_options, data, workspace);
+    EXPECT_EQ(workspace.buffer_growth_count(), 0u);
+    EXPECT_EQ(workspace.call_count(), 4u);
+    ASSERT_EQ(data.size(), expected.size());
+    ASSERT_EQ(data[0].size(), expected[0].size());
+    for (size_t i = 0; i < data[0].size(); ++i)
+        EXPECT_NEAR(data[0][i].y(), expected[0][i].y(), tol);
+}
+
 //Checks that plot_flowcell_map with no interop read sets axis values cleanly (no crash)
 TEST(plot_logic, flowcell_map_empty_interop)
 {
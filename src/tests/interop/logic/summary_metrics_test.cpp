@@ -11,6 +11,7 @@
 #include <gtest/gtest.h>
 #include "interop/util/math.h"
 #include "interop/logic/summary/run_summary.h"
+#include "interop/logic/summary/quick_look_summary.h"
 #include "interop/logic/utils/channel.h"
 #include "src/tests/interop/metrics/inc/corrected_intensity_metrics_test.h"
 #include "src/tests/interop/metrics/inc/error_metrics_test.h"
@@ -413,6 +414,95 @@ TEST(summary_metrics_test, cycle_35_cycle_34_tile)
 
 }
 
+// Test that repeated summaries with the same workspace reuse its buffers and count tiles the same way
+TEST(summary_metrics_test, summarize_with_workspace)
+{
+    model::run::info run_info;
+    model::run::read_info reads[] = {model::run::read_info(1, 1, 3)};
+    hiseq4k_run_info::create_expected(run_info, util::to_vector(reads));
+    model::metrics::run_metrics metrics(run_info);
+    typedef model::metrics::error_metric::uint_t uint_t;
+    for (uint_t cycle_number = 1; cycle_number <= 3; ++cycle_number)
+    {
+        metrics.get<model::metrics::error_metric>().insert(error_metric(1, 1101, cycle_number, 1.0f));
+        metrics.get<model::metrics::error_metric>().insert(error_metric(1, 1102, cycle_number, 2.0f));
+        metrics.get<model::metrics::extraction_metric>().insert(
+                extraction_metric(1, 1102, cycle_number, extraction_metric::ushort_array_t(4, 1),
+                                  extraction_metric::float_array_t(4, 1.0f)));
+    }
+
+    model::summary::run_summary expected;
+    logic::summary::summarize_run_metrics(metrics, expected);
+    logic::utils::workspace workspace;
+    model::summary::run_summary actual;
+    logic::summary::summarize_run_metrics(metrics, actual, workspace);
+    logic::summary::summarize_run_metrics(metrics, actual, workspace);
+    EXPECT_EQ(workspace.call_count(), 2u);
+    EXPECT_EQ(workspace.buffer_growth_count(), 0u);
+    EXPECT_GT(workspace.total_buffer_growth_count(), 0u);
+    ASSERT_EQ(actual.size(), expected.size());
+    ASSERT_EQ(actual[0].size(), 1u);
+    EXPECT_EQ(actual[0][0].tile_count(), 2u);
+    EXPECT_EQ(actual[0][0].tile_count(), expected[0][0].tile_count());
+}
+
+// Test that the columnar summary holds the same statistics as each read, lane and surface of the summary tree
+TEST(summary_metrics_test, columnar_summary_matches_tree)
+{
+    model::run::info run_info;
+    model::run::read_info reads[] = {model::run::read_info(1, 1, 3), model::run::read_info(2, 4, 6)};
+    hiseq4k_run_info::create_expected(run_info, util::to_vector(reads));
+    model::metrics::run_metrics metrics(run_info);
+    typedef model::metrics::error_metric::uint_t uint_t;
+    for (uint_t cycle_number = 1; cycle_number <= 6; ++cycle_number)
+    {
+        metrics.get<model::metrics::error_metric>().insert(error_metric(1, 1101, cycle_number, 1.0f));
+        metrics.get<model::metrics::error_metric>().insert(error_metric(1, 2101, cycle_number, 2.0f));
+        metrics.get<model::metrics::error_metric>().insert(error_metric(3, 1102, cycle_number, 4.0f));
+    }
+
+    model::summary::run_summary tree;
+    logic::summary::summarize_run_metrics(metrics, tree, false, false);
+    model::summary::columnar_summary columns;
+    logic::summary::create_columnar_summary(tree, columns);
+    ASSERT_EQ(tree.size(), columns.read_count());
+    ASSERT_EQ(tree.lane_count(), columns.lane_count());
+    ASSERT_EQ(tree.surface_count(), columns.surface_count());
+    EXPECT_EQ(columns.row_count() * model::summary::columnar_summary::column_count(), columns.size());
+
+    const float tol = 1e-7f;
+    for (size_t read = 0; read < tree.size(); ++read)
+    {
+        for (size_t lane = 0; lane < tree[read].size(); ++lane)
+        {
+            const model::summary::lane_summary& lane_summary = tree[read][lane];
+            const size_t row = columns.row(read, lane_summary.lane() - 1);
+            INTEROP_EXPECT_STAT_NEAR(lane_summary.error_rate(),
+                                     columns.stat(model::summary::columnar_summary::ErrorRate, row), tol);
+            EXPECT_EQ(static_cast<float>(lane_summary.tile_count()),
+                      columns.at(model::summary::columnar_summary::column(model::summary::columnar_summary::TileCount),
+                                 row));
+            for (size_t surface = 0; surface < lane_summary.size(); ++surface)
+            {
+                INTEROP_EXPECT_STAT_NEAR(lane_summary[surface].error_rate(),
+                                         columns.stat(model::summary::columnar_summary::ErrorRate,
+                                                      columns.row(read, lane_summary.lane() - 1, surface + 1)), tol);
+            }
+        }
+    }
+    const size_t lane1 = columns.row(1, 0);
+    INTEROP_EXPECT_NEAR(1.5f, columns.stat(model::summary::columnar_summary::ErrorRate, lane1).mean(), tol);
+    INTEROP_EXPECT_NEAR(2.0f, columns.stat(model::summary::columnar_summary::ErrorRate, columns.row(1, 0, 2)).mean(),
+                        tol);
+
+    std::vector<float> buffer(columns.size());
+    columns.copy_values(&buffer.front(), buffer.size());
+    const size_t error_rate_mean = model::summary::columnar_summary::column(model::summary::columnar_summary::ErrorRate,
+                                                                            model::summary::columnar_summary::Mean);
+    EXPECT_EQ(columns.at(error_rate_mean, lane1), buffer[error_rate_mean * columns.row_count() + lane1]);
+    EXPECT_THROW(columns.copy_values(&buffer.front(), buffer.size() - 1), model::invalid_parameter);
+}
+
 TEST(summary_metrics_test, clear_run_metrics) // TODO Expand to catch everything: probably use a fixture and the methods above
 {
     const float tol = 1e-9f;
@@ -454,6 +544,155 @@ TEST(summary_metrics_test, empty_run_metrics)
     EXPECT_EQ(summary.size(), 0u);
 }
 
+TEST(summary_metrics_test, select_tile_sample_from_layout)
+{
+    model::run::info run_info(model::run::flowcell_layout(2, 2, 2, 6, 1, 1,
+                                                          model::run::flowcell_layout::str_vector_t(),
+                                                          constants::FourDigit));
+    model::metric_base::tile_filter sample;
+    model::summary::sampling_summary sampling;
+    logic::summary::select_tile_sample(run_info, 3, sample, sampling);
+    ASSERT_EQ(sampling.size(), 2u);
+    EXPECT_EQ(sample.size(), 12u);
+    EXPECT_EQ(sample.tile_count(1), 6u);
+    EXPECT_EQ(sampling[0].total_tile_count(), 24u);
+    EXPECT_EQ(sampling[0].sampled_tile_count(), 6u);
+    // Each surface is sampled at an even stride across both swaths
+    EXPECT_TRUE(sample.accept(1, 1103));
+    EXPECT_TRUE(sample.accept(1, 1201));
+    EXPECT_TRUE(sample.accept(1, 1205));
+    EXPECT_TRUE(sample.accept(2, 2103));
+    EXPECT_FALSE(sample.accept(1, 1101));
+    EXPECT_FALSE(sample.accept(3, 1103));
+
+    model::metric_base::tile_filter resample;
+    logic::summary::select_tile_sample(run_info, 3, resample, sampling);
+    EXPECT_TRUE(std::equal(sample.begin(), sample.end(), resample.begin()));
+}
+
+TEST(summary_metrics_test, select_tile_sample_from_tile_list)
+{
+    const std::string tile_names[] = {"1_1101", "1_1102", "1_1103", "1_1104", "1_2101", "1_2102"};
+    model::run::info run_info(model::run::flowcell_layout(1, 2, 1, 4, 1, 1, util::to_vector(tile_names)));
+    model::metric_base::tile_filter sample;
+    model::summary::sampling_summary sampling;
+    logic::summary::select_tile_sample(run_info, 10, sample, sampling);
+    EXPECT_EQ(sample.size(), 6u);
+    EXPECT_EQ(sampling[0].scale(), 1.0f);
+    EXPECT_EQ(sampling[0].finite_population_correction(), 0.0f);
+}
+
+TEST(summary_metrics_test, select_tile_sample_requires_naming_method)
+{
+    model::run::info run_info(model::run::flowcell_layout(1, 2, 2, 6));
+    model::metric_base::tile_filter sample;
+    model::summary::sampling_summary sampling;
+    EXPECT_THROW(logic::summary::select_tile_sample(run_info, 3, sample, sampling),
+                 model::invalid_tile_naming_method);
+}
+
+TEST(summary_metrics_test, sampling_standard_error)
+{
+    const float tol = 1e-5f;
+    model::summary::lane_sampling_summary sampling(1, 10, 4);
+    EXPECT_NEAR(sampling.scale(), 2.5f, tol);
+    EXPECT_NEAR(sampling.finite_population_correction(), std::sqrt(6.0f/9.0f), tol);
+    const model::summary::metric_stat stat(5.0f, 2.0f, 5.0f);
+    EXPECT_NEAR(sampling.standard_error(stat), 2.0f/2.0f*std::sqrt(6.0f/9.0f), tol);
+}
+
+TEST(summary_metrics_test, surface_scale_falls_back_to_lane)
+{
+    const float tol = 1e-5f;
+    model::summary::lane_sampling_summary sampling(1, 16, 6);
+    EXPECT_NEAR(sampling.surface_scale(1, 3), sampling.scale(), tol);
+    sampling.surface_total_tile_count(1, 12);
+    sampling.surface_total_tile_count(2, 4);
+    EXPECT_NEAR(sampling.surface_scale(1, 3), 4.0f, tol);
+    EXPECT_NEAR(sampling.surface_scale(2, 3), 4.0f/3.0f, tol);
+    EXPECT_EQ(sampling.surface_total_tile_count(3), 0u);
+}
+
+/** Confirm a quick-look summary read from a run folder agrees with the full summary
+ *
+ * The two surfaces of the lane hold different numbers of tiles and different cluster counts, so reads are only
+ * extrapolated correctly when each surface is scaled by its own sampling ratio. The density varies within each
+ * surface, and the sampled mean must fall within the estimated sampling error of the full mean.
+ */
+TEST(summary_metrics_test, quick_look_matches_full_summary)
+{
+    const std::string run_folder = "summary_metrics_test_quick_look";
+    io::mkdir(run_folder);
+    io::mkdir(io::combine(run_folder, "InterOp"));
+
+    model::run::flowcell_layout::str_vector_t tile_names;
+    model::metric_base::metric_set<tile_metric> tiles(2);
+    for(::uint32_t swath=1;swath<=2;++swath)
+    {
+        for(::uint32_t tile=1;tile<=6;++tile)
+        {
+            const ::uint32_t tile_number = 1000 + swath*100 + tile;
+            tile_names.push_back("1_" + util::lexical_cast<std::string>(tile_number));
+            const float density = 100.0f + 10.0f*(swath*6+tile);
+            tiles.insert(tile_metric(1, tile_number, density, density, 1000.0f, 900.0f));
+        }
+    }
+    for(::uint32_t tile=1;tile<=4;++tile)
+    {
+        const ::uint32_t tile_number = 2100 + tile;
+        tile_names.push_back("1_" + util::lexical_cast<std::string>(tile_number));
+        tiles.insert(tile_metric(1, tile_number, 300.0f + 10.0f*tile, 300.0f, 2000.0f, 1800.0f));
+    }
+    std::vector<model::run::read_info> reads(1, model::run::read_info(1, 1, 3));
+    const std::string channels[] = {"Red", "Green"};
+    model::run::info run_info(model::run::flowcell_layout(1, 2, 2, 6, 1, 1, tile_names, constants::FourDigit),
+                              reads,
+                              util::to_vector(channels));
+    run_info.write(io::combine(run_folder, "RunInfo.xml"));
+    ASSERT_TRUE(io::write_interop(run_folder, tiles));
+
+    model::metrics::run_metrics full;
+    full.read(run_folder);
+    model::summary::run_summary expected;
+    logic::summary::summarize_run_metrics(full, expected);
+
+    model::metrics::run_metrics metrics;
+    model::summary::run_summary actual;
+    model::summary::sampling_summary sampling;
+    logic::summary::summarize_quick_look(run_folder, 3, metrics, actual, sampling);
+    std::remove(io::interop_filename<model::metric_base::metric_set<tile_metric> >(run_folder).c_str());
+    std::remove(io::combine(run_folder, "RunInfo.xml").c_str());
+    std::remove(io::combine(run_folder, "InterOp").c_str());
+    std::remove(run_folder.c_str());
+
+    // Only the sampled tiles are read
+    EXPECT_EQ(metrics.get<tile_metric>().size(), 6u);
+    ASSERT_EQ(sampling.size(), 1u);
+    EXPECT_EQ(sampling[0].total_tile_count(), 16u);
+    EXPECT_EQ(sampling[0].sampled_tile_count(), 6u);
+    ASSERT_GT(actual.size(), 0u);
+    ASSERT_GT(expected.size(), 0u);
+    const model::summary::lane_summary& actual_lane = actual[0][0];
+    const model::summary::lane_summary& expected_lane = expected[0][0];
+    ASSERT_EQ(actual_lane.size(), 2u);
+    ASSERT_EQ(expected_lane.size(), 2u);
+
+    const float tol = 1e-3f;
+    EXPECT_EQ(actual_lane.tile_count(), expected_lane.tile_count());
+    for(size_t surface=0;surface<2;++surface)
+    {
+        EXPECT_EQ(actual_lane[surface].tile_count(), expected_lane[surface].tile_count()) << surface;
+        EXPECT_NEAR(actual_lane[surface].reads(), expected_lane[surface].reads(), tol*expected_lane[surface].reads());
+        EXPECT_NEAR(actual_lane[surface].reads_pf(), expected_lane[surface].reads_pf(),
+                    tol*expected_lane[surface].reads_pf());
+    }
+    EXPECT_NEAR(actual_lane.reads(), expected_lane.reads(), tol*expected_lane.reads());
+
+    const float standard_error = sampling[0].standard_error(actual_lane.density());
+    EXPECT_GT(standard_error, 0.0f);
+    EXPECT_LE(std::abs(actual_lane.density().mean()-expected_lane.density().mean()), 3*standard_error);
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 // Unit test section
 //---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,142 @@
+/** Unit tests for the spatial index over tile locations
+ *
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "interop/logic/metric/tile_spatial_index.h"
+
+using namespace illumina::interop;
+using namespace illumina::interop::logic::metric;
+
+namespace
+{
+    /** Generate pseudo random tile locations over two lanes
+     *
+     * @param locations destination collection of tile locations
+     * @param count number of tiles in each lane
+     */
+    void create_locations(tile_spatial_index::location_vector_t& locations, const ::uint32_t count)
+    {
+        ::uint32_t seed = 12345;
+        for(::uint32_t lane=1;lane<=2;++lane)
+        {
+            for(::uint32_t tile=1;tile<=count;++tile)
+            {
+                seed = seed * 1103515245u + 12345u;
+                const float x = static_cast<float>((seed >> 8) % 10000) / 100.0f;
+                seed = seed * 1103515245u + 12345u;
+                const float y = static_cast<float>((seed >> 8) % 4000) / 100.0f;
+                locations.push_back(tile_location(lane, tile, x, y));
+            }
+        }
+    }
+    /** Find the tiles within a distance of a point by scanning every tile
+     *
+     * @param locations collection of tile locations
+     * @param lane lane number
+     * @param x horizontal coordinate of the point
+     * @param y vertical coordinate of the point
+     * @param radius maximum distance from the point
+     * @param tiles destination for the sorted tile ids
+     */
+    void scan_radius(const tile_spatial_index::location_vector_t& locations,
+                     const ::uint32_t lane,
+                     const float x,
+                     const float y,
+                     const float radius,
+                     tile_spatial_index::id_vector_t& tiles)
+    {
+        tiles.clear();
+        for(size_t i=0;i<locations.size();++i)
+        {
+            if(locations[i].lane() != lane) continue;
+            const float dx = locations[i].x()-x;
+            const float dy = locations[i].y()-y;
+            if(dx*dx+dy*dy <= radius*radius) tiles.push_back(locations[i].tile());
+        }
+        std::sort(tiles.begin(), tiles.end());
+    }
+}
+
+// Check that nearest, radius and window queries match a scan over every tile
+TEST(tile_spatial_index_test, queries_match_linear_scan)
+{
+    tile_spatial_index::location_vector_t locations;
+    create_locations(locations, 500);
+    const tile_spatial_index index(locations);
+    ASSERT_EQ(index.size(), locations.size());
+
+    tile_spatial_index::id_vector_t expected;
+    tile_spatial_index::id_vector_t actual;
+    for(int i=0;i<50;++i)
+    {
+        const float x = static_cast<float>(i*7 % 110) - 5.0f;
+        const float y = static_cast<float>(i*13 % 50) - 5.0f;
+        const ::uint32_t lane = static_cast< ::uint32_t >(1 + i % 2);
+
+        scan_radius(locations, lane, x, y, 6.5f, expected);
+        index.within_radius(lane, x, y, 6.5f, actual);
+        std::sort(actual.begin(), actual.end());
+        EXPECT_EQ(actual, expected);
+
+        float best = std::numeric_limits<float>::max();
+        for(size_t j=0;j<locations.size();++j)
+        {
+            if(locations[j].lane() != lane) continue;
+            const float dx = locations[j].x()-x;
+            const float dy = locations[j].y()-y;
+            best = std::min(best, dx*dx+dy*dy);
+        }
+        ::uint32_t tile = 0;
+        ASSERT_TRUE(index.nearest(lane, x, y, tile));
+        const tile_location* nearest = index.find(lane, tile);
+        ASSERT_TRUE(nearest != 0);
+        const float dx = nearest->x()-x;
+        const float dy = nearest->y()-y;
+        EXPECT_EQ(dx*dx+dy*dy, best);
+    }
+
+    index.within_window(2, 10, 5, 30, 15, actual);
+    size_t count = 0;
+    for(size_t j=0;j<locations.size();++j)
+        if(locations[j].lane() == 2 && locations[j].x() >= 10 && locations[j].x() <= 30 &&
+           locations[j].y() >= 5 && locations[j].y() <= 15) ++count;
+    EXPECT_EQ(actual.size(), count);
+
+    ::uint32_t tile = 0;
+    EXPECT_FALSE(index.nearest(3, 0, 0, tile));
+    EXPECT_FALSE(index.neighbors(1, 501, 1, actual));
+}
+
+// Check that the neighbors of a tile in the flowcell map are the adjacent tiles
+TEST(tile_spatial_index_test, neighbors_in_flowcell_layout)
+{
+    model::run::flowcell_layout::str_vector_t tiles;
+    for(int swath=1;swath<=2;++swath)
+        for(int number=1;number<=12;++number)
+            tiles.push_back("1_1" + std::string(1, static_cast<char>('0'+swath)) + (number < 10 ? "0" : "") +
+                            (number < 10 ? std::string(1, static_cast<char>('0'+number)) :
+                             std::string("1") + static_cast<char>('0'+number-10)));
+    const model::run::flowcell_layout layout(1, 1, 2, 12, 1, 1, tiles, constants::FourDigit);
+    tile_spatial_index::location_vector_t locations;
+    list_tile_locations(layout, locations);
+    ASSERT_EQ(locations.size(), tiles.size());
+    const tile_spatial_index index(locations);
+
+    tile_spatial_index::id_vector_t neighbors;
+    ASSERT_TRUE(index.neighbors(1, 1105, 1.0f, neighbors));
+    std::sort(neighbors.begin(), neighbors.end());
+    ASSERT_EQ(neighbors.size(), 3u);
+    EXPECT_EQ(neighbors[0], 1104u);
+    EXPECT_EQ(neighbors[1], 1106u);
+    EXPECT_EQ(neighbors[2], 1205u);
+
+    ::uint32_t tile = 0;
+    ASSERT_TRUE(index.nearest(1, 0.9f, 10.8f, tile));
+    EXPECT_EQ(tile, 1212u);
+}
@@ -56,11 +56,11 @@ namespace illumina{ namespace interop { namespace unittest
         void operator()(const MetricSet&)
         {
             typedef typename MetricSet::metric_type metric_t;
-            // Dyanmic phasing does not have a read or write format
+            // Dyanmic phasing and QByTileRead do not have a read or write format
             // QByLane uses the same format as QMetrics
-            // Neither of these is tested
+            // None of these is tested
             const constants::metric_group group = static_cast<constants::metric_group>(MetricSet::TYPE);
-            if(group == constants::DynamicPhasing || group == constants::QByLane)
+            if(group == constants::DynamicPhasing || group == constants::QByLane || group == constants::QByTileRead)
                 return;
             const std::string name = io::paths::interop_basename<metric_t>();
             if(m_format_map.find(name) == m_format_map.end())
@@ -30,6 +30,7 @@ TEST_P(run_metrics_tests, compute_buffer_size)
     {
         const constants::metric_group group = static_cast<constants::metric_group>(i);
         if(group == constants::DynamicPhasing) continue; // This does not have a format
+        if(group == constants::QByTileRead) continue; // This does not have a format
         if(actual.is_group_empty(group)) continue;
         EXPECT_NO_THROW(actual.calculate_buffer_size(group)) << constants::to_string(group);
     }
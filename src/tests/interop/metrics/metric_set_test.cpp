@@ -0,0 +1,322 @@
+/** Unit tests for the metric set lookups
+ *
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <sstream>
+#include <gtest/gtest.h>
+#include "interop/util/memory_policy.h"
+#include "interop/model/metrics/error_metric.h"
+#include "interop/model/metric_base/metric_set.h"
+#include "interop/io/metric_file_stream.h"
+#include "src/tests/interop/metrics/inc/q_metrics_test.h"
+#include "src/tests/interop/metrics/inc/tile_metrics_test.h"
+
+using namespace illumina::interop;
+using namespace illumina::interop::model::metrics;
+using namespace illumina::interop::model::metric_base;
+
+namespace
+{
+    /** Populate a metric set with error metrics covering four lanes
+     *
+     * @param metrics destination metric set
+     * @param tiles_per_lane number of tiles in each lane
+     * @param cycle_count number of cycles for each tile
+     */
+    void populate_error_metrics(metric_set<error_metric>& metrics, const ::uint32_t tiles_per_lane, const ::uint32_t cycle_count)
+    {
+        metrics.reserve(4*tiles_per_lane*cycle_count);
+        for(::uint32_t lane=1;lane<=4;++lane)
+            for(::uint32_t tile=1;tile<=tiles_per_lane;++tile)
+                for(::uint32_t cycle=1;cycle<=cycle_count;++cycle)
+                    metrics.insert(error_metric(lane, 1100+tile, cycle, static_cast<float>(cycle)));
+        metrics.rebuild_index(true);
+    }
+}
+
+// Test that a batch lookup finds the same metrics as a lookup by id
+TEST(metric_set_test, batch_find)
+{
+    metric_set<error_metric> metrics;
+    populate_error_metrics(metrics, 3, 40);
+    metric_set<error_metric>::key_vector ids;
+    ids.push_back(error_metric::create_id(2, 1102, 7));
+    ids.push_back(error_metric::create_id(9, 1102, 7));
+    for(::uint32_t cycle=1;cycle<=40;++cycle) ids.push_back(error_metric::create_id(4, 1103, cycle));
+    ids.push_back(error_metric::create_id(1, 1101, 41));
+
+    std::vector<size_t> indices;
+    metrics.find(ids, indices);
+    ASSERT_EQ(indices.size(), ids.size());
+    for(size_t i=0;i<ids.size();++i)
+        EXPECT_EQ(indices[i], metrics.find(ids[i]));
+    EXPECT_EQ(indices[1], metrics.size());
+    EXPECT_EQ(indices.back(), metrics.size());
+    EXPECT_EQ(metrics[indices[0]].id(), ids[0]);
+
+    std::vector<const error_metric*> found(ids.size());
+    metrics.get_metrics(&ids[0], ids.size(), &found[0]);
+    EXPECT_EQ(found[0], &metrics.get_metric(ids[0]));
+    EXPECT_TRUE(found[1] == 0);
+    EXPECT_EQ(found[10]->cycle(), 9u);
+    EXPECT_TRUE(found.back() == 0);
+}
+
+// Test that a batch lookup in a shuffled order finds the same records as a lookup by id
+TEST(metric_set_test, batch_find_shuffled)
+{
+    metric_set<error_metric> metrics;
+    populate_error_metrics(metrics, 10, 25);
+    ASSERT_EQ(metrics.size(), 1000u);
+
+    metric_set<error_metric>::key_vector ids;
+    for(metric_set<error_metric>::const_iterator it = metrics.begin();it != metrics.end();++it)
+        ids.push_back(it->id());
+    for(size_t i=0;i<ids.size();++i) std::swap(ids[i], ids[(i*7919) % ids.size()]);
+
+    std::vector<const error_metric*> found(ids.size());
+    metrics.get_metrics(&ids[0], ids.size(), &found[0]);
+    for(size_t i=0;i<ids.size();++i)
+        EXPECT_EQ(found[i], &metrics.get_metric(ids[i]));
+}
+
+TEST(metric_set_test, reserve_with_huge_pages)
+{
+    util::memory_policy::use_huge_pages(true);
+    metric_set<error_metric> metrics;
+    populate_error_metrics(metrics, 500, 100);
+    util::memory_policy::use_huge_pages(false);
+
+    ASSERT_EQ(metrics.size(), static_cast<size_t>(4*500*100));
+    EXPECT_EQ(static_cast< ::uint32_t >(4), metrics[metrics.size()-1].lane());
+    EXPECT_FALSE(util::memory_policy::advise(&metrics[0], metrics.size()*sizeof(error_metric)));
+}
+
+// Test that growing a set one record at a time moves the storage only a logarithmic number of times
+TEST(metric_set_test, resize_grows_geometrically)
+{
+    metric_set<error_metric> metrics;
+    size_t move_count = 0;
+    const error_metric* storage = 0;
+    for(size_t i=0;i<20000;++i)
+    {
+        metrics.resize(i+1);
+        if(&metrics[0] != storage) ++move_count;
+        storage = &metrics[0];
+    }
+    EXPECT_LT(move_count, static_cast<size_t>(40));
+}
+
+// Test that inserted and updated records are reported once, and only after the cursor
+TEST(metric_set_test, changed_since_reports_stamped_records)
+{
+    metric_set<error_metric> metrics;
+    metrics.track_changes(true);
+    metrics.insert(error_metric(1, 1101, 1, 1.0f));
+    metrics.insert(error_metric(1, 1101, 2, 1.0f));
+    const metric_set<error_metric>::generation_t cursor = metrics.generation();
+
+    metrics.next_generation();
+    metrics.insert(error_metric(1, 1102, 1, 1.0f));
+    metrics.stamp(0);
+    metrics.stamp(0);
+
+    metric_set<error_metric>::key_vector ids;
+    metrics.changed_since(cursor, ids);
+    ASSERT_EQ(ids.size(), 2u);
+    EXPECT_EQ(ids[0], metrics[2].id());
+    EXPECT_EQ(ids[1], metrics[0].id());
+
+    metrics.changed_since(metrics.generation(), ids);
+    EXPECT_TRUE(ids.empty());
+
+    metrics.changed_since(0, ids);
+    EXPECT_EQ(ids.size(), metrics.size());
+
+    // The last record moves into the removed slot, so it is reported as changed
+    const metric_set<error_metric>::generation_t before_remove = metrics.generation();
+    metrics.next_generation();
+    metric_set<error_metric>::iterator removed = metrics.begin()+1;
+    metrics.remove(removed);
+    metrics.changed_since(before_remove, ids);
+    ASSERT_EQ(ids.size(), 1u);
+    EXPECT_EQ(ids[0], metrics[1].id());
+}
+
+// Test that every record is reported when change tracking is disabled
+TEST(metric_set_test, changed_since_without_tracking)
+{
+    metric_set<error_metric> metrics;
+    populate_error_metrics(metrics, 2, 3);
+    metric_set<error_metric>::key_vector ids;
+    metrics.changed_since(metrics.generation(), ids);
+    EXPECT_EQ(ids.size(), metrics.size());
+    EXPECT_EQ(metrics.change_log_size(), 0u);
+}
+
+// Test that repeated updates of the same records do not grow the change log without bound
+TEST(metric_set_test, change_log_compaction)
+{
+    metric_set<error_metric> metrics;
+    metrics.track_changes(true);
+    populate_error_metrics(metrics, 10, 10);
+    for(size_t generation=0;generation<100;++generation)
+    {
+        const metric_set<error_metric>::generation_t cursor = metrics.generation();
+        metrics.next_generation();
+        for(size_t i=0;i<metrics.size();i+=2) metrics.stamp(i);
+        EXPECT_LE(metrics.change_log_size(), 2*metrics.size()+metric_set<error_metric>::MIN_CHANGE_LOG_SLACK);
+
+        metric_set<error_metric>::key_vector ids;
+        metrics.changed_since(cursor, ids);
+        EXPECT_EQ(ids.size(), metrics.size()/2);
+    }
+    metrics.sort();
+    EXPECT_EQ(metrics.change_log_size(), metrics.size());
+}
+
+// Test that reading a file stamps the records it holds with a new generation
+TEST(metric_set_test, changed_since_after_read)
+{
+    const ::int16_t version = 3;
+    metric_set<error_metric> first(version);
+    first.insert(error_metric(1, 1101, 1, 1.0f));
+    first.insert(error_metric(1, 1102, 1, 1.0f));
+    metric_set<error_metric> second(version);
+    second.insert(error_metric(1, 1102, 1, 2.0f));
+    second.insert(error_metric(1, 1103, 1, 2.0f));
+    std::ostringstream first_out, second_out;
+    io::write_metrics(first_out, first, version);
+    io::write_metrics(second_out, second, version);
+
+    metric_set<error_metric> metrics;
+    metrics.track_changes(true);
+    // Keep the lookup table between reads, as a reader polling a live run does
+    io::read_interop_from_string(first_out.str(), metrics, /*rebuild=*/ false);
+    const metric_set<error_metric>::generation_t cursor = metrics.generation();
+    io::read_interop_from_string(second_out.str(), metrics, /*rebuild=*/ false);
+    ASSERT_EQ(metrics.size(), 3u);
+
+    metric_set<error_metric>::key_vector ids;
+    metrics.changed_since(cursor, ids);
+    ASSERT_EQ(ids.size(), 2u);
+    EXPECT_EQ(ids[0], second[0].id());
+    EXPECT_EQ(ids[1], second[1].id());
+    EXPECT_EQ(metrics.get_metric(second[0].id()).error_rate(), 2.0f);
+}
+
+// Test that a reload into a cleared set only stamps the records whose content changed
+TEST(metric_set_test, changed_since_after_reload)
+{
+    const ::int16_t version = 3;
+    metric_set<error_metric> first(version);
+    first.insert(error_metric(1, 1101, 1, 1.0f));
+    first.insert(error_metric(1, 1102, 1, 1.0f));
+    first.insert(error_metric(1, 1103, 1, 1.0f));
+    metric_set<error_metric> second(version);
+    second.insert(error_metric(1, 1101, 1, 1.0f));
+    second.insert(error_metric(1, 1102, 1, 2.0f));
+    second.insert(error_metric(1, 1104, 1, 1.0f));
+    std::ostringstream first_out, second_out;
+    io::write_metrics(first_out, first, version);
+    io::write_metrics(second_out, second, version);
+
+    metric_set<error_metric> metrics;
+    metrics.track_changes(true);
+    io::read_interop_from_string(first_out.str(), metrics);
+    const metric_set<error_metric>::generation_t cursor = metrics.generation();
+    metric_set<error_metric>::key_vector ids;
+
+    metrics.clear();
+    io::read_interop_from_string(first_out.str(), metrics);
+    metrics.changed_since(cursor, ids);
+    EXPECT_TRUE(ids.empty());
+    metrics.changed_since(0, ids);
+    EXPECT_EQ(ids.size(), 3u);
+
+    metrics.clear();
+    io::read_interop_from_string(second_out.str(), metrics);
+    metrics.changed_since(cursor, ids);
+    ASSERT_EQ(ids.size(), 2u);
+    EXPECT_EQ(ids[0], second[1].id());
+    EXPECT_EQ(ids[1], second[2].id());
+}
+
+// Test that a reload into a cleared set decodes into the kept records, with the arrays they hold
+TEST(metric_set_test, retain_capacity_reuses_records)
+{
+    std::string data;
+    unittest::q_metric_v6::create_binary_data(data);
+    metric_set<q_metric> metrics;
+    metrics.retain_capacity(true);
+    io::read_interop_from_string(data, metrics);
+    ASSERT_FALSE(metrics.empty());
+    std::set<const ::uint32_t*> histograms;
+    for(size_t i=0;i<metrics.size();++i) histograms.insert(&metrics[i].qscore_hist()[0]);
+
+    const size_t size = metrics.size();
+    metrics.clear();
+    EXPECT_TRUE(metrics.empty());
+    EXPECT_EQ(metrics.recycled_size(), size);
+    io::read_interop_from_string(data, metrics);
+
+    metric_set<q_metric> expected;
+    io::read_interop_from_string(data, expected);
+    ASSERT_EQ(metrics.size(), expected.size());
+    EXPECT_EQ(metrics.recycled_size(), 0u);
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        EXPECT_EQ(metrics[i].id(), expected[i].id());
+        EXPECT_EQ(metrics[i].qscore_hist(), expected[i].qscore_hist());
+        EXPECT_TRUE(histograms.find(&metrics[i].qscore_hist()[0]) != histograms.end()) << i;
+    }
+}
+
+// Test that the kept records are reset, so a reload does not append to the arrays of the previous load
+TEST(metric_set_test, retain_capacity_resets_records)
+{
+    std::string data;
+    unittest::tile_metric_v2::create_binary_data(data);
+    metric_set<tile_metric> expected;
+    io::read_interop_from_string(data, expected);
+    metric_set<tile_metric> metrics;
+    metrics.retain_capacity(true);
+    for(size_t load=0;load<3;++load)
+    {
+        metrics.clear();
+        io::read_interop_from_string(data, metrics);
+        ASSERT_EQ(metrics.size(), expected.size());
+        for(size_t i=0;i<metrics.size();++i)
+        {
+            EXPECT_EQ(metrics[i].id(), expected[i].id());
+            EXPECT_EQ(metrics[i].cluster_count(), expected[i].cluster_count());
+            ASSERT_EQ(metrics[i].read_metrics().size(), expected[i].read_metrics().size());
+            for(size_t r=0;r<metrics[i].read_metrics().size();++r)
+                EXPECT_EQ(metrics[i].read_metrics()[r].read(), expected[i].read_metrics()[r].read());
+        }
+    }
+}
+
+// Test that the kept records are freed when a load uses fewer than half of them
+TEST(metric_set_test, retain_capacity_frees_after_small_load)
+{
+    metric_set<error_metric> metrics;
+    metrics.retain_capacity(true);
+    populate_error_metrics(metrics, 10, 10);
+    const size_t large_size = metrics.size();
+    metrics.clear();
+    EXPECT_EQ(metrics.recycled_size(), large_size);
+
+    populate_error_metrics(metrics, 1, 10);
+    const size_t small_size = metrics.size();
+    EXPECT_EQ(metrics.recycled_size(), large_size-small_size);
+    metrics.clear();
+    EXPECT_EQ(metrics.recycled_size(), small_size);
+
+    metrics.retain_capacity(false);
+    EXPECT_EQ(metrics.recycled_size(), 0u);
+}
@@ -14,6 +14,8 @@
 #include <gtest/gtest.h>
 #include "interop/io/metric_stream.h"
 #include "interop/io/metric_file_stream.h"
+#include "interop/io/record_view.h"
+#include "interop/io/metric_stream_parser.h"
 #include "src/tests/interop/metrics/inc/metric_format_fixtures.h"
 
 using namespace illumina::interop;
@@ -117,6 +119,228 @@ TYPED_TEST_P(metric_stream_test, test_write_data_size)
     EXPECT_NO_THROW(io::write_interop_to_buffer(metrics, &buffer.front(), buffer.size()));
 }
 
+/** Confirm that the tile filter reads only the records for the selected tile
+ */
+TYPED_TEST_P(metric_stream_test, test_read_tile_filter)
+{
+    typedef typename TypeParam::metric_set_t metric_set_t;
+    std::string tmp = std::string(TestFixture::expected);
+    metric_set_t all_metrics;
+    io::read_interop_from_string(tmp, all_metrics);
+    if(all_metrics.empty()) return;
+
+    model::metric_base::tile_filter filter;
+    filter.insert(all_metrics[0].tile_hash());
+    size_t expected_count = 0;
+    for(typename metric_set_t::const_iterator it = all_metrics.begin();it != all_metrics.end();++it)
+        if(it->tile_hash() == all_metrics[0].tile_hash()) ++expected_count;
+
+    metric_set_t metrics;
+    std::istringstream in(tmp);
+    io::read_metrics(in, metrics, tmp.size(), true, &filter);
+    EXPECT_EQ(expected_count, metrics.size());
+    for(typename metric_set_t::const_iterator it = metrics.begin();it != metrics.end();++it)
+        EXPECT_EQ(all_metrics[0].tile_hash(), it->tile_hash());
+}
+
+/** Confirm that record views decode the same metrics as the stream reader
+ */
+TYPED_TEST_P(metric_stream_test, test_record_view)
+{
+    typedef typename TypeParam::metric_set_t metric_set_t;
+    typedef typename metric_set_t::metric_type metric_t;
+    typedef typename io::record_buffer<metric_t>::const_iterator const_iterator;
+    std::string tmp = std::string(TestFixture::expected);
+    metric_set_t all_metrics;
+    io::read_interop_from_string(tmp, all_metrics);
+    all_metrics.rebuild_index(true);
+    const int version = static_cast< ::uint8_t >(tmp[0]);
+    if(io::metric_format_factory<metric_t>::metric_formats()[version]->is_multi_record() ||
+       io::metric_format_factory<metric_t>::metric_formats()[version]->is_deprecated())
+    {
+        EXPECT_THROW(io::record_buffer<metric_t>(tmp.c_str(), tmp.size()), io::bad_format_exception);
+        return;
+    }
+
+    io::record_buffer<metric_t> records(tmp.c_str(), tmp.size());
+    EXPECT_EQ(all_metrics.version(), records.version());
+    size_t valid_count = 0;
+    metric_t decoded(records.header());
+    for(const_iterator it = records.begin();it != records.end();++it)
+    {
+        if(it->id() == 0) continue;
+        EXPECT_EQ(records.record_size(), it->decode(decoded));
+        EXPECT_EQ(it->id(), decoded.id());
+        EXPECT_EQ(it->tile_hash(), decoded.tile_hash());
+        ASSERT_TRUE(all_metrics.has_metric(it->id()));
+        ++valid_count;
+    }
+    EXPECT_EQ(all_metrics.size(), valid_count);
+}
+
+/** Confirm that the incremental parser reads the same metrics as the stream reader when fed in small chunks
+ */
+TYPED_TEST_P(metric_stream_test, test_stream_parser)
+{
+    typedef typename TypeParam::metric_set_t metric_set_t;
+    typedef typename metric_set_t::metric_type metric_t;
+    std::string tmp = std::string(TestFixture::expected);
+    metric_set_t all_metrics;
+    io::read_interop_from_string(tmp, all_metrics);
+
+    metric_set_t metrics;
+    // A small ring buffer forces records to wrap around its end
+    io::metric_stream_parser<metric_t> parser(metrics, 256);
+    if(static_cast<constants::metric_group>(metric_t::TYPE) == constants::Index)
+    {
+        EXPECT_THROW(parser.feed(tmp.c_str(), tmp.size()), io::bad_format_exception);
+        return;
+    }
+    const size_t chunk_size = 7;
+    for(size_t i=0;i<tmp.size();i+=chunk_size)
+        parser.feed(tmp.c_str()+i, std::min(chunk_size, tmp.size()-i));
+    parser.finish();
+    EXPECT_EQ(all_metrics.version(), metrics.version());
+    ASSERT_EQ(all_metrics.size(), metrics.size());
+    for(size_t i=0;i<metrics.size();++i)
+        EXPECT_EQ(all_metrics[i].id(), metrics[i].id());
+
+    metric_set_t truncated;
+    io::metric_stream_parser<metric_t> truncated_parser(truncated, 256);
+    truncated_parser.feed(tmp.c_str(), tmp.size()-1);
+    if(!all_metrics.empty() && truncated_parser.header_complete() && truncated_parser.buffered() > 0)
+    {
+        EXPECT_THROW(truncated_parser.finish(), io::incomplete_file_exception);
+    }
+}
+
+/** Confirm that a partially written file is read up to its last complete record without throwing
+ */
+TYPED_TEST_P(metric_stream_test, test_read_available_metrics)
+{
+    typedef typename TypeParam::metric_set_t metric_set_t;
+    typedef typename metric_set_t::metric_type metric_t;
+    std::string tmp = std::string(TestFixture::expected);
+    const int version = static_cast< ::uint8_t >(tmp[0]);
+    if(io::metric_format_factory<metric_t>::metric_formats()[version]->is_deprecated()) return;
+    metric_set_t all_metrics;
+    std::istringstream fin(tmp);
+    const io::read_status complete = io::read_available_metrics(fin, all_metrics, tmp.size());
+    EXPECT_TRUE(complete.is_complete());
+    EXPECT_EQ(tmp.size(), complete.byte_offset());
+    if(all_metrics.empty()) return;
+
+    const std::string partial = tmp.substr(0, tmp.size()-1);
+    metric_set_t metrics;
+    std::istringstream in(partial);
+    const io::read_status status = io::read_available_metrics(in, metrics, partial.size());
+    EXPECT_EQ(io::read_status::IncompleteRecord, status.code());
+    ASSERT_LT(status.byte_offset(), tmp.size());
+    EXPECT_EQ(partial.size(), status.byte_offset()+status.partial_byte_count());
+    ASSERT_LE(metrics.size(), all_metrics.size());
+    for(size_t i=0;i<metrics.size();++i)
+        EXPECT_EQ(all_metrics[i].id(), metrics[i].id());
+    if(metrics.empty()) return;
+
+    // The valid prefix is a complete file that holds the same metrics
+    const std::string prefix = tmp.substr(0, status.byte_offset());
+    metric_set_t prefix_metrics;
+    std::istringstream prefix_in(prefix);
+    const io::read_status prefix_status = io::read_available_metrics(prefix_in, prefix_metrics, prefix.size());
+    EXPECT_TRUE(prefix_status.is_complete());
+    EXPECT_EQ(prefix.size(), prefix_status.byte_offset());
+    EXPECT_EQ(metrics.size(), prefix_metrics.size());
+}
+
+TEST(metric_stream_test, read_available_interop_missing_file)
+{
+    model::metric_base::metric_set<model::metrics::error_metric> metrics;
+    const io::read_status status = io::read_available_interop("/NO/SUCH/RUN/FOLDER", metrics);
+    EXPECT_EQ(io::read_status::FileNotFound, status.code());
+    EXPECT_FALSE(status.is_incomplete());
+    EXPECT_TRUE(metrics.empty());
+}
+
+TEST(metric_stream_test, record_view_field)
+{
+    model::metric_base::metric_set<model::metrics::extraction_metric> metrics;
+    extraction_metric_v2::create_expected(metrics);
+    std::string tmp;
+    extraction_metric_v2::create_binary_data(tmp);
+    io::record_buffer<model::metrics::extraction_metric> records(tmp.c_str(), tmp.size());
+    ASSERT_EQ(metrics.size(), records.size());
+    for(size_t i=0;i<records.size();++i)
+    {
+        // Lane, tile and cycle are each 2 bytes, followed by the focus score for channel A
+        EXPECT_EQ(metrics[i].lane(), records[i].value< ::uint16_t >(0));
+        EXPECT_EQ(metrics[i].cycle(), records[i].value< ::uint16_t >(4));
+        EXPECT_EQ(metrics[i].tile(), (records[i].value< ::uint16_t, ::uint32_t >(2)));
+        EXPECT_NEAR(metrics[i].focus_score(0), records[i].value<float>(6), 1e-5f);
+        EXPECT_EQ(metrics[i].lane(), records[i].lane());
+        EXPECT_EQ(metrics[i].tile(), records[i].tile());
+    }
+}
+
+TEST(metric_stream_test, read_metrics_across_blocks)
+{
+    // Both files are larger than a single read block, so records are decoded from more than one block
+    typedef model::metric_base::metric_set<model::metrics::q_metric> q_metric_set_t;
+    q_metric_set_t q_metrics(4);
+    std::vector< ::uint32_t > hist(model::metrics::q_metric::MAX_Q_BINS, 0);
+    for(::uint32_t lane=1;lane<=2;++lane)
+    {
+        for(::uint32_t tile=1;tile<=100;++tile)
+        {
+            for(::uint32_t cycle=1;cycle<=30;++cycle)
+            {
+                hist[cycle] = lane*tile;
+                q_metrics.insert(model::metrics::q_metric(lane, tile, cycle, hist));
+                hist[cycle] = 0;
+            }
+        }
+    }
+    std::ostringstream q_out;
+    io::write_metrics(q_out, q_metrics);
+    ASSERT_GT(q_out.str().size(), size_t(1 << 20));
+    q_metric_set_t q_actual;
+    io::read_interop_from_string(q_out.str(), q_actual);
+    ASSERT_EQ(q_metrics.size(), q_actual.size());
+    for(size_t i=0;i<q_metrics.size();i+=97)
+    {
+        EXPECT_EQ(q_metrics[i].id(), q_actual[i].id());
+        EXPECT_EQ(q_metrics[i].qscore_hist(q_metrics[i].cycle()), q_actual[i].qscore_hist(q_actual[i].cycle()));
+    }
+
+    typedef model::metric_base::metric_set<model::metrics::tile_metric> tile_metric_set_t;
+    typedef model::metrics::tile_metric::read_metric_vector read_metric_vector;
+    typedef model::metrics::tile_metric::read_metric_type read_metric_type;
+    tile_metric_set_t tile_metrics(2);
+    read_metric_vector reads;
+    reads.push_back(read_metric_type(1, 2.5f, 0.125f, 0.25f));
+    reads.push_back(read_metric_type(2, 1.5f, 0.375f, 0.5f));
+    for(::uint32_t lane=1;lane<=8;++lane)
+        for(::uint32_t tile=1;tile<=1500;++tile)
+            tile_metrics.insert(model::metrics::tile_metric(lane, tile, 1000.0f, 900.0f, tile*1.0f, lane*1.0f, reads));
+    std::ostringstream tile_out;
+    io::write_metrics(tile_out, tile_metrics, 2);
+    ASSERT_GT(tile_out.str().size(), size_t(1 << 20));
+    tile_metric_set_t tile_actual;
+    io::read_interop_from_string(tile_out.str(), tile_actual);
+    ASSERT_EQ(tile_metrics.size(), tile_actual.size());
+    for(size_t i=0;i<tile_metrics.size();i+=97)
+    {
+        EXPECT_EQ(tile_metrics[i].id(), tile_actual[i].id());
+        EXPECT_EQ(tile_metrics[i].cluster_count(), tile_actual[i].cluster_count());
+        EXPECT_EQ(tile_metrics[i].cluster_count_pf(), tile_actual[i].cluster_count_pf());
+        ASSERT_EQ(reads.size(), tile_actual[i].read_metrics().size());
+    }
+
+    // A record cut at the end of the file is still reported as an incomplete file
+    const std::string truncated = tile_out.str().substr(0, tile_out.str().size()-3);
+    tile_metric_set_t tile_truncated;
+    EXPECT_THROW(io::read_interop_from_string(truncated, tile_truncated), io::incomplete_file_exception);
+}
+
 TEST(metric_stream_test, list_filenames)
 {
     std::vector<std::string> error_metric_files;
@@ -161,7 +385,11 @@ REGISTER_TYPED_TEST_CASE_P(metric_stream_test,
                            test_read_data_size,
                            test_header_size,
                            test_write_read_binary_data,
-                           test_write_data_size
+                           test_write_data_size,
+                           test_read_tile_filter,
+                           test_record_view,
+                           test_stream_parser,
+                           test_read_available_metrics
 );
 
 
@@ -0,0 +1,138 @@
+/** Unit tests for the q-score histogram by tile and read
+ *
+ *
+ *  @file
+ *  @date 10/19/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include <gtest/gtest.h>
+#include "interop/logic/metric/q_metric.h"
+#include "interop/model/run_metrics.h"
+#include "interop/util/filesystem.h"
+#include "src/tests/interop/metrics/inc/q_metrics_test.h"
+#include "src/tests/interop/run/info_test.h"
+using namespace illumina::interop;
+using namespace illumina::interop::model::metrics;
+using namespace illumina::interop::model::metric_base;
+using namespace illumina::interop::unittest;
+
+namespace
+{
+    /** Create an unbinned histogram with all clusters at two q-scores
+     *
+     * @param q1 first q-score
+     * @param count1 number of clusters at the first q-score
+     * @param q2 second q-score
+     * @param count2 number of clusters at the second q-score
+     * @return histogram
+     */
+    q_metric::uint32_vector make_histogram(const size_t q1, const ::uint32_t count1, const size_t q2, const ::uint32_t count2)
+    {
+        q_metric::uint32_vector hist(q_metric::MAX_Q_BINS, 0);
+        hist[q1-1] += count1;
+        hist[q2-1] += count2;
+        return hist;
+    }
+}
+
+// Test that the histograms of all cycles in a read are summed for each tile
+TEST(q_by_tile_read_metrics_test, create_from_q_metrics)
+{
+    metric_set<q_metric> metrics;
+    metrics.insert(q_metric(1, 1101, 1, make_histogram(20, 10, 35, 30)));
+    metrics.insert(q_metric(1, 1101, 2, make_histogram(25, 20, 30, 40)));
+    metrics.insert(q_metric(1, 1101, 3, make_histogram(10, 5, 40, 5)));
+    metrics.insert(q_metric(1, 1102, 1, make_histogram(12, 1, 38, 1)));
+    logic::summary::read_cycle_vector_t cycle_to_read(3);
+    cycle_to_read[0] = logic::summary::read_cycle(1, 1);
+    cycle_to_read[1] = logic::summary::read_cycle(1, 2);
+    cycle_to_read[2] = logic::summary::read_cycle(2, 1);
+
+    metric_set<q_by_tile_read_metric> by_tile_read;
+    logic::metric::create_q_metrics_by_tile_read(metrics, cycle_to_read, by_tile_read);
+    ASSERT_EQ(3u, by_tile_read.size());
+
+    const q_by_tile_read_metric& read1 = by_tile_read.get_metric(1, 1101, 1);
+    EXPECT_EQ(100u, read1.sum_qscore());
+    EXPECT_EQ(70u, read1.total_over_qscore(by_tile_read.index_for_q_value(30)));
+    EXPECT_NEAR(70.0f, read1.percent_over_qscore(by_tile_read.index_for_q_value(30)), 1e-5f);
+    EXPECT_EQ(40u, read1.qscore_hist(by_tile_read.index_for_q_value(30)));
+    EXPECT_EQ(30u, read1.median());
+    EXPECT_EQ(20u, read1.quantile(0.0));
+    EXPECT_EQ(35u, read1.quantile(1.0));
+
+    const q_by_tile_read_metric& read2 = by_tile_read.get_metric(1, 1101, 2);
+    EXPECT_EQ(10u, read2.sum_qscore());
+    EXPECT_NEAR(50.0f, read2.percent_over_qscore(by_tile_read.index_for_q_value(30)), 1e-5f);
+    EXPECT_TRUE(by_tile_read.has_metric(1, 1102, 1));
+}
+
+// Test that binned histograms use the q-score bins to find the q-value
+TEST(q_by_tile_read_metrics_test, binned_quantile)
+{
+    q_by_tile_read_header::qscore_bin_vector_type bins;
+    bins.push_back(q_score_bin(1, 19, 15));
+    bins.push_back(q_score_bin(20, 29, 25));
+    bins.push_back(q_score_bin(30, 50, 35));
+    const q_by_tile_read_header header(bins);
+    EXPECT_EQ(2u, header.index_for_q_value(30));
+    EXPECT_EQ(25u, header.q_value_for_index(1));
+
+    q_by_tile_read_metric::uint64_vector hist(3);
+    hist[0] = 10;
+    hist[1] = 30;
+    hist[2] = 60;
+    const q_by_tile_read_metric metric(1, 1101, 1, hist);
+    EXPECT_NEAR(60.0f, metric.percent_over_qscore(header.index_for_q_value(30)), 1e-5f);
+    EXPECT_EQ(35u, metric.median(bins));
+    EXPECT_EQ(25u, metric.quantile(0.4, bins));
+    EXPECT_EQ(0u, metric.total_over_qscore(3));
+}
+
+// Test that an empty histogram does not produce a quantile
+TEST(q_by_tile_read_metrics_test, empty_histogram)
+{
+    const q_by_tile_read_metric metric;
+    EXPECT_EQ(0u, metric.sum_qscore());
+    EXPECT_TRUE(std::isnan(metric.percent_over_qscore(0)));
+    EXPECT_EQ(std::numeric_limits<q_by_tile_read_metric::uint_t>::max(), metric.median());
+}
+
+// Test that the derived histograms are not written when a run with Q-metrics is read, finalized and written
+TEST(q_by_tile_read_metrics_test, write_after_finalize)
+{
+    const std::string run_folder = "q_by_tile_read_metrics_test_write";
+    io::mkdir(run_folder);
+    io::mkdir(io::combine(run_folder, "InterOp"));
+    model::run::info run_info;
+    const model::run::read_info read_array[]={
+            model::run::read_info(1, 1, 4, false)
+    };
+    hiseq4k_run_info::create_expected(run_info, util::to_vector(read_array));
+    {
+        run_metrics source;
+        q_metric_v6::create_expected(source.get<q_metric>());
+        ASSERT_NO_THROW(source.write_metrics(run_folder));
+    }
+
+    run_metrics metrics;
+    metrics.run_info(run_info);
+    std::vector<unsigned char> valid_to_load(constants::MetricCount, 0);
+    valid_to_load[constants::Q] = 1;
+    metrics.read_metrics(run_folder, run_info.total_cycles(), valid_to_load, 1);
+    ASSERT_FALSE(metrics.get<q_metric>().empty());
+    metrics.finalize_after_load();
+    ASSERT_FALSE(metrics.get<q_by_tile_read_metric>().empty());
+
+    EXPECT_NO_THROW(metrics.write_metrics(run_folder));
+    EXPECT_NO_THROW(metrics.write_metrics(run_folder, true, 2));
+    EXPECT_FALSE(io::is_file_readable(io::interop_filename<metric_set<q_by_tile_read_metric> >(run_folder)));
+
+    std::remove(io::interop_filename<metric_set<q_metric> >(run_folder).c_str());
+    std::remove(io::interop_filename<metric_set<q_collapsed_metric> >(run_folder).c_str());
+    std::remove(io::interop_filename<metric_set<q_by_lane_metric> >(run_folder).c_str());
+    std::remove(io::combine(run_folder, "InterOp").c_str());
+    std::remove(run_folder.c_str());
+}
@@ -207,6 +207,38 @@ TEST(q_metrics_test, test_percent_over_q30_binned)
     EXPECT_EQ(metric.percent_over_qscore(header.index_for_q_value(30)), 50);
 }
 
+/**
+ * @class illumina::interop::model::metrics::q_metrics
+ * @test Confirm the decoder tracks the non-zero histogram columns of a legacy file
+ */
+TEST(q_metrics_test, test_decode_tracks_nonzero_columns)
+{
+    std::vector< ::uint8_t > buffer;
+    q_metric_v4::create_binary_data(buffer);
+    q_metric_set actual;
+    io::read_interop_from_buffer(&buffer.front(), buffer.size(), actual);
+
+    ASSERT_EQ(3u, actual.size());
+    EXPECT_TRUE(actual.is_tracked(actual.size()));
+    EXPECT_EQ(4u, actual.nonzero_column_count());
+    EXPECT_EQ(4u, logic::metric::count_legacy_q_score_bins(actual));
+
+    q_metric_set expected;
+    q_metric_v4::create_expected(expected);
+    EXPECT_FALSE(expected.is_tracked(expected.size()));
+    EXPECT_EQ(4u, logic::metric::count_legacy_q_score_bins(expected));
+
+    q_metric_set compressed(actual);
+    logic::metric::populate_legacy_q_score_bins(compressed, compressed.bins(), constants::HiSeq);
+    logic::metric::compress_q_metrics(compressed);
+    EXPECT_FALSE(compressed.is_tracked(compressed.size()));
+    EXPECT_EQ(0u, compressed.nonzero_column_count());
+
+    actual.clear();
+    EXPECT_EQ(0u, actual.nonzero_column_count());
+    EXPECT_FALSE(actual.is_tracked(actual.size()));
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Setup regression test
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -12,6 +12,8 @@
 #include "src/tests/interop/metrics/inc/metric_format_fixtures.h"
 #include "interop/logic/utils/metrics_to_load.h"
 #include "interop/logic/table/create_imaging_table.h"
+#include "interop/util/filesystem.h"
+#include "interop/util/lexical_cast.h"
 
 
 using namespace illumina::interop;
@@ -124,6 +126,66 @@ TYPED_TEST_P(run_metric_test, append_tiles)
     EXPECT_EQ(count_expected, subset_metric_set.size());
 }
 
+/** Confirm writing the run metrics in parallel replaces the InterOp file without leaving a temporary file
+ */
+TYPED_TEST_P(run_metric_test, write_metrics_replaces_file)
+{
+    typedef typename TestFixture::metric_set_t metric_set_t;
+    const metric_set_t& metric_set = TestFixture::expected. template  get<metric_set_t>();
+    const std::string run_folder = "run_metric_test_" + io::interop_basename<metric_set_t>() + "_v"
+                                   + util::lexical_cast<std::string>(TestFixture::VERSION);
+    io::mkdir(run_folder);
+    io::mkdir(io::combine(run_folder, "InterOp"));
+    const std::string file_name = io::interop_filename<metric_set_t>(run_folder);
+    {
+        std::ofstream fout(file_name.c_str(), std::ios::binary);
+        fout << "stale";
+    }
+
+    EXPECT_NO_THROW(TestFixture::expected.write_metrics(run_folder, true, 2));
+    EXPECT_FALSE(io::is_file_readable(file_name + ".tmp"));
+    metric_set_t actual;
+    EXPECT_NO_THROW(io::read_interop(run_folder, actual));
+    EXPECT_EQ(metric_set.size(), actual.size());
+
+    std::remove(file_name.c_str());
+    std::remove(io::combine(run_folder, "InterOp").c_str());
+    std::remove(run_folder.c_str());
+}
+
+/** Confirm reloading an unchanged run folder reports no changed records
+ */
+TYPED_TEST_P(run_metric_test, reload_unchanged_reports_no_change)
+{
+    typedef typename TestFixture::metric_set_t metric_set_t;
+    const constants::metric_group group = static_cast<constants::metric_group>(metric_set_t::TYPE);
+    const std::string run_folder = "run_metric_test_reload_" + io::interop_basename<metric_set_t>() + "_v"
+                                   + util::lexical_cast<std::string>(TestFixture::VERSION);
+    io::mkdir(run_folder);
+    io::mkdir(io::combine(run_folder, "InterOp"));
+    const std::string file_name = io::interop_filename<metric_set_t>(run_folder);
+    EXPECT_NO_THROW(TestFixture::expected.write_metrics(run_folder, true));
+
+    model::metrics::run_metrics actual;
+    actual.track_changes(true);
+    actual.read_metrics(run_folder, 1, 1);
+    const size_t size = actual.get<metric_set_t>().size();
+    const ::uint64_t cursor = actual.generation(group);
+    std::vector< ::uint64_t > ids;
+    actual.changed_since(group, 0, ids);
+    EXPECT_EQ(size, ids.size());
+
+    actual.read_metrics(run_folder, 1, 1);
+    EXPECT_EQ(size, actual.get<metric_set_t>().size());
+    EXPECT_GT(actual.generation(group), cursor);
+    actual.changed_since(group, cursor, ids);
+    EXPECT_TRUE(ids.empty()) << ids.size() << " of " << size << " records reported";
+
+    std::remove(file_name.c_str());
+    std::remove(io::combine(run_folder, "InterOp").c_str());
+    std::remove(run_folder.c_str());
+}
+
 
 REGISTER_TYPED_TEST_CASE_P(run_metric_test,
                            test_clear,
@@ -131,7 +193,9 @@ REGISTER_TYPED_TEST_CASE_P(run_metric_test,
                            is_group_empty_false,
                            test_expected_get_metric,
                            on_demand_not_clear,
-                           append_tiles
+                           append_tiles,
+                           write_metrics_replaces_file,
+                           reload_unchanged_reports_no_change
 );
 
 
@@ -9,6 +9,7 @@
 #include <limits>
 #include <fstream>
 #include <set>
+#include <list>
 #include <gtest/gtest.h>
 #include "interop/util/math.h"
 #include "interop/util/statistics.h"
@@ -106,3 +107,114 @@ TEST(stat_test, standard_deviation_vec)
 }
 
 
+
+/** Fill a vector with values of widely varying magnitude and some NaNs
+ *
+ * @param values destination vector
+ * @param n number of values
+ */
+static void fill_reduction_values(std::vector<float>& values, const size_t n)
+{
+    values.resize(n);
+    ::uint32_t state = 12345;
+    for (size_t i = 0; i < n; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        const float scale = (i % 3 == 0) ? 1e4f : ((i % 3 == 1) ? 1.0f : 1e-3f);
+        values[i] = scale * static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+        if (i % 97 == 0) values[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+}
+
+TEST(stat_test, deterministic_mean_thread_count)
+{
+    std::vector<float> values;
+    fill_reduction_values(values, 100003);
+    const float mean1 = interop::util::deterministic_mean<float>(values.begin(), values.end(),
+                                                                 interop::util::op::operator_none(), true, 1);
+    for (size_t thread_count = 2; thread_count <= 8; thread_count *= 2)
+    {
+        EXPECT_EQ(mean1, interop::util::deterministic_mean<float>(values.begin(), values.end(),
+                                                                  interop::util::op::operator_none(), true,
+                                                                  thread_count)) << thread_count;
+    }
+    std::list<float> value_list(values.begin(), values.end());
+    EXPECT_EQ(mean1, interop::util::deterministic_mean<float>(value_list.begin(), value_list.end(),
+                                                              interop::util::op::operator_none(), true));
+
+    double sum = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (std::isnan(values[i])) continue;
+        sum += values[i];
+        ++count;
+    }
+    EXPECT_NEAR(sum / count, mean1, 1e-5 * sum / count);
+}
+
+TEST(stat_test, deterministic_variance_thread_count)
+{
+    std::vector<float> values;
+    fill_reduction_values(values, 100003);
+    const float mean = interop::util::deterministic_mean<float>(values.begin(), values.end(),
+                                                                interop::util::op::operator_none(), true);
+    const float variance1 = interop::util::deterministic_variance_with_mean<float>(
+            values.begin(), values.end(), mean, interop::util::op::operator_none(), true, 1);
+    for (size_t thread_count = 2; thread_count <= 8; thread_count *= 2)
+    {
+        EXPECT_EQ(variance1, interop::util::deterministic_variance_with_mean<float>(
+                values.begin(), values.end(), mean, interop::util::op::operator_none(), true, thread_count))
+                            << thread_count;
+    }
+    EXPECT_TRUE(std::isnan(interop::util::deterministic_variance_with_mean<float>(
+            values.begin(), values.begin() + 1, mean, interop::util::op::operator_none(), true)));
+    EXPECT_EQ(0.0f, interop::util::deterministic_variance_with_mean<float>(
+            values.begin() + 1, values.begin() + 2, mean, interop::util::op::operator_none()));
+}
+
+/** Return the position of a value as the x-coordinate of a point */
+struct index_x
+{
+    /** Constructor
+     *
+     * @param beg pointer to the first value
+     */
+    index_x(const float* beg) : m_beg(beg){}
+    /** Get the x-coordinate of a value
+     *
+     * @param val value in the collection
+     * @return x-coordinate
+     */
+    float operator()(const float& val)const
+    {
+        return static_cast<float>(&val - m_beg) / 1000.0f;
+    }
+    const float* m_beg;
+};
+
+TEST(stat_test, deterministic_linear_fit_thread_count)
+{
+    std::vector<float> values;
+    fill_reduction_values(values, 100003);
+    for (size_t i = 0; i < values.size(); ++i)
+        if (std::isnan(values[i])) values[i] = 0;
+    const index_x xop(&values.front());
+    const interop::util::linear_fit_sums<float> fit1 = interop::util::deterministic_linear_fit_sums<float>(
+            values.begin(), values.end(), xop, interop::util::op::operator_none(), 1);
+    EXPECT_EQ(fit1.count, values.size());
+    for (size_t thread_count = 2; thread_count <= 8; thread_count *= 2)
+    {
+        const interop::util::linear_fit_sums<float> fit = interop::util::deterministic_linear_fit_sums<float>(
+                values.begin(), values.end(), xop, interop::util::op::operator_none(), thread_count);
+        EXPECT_EQ(fit1.slope(), fit.slope()) << thread_count;
+        EXPECT_EQ(fit1.offset(), fit.offset()) << thread_count;
+    }
+
+    std::vector<float> line(25);
+    for (size_t i = 0; i < line.size(); ++i) line[i] = 2.0f + 0.5f * static_cast<float>(i) / 1000.0f;
+    const interop::util::linear_fit_sums<float> fit = interop::util::deterministic_linear_fit_sums<float>(
+            line.begin(), line.end(), index_x(&line.front()), interop::util::op::operator_none());
+    EXPECT_NEAR(fit.slope(), 0.5f, 1e-2f);
+    EXPECT_NEAR(fit.offset(), 2.0f, 1e-3f);
+}